@@ -17,6 +17,10 @@
 // Also test DynamicShardedTree directly
 #include "DynamicShardedTree.hpp"
 
+// Alternative shard backends
+#include "concurrent_avl_shard.hpp"
+#include "skiplist_shard.hpp"
+
 using namespace std::chrono;
 
 // ============================================================================
@@ -492,6 +496,18 @@ int main(int argc, char* argv[]) {
         DynamicShardedTree<int, int> tree3(cfg);
         double ops3 = benchmark_multithreaded(tree3, config);
         
+        ParallelAVL<int, int, ConcurrentAVLShard<int, int>> tree4(config.num_shards);
+        double ops4 = benchmark_multithreaded(tree4, config);
+        
+        ParallelAVL<int, int, SkipListShard<int, int>> tree5(config.num_shards);
+        double ops5 = benchmark_multithreaded(tree5, config);
+        
+        ParallelAVL<int, int, TreeShard<int, int, BPlusTree<int, int>>> tree6(config.num_shards);
+        double ops6 = benchmark_multithreaded(tree6, config);
+        
+        ParallelAVL<int, int, TreeShard<int, int, AdaptiveRadixTree<int, int>>> tree7(config.num_shards);
+        double ops7 = benchmark_multithreaded(tree7, config);
+        
         std::cout << "┌─────────────────────────────────────────────────────────────────┐\n";
         std::cout << "│ Multi-threaded Throughput (ops/sec)                             │\n";
         std::cout << "├─────────────────────────────────────────────────────────────────┤\n";
@@ -510,6 +526,10 @@ int main(int argc, char* argv[]) {
                   << " (baseline)" << std::setw(6) << "" << "│\n";
         print_mt("ParallelAVL (New)", ops2, ops1);
         print_mt("DynamicShardedTree", ops3, ops1);
+        print_mt("ParallelAVL (Bronson)", ops4, ops1);
+        print_mt("ParallelAVL (SkipList)", ops5, ops1);
+        print_mt("ParallelAVL (B+Tree)", ops6, ops1);
+        print_mt("ParallelAVL (ART)", ops7, ops1);
         
         std::cout << "└─────────────────────────────────────────────────────────────────┘\n\n";
     }
@@ -26,6 +26,8 @@
 #include <cmath>
 #include <functional>
 
+#include "../include/latency_histogram.hpp"
+
 // ============================================================================
 // ORIGINAL-STYLE ParallelAVL Implementation
 // This mirrors the actual project structure without Intel optimizations
@@ -343,8 +345,7 @@ public:
         
         for (auto& wl : workloads) {
             OriginalParallelAVL<int64_t, int64_t> tree(8);
-            std::vector<double> latencies;
-            latencies.reserve(SAMPLES);
+            LatencyHistogram latencies;
             
             // Warmup
             for (size_t i = 0; i < WARMUP_OPS; i++) tree.insert(wl->next(), i);
@@ -354,13 +355,12 @@ public:
                 auto t0 = std::chrono::high_resolution_clock::now();
                 tree.insert(wl->next(), i);
                 auto t1 = std::chrono::high_resolution_clock::now();
-                latencies.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+                latencies.record(t1 - t0);
             }
             
-            std::sort(latencies.begin(), latencies.end());
-            double avg = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
-            double p50 = latencies[SAMPLES / 2];
-            double p99 = latencies[size_t(SAMPLES * 0.99)];
+            double avg = latencies.mean();
+            double p50 = latencies.percentile(0.50);
+            double p99 = latencies.percentile(0.99);
             
             std::cout << std::setw(15) << wl->name()
                       << std::setw(12) << std::fixed << std::setprecision(0) << avg
@@ -24,6 +24,8 @@
 #include <cmath>
 #include <functional>
 
+#include "../include/latency_histogram.hpp"
+
 // Original ParallelAVL Implementation
 template<typename Key, typename Value>
 class ParallelAVL {
@@ -382,7 +384,7 @@ void experiment_latency() {
     {
         ParallelAVL<int64_t, int64_t> tree(8);
         Uniform wl;
-        std::vector<double> lats; lats.reserve(SAMPLES);
+        LatencyHistogram lats;
         
         for (size_t i = 0; i < 10000; i++) tree.insert(wl.next(), i); // warmup
         
@@ -390,26 +392,25 @@ void experiment_latency() {
             auto t0 = std::chrono::high_resolution_clock::now();
             tree.insert(wl.next(), i);
             auto t1 = std::chrono::high_resolution_clock::now();
-            lats.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+            lats.record(t1 - t0);
         }
         
-        std::sort(lats.begin(), lats.end());
-        double avg = std::accumulate(lats.begin(), lats.end(), 0.0) / lats.size();
+        double avg = lats.mean();
         
         std::cout << std::setw(15) << "Uniform"
                   << std::setw(12) << std::fixed << std::setprecision(0) << avg
-                  << std::setw(12) << lats[SAMPLES/2]
-                  << std::setw(12) << lats[size_t(SAMPLES*0.99)]
-                  << std::setw(12) << lats[size_t(SAMPLES*0.999)] << "\n";
+                  << std::setw(12) << lats.percentile(0.50)
+                  << std::setw(12) << lats.percentile(0.99)
+                  << std::setw(12) << lats.percentile(0.999) << "\n";
         
-        all_results.push_back({"Latency_Uniform", 1, 8, 0, 0, 0, avg, lats[size_t(SAMPLES*0.99)]});
+        all_results.push_back({"Latency_Uniform", 1, 8, 0, 0, 0, avg, static_cast<double>(lats.percentile(0.99))});
     }
     
     // Adversarial
     {
         ParallelAVL<int64_t, int64_t> tree(8);
         Adversarial wl(8);
-        std::vector<double> lats; lats.reserve(SAMPLES);
+        LatencyHistogram lats;
         
         for (size_t i = 0; i < 10000; i++) tree.insert(wl.next(), i);
         
@@ -417,19 +418,18 @@ void experiment_latency() {
             auto t0 = std::chrono::high_resolution_clock::now();
             tree.insert(wl.next(), i);
             auto t1 = std::chrono::high_resolution_clock::now();
-            lats.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+            lats.record(t1 - t0);
         }
         
-        std::sort(lats.begin(), lats.end());
-        double avg = std::accumulate(lats.begin(), lats.end(), 0.0) / lats.size();
+        double avg = lats.mean();
         
         std::cout << std::setw(15) << "Adversarial"
                   << std::setw(12) << std::fixed << std::setprecision(0) << avg
-                  << std::setw(12) << lats[SAMPLES/2]
-                  << std::setw(12) << lats[size_t(SAMPLES*0.99)]
-                  << std::setw(12) << lats[size_t(SAMPLES*0.999)] << "\n";
+                  << std::setw(12) << lats.percentile(0.50)
+                  << std::setw(12) << lats.percentile(0.99)
+                  << std::setw(12) << lats.percentile(0.999) << "\n";
         
-        all_results.push_back({"Latency_Adversarial", 1, 8, 0, 0, 0, avg, lats[size_t(SAMPLES*0.99)]});
+        all_results.push_back({"Latency_Adversarial", 1, 8, 0, 0, 0, avg, static_cast<double>(lats.percentile(0.99))});
     }
 }
 
@@ -0,0 +1,111 @@
+#include "../include/parallel_avl.hpp"
+#include "../include/perf_counters.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdlib>
+
+// Huge Page Node Arenas
+//
+// Construye un ParallelAVL grande con cada modo de ArenaPages (4 KB,
+// transparent huge pages, hugetlbfs) y mide lookups aleatorios:
+// - ns por lookup
+// - dTLB load misses por lookup y delta contra páginas de 4 KB
+// - AnonHugePages del proceso (confirma que el kernel dio huge pages)
+//
+// Uso: ./bench_huge_pages [keys] [lookups]
+
+struct ModeResult {
+    double ns_per_op;
+    long long tlb_misses;
+    long long huge_kb;
+};
+
+static ModeResult run_mode(HugePageMode mode, size_t keys, size_t lookups) {
+    ArenaPages::setMode(mode);
+    ParallelAVL<int64_t, int64_t> tree(8);
+
+    std::mt19937_64 gen(777);
+    for (size_t i = 0; i < keys; ++i) {
+        int64_t k = static_cast<int64_t>(gen() % (keys * 4));
+        tree.insert(k, k);
+    }
+
+    std::vector<int64_t> probes(lookups);
+    std::mt19937_64 probe_gen(4242);
+    for (auto& p : probes) p = static_cast<int64_t>(probe_gen() % (keys * 4));
+
+    PerfCounter dtlb(PerfCounter::Event::DTLB_LOAD_MISSES);
+    size_t hits = 0;
+    dtlb.start();
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t k : probes) {
+        hits += tree.contains(k);
+    }
+    auto end = std::chrono::steady_clock::now();
+    long long misses = dtlb.stop();
+
+    ModeResult r;
+    r.ns_per_op = std::chrono::duration<double, std::nano>(end - start).count() / lookups;
+    r.tlb_misses = misses;
+    r.huge_kb = anon_huge_pages_kb();
+    volatile size_t sink = hits;  // que el compilador no descarte los lookups
+    (void)sink;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+    size_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2'000'000;
+
+    std::cout << "╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  Huge Page Node Arenas                     ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+    std::cout << "Keys: " << keys << ", random lookups: " << lookups << ", shards: 8\n\n";
+
+    const HugePageMode modes[] = {HugePageMode::Off, HugePageMode::Transparent, HugePageMode::Explicit};
+    const char* names[] = {"4 KB pages", "transparent", "hugetlbfs"};
+
+    std::cout << std::left << std::setw(14) << "Mode"
+              << std::right << std::setw(12) << "ns/lookup"
+              << std::setw(16) << "dTLB miss/op"
+              << std::setw(14) << "delta"
+              << std::setw(18) << "AnonHugePages" << std::endl;
+    std::cout << std::string(74, '-') << std::endl;
+
+    double base = -1;
+    for (size_t m = 0; m < 3; ++m) {
+        ModeResult r = run_mode(modes[m], keys, lookups);
+        std::cout << std::left << std::setw(14) << names[m] << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(1) << r.ns_per_op;
+        if (r.tlb_misses >= 0) {
+            double per_op = static_cast<double>(r.tlb_misses) / lookups;
+            if (base < 0) base = per_op;
+            double delta = base > 0 ? (per_op - base) / base * 100 : 0;
+            std::cout << std::setw(16) << std::setprecision(3) << per_op
+                      << std::setw(13) << std::showpos << std::setprecision(1) << delta
+                      << "%" << std::noshowpos;
+        } else {
+            std::cout << std::setw(16) << "n/a" << std::setw(14) << "n/a";
+        }
+        if (r.huge_kb >= 0) {
+            std::cout << std::setw(15) << r.huge_kb << " KB";
+        } else {
+            std::cout << std::setw(18) << "n/a";
+        }
+        std::cout << std::endl;
+    }
+    ArenaPages::setMode(HugePageMode::Off);
+
+    auto stats = ArenaPages::stats();
+    std::cout << "\nRegions: " << stats.explicitRegions << " hugetlbfs, "
+              << stats.transparentRegions << " transparent, "
+              << stats.fallbacks << " fallbacks" << std::endl;
+    if (!PerfCounter(PerfCounter::Event::DTLB_LOAD_MISSES).available()) {
+        std::cout << "(dTLB counters unavailable: no PMU exposed or perf_event_paranoid too strict)" << std::endl;
+    }
+    return 0;
+}
@@ -28,6 +28,8 @@
 #include <sstream>
 #include <functional>
 
+#include "../include/latency_histogram.hpp"
+
 // Simulate the parallel AVL structure for benchmarking
 class ParallelAVLBenchmark {
 private:
@@ -273,8 +275,7 @@ std::vector<BenchmarkResult> run_latency_experiment() {
     
     for (auto& wl : workloads) {
         ParallelAVLBenchmark tree(8);
-        std::vector<double> latencies;
-        latencies.reserve(SAMPLES);
+        LatencyHistogram latencies;
         
         // Warmup
         for (size_t i = 0; i < 10000; i++) {
@@ -290,15 +291,13 @@ std::vector<BenchmarkResult> run_latency_experiment() {
             } else {
                 tree.contains(key);
             }
-            latencies.push_back(t.elapsed_ns());
+            latencies.record(static_cast<uint64_t>(t.elapsed_ns()));
         }
         
-        std::sort(latencies.begin(), latencies.end());
-        
-        double avg = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
-        double p50 = latencies[SAMPLES / 2];
-        double p99 = latencies[size_t(SAMPLES * 0.99)];
-        double p999 = latencies[size_t(SAMPLES * 0.999)];
+        double avg = latencies.mean();
+        double p50 = latencies.percentile(0.50);
+        double p99 = latencies.percentile(0.99);
+        double p999 = latencies.percentile(0.999);
         
         std::cout << std::setw(15) << wl->name()
                   << std::setw(12) << std::fixed << std::setprecision(0) << avg
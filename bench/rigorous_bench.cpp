@@ -1,5 +1,6 @@
 #include "../include/parallel_avl.hpp"
 #include "../include/workloads.hpp"
+#include "../include/latency_histogram.hpp"
 #include <iostream>
 #include <iomanip>
 #include <vector>
@@ -14,7 +15,7 @@
 // Especificación:
 // - Multiple runs (10+) para estadísticas confiables
 // - Mean, stddev, 95% confidence intervals
-// - Latency percentiles (P50, P90, P99, P99.9)
+// - Latency percentiles (P50, P90, P99, P99.9, P99.99)
 // - Balance score tracking
 // - Lock contention ratio
 
@@ -28,47 +29,34 @@ struct BenchConfig {
     size_t num_shards = 8;
 };
 
+// Latencias en un LatencyHistogram (ns); los percentiles se reportan en μs
 struct LatencyStats {
-    std::vector<double> samples;  // microseconds
-
-    void record(double latency_us) {
-        samples.push_back(latency_us);
-    }
+    LatencyHistogram histogram;
 
     struct Percentiles {
         double p50;
         double p90;
         double p99;
         double p999;
+        double p9999;
         double mean;
         double min;
         double max;
     };
 
-    Percentiles compute() {
-        if (samples.empty()) {
-            return {0, 0, 0, 0, 0, 0, 0};
-        }
-
-        std::sort(samples.begin(), samples.end());
-
-        auto percentile = [&](double p) {
-            size_t idx = static_cast<size_t>(samples.size() * p);
-            if (idx >= samples.size()) idx = samples.size() - 1;
-            return samples[idx];
-        };
-
-        double sum = std::accumulate(samples.begin(), samples.end(), 0.0);
-        double mean = sum / samples.size();
+    Percentiles compute() const {
+        auto s = histogram.summary();
+        auto us = [](double ns) { return ns / 1000.0; };
 
         return {
-            .p50 = percentile(0.50),
-            .p90 = percentile(0.90),
-            .p99 = percentile(0.99),
-            .p999 = percentile(0.999),
-            .mean = mean,
-            .min = samples.front(),
-            .max = samples.back()
+            .p50 = us(s.p50),
+            .p90 = us(s.p90),
+            .p99 = us(s.p99),
+            .p999 = us(s.p999),
+            .p9999 = us(s.p9999),
+            .mean = us(s.mean),
+            .min = us(s.min),
+            .max = us(s.max)
         };
     }
 };
@@ -151,6 +139,9 @@ private:
         std::atomic<size_t> completed_ops{0};
         std::vector<std::thread> threads;
 
+        // Un histograma por thread: registrar no toca estado compartido
+        std::vector<LatencyHistogram> thread_latencies(config_.num_threads);
+
         auto start_time = std::chrono::high_resolution_clock::now();
 
         for (size_t tid = 0; tid < config_.num_threads; ++tid) {
@@ -171,8 +162,7 @@ private:
                     tree.insert(key, key * 2);
                     auto op_end = std::chrono::high_resolution_clock::now();
 
-                    double latency_us = std::chrono::duration<double, std::micro>(op_end - op_start).count();
-                    latencies.record(latency_us);
+                    thread_latencies[tid].record(op_end - op_start);
 
                     completed_ops.fetch_add(1, std::memory_order_relaxed);
                 }
@@ -184,6 +174,10 @@ private:
         }
 
         auto end_time = std::chrono::high_resolution_clock::now();
+
+        for (const auto& h : thread_latencies) {
+            latencies.histogram.merge(h);
+        }
         double duration_sec = std::chrono::duration<double>(end_time - start_time).count();
 
         double throughput = completed_ops.load() / duration_sec;
@@ -217,9 +211,7 @@ public:
             redirects.push_back(result.redirect_count);
 
             // Aggregate latencies
-            for (double lat : result.latencies.samples) {
-                all_latencies.record(lat);
-            }
+            all_latencies.histogram.merge(result.latencies.histogram);
 
             std::cout << "." << std::flush;
         }
@@ -262,6 +254,7 @@ public:
         std::cout << "  P90:     " << std::fixed << std::setprecision(2) << result.latencies.p90 << std::endl;
         std::cout << "  P99:     " << std::fixed << std::setprecision(2) << result.latencies.p99 << std::endl;
         std::cout << "  P99.9:   " << std::fixed << std::setprecision(2) << result.latencies.p999 << std::endl;
+        std::cout << "  P99.99:  " << std::fixed << std::setprecision(2) << result.latencies.p9999 << std::endl;
 
         // Other metrics
         std::cout << "\nOther Metrics:" << std::endl;
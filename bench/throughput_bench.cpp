@@ -1,4 +1,5 @@
 #include "../include/parallel_avl.hpp"
+#include "../include/latency_histogram.hpp"
 #include <iostream>
 #include <vector>
 #include <thread>
@@ -8,84 +9,22 @@
 #include <random>
 #include <atomic>
 
-// Latency histogram with percentiles
-class LatencyHistogram {
-private:
-    std::vector<double> latencies_;  // microseconds
-    std::mutex mutex_;
-
-public:
-    void record(double latency_us) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        latencies_.push_back(latency_us);
-    }
-
-    struct Statistics {
-        double min;
-        double max;
-        double mean;
-        double median;
-        double p50;
-        double p90;
-        double p95;
-        double p99;
-        double p999;
-        size_t count;
-    };
-
-    Statistics compute() {
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        if (latencies_.empty()) {
-            return {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-        }
-
-        std::sort(latencies_.begin(), latencies_.end());
-
-        Statistics stats;
-        stats.count = latencies_.size();
-        stats.min = latencies_.front();
-        stats.max = latencies_.back();
-
-        // Mean
-        double sum = 0;
-        for (double lat : latencies_) {
-            sum += lat;
-        }
-        stats.mean = sum / latencies_.size();
-
-        // Percentiles
-        auto percentile = [&](double p) {
-            size_t idx = static_cast<size_t>(latencies_.size() * p);
-            if (idx >= latencies_.size()) idx = latencies_.size() - 1;
-            return latencies_[idx];
-        };
-
-        stats.median = percentile(0.50);
-        stats.p50 = percentile(0.50);
-        stats.p90 = percentile(0.90);
-        stats.p95 = percentile(0.95);
-        stats.p99 = percentile(0.99);
-        stats.p999 = percentile(0.999);
-
-        return stats;
-    }
-
-    void print(const std::string& operation) const {
-        auto stats = const_cast<LatencyHistogram*>(this)->compute();
-
-        std::cout << "\n" << operation << " Latency (μs):" << std::endl;
-        std::cout << "  Count:  " << stats.count << std::endl;
-        std::cout << "  Min:    " << std::fixed << std::setprecision(2) << stats.min << std::endl;
-        std::cout << "  Mean:   " << std::fixed << std::setprecision(2) << stats.mean << std::endl;
-        std::cout << "  Median: " << std::fixed << std::setprecision(2) << stats.median << std::endl;
-        std::cout << "  P90:    " << std::fixed << std::setprecision(2) << stats.p90 << std::endl;
-        std::cout << "  P95:    " << std::fixed << std::setprecision(2) << stats.p95 << std::endl;
-        std::cout << "  P99:    " << std::fixed << std::setprecision(2) << stats.p99 << std::endl;
-        std::cout << "  P99.9:  " << std::fixed << std::setprecision(2) << stats.p999 << std::endl;
-        std::cout << "  Max:    " << std::fixed << std::setprecision(2) << stats.max << std::endl;
-    }
-};
+// Latencias: un LatencyHistogram por thread y operación, juntados al final
+static void print_latency(const std::string& operation, const LatencyHistogram& hist) {
+    auto stats = hist.summary();
+    auto us = [](double ns) { return ns / 1000.0; };
+
+    std::cout << "\n" << operation << " Latency (μs):" << std::endl;
+    std::cout << "  Count:  " << stats.count << std::endl;
+    std::cout << "  Min:    " << std::fixed << std::setprecision(2) << us(stats.min) << std::endl;
+    std::cout << "  Mean:   " << std::fixed << std::setprecision(2) << us(stats.mean) << std::endl;
+    std::cout << "  Median: " << std::fixed << std::setprecision(2) << us(stats.p50) << std::endl;
+    std::cout << "  P90:    " << std::fixed << std::setprecision(2) << us(stats.p90) << std::endl;
+    std::cout << "  P99:    " << std::fixed << std::setprecision(2) << us(stats.p99) << std::endl;
+    std::cout << "  P99.9:  " << std::fixed << std::setprecision(2) << us(stats.p999) << std::endl;
+    std::cout << "  P99.99: " << std::fixed << std::setprecision(2) << us(stats.p9999) << std::endl;
+    std::cout << "  Max:    " << std::fixed << std::setprecision(2) << us(stats.max) << std::endl;
+}
 
 // Benchmark configuration
 struct BenchConfig {
@@ -108,6 +47,11 @@ private:
         std::vector<std::thread> threads;
         std::atomic<bool> start_flag{false};
 
+        // Sin estado compartido al medir: cada thread escribe los suyos
+        std::vector<LatencyHistogram> insert_local(config.num_threads);
+        std::vector<LatencyHistogram> contains_local(config.num_threads);
+        std::vector<LatencyHistogram> get_local(config.num_threads);
+
         // Pre-populate tree
         for (size_t i = 0; i < KEY_SPACE / 2; ++i) {
             tree.insert(i, i);
@@ -135,20 +79,17 @@ private:
                         if (op_type < config.read_ratio / 2) {
                             tree.contains(key);
                             auto end = std::chrono::high_resolution_clock::now();
-                            double latency = std::chrono::duration<double, std::micro>(end - start).count();
-                            contains_hist.record(latency);
+                            contains_local[tid].record(end - start);
                         } else {
                             tree.get(key);
                             auto end = std::chrono::high_resolution_clock::now();
-                            double latency = std::chrono::duration<double, std::micro>(end - start).count();
-                            get_hist.record(latency);
+                            get_local[tid].record(end - start);
                         }
                     } else {
                         // Write operation (insert)
                         tree.insert(key, key * 2);
                         auto end = std::chrono::high_resolution_clock::now();
-                        double latency = std::chrono::duration<double, std::micro>(end - start).count();
-                        insert_hist.record(latency);
+                        insert_local[tid].record(end - start);
                     }
                 }
             });
@@ -161,6 +102,12 @@ private:
         for (auto& t : threads) {
             t.join();
         }
+
+        for (size_t tid = 0; tid < config.num_threads; ++tid) {
+            insert_hist.merge(insert_local[tid]);
+            contains_hist.merge(contains_local[tid]);
+            get_hist.merge(get_local[tid]);
+        }
     }
 
 public:
@@ -207,9 +154,9 @@ public:
                 std::cout << "\nThroughput: " << std::fixed << std::setprecision(0)
                          << throughput << " ops/sec" << std::endl;
 
-                insert_hist.print("INSERT");
-                contains_hist.print("CONTAINS");
-                get_hist.print("GET");
+                print_latency("INSERT", insert_hist);
+                print_latency("CONTAINS", contains_hist);
+                print_latency("GET", get_hist);
 
                 auto stats = tree.get_stats();
                 std::cout << "\nTree Statistics:" << std::endl;
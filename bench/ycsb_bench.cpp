@@ -0,0 +1,721 @@
+#include "../include/parallel_avl.hpp"
+#include "../include/AVLTreeParallel.h"
+#include "../include/AVLTreeParallelV2.h"
+#include "../include/DynamicShardedTree.hpp"
+#include "../include/workloads.hpp"
+#include "../include/latency_histogram.hpp"
+// Al final: las macros de c_src/include (VNODES_PER_SHARD...) no respetan el
+// namespace c_engine y chocarían con los miembros de AVLTreeParallelV2
+#include "../include/c_engine_avl.hpp"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <array>
+
+// =============================================================================
+// YCSB Bench - Driver único para comparar todas las variantes de árbol
+// =============================================================================
+//
+// Misma carga, mismos threads, mismo timer y misma salida para:
+//   parallel_avl     ParallelAVL<int64_t, V>           (parallel_avl.hpp)
+//   avl_parallel     AVLTreeParallel<int64_t, V>       (AVLTreeParallel.h)
+//   avl_parallel_v2  AVLTreeParallelV2<int64_t, V>     (AVLTreeParallelV2.h)
+//   dynamic_sharded  DynamicShardedTree<int64_t, V>    (DynamicShardedTree.hpp)
+//   c_engine         CEngineParallelAVL<V>             (c_engine_avl.hpp)
+//
+// Cada variante se envuelve en un TreeAdapter (insert / read / scan); añadir
+// otra variante es añadir un adapter y una entrada en make_adapter().
+//
+// Workloads (YCSB core, Cooper et al. SoCC'10, más dos del repo):
+//   A  50% read / 50% update                    scrambled zipfian
+//   B  95% read /  5% update                    scrambled zipfian
+//   C 100% read                                 scrambled zipfian
+//   D  95% read /  5% insert                    latest
+//   E  95% scan /  5% insert                    zipfian, longitud 1..100
+//   F  50% read / 50% read-modify-write         scrambled zipfian
+//   adversarial  100% upserts de keys ≡ 0 (mod shards): un solo shard hash
+//   sequential   100% inserts de keys crecientes
+//
+// Fases: carga de key_space records (keys 0..key_space-1, repartidas entre
+// threads), warmup sin contar y medición por duración. Las keys nuevas
+// (D, E, sequential) recorren [key_space, 2·key_space) y vuelven a empezar,
+// así la memoria queda acotada aunque la duración sea larga.
+//
+// Cada operación medida se registra en un LatencyHistogram del thread (sin
+// estado compartido); se reportan p50..p99.99 por tipo de operación.
+//
+// Valores: int64_t para --value-size 8 (inline en el motor en C) o un
+// payload de 64 / 256 / 1024 bytes. El motor en C solo guarda valores del
+// tamaño de un puntero: con payloads mayores se reporta como no soportado.
+// Igual con el workload E en variantes sin range_query.
+//
+// Uso:
+//   ./bench_ycsb --threads 8 --keys 1000000 --duration 10 --warmup 2
+//                --workloads A,B,C --variants parallel_avl,c_engine
+//                --csv ycsb.csv --json ycsb.json
+//
+// =============================================================================
+
+struct YcsbConfig {
+    std::vector<std::string> variants{"parallel_avl", "avl_parallel", "avl_parallel_v2",
+                                      "dynamic_sharded", "c_engine"};
+    std::vector<std::string> workloads{"A", "B", "C", "D", "E", "F",
+                                       "adversarial", "sequential"};
+    size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t num_shards = 8;
+    size_t key_space = 100'000;
+    size_t value_size = 8;
+    double duration_s = 2.0;
+    double warmup_s = 0.5;
+    unsigned seed = 42;
+    std::string csv_path;
+    std::string json_path;
+};
+
+// Mezcla de operaciones de un workload, en fracciones que suman 1
+struct WorkloadSpec {
+    std::string name;
+    double read = 0;
+    double update = 0;
+    double insert = 0;
+    double scan = 0;
+    double rmw = 0;
+
+    enum class KeyDist { ZIPFIAN, LATEST, ADVERSARIAL, SEQUENTIAL } dist = KeyDist::ZIPFIAN;
+};
+
+static bool find_workload(const std::string& name, WorkloadSpec& spec) {
+    using D = WorkloadSpec::KeyDist;
+    static const std::vector<WorkloadSpec> specs = {
+        {"A", 0.50, 0.50, 0.00, 0.00, 0.00, D::ZIPFIAN},
+        {"B", 0.95, 0.05, 0.00, 0.00, 0.00, D::ZIPFIAN},
+        {"C", 1.00, 0.00, 0.00, 0.00, 0.00, D::ZIPFIAN},
+        {"D", 0.95, 0.00, 0.05, 0.00, 0.00, D::LATEST},
+        {"E", 0.00, 0.00, 0.05, 0.95, 0.00, D::ZIPFIAN},
+        {"F", 0.50, 0.00, 0.00, 0.00, 0.50, D::ZIPFIAN},
+        {"adversarial", 0.00, 1.00, 0.00, 0.00, 0.00, D::ADVERSARIAL},
+        {"sequential", 0.00, 0.00, 1.00, 0.00, 0.00, D::SEQUENTIAL},
+    };
+    for (const auto& s : specs) {
+        if (s.name == name) {
+            spec = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+// =============================================================================
+// Valores
+// =============================================================================
+
+template<size_t N>
+struct Payload {
+    char bytes[N];
+};
+
+// Valor del record `key`: la key en los primeros 8 bytes, resto relleno
+template<typename Value>
+static Value make_value(int64_t key) {
+    if constexpr (std::is_same_v<Value, int64_t>) {
+        return key;
+    } else {
+        Value value;
+        std::memset(value.bytes, 'x', sizeof(value.bytes));
+        std::memcpy(value.bytes, &key, sizeof(key));
+        return value;
+    }
+}
+
+// Primer byte del valor: se acumula para que el compilador no descarte lecturas
+template<typename Value>
+static unsigned char value_byte(const Value& value) {
+    if constexpr (std::is_same_v<Value, int64_t>) {
+        return static_cast<unsigned char>(value);
+    } else {
+        return static_cast<unsigned char>(value.bytes[0]);
+    }
+}
+
+// =============================================================================
+// Adapters
+// =============================================================================
+
+template<typename Value>
+class TreeAdapter {
+public:
+    virtual ~TreeAdapter() = default;
+
+    // Upsert: insert y update de YCSB son la misma llamada en todas las variantes
+    virtual void insert(int64_t key, const Value& value) = 0;
+    virtual void read(int64_t key, Value& out) = 0;
+
+    // Hasta count records desde lo (keys densas: [lo, lo + count - 1]);
+    // devuelve cuántos se visitaron
+    virtual size_t scan(int64_t lo, size_t count) {
+        (void)lo;
+        (void)count;
+        return 0;
+    }
+    virtual bool supports_scan() const { return false; }
+
+    virtual size_t size() const = 0;
+};
+
+template<typename Value>
+class ParallelAVLAdapter : public TreeAdapter<Value> {
+    ParallelAVL<int64_t, Value> tree_;
+
+public:
+    explicit ParallelAVLAdapter(size_t shards) : tree_(shards) {}
+
+    void insert(int64_t key, const Value& value) override { tree_.insert(key, value); }
+
+    void read(int64_t key, Value& out) override {
+        auto got = tree_.get(key);
+        if (got) out = *got;
+    }
+
+    size_t scan(int64_t lo, size_t count) override {
+        thread_local std::vector<std::pair<int64_t, Value>> out;
+        out.clear();
+        tree_.range_query(lo, lo + static_cast<int64_t>(count) - 1, std::back_inserter(out));
+        return out.size();
+    }
+    bool supports_scan() const override { return true; }
+
+    size_t size() const override { return tree_.size(); }
+};
+
+template<typename Value>
+class AVLTreeParallelAdapter : public TreeAdapter<Value> {
+    AVLTreeParallel<int64_t, Value> tree_;
+
+public:
+    explicit AVLTreeParallelAdapter(size_t shards) : tree_(shards) {}
+
+    void insert(int64_t key, const Value& value) override { tree_.insert(key, value); }
+    void read(int64_t key, Value& out) override { out = tree_.get(key); }
+    size_t size() const override { return tree_.size(); }
+};
+
+template<typename Value>
+class AVLTreeParallelV2Adapter : public TreeAdapter<Value> {
+    AVLTreeParallelV2<int64_t, Value> tree_;
+
+public:
+    explicit AVLTreeParallelV2Adapter(size_t shards) : tree_(shards) {}
+
+    void insert(int64_t key, const Value& value) override { tree_.insert(key, value); }
+    void read(int64_t key, Value& out) override { out = tree_.get(key); }
+    size_t size() const override { return tree_.size(); }
+};
+
+template<typename Value>
+class DynamicShardedAdapter : public TreeAdapter<Value> {
+    DynamicShardedTree<int64_t, Value> tree_;
+
+    static typename DynamicShardedTree<int64_t, Value>::Config make_config(size_t shards) {
+        typename DynamicShardedTree<int64_t, Value>::Config config;
+        config.initial_shards = shards;
+        return config;
+    }
+
+public:
+    explicit DynamicShardedAdapter(size_t shards) : tree_(make_config(shards)) {}
+
+    void insert(int64_t key, const Value& value) override { tree_.insert(key, value); }
+    void read(int64_t key, Value& out) override { out = tree_.get(key); }
+    size_t size() const override { return tree_.size(); }
+};
+
+template<typename Value>
+class CEngineAdapter : public TreeAdapter<Value> {
+    CEngineParallelAVL<Value> tree_;
+
+public:
+    explicit CEngineAdapter(size_t shards) : tree_(shards) {}
+
+    void insert(int64_t key, const Value& value) override { tree_.insert(key, value); }
+
+    void read(int64_t key, Value& out) override {
+        auto got = tree_.get(key);
+        if (got) out = *got;
+    }
+
+    size_t scan(int64_t lo, size_t count) override {
+        thread_local std::vector<std::pair<int64_t, Value>> out;
+        out.clear();
+        tree_.range_query(lo, lo + static_cast<int64_t>(count) - 1, std::back_inserter(out));
+        return out.size();
+    }
+    bool supports_scan() const override { return true; }
+
+    size_t size() const override { return tree_.size(); }
+};
+
+// nullptr si la variante no existe o no admite Value
+template<typename Value>
+static std::unique_ptr<TreeAdapter<Value>> make_adapter(const std::string& variant, size_t shards) {
+    if (variant == "parallel_avl") return std::make_unique<ParallelAVLAdapter<Value>>(shards);
+    if (variant == "avl_parallel") return std::make_unique<AVLTreeParallelAdapter<Value>>(shards);
+    if (variant == "avl_parallel_v2") return std::make_unique<AVLTreeParallelV2Adapter<Value>>(shards);
+    if (variant == "dynamic_sharded") return std::make_unique<DynamicShardedAdapter<Value>>(shards);
+    if (variant == "c_engine") {
+        if constexpr (c_engine_storable<Value>::value) {
+            return std::make_unique<CEngineAdapter<Value>>(shards);
+        }
+    }
+    return nullptr;
+}
+
+static bool known_variant(const std::string& variant) {
+    return variant == "parallel_avl" || variant == "avl_parallel" ||
+           variant == "avl_parallel_v2" || variant == "dynamic_sharded" ||
+           variant == "c_engine";
+}
+
+// =============================================================================
+// Runner
+// =============================================================================
+
+enum OpType : size_t { OP_READ, OP_UPDATE, OP_INSERT, OP_SCAN, OP_RMW, OP_TYPES };
+
+static const char* const OP_NAMES[OP_TYPES] = {"read", "update", "insert", "scan", "rmw"};
+
+struct RunResult {
+    std::string variant;
+    std::string workload;
+    std::string status = "ok";      // ok | unsupported
+    double load_ms = 0;
+    double elapsed_s = 0;
+    std::array<size_t, OP_TYPES> ops{};
+    size_t scanned_records = 0;
+    size_t final_size = 0;
+
+    // Latencia (ns) por tipo de operación y de todas juntas
+    std::array<LatencyHistogram, OP_TYPES> latency;
+    LatencyHistogram all_latency;
+
+    size_t total_ops() const {
+        size_t total = 0;
+        for (size_t n : ops) total += n;
+        return total;
+    }
+    double throughput() const { return elapsed_s > 0 ? total_ops() / elapsed_s : 0; }
+};
+
+// Contadores e histogramas por thread: medir no comparte nada entre threads
+struct alignas(64) ThreadCounters {
+    std::array<size_t, OP_TYPES> ops{};
+    std::array<LatencyHistogram, OP_TYPES> latency;
+    size_t scanned_records = 0;
+    unsigned char sink = 0;
+};
+
+enum class Phase : int { WARMUP, MEASURE, STOP };
+
+template<typename Value>
+class YcsbRunner {
+    const YcsbConfig& config_;
+
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t MAX_SCAN_LENGTH = 100;
+
+    static double ms_since(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Carga inicial: keys 0..key_space-1 repartidas entre threads
+    double load(TreeAdapter<Value>& tree) {
+        auto start = Clock::now();
+        std::vector<std::thread> threads;
+        size_t n = config_.key_space;
+        size_t t_count = config_.num_threads;
+        for (size_t t = 0; t < t_count; ++t) {
+            threads.emplace_back([&tree, n, t, t_count]() {
+                for (size_t k = t; k < n; k += t_count) {
+                    int64_t key = static_cast<int64_t>(k);
+                    tree.insert(key, make_value<Value>(key));
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        return ms_since(start);
+    }
+
+public:
+    explicit YcsbRunner(const YcsbConfig& config) : config_(config) {}
+
+    RunResult run(const std::string& variant, const WorkloadSpec& spec) {
+        RunResult result;
+        result.variant = variant;
+        result.workload = spec.name;
+
+        auto tree = make_adapter<Value>(variant, config_.num_shards);
+        if (!tree || (spec.scan > 0 && !tree->supports_scan())) {
+            result.status = "unsupported";
+            return result;
+        }
+
+        result.load_ms = load(*tree);
+
+        const size_t key_space = config_.key_space;
+        const int64_t base = static_cast<int64_t>(key_space);
+        const size_t shards = config_.num_shards;
+
+        // zeta(n) una sola vez; cada thread crea su generador con su semilla
+        double zeta_n = ScrambledZipfianGenerator<int64_t>(key_space, config_.seed).zeta_n();
+
+        // Inserts nuevos (D, E, sequential): contador global, como YCSB
+        std::atomic<size_t> insert_counter{0};
+        std::atomic<Phase> phase{Phase::WARMUP};
+        std::vector<std::unique_ptr<ThreadCounters>> counters(config_.num_threads);
+
+        auto worker = [&](size_t tid) {
+            ScrambledZipfianGenerator<int64_t> zipf(key_space, config_.seed + 1 + tid, zeta_n);
+            AdversarialGenerator<int64_t> adversarial(shards, 0);
+            std::mt19937_64 rng(config_.seed * 7919 + tid);
+            std::uniform_real_distribution<double> op_dist(0.0, 1.0);
+            std::uniform_int_distribution<size_t> scan_len(1, MAX_SCAN_LENGTH);
+            auto local = std::make_unique<ThreadCounters>();   // ~90 KB: en el heap
+            Value out = make_value<Value>(0);
+
+            auto next_new_key = [&]() {
+                size_t i = insert_counter.fetch_add(1, std::memory_order_relaxed);
+                return base + static_cast<int64_t>(i % key_space);
+            };
+
+            auto next_key = [&]() -> int64_t {
+                switch (spec.dist) {
+                    case WorkloadSpec::KeyDist::LATEST: {
+                        // Rango 0 = el último insertado
+                        size_t inserted = insert_counter.load(std::memory_order_relaxed);
+                        int64_t latest = inserted == 0
+                            ? base - 1
+                            : base + static_cast<int64_t>((inserted - 1) % key_space);
+                        int64_t key = latest - static_cast<int64_t>(zipf.next_rank());
+                        return key < 0 ? key + 2 * base : key;
+                    }
+                    case WorkloadSpec::KeyDist::ADVERSARIAL: {
+                        int64_t key = adversarial.next();
+                        if (key >= base) {
+                            adversarial.reset();
+                            key = adversarial.next();
+                        }
+                        return key;
+                    }
+                    case WorkloadSpec::KeyDist::SEQUENTIAL:
+                        return next_new_key();
+                    case WorkloadSpec::KeyDist::ZIPFIAN:
+                        break;
+                }
+                return zipf.next();
+            };
+
+            // Las operaciones del warmup van a `warm` y se descartan
+            auto warm = std::make_unique<ThreadCounters>();
+            Phase current;
+            while ((current = phase.load(std::memory_order_relaxed)) != Phase::STOP) {
+                double op = op_dist(rng);
+                ThreadCounters& c = current == Phase::MEASURE ? *local : *warm;
+                OpType type;
+
+                auto op_start = Clock::now();
+                if ((op -= spec.read) < 0) {
+                    tree->read(next_key(), out);
+                    local->sink ^= value_byte(out);
+                    type = OP_READ;
+                } else if ((op -= spec.update) < 0) {
+                    int64_t key = next_key();
+                    tree->insert(key, make_value<Value>(key));
+                    type = OP_UPDATE;
+                } else if ((op -= spec.insert) < 0) {
+                    int64_t key = spec.dist == WorkloadSpec::KeyDist::SEQUENTIAL
+                        ? next_key() : next_new_key();
+                    tree->insert(key, make_value<Value>(key));
+                    type = OP_INSERT;
+                } else if ((op -= spec.scan) < 0) {
+                    c.scanned_records += tree->scan(next_key(), scan_len(rng));
+                    type = OP_SCAN;
+                } else {
+                    int64_t key = next_key();
+                    tree->read(key, out);
+                    local->sink ^= value_byte(out);
+                    tree->insert(key, make_value<Value>(key + local->sink));
+                    type = OP_RMW;
+                }
+                c.latency[type].record(Clock::now() - op_start);
+                c.ops[type]++;
+            }
+            local->sink ^= warm->sink;
+            counters[tid] = std::move(local);
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < config_.num_threads; ++t) {
+            threads.emplace_back(worker, t);
+        }
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(config_.warmup_s));
+        auto start = Clock::now();
+        phase.store(Phase::MEASURE, std::memory_order_relaxed);
+        std::this_thread::sleep_for(std::chrono::duration<double>(config_.duration_s));
+        phase.store(Phase::STOP, std::memory_order_relaxed);
+        result.elapsed_s = ms_since(start) / 1000.0;
+
+        for (auto& th : threads) th.join();
+
+        for (const auto& c : counters) {
+            for (size_t t = 0; t < OP_TYPES; ++t) {
+                result.ops[t] += c->ops[t];
+                result.latency[t].merge(c->latency[t]);
+                result.all_latency.merge(c->latency[t]);
+            }
+            result.scanned_records += c->scanned_records;
+        }
+        result.final_size = tree->size();
+        return result;
+    }
+};
+
+// =============================================================================
+// Salida
+// =============================================================================
+
+static void print_header(const YcsbConfig& config, size_t value_size) {
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  YCSB Benchmark - All Tree Variants        ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+    std::cout << "Threads:    " << config.num_threads << std::endl;
+    std::cout << "Shards:     " << config.num_shards << std::endl;
+    std::cout << "Key space:  " << config.key_space << std::endl;
+    std::cout << "Value size: " << value_size << " bytes" << std::endl;
+    std::cout << "Duration:   " << config.duration_s << " s (warmup " << config.warmup_s << " s)"
+              << std::endl;
+}
+
+static void print_result(const RunResult& r) {
+    std::cout << "  " << std::left << std::setw(17) << r.variant << std::right;
+    if (r.status != "ok") {
+        std::cout << "   (" << r.status << ")" << std::endl;
+        return;
+    }
+    auto lat = r.all_latency.summary();
+    std::cout << std::fixed << std::setprecision(0)
+              << std::setw(12) << r.throughput() << " ops/s"
+              << "   p50 " << std::setw(6) << lat.p50
+              << "   p99 " << std::setw(7) << lat.p99
+              << "   p99.99 " << std::setw(8) << lat.p9999 << " ns"
+              << "   load " << std::setw(6) << std::setprecision(1) << r.load_ms << " ms"
+              << std::endl;
+}
+
+static void write_csv(const std::string& path, const YcsbConfig& config, size_t value_size,
+                      const std::vector<RunResult>& results) {
+    std::ofstream file(path);
+    file << "variant,workload,status,threads,shards,key_space,value_size,duration_s,"
+            "ops,throughput_ops_s,reads,updates,inserts,scans,rmws,scanned_records,"
+            "load_ms,final_size,mean_ns,p50_ns,p90_ns,p99_ns,p999_ns,p9999_ns,max_ns\n";
+    file << std::fixed;
+    for (const auto& r : results) {
+        auto lat = r.all_latency.summary();
+        file << r.variant << ',' << r.workload << ',' << r.status << ','
+             << config.num_threads << ',' << config.num_shards << ',' << config.key_space << ','
+             << value_size << ',' << std::setprecision(4) << r.elapsed_s << ','
+             << r.total_ops() << ',' << std::setprecision(1) << r.throughput();
+        for (size_t n : r.ops) file << ',' << n;
+        file << ',' << r.scanned_records << ',' << r.load_ms << ',' << r.final_size << ','
+             << lat.mean << ',' << lat.p50 << ',' << lat.p90 << ',' << lat.p99 << ','
+             << lat.p999 << ',' << lat.p9999 << ',' << lat.max << '\n';
+    }
+}
+
+static void write_latency_json(std::ostream& file, const LatencyHistogram& hist) {
+    auto lat = hist.summary();
+    file << "{\"count\": " << lat.count << ", \"min\": " << lat.min
+         << ", \"mean\": " << lat.mean << ", \"p50\": " << lat.p50
+         << ", \"p90\": " << lat.p90 << ", \"p99\": " << lat.p99
+         << ", \"p999\": " << lat.p999 << ", \"p9999\": " << lat.p9999
+         << ", \"max\": " << lat.max << "}";
+}
+
+static void write_json(const std::string& path, const YcsbConfig& config, size_t value_size,
+                       const std::vector<RunResult>& results) {
+    std::ofstream file(path);
+    file << "{\n  \"config\": {"
+         << "\"threads\": " << config.num_threads
+         << ", \"shards\": " << config.num_shards
+         << ", \"key_space\": " << config.key_space
+         << ", \"value_size\": " << value_size
+         << ", \"duration_s\": " << config.duration_s
+         << ", \"warmup_s\": " << config.warmup_s
+         << ", \"seed\": " << config.seed << "},\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        file << (i ? "," : "") << "\n    {"
+             << "\"variant\": \"" << r.variant << "\""
+             << ", \"workload\": \"" << r.workload << "\""
+             << ", \"status\": \"" << r.status << "\""
+             << ", \"elapsed_s\": " << r.elapsed_s
+             << ", \"ops\": " << r.total_ops()
+             << ", \"throughput_ops_s\": " << r.throughput();
+        for (size_t t = 0; t < OP_TYPES; ++t) {
+            file << ", \"" << OP_NAMES[t] << "s\": " << r.ops[t];
+        }
+        file << ", \"scanned_records\": " << r.scanned_records
+             << ", \"load_ms\": " << r.load_ms
+             << ", \"final_size\": " << r.final_size
+             << ",\n     \"latency_ns\": {\"all\": ";
+        write_latency_json(file, r.all_latency);
+        for (size_t t = 0; t < OP_TYPES; ++t) {
+            if (r.ops[t] == 0) continue;
+            file << ",\n                    \"" << OP_NAMES[t] << "\": ";
+            write_latency_json(file, r.latency[t]);
+        }
+        file << "}}";
+    }
+    file << "\n  ]\n}\n";
+}
+
+template<typename Value>
+static int run_all(const YcsbConfig& config, size_t value_size) {
+    print_header(config, value_size);
+
+    YcsbRunner<Value> runner(config);
+    std::vector<RunResult> results;
+
+    for (const auto& name : config.workloads) {
+        WorkloadSpec spec;
+        find_workload(name, spec);
+
+        std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+        std::cout << "Workload " << spec.name << std::endl;
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+
+        for (const auto& variant : config.variants) {
+            results.push_back(runner.run(variant, spec));
+            print_result(results.back());
+        }
+    }
+
+    if (!config.csv_path.empty()) {
+        write_csv(config.csv_path, config, value_size, results);
+        std::cout << "\nCSV:  " << config.csv_path << std::endl;
+    }
+    if (!config.json_path.empty()) {
+        write_json(config.json_path, config, value_size, results);
+        std::cout << "JSON: " << config.json_path << std::endl;
+    }
+    return 0;
+}
+
+// =============================================================================
+// CLI
+// =============================================================================
+
+static std::vector<std::string> split_list(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+static void print_usage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "  --threads N       worker threads (default: hardware concurrency)\n"
+              << "  --shards N        shards per tree (default: 8)\n"
+              << "  --keys N          records loaded / key space (default: 100000)\n"
+              << "  --value-size N    8, 64, 256 or 1024 bytes (default: 8)\n"
+              << "  --duration S      measured seconds per run (default: 2)\n"
+              << "  --warmup S        unmeasured seconds before each run (default: 0.5)\n"
+              << "  --workloads LIST  A,B,C,D,E,F,adversarial,sequential (default: all)\n"
+              << "  --variants LIST   parallel_avl,avl_parallel,avl_parallel_v2,\n"
+              << "                    dynamic_sharded,c_engine (default: all)\n"
+              << "  --seed N          RNG seed (default: 42)\n"
+              << "  --csv PATH        write results as CSV\n"
+              << "  --json PATH       write results as JSON\n";
+}
+
+int main(int argc, char** argv) {
+    YcsbConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+
+        try {
+            if (arg == "--threads") config.num_threads = std::stoul(value);
+            else if (arg == "--shards") config.num_shards = std::stoul(value);
+            else if (arg == "--keys") config.key_space = std::stoul(value);
+            else if (arg == "--value-size") config.value_size = std::stoul(value);
+            else if (arg == "--duration") config.duration_s = std::stod(value);
+            else if (arg == "--warmup") config.warmup_s = std::stod(value);
+            else if (arg == "--workloads") config.workloads = split_list(value);
+            else if (arg == "--variants") config.variants = split_list(value);
+            else if (arg == "--seed") config.seed = static_cast<unsigned>(std::stoul(value));
+            else if (arg == "--csv") config.csv_path = value;
+            else if (arg == "--json") config.json_path = value;
+            else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+            return 1;
+        }
+    }
+
+    if (config.num_threads == 0 || config.num_shards == 0 || config.key_space < 2 ||
+        config.duration_s <= 0 || config.warmup_s < 0) {
+        std::cerr << "threads, shards and duration must be positive, keys >= 2" << std::endl;
+        return 1;
+    }
+    for (const auto& name : config.workloads) {
+        WorkloadSpec spec;
+        if (!find_workload(name, spec)) {
+            std::cerr << "Unknown workload " << name << std::endl;
+            return 1;
+        }
+    }
+    for (const auto& variant : config.variants) {
+        if (!known_variant(variant)) {
+            std::cerr << "Unknown variant " << variant << std::endl;
+            return 1;
+        }
+    }
+
+    switch (config.value_size) {
+        case 8:    return run_all<int64_t>(config, 8);
+        case 64:   return run_all<Payload<64>>(config, 64);
+        case 256:  return run_all<Payload<256>>(config, 256);
+        case 1024: return run_all<Payload<1024>>(config, 1024);
+        default:
+            std::cerr << "--value-size must be 8, 64, 256 or 1024" << std::endl;
+            return 1;
+    }
+}
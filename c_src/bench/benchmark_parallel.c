@@ -11,6 +11,12 @@
 #include <time.h>
 #include <stdint.h>
 
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
 #ifdef _WIN32
 #include <windows.h>
 #define NUM_CORES 8
@@ -360,6 +366,161 @@ static void run_large_scale_benchmark(void) {
     }
 }
 
+/* ============================================================================
+ * Huge page node pools: lookup latency and dTLB misses
+ * ============================================================================ */
+
+/* dTLB load-miss counter for this thread; -1 when the PMU is not available */
+static int tlb_counter_open(void) {
+#if defined(__linux__)
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+static void tlb_counter_start(int fd) {
+#if defined(__linux__)
+    if (fd < 0) return;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#else
+    (void)fd;
+#endif
+}
+
+static long long tlb_counter_stop(int fd) {
+#if defined(__linux__)
+    long long count = 0;
+    if (fd < 0) return -1;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &count, sizeof(count)) != (ssize_t)sizeof(count)) return -1;
+    return count;
+#else
+    (void)fd;
+    return -1;
+#endif
+}
+
+static void run_huge_page_benchmark(void) {
+    print_header("Huge Page Node Pools");
+
+    const size_t KEYS = 4000000;
+    const size_t LOOKUPS = 2000000;
+    const AVLHugePageMode modes[] = {
+        AVL_HUGE_PAGES_OFF, AVL_HUGE_PAGES_TRANSPARENT, AVL_HUGE_PAGES_EXPLICIT
+    };
+    const char* names[] = { "off (malloc)", "transparent", "explicit (hugetlb)" };
+
+    printf("Keys: %zu, random lookups: %zu\n\n", KEYS, LOOKUPS);
+    printf("%-20s %12s %16s %14s\n", "Mode", "ns/lookup", "dTLB miss/op", "delta vs off");
+
+    int fd = tlb_counter_open();
+    double base_misses = -1;
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        avl_huge_pages_set_mode(modes[m]);
+        AVLTree* tree = avl_tree_create(NULL);
+        if (!tree) break;
+
+        uint64_t rng = 777;
+        for (size_t i = 0; i < KEYS; i++) {
+            avl_tree_insert(tree, (int64_t)(xorshift64(&rng) % (KEYS * 4)), NULL);
+        }
+
+        size_t hits = 0;
+        rng = 4242;
+        tlb_counter_start(fd);
+        double start = get_time_ms();
+        for (size_t i = 0; i < LOOKUPS; i++) {
+            hits += avl_tree_contains(tree, (int64_t)(xorshift64(&rng) % (KEYS * 4)));
+        }
+        double elapsed = get_time_ms() - start;
+        long long misses = tlb_counter_stop(fd);
+
+        printf("%-20s %12.1f ", names[m], elapsed * 1e6 / (double)LOOKUPS);
+        if (misses >= 0) {
+            double per_op = (double)misses / (double)LOOKUPS;
+            if (base_misses < 0) base_misses = per_op;
+            printf("%16.3f %+13.1f%%\n", per_op,
+                   base_misses > 0 ? (per_op - base_misses) / base_misses * 100 : 0.0);
+        } else {
+            printf("%16s %14s\n", "n/a", "n/a");
+        }
+        (void)hits;
+        avl_tree_destroy(tree);
+    }
+
+    AVLHugePageStats stats;
+    avl_huge_pages_get_stats(&stats);
+    printf("\nRegions: %zu hugetlb, %zu transparent, %zu fallbacks\n",
+           stats.explicit_regions, stats.transparent_regions, stats.fallbacks);
+    if (fd < 0) {
+        printf("(dTLB counters unavailable: no PMU exposed or perf_event_paranoid too strict)\n");
+    } else {
+#if defined(__linux__)
+        close(fd);
+#endif
+    }
+    avl_huge_pages_set_mode(AVL_HUGE_PAGES_OFF);
+}
+
+/* ============================================================================
+ * Batched lookups: one lock per shard and interleaved descents
+ * ============================================================================ */
+
+static void run_batched_lookup_benchmark(void) {
+    print_header("Batched Lookups (get_many)");
+
+    enum { KEYS = 1000000, LOOKUPS = 1000000, BATCH = 64 };
+    ParallelAVL* tree = parallel_avl_create(8, ROUTER_STATIC_HASH);
+    if (!tree) return;
+
+    uint64_t rng = 91;
+    for (size_t i = 0; i < KEYS; i++) {
+        parallel_avl_insert(tree, (int64_t)(xorshift64(&rng) % (KEYS * 2)), NULL);
+    }
+
+    size_t hits = 0;
+    rng = 5150;
+    double start = get_time_ms();
+    for (size_t i = 0; i < LOOKUPS; i++) {
+        hits += parallel_avl_contains(tree, (int64_t)(xorshift64(&rng) % (KEYS * 2)));
+    }
+    double single = get_time_ms() - start;
+
+    size_t batch_hits = 0;
+    int64_t keys[BATCH];
+    bool found[BATCH];
+    rng = 5150;
+    start = get_time_ms();
+    for (size_t i = 0; i < LOOKUPS; i += BATCH) {
+        for (size_t j = 0; j < BATCH; j++) {
+            keys[j] = (int64_t)(xorshift64(&rng) % (KEYS * 2));
+        }
+        batch_hits += parallel_avl_get_many(tree, keys, BATCH, NULL, found);
+    }
+    double batched = get_time_ms() - start;
+
+    printf("Keys: %d, lookups: %d, batch: %d\n\n", KEYS, LOOKUPS, BATCH);
+    printf("%-20s %12s\n", "Mode", "ns/lookup");
+    printf("%-20s %12.1f\n", "single key", single * 1e6 / LOOKUPS);
+    printf("%-20s %12.1f\n", "get_many", batched * 1e6 / LOOKUPS);
+    printf("\nSpeedup: %.2fx (hits %zu / %zu)\n", single / batched, hits, batch_hits);
+
+    parallel_avl_destroy(tree);
+}
+
 int main(void) {
     print_header("Parallel AVL Tree - Pure C (Optimized)");
     
@@ -385,6 +546,12 @@ int main(void) {
     
     /* Large scale benchmark */
     run_large_scale_benchmark();
+
+    /* TLB effects of huge page backed node pools */
+    run_huge_page_benchmark();
+
+    /* Batched API vs single-key calls */
+    run_batched_lookup_benchmark();
     
     print_header("Benchmark Complete");
     
@@ -53,7 +53,13 @@ extern "C" {
     /* For MSVC and builtins, use volatile + functions */
     typedef volatile size_t atomic_size;
     typedef volatile int64_t atomic_int64;
+#ifdef ATOMICS_BUILTIN
+    /* Same size as _Atomic(bool): C++ users of these headers (always on
+     * this path) must see the same struct layout as the C11 library */
+    typedef volatile bool atomic_bool_t;
+#else
     typedef volatile int atomic_bool_t;
+#endif
     typedef volatile double atomic_double;
 #endif
 
@@ -6,17 +6,19 @@
  *   - Inline critical path functions
  *   - Cache-friendly node layout
  *   - Minimal branching in hot paths
- *   - Node pooling for reduced allocations
+ *   - Node pooling for reduced allocations, with memory returned after
+ *     bulk deletes (avl_tree_trim)
  */
 
-#ifndef AVL_TREE_H
-#define AVL_TREE_H
+#ifndef C_AVL_TREE_H
+#define C_AVL_TREE_H
 
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include "huge_pages.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,20 +54,63 @@ typedef struct AVLNode {
 
 /**
  * Node pool for fast allocation
+ *
+ * Blocks are AVL_POOL_BLOCK_BYTES long and aligned to their size, so the
+ * block owning a node is found by masking the node's address. Each block
+ * keeps its own free list and live count:
+ *   - partial: blocks with free slots; allocation always takes from the head
+ *   - full:    blocks with no free slot
+ *   - empty:   blocks with no live node, kept for reuse (up to
+ *              AVL_POOL_KEEP_EMPTY); beyond that malloc'd blocks go to a
+ *              process-wide depot other pools draw from before malloc
+ * avl_pool_trim() returns a pool's empty blocks to the OS.
  */
-#define AVL_POOL_BLOCK_SIZE 256
+#define AVL_POOL_BLOCK_BYTES  ((size_t)16 * 1024)
+#define AVL_POOL_BLOCK_HEADER 64
+#define AVL_POOL_BLOCK_SIZE   ((AVL_POOL_BLOCK_BYTES - AVL_POOL_BLOCK_HEADER) / sizeof(AVLNode))
+#define AVL_POOL_KEEP_EMPTY   4     /* empty blocks a pool holds before using the depot */
+#define AVL_POOL_DEPOT_MAX    64    /* blocks in the shared depot (1 MB) */
 
 typedef struct AVLNodeBlock {
-    AVLNode nodes[AVL_POOL_BLOCK_SIZE];
     struct AVLNodeBlock* next;
+    struct AVLNodeBlock* prev;
+    AVLNode* free;                  /* freed slots of this block */
+    uint32_t live;                  /* nodes handed out */
+    uint32_t bump;                  /* slots [bump, SIZE) never used yet */
+    uint32_t in_region;             /* carved from a huge page region */
+    char _padding[AVL_POOL_BLOCK_HEADER - 3 * sizeof(void*) - 3 * sizeof(uint32_t)];
+    AVLNode nodes[AVL_POOL_BLOCK_SIZE];
 } AVLNodeBlock;
 
+#define AVL_POOL_BLOCK_OF(node) \
+    ((AVLNodeBlock*)((uintptr_t)(node) & ~(uintptr_t)(AVL_POOL_BLOCK_BYTES - 1)))
+
+/**
+ * Header of a huge page region; blocks are carved from the rest of it
+ */
+typedef struct AVLPoolRegion {
+    struct AVLPoolRegion* next;
+} AVLPoolRegion;
+
 typedef struct AVLNodePool {
-    AVLNodeBlock* blocks;
-    AVLNode* free_list;
-    size_t total_allocated;
+    AVLNodeBlock* partial;          /* doubly linked */
+    AVLNodeBlock* full;             /* doubly linked */
+    AVLNodeBlock* empty;            /* singly linked through next */
+    size_t empty_count;
+    size_t block_count;             /* blocks held, in any list */
+    size_t total_allocated;         /* node slots in held blocks */
+    AVLPoolRegion* regions;         /* huge page regions (see huge_pages.h) */
+    char* region_cursor;            /* next free byte in the newest region */
+    char* region_end;
 } AVLNodePool;
 
+typedef struct AVLPoolStats {
+    size_t blocks;                  /* held by the pool */
+    size_t empty_blocks;            /* of which have no live node */
+    size_t live_nodes;
+    size_t bytes;                   /* blocks * AVL_POOL_BLOCK_BYTES */
+} AVLPoolStats;
+
 /**
  * AVL Tree structure
  */
@@ -89,52 +134,73 @@ typedef struct AVLKeyValue {
  * ============================================================================ */
 
 AVL_INLINE void avl_pool_init(AVLNodePool* pool) {
-    pool->blocks = NULL;
-    pool->free_list = NULL;
+    pool->partial = NULL;
+    pool->full = NULL;
+    pool->empty = NULL;
+    pool->empty_count = 0;
+    pool->block_count = 0;
     pool->total_allocated = 0;
+    pool->regions = NULL;
+    pool->region_cursor = NULL;
+    pool->region_end = NULL;
 }
 
+/*
+ * Cold paths (avl_tree.c):
+ *   - avl_pool_new_block:   makes a block the partial head; takes it from the
+ *                           pool's empty list, the shared depot, a huge page
+ *                           region or malloc, in that order
+ *   - avl_pool_block_full:  moves the partial head to the full list
+ *   - avl_pool_block_freed: list moves after a free left a block with
+ *                           prev_live - 1 live nodes
+ */
+AVLNodeBlock* avl_pool_new_block(AVLNodePool* pool);
+void avl_pool_block_full(AVLNodePool* pool, AVLNodeBlock* block);
+void avl_pool_block_freed(AVLNodePool* pool, AVLNodeBlock* block, uint32_t prev_live);
+
 AVL_INLINE AVLNode* avl_pool_alloc(AVLNodePool* pool) {
-    if (AVL_LIKELY(pool->free_list != NULL)) {
-        AVLNode* node = pool->free_list;
-        pool->free_list = node->right;  /* Using right as next pointer in free list */
-        return node;
+    AVLNodeBlock* block = pool->partial;
+    if (AVL_UNLIKELY(!block)) {
+        block = avl_pool_new_block(pool);
+        if (!block) return NULL;
+    }
+
+    AVLNode* node = block->free;
+    if (AVL_LIKELY(node != NULL)) {
+        block->free = node->right;      /* Using right as next pointer in free list */
+    } else {
+        node = &block->nodes[block->bump++];
     }
-    
-    /* Allocate new block */
-    AVLNodeBlock* block = (AVLNodeBlock*)malloc(sizeof(AVLNodeBlock));
-    if (!block) return NULL;
-    
-    block->next = pool->blocks;
-    pool->blocks = block;
-    
-    /* Add all nodes except first to free list */
-    for (size_t i = 1; i < AVL_POOL_BLOCK_SIZE - 1; i++) {
-        block->nodes[i].right = &block->nodes[i + 1];
+
+    if (AVL_UNLIKELY(++block->live == AVL_POOL_BLOCK_SIZE)) {
+        avl_pool_block_full(pool, block);
     }
-    block->nodes[AVL_POOL_BLOCK_SIZE - 1].right = pool->free_list;
-    pool->free_list = &block->nodes[1];
-    
-    pool->total_allocated += AVL_POOL_BLOCK_SIZE;
-    return &block->nodes[0];
+    return node;
 }
 
 AVL_INLINE void avl_pool_free(AVLNodePool* pool, AVLNode* node) {
-    node->right = pool->free_list;
-    pool->free_list = node;
-}
+    AVLNodeBlock* block = AVL_POOL_BLOCK_OF(node);
+    node->right = block->free;
+    block->free = node;
 
-AVL_INLINE void avl_pool_destroy(AVLNodePool* pool) {
-    AVLNodeBlock* block = pool->blocks;
-    while (block) {
-        AVLNodeBlock* next = block->next;
-        free(block);
-        block = next;
+    uint32_t prev_live = block->live--;
+    if (AVL_UNLIKELY(prev_live == AVL_POOL_BLOCK_SIZE || prev_live == 1)) {
+        avl_pool_block_freed(pool, block, prev_live);
     }
-    pool->blocks = NULL;
-    pool->free_list = NULL;
 }
 
+/* Releases every block; malloc'd ones refill the shared depot first */
+void avl_pool_destroy(AVLNodePool* pool);
+
+/* Frees the pool's empty malloc'd blocks; returns bytes released */
+size_t avl_pool_trim(AVLNodePool* pool);
+
+/* Frees the blocks parked in the shared depot; returns bytes released */
+size_t avl_pool_depot_trim(void);
+size_t avl_pool_depot_blocks(void);
+
+void avl_pool_get_stats(const AVLNodePool* pool, AVLPoolStats* stats);
+
 /* ============================================================================
  * Core AVL Functions (inlined hot paths)
  * ============================================================================ */
@@ -175,6 +241,25 @@ void avl_tree_clear(AVLTree* tree);
 AVLNode* avl_tree_get_root(const AVLTree* tree);
 void avl_tree_extract_all(const AVLTree* tree, AVLKeyValue* out_array, size_t* out_count);
 
+/*
+ * Builds a perfectly balanced tree from n items with strictly increasing
+ * keys in O(n), without rotations. The tree must be empty. Returns false
+ * (tree left empty) if a node allocation fails.
+ */
+bool avl_tree_build_sorted(AVLTree* tree, const AVLKeyValue* items, size_t n);
+
+/* Returns the tree's fully free node blocks to the OS; bytes released */
+size_t avl_tree_trim(AVLTree* tree);
+
+/*
+ * Batched lookup: descends AVL_BATCH_WIDTH keys at once, one level per key
+ * per round, prefetching each key's next node so the cache misses of
+ * independent descents overlap. out_values may be NULL.
+ */
+#define AVL_BATCH_WIDTH 8
+void avl_tree_get_many(const AVLTree* tree, const int64_t* keys, size_t n,
+                       void** out_values, bool* out_found) AVL_HOT;
+
 /* Range query with callback (avoids allocation) */
 typedef bool (*AVLRangeCallback)(int64_t key, void* value, void* ctx);
 void avl_tree_range_foreach(const AVLTree* tree, int64_t lo, int64_t hi,
@@ -184,4 +269,4 @@ void avl_tree_range_foreach(const AVLTree* tree, int64_t lo, int64_t hi,
 }
 #endif
 
-#endif /* AVL_TREE_H */
+#endif /* C_AVL_TREE_H */
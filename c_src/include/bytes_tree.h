@@ -0,0 +1,230 @@
+/**
+ * @file bytes_tree.h
+ * @brief AVL tree keyed by variable-length byte strings
+ *
+ * Same algorithm as avl_tree.h, with keys ordered like memcmp (a shorter key
+ * that is a prefix of a longer one sorts first).
+ *
+ * Optimizations:
+ *   - Each node carries the first 8 key bytes as a big-endian integer, so
+ *     most comparisons during a descent are one integer compare and never
+ *     touch the key bytes
+ *   - Keys of up to 8 bytes live inline in the node (64 bytes, one line)
+ *   - Longer keys are copied into a per-tree key arena with size-class free
+ *     lists; keys above AVL_KEY_ARENA_MAX_CLASS fall back to malloc
+ *   - Node pooling in 256-node blocks (AVL_BYTES_POOL_BLOCK_SIZE)
+ *
+ * The int64 tree in avl_tree.h is untouched; this is a separate type.
+ */
+
+#ifndef BYTES_TREE_H
+#define BYTES_TREE_H
+
+#include "avl_tree.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AVL_KEY_INLINE_BYTES 8
+
+/**
+ * Byte-string AVL node - exactly one cache line
+ */
+typedef struct AVLBytesNode {
+    uint64_t prefix;                    /* first 8 bytes, big-endian, zero padded */
+    const uint8_t* key;                 /* inline_key or arena/malloc copy */
+    void* value;
+    struct AVLBytesNode* left;
+    struct AVLBytesNode* right;
+    struct AVLBytesNode* parent;
+    uint32_t len;
+    int32_t height;
+    uint8_t inline_key[AVL_KEY_INLINE_BYTES];
+} AVLBytesNode;  /* 64 bytes */
+
+#define AVL_BYTES_POOL_BLOCK_SIZE 256
+
+typedef struct AVLBytesNodeBlock {
+    AVLBytesNode nodes[AVL_BYTES_POOL_BLOCK_SIZE];
+    struct AVLBytesNodeBlock* next;
+} AVLBytesNodeBlock;
+
+/**
+ * Key arena: bump-allocated chunks, freed keys recycled per 16-byte class
+ */
+#define AVL_KEY_ARENA_CHUNK      (64 * 1024)
+#define AVL_KEY_ARENA_GRANULE    16
+#define AVL_KEY_ARENA_MAX_CLASS  512    /* larger keys are malloc'd */
+#define AVL_KEY_ARENA_CLASSES    (AVL_KEY_ARENA_MAX_CLASS / AVL_KEY_ARENA_GRANULE)
+
+typedef struct AVLKeyChunk {
+    struct AVLKeyChunk* next;
+} AVLKeyChunk;
+
+typedef struct AVLKeyArena {
+    AVLKeyChunk* chunks;
+    char* cursor;
+    char* end;
+    void* free_lists[AVL_KEY_ARENA_CLASSES];
+    size_t bytes_in_use;
+} AVLKeyArena;
+
+typedef struct AVLBytesTree {
+    AVLBytesNode* root;
+    size_t size;
+    AVLBytesNodeBlock* blocks;
+    AVLBytesNode* free_nodes;
+    AVLKeyArena keys;
+    void (*value_destructor)(void*);
+} AVLBytesTree;
+
+/* ============================================================================
+ * Key helpers (inlined hot paths)
+ * ============================================================================ */
+
+/* First min(len, 8) bytes as a big-endian integer: integer order == memcmp order */
+AVL_INLINE uint64_t avl_bytes_prefix(const void* key, size_t len) {
+    const uint8_t* p = (const uint8_t*)key;
+    if (AVL_LIKELY(len >= 8)) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+#if defined(__GNUC__) && defined(__ORDER_LITTLE_ENDIAN__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        return __builtin_bswap64(v);
+#elif defined(__GNUC__)
+        return v;
+#else
+        uint64_t r = 0;
+        for (size_t i = 0; i < 8; i++) r = (r << 8) | p[i];
+        return r;
+#endif
+    }
+    uint64_t r = 0;
+    for (size_t i = 0; i < len; i++) r |= (uint64_t)p[i] << (56 - 8 * i);
+    return r;
+}
+
+/* memcmp order; prefixes already computed for both sides */
+AVL_INLINE int avl_bytes_compare(uint64_t pa, const uint8_t* a, size_t la,
+                                 uint64_t pb, const uint8_t* b, size_t lb) {
+    if (AVL_LIKELY(pa != pb)) return pa < pb ? -1 : 1;
+    size_t m = la < lb ? la : lb;
+    if (m > 8) {
+        int c = memcmp(a + 8, b + 8, m - 8);
+        if (c) return c;
+    }
+    return (la > lb) - (la < lb);
+}
+
+/* 64x64 -> 128 multiply folded to 64 bits (wyhash mixing step) */
+AVL_INLINE uint64_t avl_bytes_mum(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+    uint64_t ha = a >> 32, la = (uint32_t)a, hb = b >> 32, lb = (uint32_t)b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    return lo ^ hi;
+#endif
+}
+
+AVL_INLINE uint64_t avl_bytes_read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+AVL_INLINE uint64_t avl_bytes_read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+/**
+ * wyhash-style hash for routing byte keys to shards. Not cryptographic;
+ * the seed only decorrelates it from other uses.
+ */
+AVL_INLINE uint64_t avl_bytes_hash(const void* key, size_t len) {
+    static const uint64_t s0 = 0xa0761d6478bd642fULL, s1 = 0xe7037ed1a0b428dbULL,
+                          s2 = 0x8ebc6af09c88c6e3ULL, s3 = 0x589965cc75374cc3ULL;
+    const uint8_t* p = (const uint8_t*)key;
+    uint64_t seed = 0x2d358dccaa6c78a5ULL ^ avl_bytes_mum(0x2d358dccaa6c78a5ULL ^ s0, s1);
+    uint64_t a, b;
+    if (AVL_LIKELY(len <= 16)) {
+        if (len >= 4) {
+            a = (avl_bytes_read32(p) << 32) | avl_bytes_read32(p + ((len >> 3) << 2));
+            b = (avl_bytes_read32(p + len - 4) << 32) |
+                avl_bytes_read32(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = avl_bytes_mum(avl_bytes_read64(p) ^ s1, avl_bytes_read64(p + 8) ^ seed);
+                see1 = avl_bytes_mum(avl_bytes_read64(p + 16) ^ s2, avl_bytes_read64(p + 24) ^ see1);
+                see2 = avl_bytes_mum(avl_bytes_read64(p + 32) ^ s3, avl_bytes_read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = avl_bytes_mum(avl_bytes_read64(p) ^ s1, avl_bytes_read64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = avl_bytes_read64(p + i - 16);
+        b = avl_bytes_read64(p + i - 8);
+    }
+    return avl_bytes_mum(s1 ^ len, avl_bytes_mum(a ^ s1, b ^ seed));
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+AVLBytesTree* avl_bytes_tree_create(void (*value_destructor)(void*));
+void avl_bytes_tree_destroy(AVLBytesTree* tree);
+
+/* Returns true if the key was new; an existing key gets its value replaced */
+bool avl_bytes_tree_insert(AVLBytesTree* tree, const void* key, size_t len, void* value) AVL_HOT;
+bool avl_bytes_tree_remove(AVLBytesTree* tree, const void* key, size_t len);
+void* avl_bytes_tree_get(const AVLBytesTree* tree, const void* key, size_t len,
+                         bool* found) AVL_HOT;
+bool avl_bytes_tree_contains(const AVLBytesTree* tree, const void* key, size_t len) AVL_HOT;
+size_t avl_bytes_tree_size(const AVLBytesTree* tree);
+void avl_bytes_tree_clear(AVLBytesTree* tree);
+
+/* Key arena bytes currently holding live keys longer than 8 bytes */
+size_t avl_bytes_tree_key_bytes(const AVLBytesTree* tree);
+
+/* In-order traversal; the key pointer is only valid during the callback */
+typedef bool (*AVLBytesCallback)(const void* key, size_t len, void* value, void* ctx);
+void avl_bytes_tree_foreach(const AVLBytesTree* tree, AVLBytesCallback callback, void* ctx);
+
+/* Keys in [lo, hi] (memcmp order), in order, until the callback returns false */
+void avl_bytes_tree_range_foreach(const AVLBytesTree* tree,
+                                  const void* lo, size_t lo_len,
+                                  const void* hi, size_t hi_len,
+                                  AVLBytesCallback callback, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BYTES_TREE_H */
@@ -1,12 +1,14 @@
 /**
  * @file hash_table.h
- * @brief High-performance hash table with Robin Hood hashing
+ * @brief High-performance hash table with SIMD group probing (Swiss table)
  * 
  * Optimizations:
- *   - Robin Hood hashing for better cache performance
- *   - Power-of-2 sizing for fast modulo
- *   - Inline hot path functions
- *   - Separate metadata for better cache locality
+ *   - Separate control-byte array: one byte per slot holding a 7-bit hash
+ *     tag (or EMPTY / DELETED), so probing never touches the entries
+ *   - Probes HT_GROUP_WIDTH control bytes per step with SSE2 (16) or
+ *     AVX2 (32); a scalar loop builds the same bitmask elsewhere
+ *   - Entries are plain 16-byte key/value pairs, no per-entry metadata
+ *   - Power-of-2 sizing, 7/8 max load, tombstones only where needed
  */
 
 #ifndef HASH_TABLE_H
@@ -18,6 +20,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -33,32 +41,38 @@ extern "C" {
 #define HT_INLINE      static inline
 #endif
 
-/* Entry states for Robin Hood */
-#define HT_EMPTY    0
-#define HT_OCCUPIED 1
-#define HT_DELETED  2
+/* Control bytes: full slots hold the low 7 hash bits (high bit clear) */
+#define HT_CTRL_EMPTY   ((int8_t)-128)  /* 0x80 */
+#define HT_CTRL_DELETED ((int8_t)-2)    /* 0xFE */
+
+#if defined(__AVX2__)
+#define HT_GROUP_WIDTH 32
+#else
+#define HT_GROUP_WIDTH 16
+#endif
 
 /**
- * Hash entry - compact layout
+ * Hash entry - key/value only, state lives in the control bytes
  */
 typedef struct HashEntry {
     int64_t key;
     size_t value;
-    uint8_t state;      /* HT_EMPTY, HT_OCCUPIED, HT_DELETED */
-    uint8_t probe_dist; /* Distance from ideal position (Robin Hood) */
-    uint16_t _pad;
 } HashEntry;
 
 /**
  * Hash table structure
+ *
+ * ctrl has capacity + HT_GROUP_WIDTH bytes: the first HT_GROUP_WIDTH are
+ * mirrored at the end so a group load never wraps.
  */
 typedef struct HashTable {
+    int8_t* ctrl;
     HashEntry* entries;
-    size_t capacity;    /* Always power of 2 */
+    size_t capacity;    /* Always power of 2, >= HT_GROUP_WIDTH */
     size_t mask;        /* capacity - 1 for fast modulo */
     size_t size;
     size_t tombstones;
-    size_t max_probe;   /* Track max probe distance */
+    size_t growth_left; /* EMPTY slots usable before the next resize */
 } HashTable;
 
 /* ============================================================================
@@ -81,6 +95,78 @@ HT_INLINE size_t ht_index(uint64_t hash, size_t mask) {
     return (size_t)(hash & mask);
 }
 
+/* Probe start from the high bits, 7-bit tag from the low bits */
+HT_INLINE size_t ht_h1(uint64_t hash) {
+    return (size_t)(hash >> 7);
+}
+
+HT_INLINE int8_t ht_h2(uint64_t hash) {
+    return (int8_t)(hash & 0x7F);
+}
+
+/* ============================================================================
+ * Group Matching - bit i set <=> control byte i of the group matches
+ * ============================================================================ */
+
+typedef uint32_t ht_bitmask;
+
+HT_INLINE ht_bitmask ht_group_match(const int8_t* group, int8_t h2) {
+#if defined(__AVX2__)
+    __m256i ctrl = _mm256_loadu_si256((const __m256i*)group);
+    return (ht_bitmask)_mm256_movemask_epi8(_mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8(h2)));
+#elif defined(__SSE2__)
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (ht_bitmask)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)));
+#else
+    ht_bitmask m = 0;
+    for (int i = 0; i < HT_GROUP_WIDTH; i++) {
+        m |= (ht_bitmask)(group[i] == h2) << i;
+    }
+    return m;
+#endif
+}
+
+HT_INLINE ht_bitmask ht_group_match_empty(const int8_t* group) {
+    return ht_group_match(group, HT_CTRL_EMPTY);
+}
+
+/* EMPTY and DELETED are the only control values with the high bit set */
+HT_INLINE ht_bitmask ht_group_match_free(const int8_t* group) {
+#if defined(__AVX2__)
+    return (ht_bitmask)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)group));
+#elif defined(__SSE2__)
+    return (ht_bitmask)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+    ht_bitmask m = 0;
+    for (int i = 0; i < HT_GROUP_WIDTH; i++) {
+        m |= (ht_bitmask)(group[i] < 0) << i;
+    }
+    return m;
+#endif
+}
+
+HT_INLINE unsigned ht_lowest_bit(ht_bitmask m) {
+#ifdef __GNUC__
+    return (unsigned)__builtin_ctz(m);
+#else
+    unsigned i = 0;
+    while (!(m & 1u)) { m >>= 1; i++; }
+    return i;
+#endif
+}
+
+/* Zeros above the highest set bit, counted within the group width */
+HT_INLINE unsigned ht_leading_zeros(ht_bitmask m) {
+    if (!m) return HT_GROUP_WIDTH;
+#ifdef __GNUC__
+    return (unsigned)__builtin_clz(m) - (32 - HT_GROUP_WIDTH);
+#else
+    unsigned n = 0;
+    for (ht_bitmask bit = (ht_bitmask)1 << (HT_GROUP_WIDTH - 1); !(m & bit); bit >>= 1) n++;
+    return n;
+#endif
+}
+
 /* ============================================================================
  * Public API
  * ============================================================================ */
@@ -91,6 +177,7 @@ bool hash_table_insert(HashTable* table, int64_t key, size_t value);
 bool hash_table_lookup(const HashTable* table, int64_t key, size_t* out_value);
 bool hash_table_remove(HashTable* table, int64_t key);
 size_t hash_table_size(const HashTable* table);
+size_t hash_table_memory_bytes(const HashTable* table);
 void hash_table_clear(HashTable* table);
 
 /* Iterator */
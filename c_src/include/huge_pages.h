@@ -0,0 +1,58 @@
+/**
+ * @file huge_pages.h
+ * @brief 2 MB page-backed memory regions for node pools
+ *
+ * Deep tree traversals pay a TLB miss on top of a cache miss at nearly every
+ * level once the node set outgrows the TLB reach of 4 KB pages. Backing node
+ * pools with 2 MB pages lets one TLB entry cover 512 times more nodes.
+ *
+ * Modes:
+ *   - AVL_HUGE_PAGES_OFF:         plain malloc'd pool blocks (default)
+ *   - AVL_HUGE_PAGES_TRANSPARENT: 2 MB aligned mmap regions with
+ *                                 madvise(MADV_HUGEPAGE)
+ *   - AVL_HUGE_PAGES_EXPLICIT:    MAP_HUGETLB (hugetlbfs pool, see
+ *                                 /proc/sys/vm/nr_hugepages); falls back to
+ *                                 TRANSPARENT when no huge pages are reserved
+ *
+ * Every failure falls back to the next mode down, ending at malloc, so
+ * enabling huge pages never makes an allocation fail. Non-Linux builds always
+ * use malloc.
+ */
+
+#ifndef HUGE_PAGES_H
+#define HUGE_PAGES_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AVL_HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+
+typedef enum AVLHugePageMode {
+    AVL_HUGE_PAGES_OFF = 0,
+    AVL_HUGE_PAGES_TRANSPARENT,
+    AVL_HUGE_PAGES_EXPLICIT
+} AVLHugePageMode;
+
+typedef struct AVLHugePageStats {
+    size_t explicit_regions;        /* Regions served from hugetlbfs */
+    size_t transparent_regions;     /* Regions marked MADV_HUGEPAGE */
+    size_t fallbacks;               /* Requests that got a lesser kind */
+} AVLHugePageStats;
+
+/* Process-wide mode, read when a pool needs a new region */
+void avl_huge_pages_set_mode(AVLHugePageMode mode);
+AVLHugePageMode avl_huge_pages_get_mode(void);
+void avl_huge_pages_get_stats(AVLHugePageStats* stats);
+
+/* AVL_HUGE_PAGE_SIZE bytes aligned to AVL_HUGE_PAGE_SIZE, or NULL */
+void* avl_huge_region_alloc(AVLHugePageMode mode);
+void avl_huge_region_free(void* region);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HUGE_PAGES_H */
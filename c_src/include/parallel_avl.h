@@ -6,8 +6,9 @@
  *   - N independent AVL trees for true parallelism
  *   - Adversary-resistant routing with hotspot detection
  *   - Dynamic scaling: add_shard(), remove_shard(), force_rebalance()
+ *   - Consistent-hash ring placement with lazy migration
  *   - Linearizability guarantee via RedirectIndex
- *   - Optimized range queries
+ *   - Streaming sorted range queries (heap merge of per-shard cursors)
  * 
  * Optimizations:
  *   - Inline hot paths for minimal overhead
@@ -67,8 +68,27 @@ typedef struct ParallelAVLStats {
     size_t redirect_index_hits;
     double redirect_hit_rate;
     size_t redirect_index_memory_bytes;
+    
+    /* Ring placement (ROUTER_CONSISTENT_HASH) */
+    bool migrating;
+    size_t migrated_keys;
 } ParallelAVLStats;
 
+/**
+ * Lazy migration after add_shard in ring placement. The new shard takes
+ * over some ring arcs; keys in those arcs stay on their previous owner
+ * until a lookup touches them or parallel_avl_migrate_step scans them.
+ * A miss probes at most that one previous owner, never every shard.
+ */
+typedef struct RingMigration {
+    Router* prev_router;            /* ring before the last add_shard */
+    size_t num_sources;             /* shards that existed before it */
+    atomic_bool_t* pending;         /* per source: may still hold moved keys */
+    int64_t* cursors;               /* per source: next key to scan */
+    size_t next_source;
+    atomic_size moved_keys;
+} RingMigration;
+
 /**
  * Parallel AVL Tree structure - optimized layout
  */
@@ -86,8 +106,13 @@ typedef struct ParallelAVL {
     atomic_size total_ops;
     atomic_size redirect_hits;
     
+    /* Ring placement: keys live on their consistent-hash ring owner */
+    bool ring;
+    atomic_bool_t migrating;
+    
     /* Cold data */
     RedirectIndex* redirect_index;
+    RingMigration migration;
 } ParallelAVL;
 
 /* ============================================================================
@@ -104,6 +129,11 @@ PAVL_INLINE uint64_t pavl_hash(int64_t key) {
     return h;
 }
 
+/* Shard hash for byte-string keys (wyhash-style, see bytes_tree.h) */
+PAVL_INLINE uint64_t pavl_hash_bytes(const void* key, size_t len) {
+    return avl_bytes_hash(key, len);
+}
+
 /* ============================================================================
  * Public API
  * ============================================================================ */
@@ -117,7 +147,63 @@ bool parallel_avl_contains(ParallelAVL* tree, int64_t key) PAVL_HOT;
 void* parallel_avl_get(ParallelAVL* tree, int64_t key, bool* found) PAVL_HOT;
 bool parallel_avl_remove(ParallelAVL* tree, int64_t key);
 
-/* Range queries */
+/*
+ * Batched operations: keys are hashed in one pass, grouped by shard, and
+ * each shard is locked once; lookups interleave their tree descents with
+ * prefetching (avl_tree_get_many).
+ *   get_many:    out_found[i] / out_values[i] per key (out_values may be
+ *                NULL); returns the number found
+ *   insert_many: values may be NULL (all NULL); returns the number of new
+ *                keys. Load-aware routing is decided for the whole batch
+ *                before any of it is inserted.
+ */
+size_t parallel_avl_get_many(ParallelAVL* tree, const int64_t* keys, size_t n,
+                             void** out_values, bool* out_found) PAVL_HOT;
+size_t parallel_avl_insert_many(ParallelAVL* tree, const int64_t* keys,
+                                void* const* values, size_t n);
+
+/*
+ * Byte-string keys: a keyspace separate from the int64 one, kept in a second
+ * tree per shard (same shard mutex). Keys are copied in; ordering is memcmp.
+ * They always live in their hash shard (no load-aware redirection), so they
+ * never touch the redirect index. Returns true from insert if the key was new.
+ */
+bool parallel_avl_insert_bytes(ParallelAVL* tree, const void* key, size_t len,
+                               void* value) PAVL_HOT;
+bool parallel_avl_contains_bytes(ParallelAVL* tree, const void* key, size_t len) PAVL_HOT;
+void* parallel_avl_get_bytes(ParallelAVL* tree, const void* key, size_t len,
+                             bool* found) PAVL_HOT;
+bool parallel_avl_remove_bytes(ParallelAVL* tree, const void* key, size_t len);
+
+PAVL_INLINE size_t parallel_avl_bytes_size(const ParallelAVL* tree) {
+    if (PAVL_UNLIKELY(!tree)) return 0;
+    size_t total = 0;
+    for (size_t i = 0; i < tree->num_shards; i++) {
+        total += shard_bytes_size(tree->shards[i]);
+    }
+    return total;
+}
+
+/*
+ * Range queries. Per-shard in-order cursors are merged through a min-heap,
+ * so keys come out sorted without buffering the whole range; shards are
+ * read PAVL_RANGE_BATCH keys at a time and never locked during a callback.
+ */
+#define PAVL_RANGE_BATCH 64
+
+/* Keys in [lo, hi] in order, until the callback returns false */
+void parallel_avl_range_foreach(ParallelAVL* tree, int64_t lo, int64_t hi,
+                                AVLRangeCallback callback, void* ctx);
+
+/*
+ * Up to limit smallest keys in [lo, hi]. Returns true if more remain; then
+ * *next_lo is the lo for the following page.
+ */
+bool parallel_avl_range_page(ParallelAVL* tree, int64_t lo, int64_t hi,
+                             AVLKeyValue* out_array, size_t limit,
+                             size_t* out_count, int64_t* next_lo);
+
+/* Smallest max_results keys in [lo, hi], sorted */
 void parallel_avl_range_query(ParallelAVL* tree, int64_t lo, int64_t hi,
                                AVLKeyValue* out_array, size_t max_results,
                                size_t* out_count);
@@ -139,11 +225,35 @@ PAVL_INLINE size_t parallel_avl_num_shards(const ParallelAVL* tree) {
 double parallel_avl_balance_score(const ParallelAVL* tree);
 void parallel_avl_clear(ParallelAVL* tree);
 
-/* Dynamic scaling */
+/*
+ * Returns memory left over after bulk deletes: every shard's empty node
+ * blocks and the shared block depot go back to the OS. Bytes released.
+ */
+size_t parallel_avl_trim(ParallelAVL* tree);
+
+/*
+ * Dynamic scaling. With ROUTER_CONSISTENT_HASH the tree uses ring
+ * placement: add_shard only reassigns the arcs the new shard takes over
+ * and migrates them lazily (see RingMigration); remove_shard re-places
+ * just the removed shard's keys. Other strategies re-place by modulo and
+ * fall back to searching every shard until force_rebalance.
+ * Topology changes must not run concurrently with other operations.
+ */
 bool parallel_avl_add_shard(ParallelAVL* tree);
 bool parallel_avl_remove_shard(ParallelAVL* tree);
 void parallel_avl_force_rebalance(ParallelAVL* tree);
 
+/*
+ * Moves up to max_keys scanned keys of a pending migration to their new
+ * owner; returns the number moved. Safe alongside other operations, but
+ * only one thread may drive the migration. SIZE_MAX finishes it.
+ */
+size_t parallel_avl_migrate_step(ParallelAVL* tree, size_t max_keys);
+
+PAVL_INLINE bool parallel_avl_migrating(const ParallelAVL* tree) {
+    return tree && atomic_load_bool(&((ParallelAVL*)tree)->migrating);
+}
+
 /* Statistics */
 ParallelAVLStats parallel_avl_get_stats(const ParallelAVL* tree);
 void parallel_avl_free_stats(ParallelAVLStats* stats);
@@ -148,9 +148,17 @@ Router* router_create(size_t num_shards, RouterStrategy strategy);
 void router_destroy(Router* router);
 size_t router_route(Router* router, int64_t key) ROUTER_HOT;
 void router_record_insertion(Router* router, size_t shard_idx);
+void router_record_insertions(Router* router, size_t shard_idx, size_t count);
 void router_record_removal(Router* router, size_t shard_idx);
 RouterStats router_get_stats(const Router* router);
 
+/*
+ * Owner of a key hash on the virtual node ring (ROUTER_CONSISTENT_HASH and
+ * ROUTER_INTELLIGENT). Vnodes of shard s depend only on s, so a ring with
+ * one more shard differs only in the arcs the new shard takes over.
+ */
+size_t router_ring_shard(const Router* router, uint64_t key_hash) ROUTER_HOT;
+
 /* Inline natural shard calculation */
 ROUTER_INLINE size_t router_natural_shard(const Router* router, int64_t key) {
     uint64_t h = router_hash(key);
@@ -13,6 +13,7 @@
 #define SHARD_H
 
 #include "avl_tree.h"
+#include "bytes_tree.h"
 #include "atomics.h"
 #include <stddef.h>
 #include <stdint.h>
@@ -77,6 +78,10 @@ typedef struct TreeShard {
     atomic_int64 min_key;
     atomic_int64 max_key;
     atomic_bool_t has_keys;
+    
+    /* Byte-string keys: separate tree, created on first use, same mutex */
+    AVLBytesTree* bytes_tree;
+    atomic_size bytes_size;
 } TreeShard;
 
 /* ============================================================================
@@ -90,8 +95,44 @@ void shard_destroy(TreeShard* shard);
 void shard_insert(TreeShard* shard, int64_t key, void* value);
 bool shard_remove(TreeShard* shard, int64_t key);
 bool shard_contains(TreeShard* shard, int64_t key);
+
+/* Outcome of shard_move_key */
+typedef enum {
+    SHARD_MOVE_ABSENT,      /* neither shard has the key */
+    SHARD_MOVE_MOVED,       /* src's copy was inserted into dst */
+    SHARD_MOVE_DROPPED,     /* dst already had it (a newer write); src's copy dropped */
+    SHARD_MOVE_IN_DST       /* only dst had it: nothing to do */
+} ShardMoveResult;
+
+/*
+ * Moves key from src to dst holding both locks, so readers see it in one
+ * of them at every instant. If dst already has the key (a newer write) its
+ * value wins and src's copy is dropped. Both shards are checked under both
+ * locks, so a concurrent move between them cannot make the key look
+ * absent. Unless the result is SHARD_MOVE_ABSENT, *out_value gets the value
+ * now in dst.
+ */
+ShardMoveResult shard_move_key(TreeShard* src, TreeShard* dst, int64_t key, void** out_value);
+
+/*
+ * Removes key from both shards under both locks (a ring migration's home
+ * and stale owner). *removed_a / *removed_b report which held it.
+ */
+bool shard_remove_either(TreeShard* a, TreeShard* b, int64_t key,
+                         bool* removed_a, bool* removed_b);
 void* shard_get(TreeShard* shard, int64_t key, bool* found);
 
+/*
+ * Batched operations: one lock acquisition for the whole batch.
+ * get_many: out_values may be NULL; returns the number found.
+ * insert_many: values may be NULL (all NULL); out_inserted (optional)
+ * marks keys that were new; returns the number of new keys.
+ */
+size_t shard_get_many(TreeShard* shard, const int64_t* keys, size_t n,
+                      void** out_values, bool* out_found);
+size_t shard_insert_many(TreeShard* shard, const int64_t* keys, void* const* values,
+                         size_t n, bool* out_inserted);
+
 /* Lock-free size read */
 static inline size_t shard_size(const TreeShard* shard) {
     return shard ? atomic_load_size(&((TreeShard*)shard)->size) : 0;
@@ -102,11 +143,37 @@ bool shard_intersects_range(const TreeShard* shard, int64_t lo, int64_t hi);
 void shard_range_query(TreeShard* shard, int64_t lo, int64_t hi,
                        AVLKeyValue* out_array, size_t max_results, size_t* out_count);
 
+/* Byte-string keys (bytes_tree.h) - independent of the int64 keyspace */
+bool shard_insert_bytes(TreeShard* shard, const void* key, size_t len, void* value);
+bool shard_remove_bytes(TreeShard* shard, const void* key, size_t len);
+bool shard_contains_bytes(TreeShard* shard, const void* key, size_t len);
+void* shard_get_bytes(TreeShard* shard, const void* key, size_t len, bool* found);
+
+static inline size_t shard_bytes_size(const TreeShard* shard) {
+    return shard ? atomic_load_size(&((TreeShard*)shard)->bytes_size) : 0;
+}
+
+/* Unhooks the byte-key tree (caller owns and destroys it); NULL if empty */
+AVLBytesTree* shard_detach_bytes(TreeShard* shard);
+
 /* Statistics and management */
 ShardStats shard_get_stats(const TreeShard* shard);
 void shard_clear(TreeShard* shard);
 void shard_extract_all(TreeShard* shard, AVLKeyValue* out_array, size_t* out_count);
 
+/* Like shard_extract_all, sized under the lock; caller frees. NULL on OOM */
+AVLKeyValue* shard_extract_all_alloc(TreeShard* shard, size_t* out_count);
+
+/*
+ * Replaces the shard's int64 keys with items (strictly increasing keys),
+ * built in O(n) by avl_tree_build_sorted. Byte-string keys are untouched.
+ * Returns false, leaving no int64 keys, if the build runs out of memory.
+ */
+bool shard_load_sorted(TreeShard* shard, const AVLKeyValue* items, size_t n);
+
+/* Returns the shard's fully free node blocks to the OS; bytes released */
+size_t shard_trim(TreeShard* shard);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,53 @@
+/**
+ * @file worker_pool.h
+ * @brief Fixed-size thread pool for the library's bulk operations
+ *
+ * force_rebalance and remove_shard split their work into independent tasks
+ * (one per shard) and run them here. worker_pool_run is a blocking parallel
+ * for: helper threads and the calling thread pull task indices from a
+ * shared counter until all are done, so a pool of 0 helpers is simply a
+ * serial loop on the caller.
+ *
+ * Internal to the library; not part of parallel_avl.h.
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WORKER_POOL_MAX_THREADS 64
+
+typedef struct WorkerPool WorkerPool;
+
+/* task(ctx, i) for one index i in [0, num_tasks) */
+typedef void (*WorkerTask)(void* ctx, size_t index);
+
+/* num_threads helper threads (capped at WORKER_POOL_MAX_THREADS); NULL on failure */
+WorkerPool* worker_pool_create(size_t num_threads);
+void worker_pool_destroy(WorkerPool* pool);
+size_t worker_pool_threads(const WorkerPool* pool);
+
+/*
+ * Runs every task and returns when all have finished. Concurrent calls on
+ * one pool take turns; a task must not call worker_pool_run on its own
+ * pool. A NULL pool runs the tasks serially on the caller.
+ */
+void worker_pool_run(WorkerPool* pool, size_t num_tasks, WorkerTask task, void* ctx);
+
+/*
+ * Process-wide pool with one helper per online CPU besides the caller,
+ * created on first use and kept for the life of the process. NULL if it
+ * could not be created (callers then run serially).
+ */
+WorkerPool* worker_pool_shared(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WORKER_POOL_H */
@@ -5,6 +5,251 @@
 
 #include "../include/avl_tree.h"
 
+/* ============================================================================
+ * Node Pool Blocks
+ * ============================================================================ */
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <malloc.h>
+static SRWLOCK g_depot_lock = SRWLOCK_INIT;
+#define DEPOT_LOCK()    AcquireSRWLockExclusive(&g_depot_lock)
+#define DEPOT_UNLOCK()  ReleaseSRWLockExclusive(&g_depot_lock)
+#define BLOCK_ALLOC()   _aligned_malloc(AVL_POOL_BLOCK_BYTES, AVL_POOL_BLOCK_BYTES)
+#define BLOCK_FREE(b)   _aligned_free(b)
+#else
+#include <pthread.h>
+static pthread_mutex_t g_depot_lock = PTHREAD_MUTEX_INITIALIZER;
+#define DEPOT_LOCK()    pthread_mutex_lock(&g_depot_lock)
+#define DEPOT_UNLOCK()  pthread_mutex_unlock(&g_depot_lock)
+#define BLOCK_ALLOC()   aligned_alloc(AVL_POOL_BLOCK_BYTES, AVL_POOL_BLOCK_BYTES)
+#define BLOCK_FREE(b)   free(b)
+#endif
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+_Static_assert(sizeof(AVLNodeBlock) <= AVL_POOL_BLOCK_BYTES, "AVLNodeBlock exceeds its alignment");
+#endif
+
+/*
+ * Shared depot of empty malloc'd blocks. Pools park surplus empty blocks
+ * here and take from it before calling malloc, so memory freed by one
+ * shard's deletes is reused by another shard's inserts.
+ */
+static AVLNodeBlock* g_depot = NULL;
+static size_t g_depot_count = 0;
+
+static AVLNodeBlock* depot_take(void) {
+    DEPOT_LOCK();
+    AVLNodeBlock* block = g_depot;
+    if (block) {
+        g_depot = block->next;
+        g_depot_count--;
+    }
+    DEPOT_UNLOCK();
+    return block;
+}
+
+/* Parks block in the depot, or frees it when the depot is full */
+static void depot_put(AVLNodeBlock* block) {
+    DEPOT_LOCK();
+    if (g_depot_count < AVL_POOL_DEPOT_MAX) {
+        block->next = g_depot;
+        g_depot = block;
+        g_depot_count++;
+        block = NULL;
+    }
+    DEPOT_UNLOCK();
+    if (block) BLOCK_FREE(block);
+}
+
+size_t avl_pool_depot_trim(void) {
+    DEPOT_LOCK();
+    AVLNodeBlock* block = g_depot;
+    size_t count = g_depot_count;
+    g_depot = NULL;
+    g_depot_count = 0;
+    DEPOT_UNLOCK();
+
+    while (block) {
+        AVLNodeBlock* next = block->next;
+        BLOCK_FREE(block);
+        block = next;
+    }
+    return count * AVL_POOL_BLOCK_BYTES;
+}
+
+size_t avl_pool_depot_blocks(void) {
+    DEPOT_LOCK();
+    size_t count = g_depot_count;
+    DEPOT_UNLOCK();
+    return count;
+}
+
+AVL_INLINE void block_reset(AVLNodeBlock* block, uint32_t in_region) {
+    block->free = NULL;
+    block->live = 0;
+    block->bump = 0;
+    block->in_region = in_region;
+}
+
+AVL_INLINE void list_push(AVLNodeBlock** head, AVLNodeBlock* block) {
+    block->prev = NULL;
+    block->next = *head;
+    if (*head) (*head)->prev = block;
+    *head = block;
+}
+
+AVL_INLINE void list_unlink(AVLNodeBlock** head, AVLNodeBlock* block) {
+    if (block->prev) {
+        block->prev->next = block->next;
+    } else {
+        *head = block->next;
+    }
+    if (block->next) block->next->prev = block->prev;
+}
+
+/* A fresh block carved from a huge page region, or NULL */
+static AVLNodeBlock* region_block(AVLNodePool* pool, AVLHugePageMode mode) {
+    if ((size_t)(pool->region_end - pool->region_cursor) < AVL_POOL_BLOCK_BYTES) {
+        AVLPoolRegion* region = (AVLPoolRegion*)avl_huge_region_alloc(mode);
+        if (!region) return NULL;
+        region->next = pool->regions;
+        pool->regions = region;
+        /* The first block-sized slice holds the header; the rest stay aligned */
+        pool->region_cursor = (char*)region + AVL_POOL_BLOCK_BYTES;
+        pool->region_end = (char*)region + AVL_HUGE_PAGE_SIZE;
+    }
+    AVLNodeBlock* block = (AVLNodeBlock*)pool->region_cursor;
+    pool->region_cursor += AVL_POOL_BLOCK_BYTES;
+    block_reset(block, 1);
+    return block;
+}
+
+AVLNodeBlock* avl_pool_new_block(AVLNodePool* pool) {
+    AVLNodeBlock* block = pool->empty;
+    if (block) {
+        /* Keeps its free list: freed slots are as good as fresh ones */
+        pool->empty = block->next;
+        pool->empty_count--;
+        list_push(&pool->partial, block);
+        return block;
+    }
+
+    block = depot_take();
+    if (!block) {
+        AVLHugePageMode mode = avl_huge_pages_get_mode();
+        if (mode != AVL_HUGE_PAGES_OFF) {
+            block = region_block(pool, mode);
+        }
+    }
+    if (!block) {
+        /* Huge pages off or region allocation failed: malloc */
+        block = (AVLNodeBlock*)BLOCK_ALLOC();
+        if (!block) return NULL;
+        block->in_region = 0;
+    }
+    if (!block->in_region) {
+        block_reset(block, 0);
+    }
+
+    pool->block_count++;
+    pool->total_allocated += AVL_POOL_BLOCK_SIZE;
+    list_push(&pool->partial, block);
+    return block;
+}
+
+void avl_pool_block_full(AVLNodePool* pool, AVLNodeBlock* block) {
+    list_unlink(&pool->partial, block);
+    list_push(&pool->full, block);
+}
+
+/* Drops a block the pool no longer holds (region blocks die with their region) */
+AVL_INLINE void pool_release_block(AVLNodePool* pool, AVLNodeBlock* block) {
+    pool->block_count--;
+    pool->total_allocated -= AVL_POOL_BLOCK_SIZE;
+    depot_put(block);
+}
+
+void avl_pool_block_freed(AVLNodePool* pool, AVLNodeBlock* block, uint32_t prev_live) {
+    if (prev_live == AVL_POOL_BLOCK_SIZE) {
+        list_unlink(&pool->full, block);
+        list_push(&pool->partial, block);
+    }
+    if (block->live != 0) return;
+
+    list_unlink(&pool->partial, block);
+    if (pool->empty_count < AVL_POOL_KEEP_EMPTY || block->in_region) {
+        block->next = pool->empty;
+        pool->empty = block;
+        pool->empty_count++;
+    } else {
+        pool_release_block(pool, block);
+    }
+}
+
+static void release_list(AVLNodePool* pool, AVLNodeBlock* block) {
+    while (block) {
+        AVLNodeBlock* next = block->next;
+        if (!block->in_region) {
+            pool_release_block(pool, block);
+        }
+        block = next;
+    }
+}
+
+void avl_pool_destroy(AVLNodePool* pool) {
+    /* Every node is dead: whole blocks are reusable by other pools */
+    release_list(pool, pool->partial);
+    release_list(pool, pool->full);
+    release_list(pool, pool->empty);
+    pool->partial = NULL;
+    pool->full = NULL;
+    pool->empty = NULL;
+    pool->empty_count = 0;
+    pool->block_count = 0;
+    pool->total_allocated = 0;
+
+    AVLPoolRegion* region = pool->regions;
+    while (region) {
+        AVLPoolRegion* next = region->next;
+        avl_huge_region_free(region);
+        region = next;
+    }
+    pool->regions = NULL;
+    pool->region_cursor = NULL;
+    pool->region_end = NULL;
+}
+
+size_t avl_pool_trim(AVLNodePool* pool) {
+    size_t released = 0;
+    AVLNodeBlock** link = &pool->empty;
+    while (*link) {
+        AVLNodeBlock* block = *link;
+        if (block->in_region) {
+            link = &block->next;
+            continue;
+        }
+        *link = block->next;
+        BLOCK_FREE(block);
+        pool->empty_count--;
+        pool->block_count--;
+        pool->total_allocated -= AVL_POOL_BLOCK_SIZE;
+        released += AVL_POOL_BLOCK_BYTES;
+    }
+    return released;
+}
+
+void avl_pool_get_stats(const AVLNodePool* pool, AVLPoolStats* stats) {
+    if (!stats) return;
+    size_t live = 0;
+    for (const AVLNodeBlock* b = pool->partial; b; b = b->next) live += b->live;
+    for (const AVLNodeBlock* b = pool->full; b; b = b->next) live += b->live;
+    stats->blocks = pool->block_count;
+    stats->empty_blocks = pool->empty_count;
+    stats->live_nodes = live;
+    stats->bytes = pool->block_count * AVL_POOL_BLOCK_BYTES;
+}
+
 /* ============================================================================
  * Internal Helper Functions
  * ============================================================================ */
@@ -361,7 +606,6 @@ void avl_tree_clear(AVLTree* tree) {
     }
     
     avl_pool_destroy(&tree->pool);
-    avl_pool_init(&tree->pool);
     
     tree->root = NULL;
     tree->size = 0;
@@ -379,6 +623,89 @@ void avl_tree_extract_all(const AVLTree* tree, AVLKeyValue* out_array, size_t* o
     *out_count = index;
 }
 
+/*
+ * Subtree over items[lo, hi): the middle item is the root. Nodes are
+ * allocated in key order (left subtree, node, right subtree), so in-order
+ * neighbours are also neighbours in the pool blocks.
+ */
+static AVLNode* avl_build_recursive(AVLTree* tree, const AVLKeyValue* items,
+                                    size_t lo, size_t hi, bool* failed) {
+    if (lo >= hi) return NULL;
+
+    size_t mid = lo + (hi - lo) / 2;
+    AVLNode* left = avl_build_recursive(tree, items, lo, mid, failed);
+    AVLNode* node = avl_node_create(tree, items[mid].key, items[mid].value);
+    if (AVL_UNLIKELY(!node)) {
+        *failed = true;
+        return NULL;
+    }
+    AVLNode* right = avl_build_recursive(tree, items, mid + 1, hi, failed);
+
+    node->left = left;
+    node->right = right;
+    if (left) left->parent = node;
+    if (right) right->parent = node;
+    avl_update_height(node);
+    return node;
+}
+
+bool avl_tree_build_sorted(AVLTree* tree, const AVLKeyValue* items, size_t n) {
+    if (!tree || tree->root || (n && !items)) return false;
+
+    bool failed = false;
+    AVLNode* root = avl_build_recursive(tree, items, 0, n, &failed);
+    if (AVL_UNLIKELY(failed)) {
+        /* Values still belong to the caller: drop the nodes only */
+        avl_pool_destroy(&tree->pool);
+        return false;
+    }
+
+    tree->root = root;
+    tree->size = n;
+    return true;
+}
+
+size_t avl_tree_trim(AVLTree* tree) {
+    return tree ? avl_pool_trim(&tree->pool) : 0;
+}
+
+void AVL_HOT avl_tree_get_many(const AVLTree* tree, const int64_t* keys, size_t n,
+                               void** out_values, bool* out_found) {
+    if (!tree || !keys || !out_found) return;
+
+    for (size_t base = 0; base < n; base += AVL_BATCH_WIDTH) {
+        size_t width = n - base < AVL_BATCH_WIDTH ? n - base : AVL_BATCH_WIDTH;
+        const AVLNode* cursor[AVL_BATCH_WIDTH];
+
+        for (size_t i = 0; i < width; i++) {
+            cursor[i] = tree->root;
+            out_found[base + i] = false;
+            if (out_values) out_values[base + i] = NULL;
+        }
+
+        size_t active = tree->root ? width : 0;
+        while (active > 0) {
+            active = 0;
+            for (size_t i = 0; i < width; i++) {
+                const AVLNode* node = cursor[i];
+                if (!node) continue;
+
+                int64_t key = keys[base + i];
+                if (key == node->key) {
+                    out_found[base + i] = true;
+                    if (out_values) out_values[base + i] = node->value;
+                    cursor[i] = NULL;
+                    continue;
+                }
+                node = key < node->key ? node->left : node->right;
+                AVL_PREFETCH(node);
+                cursor[i] = node;
+                active += node != NULL;
+            }
+        }
+    }
+}
+
 void avl_tree_range_foreach(const AVLTree* tree, int64_t lo, int64_t hi,
                             AVLRangeCallback callback, void* ctx) {
     if (!tree || !callback) return;
@@ -0,0 +1,466 @@
+/**
+ * @file bytes_tree.c
+ * @brief Byte-string keyed AVL tree implementation
+ */
+
+#include "../include/bytes_tree.h"
+
+/* ============================================================================
+ * Node Pool
+ * ============================================================================ */
+
+static AVLBytesNode* bytes_node_alloc(AVLBytesTree* tree) {
+    if (AVL_LIKELY(tree->free_nodes != NULL)) {
+        AVLBytesNode* node = tree->free_nodes;
+        tree->free_nodes = node->right;
+        return node;
+    }
+
+    AVLBytesNodeBlock* block = (AVLBytesNodeBlock*)malloc(sizeof(AVLBytesNodeBlock));
+    if (!block) return NULL;
+    block->next = tree->blocks;
+    tree->blocks = block;
+
+    for (size_t i = 1; i < AVL_BYTES_POOL_BLOCK_SIZE - 1; i++) {
+        block->nodes[i].right = &block->nodes[i + 1];
+    }
+    block->nodes[AVL_BYTES_POOL_BLOCK_SIZE - 1].right = tree->free_nodes;
+    tree->free_nodes = &block->nodes[1];
+    return &block->nodes[0];
+}
+
+static void bytes_node_free(AVLBytesTree* tree, AVLBytesNode* node) {
+    node->right = tree->free_nodes;
+    tree->free_nodes = node;
+}
+
+/* ============================================================================
+ * Key Arena
+ * ============================================================================ */
+
+AVL_INLINE size_t key_class(size_t len) {
+    return (len + AVL_KEY_ARENA_GRANULE - 1) / AVL_KEY_ARENA_GRANULE - 1;
+}
+
+static uint8_t* key_alloc(AVLKeyArena* arena, size_t len) {
+    if (AVL_UNLIKELY(len > AVL_KEY_ARENA_MAX_CLASS)) {
+        return (uint8_t*)malloc(len);
+    }
+
+    size_t cls = key_class(len);
+    size_t bytes = (cls + 1) * AVL_KEY_ARENA_GRANULE;
+    arena->bytes_in_use += bytes;
+
+    void* slot = arena->free_lists[cls];
+    if (slot) {
+        memcpy(&arena->free_lists[cls], slot, sizeof(void*));
+        return (uint8_t*)slot;
+    }
+
+    if ((size_t)(arena->end - arena->cursor) < bytes) {
+        /* The unused tail of the old chunk is abandoned until clear/destroy */
+        AVLKeyChunk* chunk = (AVLKeyChunk*)malloc(AVL_KEY_ARENA_CHUNK);
+        if (!chunk) {
+            arena->bytes_in_use -= bytes;
+            return NULL;
+        }
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->cursor = (char*)chunk + AVL_KEY_ARENA_GRANULE;
+        arena->end = (char*)chunk + AVL_KEY_ARENA_CHUNK;
+    }
+
+    uint8_t* p = (uint8_t*)arena->cursor;
+    arena->cursor += bytes;
+    return p;
+}
+
+static void key_free(AVLKeyArena* arena, uint8_t* p, size_t len) {
+    if (AVL_UNLIKELY(len > AVL_KEY_ARENA_MAX_CLASS)) {
+        free(p);
+        return;
+    }
+    size_t cls = key_class(len);
+    arena->bytes_in_use -= (cls + 1) * AVL_KEY_ARENA_GRANULE;
+    memcpy(p, &arena->free_lists[cls], sizeof(void*));
+    arena->free_lists[cls] = p;
+}
+
+/* ============================================================================
+ * Internal Helpers
+ * ============================================================================ */
+
+AVL_INLINE int node_height(const AVLBytesNode* n) {
+    return n ? n->height : 0;
+}
+
+AVL_INLINE void node_update_height(AVLBytesNode* n) {
+    n->height = 1 + avl_max(node_height(n->left), node_height(n->right));
+}
+
+AVL_INLINE int node_balance(const AVLBytesNode* n) {
+    return node_height(n->right) - node_height(n->left);
+}
+
+AVL_INLINE int node_compare(uint64_t prefix, const uint8_t* key, size_t len,
+                            const AVLBytesNode* node) {
+    return avl_bytes_compare(prefix, key, len, node->prefix, node->key, node->len);
+}
+
+AVL_INLINE AVLBytesNode* bytes_find_node(const AVLBytesTree* tree, const void* key, size_t len) {
+    uint64_t prefix = avl_bytes_prefix(key, len);
+    AVLBytesNode* current = tree->root;
+
+    while (AVL_LIKELY(current != NULL)) {
+        AVL_PREFETCH(current->left);
+        AVL_PREFETCH(current->right);
+
+        int c = node_compare(prefix, (const uint8_t*)key, len, current);
+        if (c < 0) {
+            current = current->left;
+        } else if (c > 0) {
+            current = current->right;
+        } else {
+            return current;
+        }
+    }
+    return NULL;
+}
+
+static void bytes_transplant(AVLBytesTree* tree, AVLBytesNode* u, AVLBytesNode* v) {
+    if (!u->parent) {
+        tree->root = v;
+    } else if (u == u->parent->left) {
+        u->parent->left = v;
+    } else {
+        u->parent->right = v;
+    }
+    if (v) {
+        v->parent = u->parent;
+    }
+}
+
+static AVLBytesNode* bytes_rotate_left(AVLBytesTree* tree, AVLBytesNode* x) {
+    AVLBytesNode* y = x->right;
+    AVLBytesNode* B = y->left;
+
+    y->left = x;
+    x->right = B;
+    if (B) B->parent = x;
+
+    y->parent = x->parent;
+    if (!x->parent) {
+        tree->root = y;
+    } else if (x->parent->left == x) {
+        x->parent->left = y;
+    } else {
+        x->parent->right = y;
+    }
+    x->parent = y;
+
+    node_update_height(x);
+    node_update_height(y);
+    return y;
+}
+
+static AVLBytesNode* bytes_rotate_right(AVLBytesTree* tree, AVLBytesNode* x) {
+    AVLBytesNode* y = x->left;
+    AVLBytesNode* B = y->right;
+
+    y->right = x;
+    x->left = B;
+    if (B) B->parent = x;
+
+    y->parent = x->parent;
+    if (!x->parent) {
+        tree->root = y;
+    } else if (x->parent->left == x) {
+        x->parent->left = y;
+    } else {
+        x->parent->right = y;
+    }
+    x->parent = y;
+
+    node_update_height(x);
+    node_update_height(y);
+    return y;
+}
+
+static void bytes_rebalance(AVLBytesTree* tree, AVLBytesNode* node) {
+    while (node) {
+        node_update_height(node);
+        int bf = node_balance(node);
+
+        if (bf == 2) {
+            if (node_balance(node->right) < 0) {
+                bytes_rotate_right(tree, node->right);
+            }
+            node = bytes_rotate_left(tree, node);
+        } else if (bf == -2) {
+            if (node_balance(node->left) > 0) {
+                bytes_rotate_left(tree, node->left);
+            }
+            node = bytes_rotate_right(tree, node);
+        }
+        node = node->parent;
+    }
+}
+
+static void bytes_release_node(AVLBytesTree* tree, AVLBytesNode* node) {
+    if (node->len > AVL_KEY_INLINE_BYTES) {
+        key_free(&tree->keys, (uint8_t*)node->key, node->len);
+    }
+    bytes_node_free(tree, node);
+}
+
+static void bytes_destroy_values(AVLBytesTree* tree, AVLBytesNode* node) {
+    if (!node) return;
+    bytes_destroy_values(tree, node->left);
+    bytes_destroy_values(tree, node->right);
+    if (tree->value_destructor && node->value) {
+        tree->value_destructor(node->value);
+    }
+}
+
+/* Long keys that went to malloc are not in the arena chunks */
+static void bytes_free_large_keys(AVLBytesNode* node) {
+    if (!node) return;
+    bytes_free_large_keys(node->left);
+    bytes_free_large_keys(node->right);
+    if (node->len > AVL_KEY_ARENA_MAX_CLASS) {
+        free((void*)node->key);
+    }
+}
+
+static void bytes_release_all(AVLBytesTree* tree) {
+    if (tree->value_destructor) {
+        bytes_destroy_values(tree, tree->root);
+    }
+    bytes_free_large_keys(tree->root);
+
+    AVLBytesNodeBlock* block = tree->blocks;
+    while (block) {
+        AVLBytesNodeBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    AVLKeyChunk* chunk = tree->keys.chunks;
+    while (chunk) {
+        AVLKeyChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    tree->root = NULL;
+    tree->size = 0;
+    tree->blocks = NULL;
+    tree->free_nodes = NULL;
+    memset(&tree->keys, 0, sizeof(tree->keys));
+}
+
+static bool bytes_foreach_recursive(const AVLBytesNode* node, AVLBytesCallback callback,
+                                    void* ctx) {
+    if (!node) return true;
+    if (!bytes_foreach_recursive(node->left, callback, ctx)) return false;
+    if (!callback(node->key, node->len, node->value, ctx)) return false;
+    return bytes_foreach_recursive(node->right, callback, ctx);
+}
+
+typedef struct {
+    uint64_t lo_prefix, hi_prefix;
+    const uint8_t* lo;
+    const uint8_t* hi;
+    size_t lo_len, hi_len;
+    AVLBytesCallback callback;
+    void* ctx;
+} BytesRange;
+
+static bool bytes_range_recursive(const AVLBytesNode* node, const BytesRange* r) {
+    if (!node) return true;
+
+    int vs_lo = avl_bytes_compare(node->prefix, node->key, node->len,
+                                  r->lo_prefix, r->lo, r->lo_len);
+    int vs_hi = avl_bytes_compare(node->prefix, node->key, node->len,
+                                  r->hi_prefix, r->hi, r->hi_len);
+
+    if (vs_lo > 0 && !bytes_range_recursive(node->left, r)) return false;
+    if (vs_lo >= 0 && vs_hi <= 0 &&
+        !r->callback(node->key, node->len, node->value, r->ctx)) return false;
+    if (vs_hi < 0) return bytes_range_recursive(node->right, r);
+    return true;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+AVLBytesTree* avl_bytes_tree_create(void (*value_destructor)(void*)) {
+    AVLBytesTree* tree = (AVLBytesTree*)calloc(1, sizeof(AVLBytesTree));
+    if (AVL_UNLIKELY(!tree)) return NULL;
+    tree->value_destructor = value_destructor;
+    return tree;
+}
+
+void avl_bytes_tree_destroy(AVLBytesTree* tree) {
+    if (!tree) return;
+    bytes_release_all(tree);
+    free(tree);
+}
+
+bool AVL_HOT avl_bytes_tree_insert(AVLBytesTree* tree, const void* key, size_t len,
+                                   void* value) {
+    if (AVL_UNLIKELY(!tree || (!key && len > 0) || len > UINT32_MAX)) return false;
+
+    const uint8_t* k = (const uint8_t*)key;
+    uint64_t prefix = avl_bytes_prefix(k, len);
+    AVLBytesNode* parent = NULL;
+    AVLBytesNode* current = tree->root;
+    int c = 0;
+
+    while (AVL_LIKELY(current != NULL)) {
+        parent = current;
+        c = node_compare(prefix, k, len, current);
+        if (c < 0) {
+            current = current->left;
+        } else if (c > 0) {
+            current = current->right;
+        } else {
+            if (tree->value_destructor && current->value) {
+                tree->value_destructor(current->value);
+            }
+            current->value = value;
+            return false;
+        }
+    }
+
+    AVLBytesNode* node = bytes_node_alloc(tree);
+    if (AVL_UNLIKELY(!node)) return false;
+
+    if (len <= AVL_KEY_INLINE_BYTES) {
+        if (len) memcpy(node->inline_key, k, len);
+        node->key = node->inline_key;
+    } else {
+        uint8_t* copy = key_alloc(&tree->keys, len);
+        if (AVL_UNLIKELY(!copy)) {
+            bytes_node_free(tree, node);
+            return false;
+        }
+        memcpy(copy, k, len);
+        node->key = copy;
+    }
+    node->prefix = prefix;
+    node->len = (uint32_t)len;
+    node->value = value;
+    node->left = NULL;
+    node->right = NULL;
+    node->parent = parent;
+    node->height = 1;
+
+    if (!parent) {
+        tree->root = node;
+    } else if (c < 0) {
+        parent->left = node;
+    } else {
+        parent->right = node;
+    }
+
+    tree->size++;
+    bytes_rebalance(tree, node);
+    return true;
+}
+
+bool avl_bytes_tree_remove(AVLBytesTree* tree, const void* key, size_t len) {
+    if (AVL_UNLIKELY(!tree)) return false;
+
+    AVLBytesNode* node = bytes_find_node(tree, key, len);
+    if (!node) return false;
+
+    AVLBytesNode* rebalance_start;
+
+    if (!node->left) {
+        rebalance_start = node->parent;
+        bytes_transplant(tree, node, node->right);
+    } else if (!node->right) {
+        rebalance_start = node->parent;
+        bytes_transplant(tree, node, node->left);
+    } else {
+        AVLBytesNode* successor = node->right;
+        while (successor->left) successor = successor->left;
+        rebalance_start = (successor->parent == node) ? successor : successor->parent;
+
+        if (successor->parent != node) {
+            bytes_transplant(tree, successor, successor->right);
+            successor->right = node->right;
+            successor->right->parent = successor;
+        }
+
+        bytes_transplant(tree, node, successor);
+        successor->left = node->left;
+        successor->left->parent = successor;
+    }
+
+    if (tree->value_destructor && node->value) {
+        tree->value_destructor(node->value);
+    }
+    bytes_release_node(tree, node);
+    tree->size--;
+
+    if (rebalance_start) {
+        bytes_rebalance(tree, rebalance_start);
+    }
+    return true;
+}
+
+void* AVL_HOT avl_bytes_tree_get(const AVLBytesTree* tree, const void* key, size_t len,
+                                 bool* found) {
+    if (found) *found = false;
+    if (AVL_UNLIKELY(!tree)) return NULL;
+
+    AVLBytesNode* node = bytes_find_node(tree, key, len);
+    if (node) {
+        if (found) *found = true;
+        return node->value;
+    }
+    return NULL;
+}
+
+bool AVL_HOT avl_bytes_tree_contains(const AVLBytesTree* tree, const void* key, size_t len) {
+    if (AVL_UNLIKELY(!tree)) return false;
+    return bytes_find_node(tree, key, len) != NULL;
+}
+
+size_t avl_bytes_tree_size(const AVLBytesTree* tree) {
+    return tree ? tree->size : 0;
+}
+
+void avl_bytes_tree_clear(AVLBytesTree* tree) {
+    if (!tree) return;
+    bytes_release_all(tree);
+}
+
+size_t avl_bytes_tree_key_bytes(const AVLBytesTree* tree) {
+    return tree ? tree->keys.bytes_in_use : 0;
+}
+
+void avl_bytes_tree_foreach(const AVLBytesTree* tree, AVLBytesCallback callback, void* ctx) {
+    if (!tree || !callback) return;
+    bytes_foreach_recursive(tree->root, callback, ctx);
+}
+
+void avl_bytes_tree_range_foreach(const AVLBytesTree* tree,
+                                  const void* lo, size_t lo_len,
+                                  const void* hi, size_t hi_len,
+                                  AVLBytesCallback callback, void* ctx) {
+    if (!tree || !callback) return;
+
+    BytesRange r;
+    r.lo = (const uint8_t*)lo;
+    r.hi = (const uint8_t*)hi;
+    r.lo_len = lo_len;
+    r.hi_len = hi_len;
+    r.lo_prefix = avl_bytes_prefix(lo, lo_len);
+    r.hi_prefix = avl_bytes_prefix(hi, hi_len);
+    r.callback = callback;
+    r.ctx = ctx;
+    bytes_range_recursive(tree->root, &r);
+}
@@ -1,11 +1,10 @@
 /**
  * @file hash_table.c
- * @brief High-performance hash table with Robin Hood hashing
+ * @brief High-performance hash table with SIMD group probing (Swiss table)
  */
 
 #include "../include/hash_table.h"
 
-#define LOAD_FACTOR_MAX 0.7
 #define INITIAL_CAPACITY 16
 
 /* ============================================================================
@@ -26,83 +25,126 @@ HT_INLINE size_t next_power_of_2(size_t n) {
     return n + 1;
 }
 
-HT_INLINE bool is_power_of_2(size_t n) {
-    return n && !(n & (n - 1));
+/* Max load 7/8 */
+HT_INLINE size_t max_fill(size_t capacity) {
+    return capacity - capacity / 8;
 }
 
-static bool hash_table_resize(HashTable* table, size_t new_capacity) {
-    HashEntry* old_entries = table->entries;
-    size_t old_capacity = table->capacity;
-    
-    /* Allocate new array */
-    HashEntry* new_entries = (HashEntry*)calloc(new_capacity, sizeof(HashEntry));
-    if (HT_UNLIKELY(!new_entries)) return false;
-    
-    /* Update table */
-    table->entries = new_entries;
-    table->capacity = new_capacity;
-    table->mask = new_capacity - 1;
+/* Sets a control byte and its mirror past the end */
+HT_INLINE void set_ctrl(HashTable* table, size_t i, int8_t value) {
+    table->ctrl[i] = value;
+    if (i < HT_GROUP_WIDTH) {
+        table->ctrl[table->capacity + i] = value;
+    }
+}
+
+/*
+ * Probe sequence: groups at pos, pos + W, pos + 3W, pos + 6W, ... With a
+ * power-of-2 capacity that is a multiple of W this visits every group.
+ */
+typedef struct {
+    size_t pos;
+    size_t step;
+} ProbeSeq;
+
+HT_INLINE ProbeSeq probe_start(const HashTable* table, uint64_t hash) {
+    ProbeSeq seq = {ht_h1(hash) & table->mask, 0};
+    return seq;
+}
+
+HT_INLINE void probe_next(ProbeSeq* seq, size_t mask) {
+    seq->step += HT_GROUP_WIDTH;
+    seq->pos = (seq->pos + seq->step) & mask;
+}
+
+static bool alloc_arrays(HashTable* table, size_t capacity) {
+    int8_t* ctrl = (int8_t*)malloc(capacity + HT_GROUP_WIDTH);
+    HashEntry* entries = (HashEntry*)malloc(capacity * sizeof(HashEntry));
+    if (HT_UNLIKELY(!ctrl || !entries)) {
+        free(ctrl);
+        free(entries);
+        return false;
+    }
+    memset(ctrl, (unsigned char)HT_CTRL_EMPTY, capacity + HT_GROUP_WIDTH);
+
+    table->ctrl = ctrl;
+    table->entries = entries;
+    table->capacity = capacity;
+    table->mask = capacity - 1;
     table->size = 0;
     table->tombstones = 0;
-    table->max_probe = 0;
-    
-    /* Rehash all entries using Robin Hood insertion */
-    for (size_t i = 0; i < old_capacity; i++) {
-        if (old_entries[i].state == HT_OCCUPIED) {
-            hash_table_insert(table, old_entries[i].key, old_entries[i].value);
-        }
-    }
-    
-    free(old_entries);
+    table->growth_left = max_fill(capacity);
     return true;
 }
 
-/* Robin Hood insertion - swap if current probe distance > existing */
-static bool robin_hood_insert(HashTable* table, int64_t key, size_t value) {
-    uint64_t hash = ht_hash(key);
-    size_t idx = ht_index(hash, table->mask);
-    uint8_t probe_dist = 0;
-    
-    HashEntry entry = {key, value, HT_OCCUPIED, 0, 0};
-    
+/* Slot index of key, or SIZE_MAX */
+HT_INLINE size_t find_slot(const HashTable* table, int64_t key, uint64_t hash) {
+    int8_t h2 = ht_h2(hash);
+    ProbeSeq seq = probe_start(table, hash);
+
     while (true) {
-        HashEntry* slot = &table->entries[idx];
-        
-        if (slot->state != HT_OCCUPIED) {
-            /* Empty or deleted slot - insert here */
-            entry.probe_dist = probe_dist;
-            *slot = entry;
-            table->size++;
-            if (probe_dist > table->max_probe) {
-                table->max_probe = probe_dist;
+        const int8_t* group = table->ctrl + seq.pos;
+        ht_bitmask match = ht_group_match(group, h2);
+        while (match) {
+            size_t idx = (seq.pos + ht_lowest_bit(match)) & table->mask;
+            if (HT_LIKELY(table->entries[idx].key == key)) {
+                return idx;
             }
-            return true;
+            match &= match - 1;
         }
-        
-        if (slot->key == key) {
-            /* Update existing */
-            slot->value = value;
-            return true;
+        if (HT_LIKELY(ht_group_match_empty(group))) {
+            return SIZE_MAX;
         }
-        
-        /* Robin Hood: if we've probed further than existing entry, swap */
-        if (probe_dist > slot->probe_dist) {
-            HashEntry tmp = *slot;
-            entry.probe_dist = probe_dist;
-            *slot = entry;
-            entry = tmp;
-            probe_dist = tmp.probe_dist;
+        probe_next(&seq, table->mask);
+    }
+}
+
+/* First EMPTY or DELETED slot on key's probe sequence */
+HT_INLINE size_t find_free_slot(const HashTable* table, uint64_t hash) {
+    ProbeSeq seq = probe_start(table, hash);
+
+    while (true) {
+        ht_bitmask free_slots = ht_group_match_free(table->ctrl + seq.pos);
+        if (HT_LIKELY(free_slots)) {
+            return (seq.pos + ht_lowest_bit(free_slots)) & table->mask;
         }
-        
-        /* Continue probing */
-        idx = (idx + 1) & table->mask;
-        probe_dist++;
-        
-        /* Safety check */
-        if (HT_UNLIKELY(probe_dist > 255)) {
-            return false;
+        probe_next(&seq, table->mask);
+    }
+}
+
+/* Fills free slot idx with a known-absent key */
+HT_INLINE void place_at(HashTable* table, size_t idx, int64_t key, size_t value, uint64_t hash) {
+    if (table->ctrl[idx] == HT_CTRL_DELETED) {
+        table->tombstones--;
+    } else {
+        table->growth_left--;
+    }
+    set_ctrl(table, idx, ht_h2(hash));
+    table->entries[idx].key = key;
+    table->entries[idx].value = value;
+    table->size++;
+}
+
+static bool hash_table_resize(HashTable* table, size_t new_capacity) {
+    int8_t* old_ctrl = table->ctrl;
+    HashEntry* old_entries = table->entries;
+    size_t old_capacity = table->capacity;
+
+    if (HT_UNLIKELY(!alloc_arrays(table, new_capacity))) {
+        return false;
+    }
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_ctrl[i] >= 0) {
+            uint64_t hash = ht_hash(old_entries[i].key);
+            place_at(table, find_free_slot(table, hash),
+                     old_entries[i].key, old_entries[i].value, hash);
         }
     }
+
+    free(old_ctrl);
+    free(old_entries);
+    return true;
 }
 
 /* ============================================================================
@@ -112,133 +154,109 @@ static bool robin_hood_insert(HashTable* table, int64_t key, size_t value) {
 HashTable* hash_table_create(size_t initial_capacity) {
     HashTable* table = (HashTable*)malloc(sizeof(HashTable));
     if (HT_UNLIKELY(!table)) return NULL;
-    
-    size_t capacity = next_power_of_2(initial_capacity > INITIAL_CAPACITY ? 
+
+    size_t capacity = next_power_of_2(initial_capacity > INITIAL_CAPACITY ?
                                        initial_capacity : INITIAL_CAPACITY);
-    
-    table->entries = (HashEntry*)calloc(capacity, sizeof(HashEntry));
-    if (HT_UNLIKELY(!table->entries)) {
+    if (capacity < HT_GROUP_WIDTH) capacity = HT_GROUP_WIDTH;
+
+    if (HT_UNLIKELY(!alloc_arrays(table, capacity))) {
         free(table);
         return NULL;
     }
-    
-    table->capacity = capacity;
-    table->mask = capacity - 1;
-    table->size = 0;
-    table->tombstones = 0;
-    table->max_probe = 0;
-    
+
     return table;
 }
 
 void hash_table_destroy(HashTable* table) {
     if (!table) return;
+    free(table->ctrl);
     free(table->entries);
     free(table);
 }
 
 bool hash_table_insert(HashTable* table, int64_t key, size_t value) {
     if (HT_UNLIKELY(!table)) return false;
-    
-    /* Check if resize needed */
-    double load = (double)(table->size + table->tombstones + 1) / table->capacity;
-    if (load > LOAD_FACTOR_MAX) {
-        if (!hash_table_resize(table, table->capacity * 2)) {
+
+    uint64_t hash = ht_hash(key);
+    size_t idx = find_slot(table, key, hash);
+    if (idx != SIZE_MAX) {
+        /* Update existing */
+        table->entries[idx].value = value;
+        return true;
+    }
+
+    idx = find_free_slot(table, hash);
+    if (HT_UNLIKELY(table->growth_left == 0 && table->ctrl[idx] != HT_CTRL_DELETED)) {
+        /* Mostly tombstones: rehash in place size; else double */
+        size_t new_capacity = table->size + 1 > max_fill(table->capacity) / 2 ?
+                              table->capacity * 2 : table->capacity;
+        if (!hash_table_resize(table, new_capacity)) {
             return false;
         }
+        idx = find_free_slot(table, hash);
     }
-    
-    return robin_hood_insert(table, key, value);
+
+    place_at(table, idx, key, value, hash);
+    return true;
 }
 
 bool hash_table_lookup(const HashTable* table, int64_t key, size_t* out_value) {
     if (HT_UNLIKELY(!table)) return false;
-    
-    uint64_t hash = ht_hash(key);
-    size_t idx = ht_index(hash, table->mask);
-    uint8_t probe_dist = 0;
-    
-    while (probe_dist <= table->max_probe) {
-        const HashEntry* slot = &table->entries[idx];
-        
-        if (slot->state == HT_EMPTY) {
-            return false;
-        }
-        
-        if (slot->state == HT_OCCUPIED && slot->key == key) {
-            if (out_value) *out_value = slot->value;
-            return true;
-        }
-        
-        /* Robin Hood optimization: if probe_dist > slot's probe, key doesn't exist */
-        if (slot->state == HT_OCCUPIED && probe_dist > slot->probe_dist) {
-            return false;
-        }
-        
-        idx = (idx + 1) & table->mask;
-        probe_dist++;
+
+    size_t idx = find_slot(table, key, ht_hash(key));
+    if (idx == SIZE_MAX) {
+        return false;
     }
-    
-    return false;
+    if (out_value) *out_value = table->entries[idx].value;
+    return true;
 }
 
 bool hash_table_remove(HashTable* table, int64_t key) {
     if (HT_UNLIKELY(!table)) return false;
-    
-    uint64_t hash = ht_hash(key);
-    size_t idx = ht_index(hash, table->mask);
-    uint8_t probe_dist = 0;
-    
-    while (probe_dist <= table->max_probe) {
-        HashEntry* slot = &table->entries[idx];
-        
-        if (slot->state == HT_EMPTY) {
-            return false;
-        }
-        
-        if (slot->state == HT_OCCUPIED && slot->key == key) {
-            /* Use backward shift deletion for Robin Hood */
-            size_t curr = idx;
-            while (true) {
-                size_t next = (curr + 1) & table->mask;
-                HashEntry* next_slot = &table->entries[next];
-                
-                if (next_slot->state != HT_OCCUPIED || next_slot->probe_dist == 0) {
-                    table->entries[curr].state = HT_EMPTY;
-                    break;
-                }
-                
-                /* Shift back */
-                table->entries[curr] = *next_slot;
-                table->entries[curr].probe_dist--;
-                curr = next;
-            }
-            
-            table->size--;
-            return true;
-        }
-        
-        if (slot->state == HT_OCCUPIED && probe_dist > slot->probe_dist) {
-            return false;
-        }
-        
-        idx = (idx + 1) & table->mask;
-        probe_dist++;
+
+    size_t idx = find_slot(table, key, ht_hash(key));
+    if (idx == SIZE_MAX) {
+        return false;
     }
-    
-    return false;
+
+    /*
+     * A slot can go back to EMPTY only if no probe ever walked a full group
+     * across it: i.e. the run of full slots through idx is shorter than a
+     * group. Otherwise leave a tombstone so later keys are still found.
+     */
+    size_t before = (idx - HT_GROUP_WIDTH) & table->mask;
+    ht_bitmask empty_before = ht_group_match_empty(table->ctrl + before);
+    ht_bitmask empty_after = ht_group_match_empty(table->ctrl + idx);
+    bool was_never_full = empty_before && empty_after &&
+        ht_lowest_bit(empty_after) + ht_leading_zeros(empty_before) < HT_GROUP_WIDTH;
+
+    if (was_never_full) {
+        set_ctrl(table, idx, HT_CTRL_EMPTY);
+        table->growth_left++;
+    } else {
+        set_ctrl(table, idx, HT_CTRL_DELETED);
+        table->tombstones++;
+    }
+    table->size--;
+    return true;
 }
 
 size_t hash_table_size(const HashTable* table) {
     return table ? table->size : 0;
 }
 
+size_t hash_table_memory_bytes(const HashTable* table) {
+    if (!table) return 0;
+    return sizeof(HashTable) + table->capacity + HT_GROUP_WIDTH +
+           table->capacity * sizeof(HashEntry);
+}
+
 void hash_table_clear(HashTable* table) {
     if (!table) return;
-    memset(table->entries, 0, table->capacity * sizeof(HashEntry));
+    memset(table->ctrl, (unsigned char)HT_CTRL_EMPTY, table->capacity + HT_GROUP_WIDTH);
     table->size = 0;
     table->tombstones = 0;
-    table->max_probe = 0;
+    table->growth_left = max_fill(table->capacity);
 }
 
 HashTableIterator hash_table_iterator(const HashTable* table) {
@@ -248,17 +266,15 @@ HashTableIterator hash_table_iterator(const HashTable* table) {
 
 bool hash_table_next(HashTableIterator* iter, int64_t* out_key, size_t* out_value) {
     if (!iter || !iter->table) return false;
-    
+
     while (iter->index < iter->table->capacity) {
-        const HashEntry* entry = &iter->table->entries[iter->index];
-        iter->index++;
-        
-        if (entry->state == HT_OCCUPIED) {
-            if (out_key) *out_key = entry->key;
-            if (out_value) *out_value = entry->value;
+        size_t i = iter->index++;
+        if (iter->table->ctrl[i] >= 0) {
+            if (out_key) *out_key = iter->table->entries[i].key;
+            if (out_value) *out_value = iter->table->entries[i].value;
             return true;
         }
     }
-    
+
     return false;
 }
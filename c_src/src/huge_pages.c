@@ -0,0 +1,86 @@
+/**
+ * @file huge_pages.c
+ * @brief 2 MB page-backed memory regions for node pools
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE     /* MAP_ANONYMOUS, MAP_HUGETLB, MADV_HUGEPAGE */
+#endif
+
+#include "../include/huge_pages.h"
+#include "../include/atomics.h"
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+static atomic_size g_mode = AVL_HUGE_PAGES_OFF;
+static atomic_size g_explicit_regions = 0;
+static atomic_size g_transparent_regions = 0;
+static atomic_size g_fallbacks = 0;
+
+void avl_huge_pages_set_mode(AVLHugePageMode mode) {
+    atomic_store_size(&g_mode, (size_t)mode);
+}
+
+AVLHugePageMode avl_huge_pages_get_mode(void) {
+    return (AVLHugePageMode)atomic_load_size(&g_mode);
+}
+
+void avl_huge_pages_get_stats(AVLHugePageStats* stats) {
+    if (!stats) return;
+    stats->explicit_regions = atomic_load_size(&g_explicit_regions);
+    stats->transparent_regions = atomic_load_size(&g_transparent_regions);
+    stats->fallbacks = atomic_load_size(&g_fallbacks);
+}
+
+void* avl_huge_region_alloc(AVLHugePageMode mode) {
+    if (mode == AVL_HUGE_PAGES_OFF) return NULL;
+
+#if defined(__linux__)
+#ifdef MAP_HUGETLB
+    if (mode == AVL_HUGE_PAGES_EXPLICIT) {
+        void* p = mmap(NULL, AVL_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            atomic_increment_size(&g_explicit_regions);
+            return p;
+        }
+        atomic_increment_size(&g_fallbacks);
+    }
+#endif
+
+    /* Over-map by one huge page and trim to an aligned window */
+    size_t span = 2 * AVL_HUGE_PAGE_SIZE;
+    void* raw = mmap(NULL, span, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        atomic_increment_size(&g_fallbacks);
+        return NULL;
+    }
+
+    uintptr_t start = (uintptr_t)raw;
+    uintptr_t aligned = (start + AVL_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(AVL_HUGE_PAGE_SIZE - 1);
+    uintptr_t tail = aligned + AVL_HUGE_PAGE_SIZE;
+    if (aligned > start) munmap(raw, aligned - start);
+    if (start + span > tail) munmap((void*)tail, start + span - tail);
+
+#ifdef MADV_HUGEPAGE
+    madvise((void*)aligned, AVL_HUGE_PAGE_SIZE, MADV_HUGEPAGE);
+#endif
+    atomic_increment_size(&g_transparent_regions);
+    return (void*)aligned;
+#else
+    atomic_increment_size(&g_fallbacks);
+    return NULL;
+#endif
+}
+
+void avl_huge_region_free(void* region) {
+#if defined(__linux__)
+    if (region) munmap(region, AVL_HUGE_PAGE_SIZE);
+#else
+    (void)region;
+#endif
+}
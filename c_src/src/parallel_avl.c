@@ -4,6 +4,7 @@
  */
 
 #include "../include/parallel_avl.h"
+#include "../include/worker_pool.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -12,13 +13,253 @@
  * Internal Helpers
  * ============================================================================ */
 
-/* Compare function for qsort on AVLKeyValue */
-static int kv_compare(const void* a, const void* b) {
-    const AVLKeyValue* ka = (const AVLKeyValue*)a;
-    const AVLKeyValue* kb = (const AVLKeyValue*)b;
-    if (ka->key < kb->key) return -1;
-    if (ka->key > kb->key) return 1;
-    return 0;
+PAVL_INLINE size_t bytes_natural_shard(const ParallelAVL* tree, const void* key, size_t len) {
+    return (size_t)(pavl_hash_bytes(key, len) % tree->num_shards);
+}
+
+/* Re-inserts a detached byte-key tree at each key's current natural shard */
+static bool bytes_rehome_callback(const void* key, size_t len, void* value, void* ctx) {
+    ParallelAVL* tree = (ParallelAVL*)ctx;
+    size_t target = bytes_natural_shard(tree, key, len);
+    if (shard_insert_bytes(tree->shards[target], key, len, value)) {
+        router_record_insertion(tree->router, target);
+    }
+    return true;
+}
+
+static void bytes_rehome(ParallelAVL* tree, AVLBytesTree* detached) {
+    if (!detached) return;
+    avl_bytes_tree_foreach(detached, bytes_rehome_callback, tree);
+    avl_bytes_tree_destroy(detached);
+}
+
+static void redistribute_keys(ParallelAVL* tree, const AVLKeyValue* items, size_t n);
+
+/* ============================================================================
+ * Ring Placement
+ * ============================================================================ */
+
+/* Shard a key belongs on right now */
+PAVL_INLINE size_t home_shard(const ParallelAVL* tree, uint64_t hash) {
+    if (PAVL_UNLIKELY(tree->ring)) {
+        return router_ring_shard(tree->router, hash);
+    }
+    return (size_t)(hash % tree->num_shards);
+}
+
+/* Previous owner that may still hold the key during a migration, or SIZE_MAX */
+PAVL_INLINE size_t ring_stale_shard(ParallelAVL* tree, uint64_t hash, size_t home) {
+    if (PAVL_LIKELY(!tree->ring || !atomic_load_bool(&tree->migrating))) {
+        return SIZE_MAX;
+    }
+    size_t prev = router_ring_shard(tree->migration.prev_router, hash);
+    if (prev == home || !atomic_load_bool(&tree->migration.pending[prev])) {
+        return SIZE_MAX;
+    }
+    return prev;
+}
+
+/*
+ * Lazy migration on access, after a miss in home. stale must have been read
+ * before that miss: a key that left stale since then is found in home here,
+ * because both shards are checked under both locks.
+ */
+static bool ring_move_on_access(ParallelAVL* tree, int64_t key, size_t stale, size_t home,
+                                void** out_value) {
+    if (stale == SIZE_MAX) return false;
+    
+    switch (shard_move_key(tree->shards[stale], tree->shards[home], key, out_value)) {
+        case SHARD_MOVE_ABSENT:
+            return false;
+        case SHARD_MOVE_MOVED:
+            router_record_insertion(tree->router, home);
+            /* fall through */
+        case SHARD_MOVE_DROPPED:
+            atomic_increment_size(&tree->migration.moved_keys);
+            router_record_removal(tree->router, stale);
+            break;
+        case SHARD_MOVE_IN_DST:
+            break;
+    }
+    return true;
+}
+
+/* Drops the copy a write to home has superseded */
+PAVL_INLINE void ring_drop_stale(ParallelAVL* tree, int64_t key, uint64_t hash, size_t home) {
+    size_t stale = ring_stale_shard(tree, hash, home);
+    if (PAVL_UNLIKELY(stale != SIZE_MAX) && shard_remove(tree->shards[stale], key)) {
+        router_record_removal(tree->router, stale);
+    }
+}
+
+static void ring_migration_reset(ParallelAVL* tree) {
+    atomic_store_bool(&tree->migrating, false);
+    router_destroy(tree->migration.prev_router);
+    free(tree->migration.pending);
+    free(tree->migration.cursors);
+    tree->migration.prev_router = NULL;
+    tree->migration.pending = NULL;
+    tree->migration.cursors = NULL;
+    tree->migration.num_sources = 0;
+    tree->migration.next_source = 0;
+}
+
+/* New ring router for num_shards, carrying over the old per-shard loads */
+static Router* ring_router_resize(const Router* old, size_t num_shards) {
+    Router* router = router_create(num_shards, ROUTER_CONSISTENT_HASH);
+    if (!router) return NULL;
+    size_t common = old->num_shards < num_shards ? old->num_shards : num_shards;
+    for (size_t i = 0; i < common; i++) {
+        atomic_store_size(&router->shard_loads[i],
+                          atomic_load_size(&((Router*)old)->shard_loads[i]));
+    }
+    return router;
+}
+
+/* Byte keys are placed by modulo: re-place them all after a resize */
+static void bytes_rehome_all(ParallelAVL* tree, size_t num_shards) {
+    AVLBytesTree** detached = (AVLBytesTree**)malloc(num_shards * sizeof(AVLBytesTree*));
+    if (!detached) return;
+    for (size_t i = 0; i < num_shards; i++) {
+        detached[i] = shard_detach_bytes(tree->shards[i]);
+    }
+    for (size_t i = 0; i < num_shards; i++) {
+        bytes_rehome(tree, detached[i]);
+    }
+    free(detached);
+}
+
+static bool ring_add_shard(ParallelAVL* tree) {
+    /* One migration at a time: settle the previous one */
+    parallel_avl_migrate_step(tree, SIZE_MAX);
+    
+    size_t old_count = tree->num_shards;
+    TreeShard* new_shard = shard_create();
+    Router* router = ring_router_resize(tree->router, old_count + 1);
+    atomic_bool_t* pending = (atomic_bool_t*)malloc(old_count * sizeof(atomic_bool_t));
+    int64_t* cursors = (int64_t*)malloc(old_count * sizeof(int64_t));
+    TreeShard** shards = new_shard && router && pending && cursors ?
+        (TreeShard**)realloc(tree->shards, (old_count + 1) * sizeof(TreeShard*)) : NULL;
+    if (!shards) {
+        shard_destroy(new_shard);
+        router_destroy(router);
+        free(pending);
+        free(cursors);
+        return false;
+    }
+    
+    /*
+     * The new shard's vnode at hash h takes over the arc ending at h, which
+     * the old ring gave to router_ring_shard(old, h). Only those owners
+     * have keys to hand over.
+     */
+    for (size_t i = 0; i < old_count; i++) {
+        atomic_store_bool(&pending[i], false);
+        cursors[i] = INT64_MIN;
+    }
+    for (size_t v = 0; v < router->num_virtual_nodes; v++) {
+        if (router->virtual_nodes[v].shard_id == old_count) {
+            size_t prev = router_ring_shard(tree->router, router->virtual_nodes[v].hash_value);
+            atomic_store_bool(&pending[prev], true);
+        }
+    }
+    
+    ring_migration_reset(tree);
+    tree->shards = shards;
+    tree->shards[old_count] = new_shard;
+    tree->num_shards = old_count + 1;
+    tree->migration.prev_router = tree->router;
+    tree->migration.pending = pending;
+    tree->migration.cursors = cursors;
+    tree->migration.num_sources = old_count;
+    tree->router = router;
+    atomic_store_bool(&tree->migrating, true);
+    
+    bytes_rehome_all(tree, old_count);
+    return true;
+}
+
+static bool ring_remove_shard(ParallelAVL* tree) {
+    parallel_avl_migrate_step(tree, SIZE_MAX);
+    
+    size_t removing_id = tree->num_shards - 1;
+    Router* router = ring_router_resize(tree->router, removing_id);
+    if (!router) return false;
+    
+    size_t redistribute_count = 0;
+    AVLKeyValue* to_redistribute = shard_extract_all_alloc(tree->shards[removing_id],
+                                                           &redistribute_count);
+    if (!to_redistribute) {
+        router_destroy(router);
+        return false;
+    }
+    AVLBytesTree* bytes_to_redistribute = shard_detach_bytes(tree->shards[removing_id]);
+    
+    shard_destroy(tree->shards[removing_id]);
+    tree->num_shards--;
+    router_destroy(tree->router);
+    tree->router = router;
+    
+    /* Only the removed shard's arcs change owner: nothing else moves */
+    redistribute_keys(tree, to_redistribute, redistribute_count);
+    free(to_redistribute);
+    
+    bytes_rehome_all(tree, tree->num_shards);
+    bytes_rehome(tree, bytes_to_redistribute);
+    return true;
+}
+
+size_t parallel_avl_migrate_step(ParallelAVL* tree, size_t max_keys) {
+    if (!tree || !atomic_load_bool(&tree->migrating)) return 0;
+    
+    RingMigration* m = &tree->migration;
+    AVLKeyValue batch[PAVL_RANGE_BATCH];
+    size_t scanned = 0, moved = 0;
+    
+    while (scanned < max_keys && m->next_source < m->num_sources) {
+        size_t src = m->next_source;
+        if (!atomic_load_bool(&m->pending[src])) {
+            m->next_source++;
+            continue;
+        }
+        
+        size_t want = max_keys - scanned < PAVL_RANGE_BATCH ? max_keys - scanned
+                                                             : PAVL_RANGE_BATCH;
+        size_t count = 0;
+        shard_range_query(tree->shards[src], m->cursors[src], INT64_MAX, batch, want, &count);
+        
+        for (size_t i = 0; i < count; i++) {
+            size_t home = home_shard(tree, pavl_hash(batch[i].key));
+            if (home == src) continue;
+            switch (shard_move_key(tree->shards[src], tree->shards[home], batch[i].key, NULL)) {
+                case SHARD_MOVE_MOVED:
+                    router_record_insertion(tree->router, home);
+                    /* fall through */
+                case SHARD_MOVE_DROPPED:
+                    router_record_removal(tree->router, src);
+                    moved++;
+                    break;
+                case SHARD_MOVE_ABSENT:
+                case SHARD_MOVE_IN_DST:
+                    break;
+            }
+        }
+        scanned += count;
+        
+        if (count < want || batch[count - 1].key == INT64_MAX) {
+            atomic_store_bool(&m->pending[src], false);
+            m->next_source++;
+        } else {
+            m->cursors[src] = batch[count - 1].key + 1;
+        }
+    }
+    
+    atomic_fetch_add_size(&m->moved_keys, moved);
+    if (m->next_source >= m->num_sources) {
+        /* prev_router stays until the next resize: readers may still use it */
+        atomic_store_bool(&tree->migrating, false);
+    }
+    return moved;
 }
 
 /* ============================================================================
@@ -37,6 +278,10 @@ ParallelAVL* parallel_avl_create(size_t num_shards, RouterStrategy strategy) {
     atomic_store_bool(&tree->topology_changed, false);
     atomic_store_bool(&tree->has_redirects, false);
     
+    /* Consistent hashing places keys on the ring instead of hash % n */
+    tree->ring = strategy == ROUTER_CONSISTENT_HASH;
+    atomic_store_bool(&tree->migrating, false);
+    
     /* Allocate shard array */
     tree->shards = (TreeShard**)malloc(num_shards * sizeof(TreeShard*));
     if (PAVL_UNLIKELY(!tree->shards)) {
@@ -88,6 +333,7 @@ void parallel_avl_destroy(ParallelAVL* tree) {
     
     redirect_index_destroy(tree->redirect_index);
     router_destroy(tree->router);
+    ring_migration_reset(tree);
     
     for (size_t i = 0; i < tree->num_shards; i++) {
         shard_destroy(tree->shards[i]);
@@ -103,7 +349,7 @@ void PAVL_HOT parallel_avl_insert(ParallelAVL* tree, int64_t key, void* value) {
     
     /* Calculate natural and target shards */
     uint64_t hash = pavl_hash(key);
-    size_t natural_shard = (size_t)(hash % tree->num_shards);
+    size_t natural_shard = home_shard(tree, hash);
     size_t target_shard = router_route(tree->router, key);
     
     /* Capture size before insert */
@@ -123,6 +369,8 @@ void PAVL_HOT parallel_avl_insert(ParallelAVL* tree, int64_t key, void* value) {
             atomic_store_bool(&tree->has_redirects, true);
         }
     }
+    
+    ring_drop_stale(tree, key, hash, natural_shard);
 }
 
 bool PAVL_HOT parallel_avl_contains(ParallelAVL* tree, int64_t key) {
@@ -130,12 +378,18 @@ bool PAVL_HOT parallel_avl_contains(ParallelAVL* tree, int64_t key) {
     
     /* Fast path: search in natural shard (common case) */
     uint64_t hash = pavl_hash(key);
-    size_t natural_shard = (size_t)(hash % tree->num_shards);
+    size_t natural_shard = home_shard(tree, hash);
+    /* Read before the home lookup (see ring_move_on_access) */
+    size_t stale = ring_stale_shard(tree, hash, natural_shard);
     
     if (PAVL_LIKELY(shard_contains(tree->shards[natural_shard], key))) {
         return true;
     }
     
+    if (PAVL_UNLIKELY(tree->ring)) {
+        return ring_move_on_access(tree, key, stale, natural_shard, NULL);
+    }
+    
     /* Quick exit if no redirects and no topology changes */
     bool has_redirects = atomic_load_bool(&tree->has_redirects);
     bool topology_changed = atomic_load_bool(&tree->topology_changed);
@@ -174,7 +428,9 @@ void* PAVL_HOT parallel_avl_get(ParallelAVL* tree, int64_t key, bool* found) {
     
     /* Fast path: search in natural shard */
     uint64_t hash = pavl_hash(key);
-    size_t natural_shard = (size_t)(hash % tree->num_shards);
+    size_t natural_shard = home_shard(tree, hash);
+    /* Read before the home lookup (see ring_move_on_access) */
+    size_t stale = ring_stale_shard(tree, hash, natural_shard);
     
     bool shard_found = false;
     void* result = shard_get(tree->shards[natural_shard], key, &shard_found);
@@ -184,6 +440,14 @@ void* PAVL_HOT parallel_avl_get(ParallelAVL* tree, int64_t key, bool* found) {
         return result;
     }
     
+    if (PAVL_UNLIKELY(tree->ring)) {
+        result = NULL;
+        if (ring_move_on_access(tree, key, stale, natural_shard, &result) && found) {
+            *found = true;
+        }
+        return result;
+    }
+    
     /* Quick exit if no redirects and no topology changes */
     bool has_redirects = atomic_load_bool(&tree->has_redirects);
     bool topology_changed = atomic_load_bool(&tree->topology_changed);
@@ -218,6 +482,146 @@ void* PAVL_HOT parallel_avl_get(ParallelAVL* tree, int64_t key, bool* found) {
     return NULL;
 }
 
+/* ============================================================================
+ * Batched Operations
+ *
+ * A batch is grouped by shard with a stable counting sort, so every shard
+ * is locked once and keys for one shard keep their relative order (the
+ * last duplicate wins, as with single inserts).
+ * ============================================================================ */
+
+typedef struct ShardBatch {
+    size_t* shard_of;           /* caller index -> shard */
+    size_t* start;              /* num_shards + 1 group offsets */
+    size_t* order;              /* grouped position -> caller index */
+    int64_t* keys;              /* grouped keys */
+    void** values;              /* grouped values / results */
+    bool* flags;                /* grouped found / inserted */
+} ShardBatch;
+
+static bool shard_batch_alloc(ShardBatch* b, size_t n, size_t num_shards) {
+    /* keys first: the strictest alignment */
+    char* mem = (char*)malloc(n * (sizeof(int64_t) + 2 * sizeof(size_t) + sizeof(void*) +
+                                   sizeof(bool)) + (num_shards + 1) * sizeof(size_t));
+    if (!mem) return false;
+    b->keys = (int64_t*)mem;
+    b->shard_of = (size_t*)(b->keys + n);
+    b->order = b->shard_of + n;
+    b->values = (void**)(b->order + n);
+    b->start = (size_t*)(b->values + n);
+    b->flags = (bool*)(b->start + num_shards + 1);
+    return true;
+}
+
+/* Groups keys (and values, if any) by b->shard_of */
+static void shard_batch_group(ShardBatch* b, const int64_t* keys, void* const* values,
+                              size_t n, size_t num_shards) {
+    memset(b->start, 0, (num_shards + 1) * sizeof(size_t));
+    for (size_t i = 0; i < n; i++) {
+        b->start[b->shard_of[i] + 1]++;
+    }
+    for (size_t s = 0; s < num_shards; s++) {
+        b->start[s + 1] += b->start[s];
+    }
+    for (size_t i = 0; i < n; i++) {
+        size_t pos = b->start[b->shard_of[i]]++;
+        b->order[pos] = i;
+        b->keys[pos] = keys[i];
+        b->values[pos] = values ? values[i] : NULL;
+    }
+    /* The fill pass advanced each start to the next group's start */
+    for (size_t s = num_shards; s > 0; s--) {
+        b->start[s] = b->start[s - 1];
+    }
+    b->start[0] = 0;
+}
+
+size_t parallel_avl_get_many(ParallelAVL* tree, const int64_t* keys, size_t n,
+                             void** out_values, bool* out_found) {
+    if (!tree || !keys || !out_found || n == 0) return 0;
+
+    size_t num_shards = tree->num_shards;
+    ShardBatch b;
+    if (!shard_batch_alloc(&b, n, num_shards)) return 0;
+
+    /* Branch-free hashing loop over the whole batch */
+    for (size_t i = 0; i < n; i++) {
+        b.shard_of[i] = home_shard(tree, pavl_hash(keys[i]));
+    }
+    shard_batch_group(&b, keys, NULL, n, num_shards);
+
+    size_t hits = 0;
+    for (size_t s = 0; s < num_shards; s++) {
+        size_t first = b.start[s], count = b.start[s + 1] - first;
+        if (count == 0) continue;
+        hits += shard_get_many(tree->shards[s], b.keys + first, count,
+                               b.values + first, b.flags + first);
+    }
+    for (size_t j = 0; j < n; j++) {
+        size_t i = b.order[j];
+        out_found[i] = b.flags[j];
+        if (out_values) out_values[i] = b.values[j];
+    }
+    free(b.keys);
+
+    /* Misses may live outside their natural shard: single-key slow path */
+    if (hits < n && (atomic_load_bool(&tree->has_redirects) ||
+                     atomic_load_bool(&tree->topology_changed) ||
+                     atomic_load_bool(&tree->migrating))) {
+        for (size_t i = 0; i < n; i++) {
+            if (out_found[i]) continue;
+            void* value = parallel_avl_get(tree, keys[i], &out_found[i]);
+            if (out_values) out_values[i] = value;
+            hits += out_found[i];
+        }
+    }
+    return hits;
+}
+
+size_t parallel_avl_insert_many(ParallelAVL* tree, const int64_t* keys,
+                                void* const* values, size_t n) {
+    if (!tree || !keys || n == 0) return 0;
+
+    size_t num_shards = tree->num_shards;
+    ShardBatch b;
+    if (!shard_batch_alloc(&b, n, num_shards)) return 0;
+
+    atomic_fetch_add_size(&tree->total_ops, n);
+
+    /* Routed up front: load-aware decisions see the load before the batch */
+    for (size_t i = 0; i < n; i++) {
+        b.shard_of[i] = router_route(tree->router, keys[i]);
+    }
+    shard_batch_group(&b, keys, values, n, num_shards);
+
+    size_t added = 0;
+    for (size_t s = 0; s < num_shards; s++) {
+        size_t first = b.start[s], count = b.start[s + 1] - first;
+        if (count == 0) continue;
+        added += shard_insert_many(tree->shards[s], b.keys + first, b.values + first,
+                                   count, b.flags + first);
+
+        for (size_t j = first; j < first + count; j++) {
+            if (!b.flags[j]) continue;
+            router_record_insertion(tree->router, s);
+
+            size_t natural_shard = home_shard(tree, pavl_hash(b.keys[j]));
+            if (PAVL_UNLIKELY(s != natural_shard)) {
+                redirect_index_record(tree->redirect_index, b.keys[j], natural_shard, s);
+                atomic_store_bool(&tree->has_redirects, true);
+            }
+        }
+    }
+    if (PAVL_UNLIKELY(atomic_load_bool(&tree->migrating))) {
+        for (size_t i = 0; i < n; i++) {
+            uint64_t hash = pavl_hash(keys[i]);
+            ring_drop_stale(tree, keys[i], hash, home_shard(tree, hash));
+        }
+    }
+    free(b.keys);
+    return added;
+}
+
 bool parallel_avl_remove(ParallelAVL* tree, int64_t key) {
     if (PAVL_UNLIKELY(!tree)) return false;
     
@@ -225,7 +629,19 @@ bool parallel_avl_remove(ParallelAVL* tree, int64_t key) {
     
     /* Try natural shard first */
     uint64_t hash = pavl_hash(key);
-    size_t natural_shard = (size_t)(hash % tree->num_shards);
+    size_t natural_shard = home_shard(tree, hash);
+    
+    /* Mid-migration the key may be moving from its old owner to home:
+     * remove from both under both locks so it cannot slip between them */
+    size_t stale = ring_stale_shard(tree, hash, natural_shard);
+    if (PAVL_UNLIKELY(stale != SIZE_MAX)) {
+        bool in_home = false, in_stale = false;
+        shard_remove_either(tree->shards[natural_shard], tree->shards[stale], key,
+                            &in_home, &in_stale);
+        if (in_home) router_record_removal(tree->router, natural_shard);
+        if (in_stale) router_record_removal(tree->router, stale);
+        return in_home || in_stale;
+    }
     
     if (shard_remove(tree->shards[natural_shard], key)) {
         router_record_removal(tree->router, natural_shard);
@@ -233,6 +649,10 @@ bool parallel_avl_remove(ParallelAVL* tree, int64_t key) {
         return true;
     }
     
+    if (PAVL_UNLIKELY(tree->ring)) {
+        return false;
+    }
+    
     /* Check redirected shard */
     size_t redirected_shard;
     if (redirect_index_lookup(tree->redirect_index, key, &redirected_shard)) {
@@ -257,46 +677,268 @@ bool parallel_avl_remove(ParallelAVL* tree, int64_t key) {
     return false;
 }
 
-void parallel_avl_range_query(ParallelAVL* tree, int64_t lo, int64_t hi,
-                               AVLKeyValue* out_array, size_t max_results,
-                               size_t* out_count) {
-    if (!tree || !out_array || !out_count) return;
+/* =========================================================================
+ * Byte-String Keys
+ * ========================================================================= */
+
+bool PAVL_HOT parallel_avl_insert_bytes(ParallelAVL* tree, const void* key, size_t len,
+                                        void* value) {
+    if (PAVL_UNLIKELY(!tree)) return false;
     
-    *out_count = 0;
     atomic_increment_size(&tree->total_ops);
+    size_t natural_shard = bytes_natural_shard(tree, key, len);
+    
+    /* After a resize the key may still sit in its old shard: update it there */
+    if (PAVL_UNLIKELY(atomic_load_bool(&tree->topology_changed))) {
+        for (size_t i = 0; i < tree->num_shards; i++) {
+            if (i == natural_shard) continue;
+            if (shard_contains_bytes(tree->shards[i], key, len)) {
+                shard_insert_bytes(tree->shards[i], key, len, value);
+                return false;
+            }
+        }
+    }
     
-    /* Temporary buffer to collect results */
-    size_t buffer_size = max_results * 2;
-    AVLKeyValue* buffer = (AVLKeyValue*)malloc(buffer_size * sizeof(AVLKeyValue));
-    if (!buffer) return;
+    if (shard_insert_bytes(tree->shards[natural_shard], key, len, value)) {
+        router_record_insertion(tree->router, natural_shard);
+        return true;
+    }
+    return false;
+}
+
+bool PAVL_HOT parallel_avl_contains_bytes(ParallelAVL* tree, const void* key, size_t len) {
+    if (PAVL_UNLIKELY(!tree)) return false;
     
-    size_t total_collected = 0;
+    size_t natural_shard = bytes_natural_shard(tree, key, len);
+    if (PAVL_LIKELY(shard_contains_bytes(tree->shards[natural_shard], key, len))) {
+        return true;
+    }
     
-    /* Query all shards that intersect the range */
+    if (PAVL_LIKELY(!atomic_load_bool(&tree->topology_changed))) {
+        return false;
+    }
     for (size_t i = 0; i < tree->num_shards; i++) {
-        if (shard_intersects_range(tree->shards[i], lo, hi)) {
-            size_t shard_count = 0;
-            size_t remaining = buffer_size - total_collected;
-            
-            shard_range_query(tree->shards[i], lo, hi,
-                              buffer + total_collected, remaining, &shard_count);
-            total_collected += shard_count;
-            
-            if (total_collected >= buffer_size) break;
+        if (i == natural_shard) continue;
+        if (shard_contains_bytes(tree->shards[i], key, len)) {
+            return true;
         }
     }
+    return false;
+}
+
+void* PAVL_HOT parallel_avl_get_bytes(ParallelAVL* tree, const void* key, size_t len,
+                                      bool* found) {
+    if (found) *found = false;
+    if (PAVL_UNLIKELY(!tree)) return NULL;
+    
+    size_t natural_shard = bytes_natural_shard(tree, key, len);
+    bool shard_found = false;
+    void* result = shard_get_bytes(tree->shards[natural_shard], key, len, &shard_found);
+    
+    if (PAVL_LIKELY(shard_found)) {
+        if (found) *found = true;
+        return result;
+    }
     
-    /* Sort results */
-    if (total_collected > 0) {
-        qsort(buffer, total_collected, sizeof(AVLKeyValue), kv_compare);
+    if (PAVL_LIKELY(!atomic_load_bool(&tree->topology_changed))) {
+        return NULL;
+    }
+    for (size_t i = 0; i < tree->num_shards; i++) {
+        if (i == natural_shard) continue;
+        result = shard_get_bytes(tree->shards[i], key, len, &shard_found);
+        if (shard_found) {
+            if (found) *found = true;
+            return result;
+        }
     }
+    return NULL;
+}
+
+bool parallel_avl_remove_bytes(ParallelAVL* tree, const void* key, size_t len) {
+    if (PAVL_UNLIKELY(!tree)) return false;
     
-    /* Copy to output (limited by max_results) */
-    size_t copy_count = total_collected < max_results ? total_collected : max_results;
-    memcpy(out_array, buffer, copy_count * sizeof(AVLKeyValue));
-    *out_count = copy_count;
+    atomic_increment_size(&tree->total_ops);
+    size_t natural_shard = bytes_natural_shard(tree, key, len);
     
-    free(buffer);
+    if (shard_remove_bytes(tree->shards[natural_shard], key, len)) {
+        router_record_removal(tree->router, natural_shard);
+        return true;
+    }
+    
+    if (atomic_load_bool(&tree->topology_changed)) {
+        for (size_t i = 0; i < tree->num_shards; i++) {
+            if (i == natural_shard) continue;
+            if (shard_remove_bytes(tree->shards[i], key, len)) {
+                router_record_removal(tree->router, i);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* ============================================================================
+ * Range Merge
+ *
+ * Each intersecting shard gets a cursor that pulls its keys in order, a
+ * batch at a time, under the shard lock (shard_range_query). A min-heap over
+ * the cursor heads merges them, so results stream out sorted with
+ * O(shards * batch) memory and no sort. Locks are never held across the
+ * caller's callback; each batch is a consistent slice of its shard.
+ * ============================================================================ */
+
+typedef struct RangeCursor {
+    TreeShard* shard;
+    AVLKeyValue* buf;
+    size_t count;
+    size_t pos;
+    int64_t next_lo;            /* where the next batch starts */
+    bool exhausted;             /* no keys beyond buf */
+} RangeCursor;
+
+typedef struct RangeMerge {
+    RangeCursor* cursors;
+    RangeCursor** heap;         /* min-heap on buf[pos].key */
+    size_t heap_size;
+    size_t batch;
+    int64_t hi;
+} RangeMerge;
+
+PAVL_INLINE int64_t cursor_key(const RangeCursor* c) {
+    return c->buf[c->pos].key;
+}
+
+/* Loads the next batch; false once the shard has nothing left in range */
+static bool cursor_fill(RangeCursor* c, int64_t hi, size_t batch) {
+    if (c->exhausted) return false;
+
+    shard_range_query(c->shard, c->next_lo, hi, c->buf, batch, &c->count);
+    c->pos = 0;
+    if (c->count < batch || c->buf[c->count - 1].key >= hi) {
+        c->exhausted = true;    /* also avoids next_lo overflow at INT64_MAX */
+    } else {
+        c->next_lo = c->buf[c->count - 1].key + 1;
+    }
+    return c->count > 0;
+}
+
+static void heap_sift_down(RangeMerge* m, size_t i) {
+    RangeCursor** heap = m->heap;
+    RangeCursor* item = heap[i];
+    int64_t key = cursor_key(item);
+
+    while (true) {
+        size_t child = 2 * i + 1;
+        if (child >= m->heap_size) break;
+        if (child + 1 < m->heap_size && cursor_key(heap[child + 1]) < cursor_key(heap[child])) {
+            child++;
+        }
+        if (cursor_key(heap[child]) >= key) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = item;
+}
+
+static bool range_merge_init(RangeMerge* m, ParallelAVL* tree, int64_t lo, int64_t hi,
+                             size_t batch) {
+    size_t n = tree->num_shards;
+    m->cursors = (RangeCursor*)malloc(n * (sizeof(RangeCursor) + sizeof(RangeCursor*)) +
+                                      n * batch * sizeof(AVLKeyValue));
+    if (!m->cursors) return false;
+    m->heap = (RangeCursor**)(m->cursors + n);
+    m->heap_size = 0;
+    m->batch = batch;
+    m->hi = hi;
+
+    AVLKeyValue* bufs = (AVLKeyValue*)(m->heap + n);
+    for (size_t i = 0; i < n; i++) {
+        if (!shard_intersects_range(tree->shards[i], lo, hi)) continue;
+
+        RangeCursor* c = &m->cursors[i];
+        c->shard = tree->shards[i];
+        c->buf = bufs + i * batch;
+        c->next_lo = lo;
+        c->exhausted = false;
+        if (cursor_fill(c, hi, batch)) {
+            m->heap[m->heap_size++] = c;
+        }
+    }
+    for (size_t i = m->heap_size / 2; i-- > 0;) {
+        heap_sift_down(m, i);
+    }
+    return true;
+}
+
+/* Pops the smallest entry and advances its cursor */
+PAVL_INLINE AVLKeyValue range_merge_pop(RangeMerge* m) {
+    RangeCursor* c = m->heap[0];
+    AVLKeyValue kv = c->buf[c->pos++];
+
+    if (c->pos == c->count && !cursor_fill(c, m->hi, m->batch)) {
+        m->heap[0] = m->heap[--m->heap_size];
+    }
+    if (m->heap_size > 0) {
+        heap_sift_down(m, 0);
+    }
+    return kv;
+}
+
+void parallel_avl_range_foreach(ParallelAVL* tree, int64_t lo, int64_t hi,
+                                AVLRangeCallback callback, void* ctx) {
+    if (!tree || !callback || lo > hi) return;
+
+    atomic_increment_size(&tree->total_ops);
+
+    RangeMerge m;
+    if (!range_merge_init(&m, tree, lo, hi, PAVL_RANGE_BATCH)) return;
+
+    bool emitted = false;
+    int64_t last = 0;
+    while (m.heap_size > 0) {
+        AVLKeyValue kv = range_merge_pop(&m);
+        /* A key mid-migration can briefly sit in two shards */
+        if (PAVL_UNLIKELY(emitted && kv.key == last)) continue;
+        emitted = true;
+        last = kv.key;
+        if (!callback(kv.key, kv.value, ctx)) break;
+    }
+    free(m.cursors);
+}
+
+bool parallel_avl_range_page(ParallelAVL* tree, int64_t lo, int64_t hi,
+                             AVLKeyValue* out_array, size_t limit,
+                             size_t* out_count, int64_t* next_lo) {
+    if (out_count) *out_count = 0;
+    if (!tree || !out_array || !out_count || limit == 0 || lo > hi) return false;
+
+    atomic_increment_size(&tree->total_ops);
+
+    /* No shard can contribute more than limit entries to one page */
+    size_t batch = limit < PAVL_RANGE_BATCH ? limit : PAVL_RANGE_BATCH;
+    RangeMerge m;
+    if (!range_merge_init(&m, tree, lo, hi, batch)) return false;
+
+    size_t count = 0;
+    while (count < limit && m.heap_size > 0) {
+        AVLKeyValue kv = range_merge_pop(&m);
+        if (PAVL_UNLIKELY(count > 0 && kv.key == out_array[count - 1].key)) continue;
+        out_array[count++] = kv;
+    }
+    bool more = m.heap_size > 0;
+    free(m.cursors);
+
+    *out_count = count;
+    if (more && next_lo) {
+        *next_lo = out_array[count - 1].key + 1;
+    }
+    return more;
+}
+
+void parallel_avl_range_query(ParallelAVL* tree, int64_t lo, int64_t hi,
+                               AVLKeyValue* out_array, size_t max_results,
+                               size_t* out_count) {
+    parallel_avl_range_page(tree, lo, hi, out_array, max_results, out_count, NULL);
 }
 
 double parallel_avl_balance_score(const ParallelAVL* tree) {
@@ -313,6 +955,269 @@ void parallel_avl_clear(ParallelAVL* tree) {
     redirect_index_clear(tree->redirect_index);
     atomic_store_size(&tree->total_ops, 0);
     atomic_store_size(&tree->redirect_hits, 0);
+    atomic_store_bool(&tree->migrating, false);
+}
+
+size_t parallel_avl_trim(ParallelAVL* tree) {
+    if (!tree) return 0;
+
+    size_t released = 0;
+    for (size_t i = 0; i < tree->num_shards; i++) {
+        released += shard_trim(tree->shards[i]);
+    }
+    return released + avl_pool_depot_trim();
+}
+
+/* =========================================================================
+ * Parallel Redistribution
+ *
+ * remove_shard and force_rebalance run one task per shard on the shared
+ * worker pool (worker_pool.h). Below PAVL_PARALLEL_MIN keys the hand-off
+ * costs more than it saves and the same tasks run on the caller.
+ * ========================================================================= */
+
+#define PAVL_PARALLEL_MIN 16384
+
+static WorkerPool* redistribution_pool(size_t num_keys) {
+    return num_keys >= PAVL_PARALLEL_MIN ? worker_pool_shared() : NULL;
+}
+
+typedef struct InsertJob {
+    ParallelAVL* tree;
+    const ShardBatch* batch;
+} InsertJob;
+
+static void insert_group_task(void* ctx, size_t s) {
+    const InsertJob* job = (const InsertJob*)ctx;
+    size_t first = job->batch->start[s], count = job->batch->start[s + 1] - first;
+    if (count == 0) return;
+    shard_insert_many(job->tree->shards[s], job->batch->keys + first,
+                      job->batch->values + first, count, NULL);
+}
+
+/*
+ * Re-inserts keys taken from a removed shard. Targets are chosen serially
+ * (load-aware routing sees each placement), then every target shard takes
+ * its group under one lock, in parallel.
+ */
+static void redistribute_keys(ParallelAVL* tree, const AVLKeyValue* items, size_t n) {
+    if (n == 0) return;
+    size_t num_shards = tree->num_shards;
+    
+    ShardBatch b;
+    if (!shard_batch_alloc(&b, n, num_shards)) {
+        for (size_t i = 0; i < n; i++) {
+            size_t target = tree->ring ? home_shard(tree, pavl_hash(items[i].key))
+                                       : router_route(tree->router, items[i].key);
+            shard_insert(tree->shards[target], items[i].key, items[i].value);
+            router_record_insertion(tree->router, target);
+        }
+        return;
+    }
+    
+    memset(b.start, 0, (num_shards + 1) * sizeof(size_t));
+    for (size_t i = 0; i < n; i++) {
+        size_t target;
+        if (tree->ring) {
+            target = home_shard(tree, pavl_hash(items[i].key));
+        } else {
+            target = router_route(tree->router, items[i].key);
+            router_record_insertion(tree->router, target);
+        }
+        b.shard_of[i] = target;
+        b.start[target + 1]++;
+    }
+    for (size_t s = 0; s < num_shards; s++) {
+        b.start[s + 1] += b.start[s];
+    }
+    for (size_t i = 0; i < n; i++) {
+        size_t pos = b.start[b.shard_of[i]]++;
+        b.keys[pos] = items[i].key;
+        b.values[pos] = items[i].value;
+    }
+    for (size_t s = num_shards; s > 0; s--) {
+        b.start[s] = b.start[s - 1];
+    }
+    b.start[0] = 0;
+    
+    if (tree->ring) {
+        for (size_t s = 0; s < num_shards; s++) {
+            router_record_insertions(tree->router, s, b.start[s + 1] - b.start[s]);
+        }
+    }
+    
+    InsertJob job = {tree, &b};
+    worker_pool_run(redistribution_pool(n), num_shards, insert_group_task, &job);
+    free(b.keys);
+}
+
+/*
+ * force_rebalance. Every key moves to hash % num_shards:
+ *   1. extract: each source shard copies out its keys (already sorted)
+ *   2. scatter: each source splits its keys into one run per destination,
+ *      placed so destination j's runs are contiguous, in source order
+ *   3. build:   each destination merges its sorted runs, keeps the last
+ *               copy of a key present in several shards (the later shard
+ *               wins, as with serial re-insertion) and rebuilds its tree
+ *               with shard_load_sorted
+ */
+typedef struct RebalanceJob {
+    ParallelAVL* tree;
+    size_t num_shards;
+    AVLKeyValue** src;              /* per source: extracted keys */
+    size_t* src_count;
+    size_t* run_start;              /* [source * num_shards + dest] */
+    size_t* cursor;                 /* scatter positions, same layout */
+    size_t* dest_start;             /* num_shards + 1 */
+    size_t* loaded;                 /* per dest: keys after dedup */
+    AVLKeyValue* dest;              /* all keys, grouped by destination */
+    AVLKeyValue* scratch;           /* merge buffer, same layout */
+    atomic_bool_t failed;
+} RebalanceJob;
+
+PAVL_INLINE size_t rebalance_dest(const RebalanceJob* job, int64_t key) {
+    return (size_t)(pavl_hash(key) % job->num_shards);
+}
+
+static bool rebalance_job_init(RebalanceJob* job, ParallelAVL* tree) {
+    size_t n = tree->num_shards;
+    memset(job, 0, sizeof(*job));
+    job->tree = tree;
+    job->num_shards = n;
+    job->src = (AVLKeyValue**)calloc(n, sizeof(AVLKeyValue*));
+    job->src_count = (size_t*)calloc(n, sizeof(size_t));
+    job->run_start = (size_t*)calloc(n * n, sizeof(size_t));
+    job->cursor = (size_t*)malloc(n * n * sizeof(size_t));
+    job->dest_start = (size_t*)calloc(n + 1, sizeof(size_t));
+    job->loaded = (size_t*)calloc(n, sizeof(size_t));
+    atomic_store_bool(&job->failed, false);
+    return job->src && job->src_count && job->run_start && job->cursor &&
+           job->dest_start && job->loaded;
+}
+
+static void rebalance_job_free(RebalanceJob* job) {
+    for (size_t i = 0; job->src && i < job->num_shards; i++) {
+        free(job->src[i]);
+    }
+    free(job->src);
+    free(job->src_count);
+    free(job->run_start);
+    free(job->cursor);
+    free(job->dest_start);
+    free(job->loaded);
+    free(job->dest);
+    free(job->scratch);
+}
+
+static void rebalance_extract_task(void* ctx, size_t i) {
+    RebalanceJob* job = (RebalanceJob*)ctx;
+    size_t count = 0;
+    AVLKeyValue* items = shard_extract_all_alloc(job->tree->shards[i], &count);
+    if (!items) {
+        atomic_store_bool(&job->failed, true);
+        return;
+    }
+    size_t* counts = job->run_start + i * job->num_shards;
+    for (size_t k = 0; k < count; k++) {
+        counts[rebalance_dest(job, items[k].key)]++;
+    }
+    job->src[i] = items;
+    job->src_count[i] = count;
+}
+
+/* Turns per-run counts into offsets and allocates the merge buffers */
+static bool rebalance_job_plan(RebalanceJob* job, size_t total) {
+    size_t n = job->num_shards;
+    size_t offset = 0;
+    for (size_t j = 0; j < n; j++) {
+        job->dest_start[j] = offset;
+        for (size_t i = 0; i < n; i++) {
+            size_t count = job->run_start[i * n + j];
+            job->run_start[i * n + j] = offset;
+            offset += count;
+        }
+    }
+    job->dest_start[n] = offset;
+    memcpy(job->cursor, job->run_start, n * n * sizeof(size_t));
+    
+    job->dest = (AVLKeyValue*)malloc((total ? total : 1) * sizeof(AVLKeyValue));
+    job->scratch = (AVLKeyValue*)malloc((total ? total : 1) * sizeof(AVLKeyValue));
+    return job->dest && job->scratch;
+}
+
+static void rebalance_scatter_task(void* ctx, size_t i) {
+    RebalanceJob* job = (RebalanceJob*)ctx;
+    size_t* cursor = job->cursor + i * job->num_shards;
+    const AVLKeyValue* items = job->src[i];
+    for (size_t k = 0; k < job->src_count[i]; k++) {
+        job->dest[cursor[rebalance_dest(job, items[k].key)]++] = items[k];
+    }
+    free(job->src[i]);
+    job->src[i] = NULL;
+}
+
+/* Stable merge of sorted [a, a + na) and [b, b + nb) into out */
+static void merge_runs(const AVLKeyValue* a, size_t na, const AVLKeyValue* b, size_t nb,
+                       AVLKeyValue* out) {
+    size_t i = 0, k = 0;
+    while (i < na && k < nb) {
+        *out++ = b[k].key < a[i].key ? b[k++] : a[i++];
+    }
+    memcpy(out, a + i, (na - i) * sizeof(AVLKeyValue));
+    memcpy(out + (na - i), b + k, (nb - k) * sizeof(AVLKeyValue));
+}
+
+static void rebalance_build_task(void* ctx, size_t j) {
+    RebalanceJob* job = (RebalanceJob*)ctx;
+    size_t n = job->num_shards;
+    size_t begin = job->dest_start[j], end = job->dest_start[j + 1];
+    TreeShard* shard = job->tree->shards[j];
+    
+    /* Bottom-up pairwise merge of the n source runs; bounds[r] starts run r */
+    size_t* bounds = (size_t*)malloc((n + 1) * sizeof(size_t));
+    AVLKeyValue* from = job->dest;
+    AVLKeyValue* to = job->scratch;
+    if (bounds) {
+        for (size_t i = 0; i < n; i++) {
+            bounds[i] = job->run_start[i * n + j];
+        }
+        bounds[n] = end;
+        
+        for (size_t width = 1; width < n; width *= 2) {
+            for (size_t r = 0; r < n; r += 2 * width) {
+                size_t mid = r + width < n ? r + width : n;
+                size_t last = r + 2 * width < n ? r + 2 * width : n;
+                merge_runs(from + bounds[r], bounds[mid] - bounds[r],
+                           from + bounds[mid], bounds[last] - bounds[mid],
+                           to + bounds[r]);
+            }
+            AVLKeyValue* swap = from;
+            from = to;
+            to = swap;
+        }
+        free(bounds);
+    }
+    
+    AVLKeyValue* items = from + begin;
+    size_t count = end - begin;
+    if (bounds) {
+        /* Duplicates are adjacent, in source order: keep the last */
+        size_t kept = 0;
+        for (size_t k = 0; k < count; k++) {
+            if (k + 1 < count && items[k + 1].key == items[k].key) continue;
+            items[kept++] = items[k];
+        }
+        count = kept;
+    }
+    
+    shard_clear(shard);
+    if (!bounds || !shard_load_sorted(shard, items, count)) {
+        /* Out of memory: fall back to plain inserts (in source order) */
+        for (size_t k = 0; k < count; k++) {
+            shard_insert(shard, items[k].key, items[k].value);
+        }
+    }
+    job->loaded[j] = shard_size(shard);
 }
 
 /* =========================================================================
@@ -321,6 +1226,7 @@ void parallel_avl_clear(ParallelAVL* tree) {
 
 bool parallel_avl_add_shard(ParallelAVL* tree) {
     if (!tree) return false;
+    if (tree->ring) return ring_add_shard(tree);
     
     /* Create new shard */
     TreeShard* new_shard = shard_create();
@@ -354,20 +1260,16 @@ bool parallel_avl_add_shard(ParallelAVL* tree) {
 
 bool parallel_avl_remove_shard(ParallelAVL* tree) {
     if (!tree || tree->num_shards <= 1) return false;
+    if (tree->ring) return ring_remove_shard(tree);
     
     size_t removing_id = tree->num_shards - 1;
     
     /* Extract all elements from shard to remove */
-    size_t shard_sz = shard_size(tree->shards[removing_id]);
-    AVLKeyValue* to_redistribute = NULL;
     size_t redistribute_count = 0;
+    AVLKeyValue* to_redistribute = shard_extract_all_alloc(tree->shards[removing_id],
+                                                           &redistribute_count);
     
-    if (shard_sz > 0) {
-        to_redistribute = (AVLKeyValue*)malloc(shard_sz * sizeof(AVLKeyValue));
-        if (to_redistribute) {
-            shard_extract_all(tree->shards[removing_id], to_redistribute, &redistribute_count);
-        }
-    }
+    AVLBytesTree* bytes_to_redistribute = shard_detach_bytes(tree->shards[removing_id]);
     
     /* Destroy the shard */
     shard_destroy(tree->shards[removing_id]);
@@ -382,56 +1284,80 @@ bool parallel_avl_remove_shard(ParallelAVL* tree) {
     
     /* Re-insert data from removed shard */
     if (to_redistribute) {
-        for (size_t i = 0; i < redistribute_count; i++) {
-            size_t target = router_route(tree->router, to_redistribute[i].key);
-            shard_insert(tree->shards[target], to_redistribute[i].key, to_redistribute[i].value);
-            router_record_insertion(tree->router, target);
-        }
+        redistribute_keys(tree, to_redistribute, redistribute_count);
         free(to_redistribute);
     }
+    bytes_rehome(tree, bytes_to_redistribute);
     
     return true;
 }
 
 void parallel_avl_force_rebalance(ParallelAVL* tree) {
     if (!tree) return;
+    if (tree->ring) {
+        /* Ring placement has no redirects: settling the migration is enough */
+        parallel_avl_migrate_step(tree, SIZE_MAX);
+        return;
+    }
     
-    /* Step 1: Extract all data */
-    size_t total_size = parallel_avl_size(tree);
-    if (total_size == 0) return;
+    size_t num_shards = tree->num_shards;
+    if (parallel_avl_size(tree) == 0 && parallel_avl_bytes_size(tree) == 0) return;
     
-    AVLKeyValue* all_data = (AVLKeyValue*)malloc(total_size * sizeof(AVLKeyValue));
-    if (!all_data) return;
+    /* Step 1: Extract every shard, counting keys per destination */
+    RebalanceJob job;
+    if (!rebalance_job_init(&job, tree)) {
+        rebalance_job_free(&job);
+        return;
+    }
+    worker_pool_run(redistribution_pool(parallel_avl_size(tree)), num_shards,
+                    rebalance_extract_task, &job);
     
-    size_t total_extracted = 0;
-    for (size_t i = 0; i < tree->num_shards; i++) {
-        size_t count = 0;
-        shard_extract_all(tree->shards[i], all_data + total_extracted, &count);
-        total_extracted += count;
+    size_t total = 0;
+    bool ok = !atomic_load_bool(&job.failed);
+    for (size_t i = 0; ok && i < num_shards; i++) {
+        total += job.src_count[i];
+    }
+    ok = ok && rebalance_job_plan(&job, total);
+    if (!ok) {
+        rebalance_job_free(&job);
+        return;
     }
+    WorkerPool* pool = redistribution_pool(total);
     
-    /* Step 2: Clear all shards and redirect index */
-    for (size_t i = 0; i < tree->num_shards; i++) {
-        shard_clear(tree->shards[i]);
+    /* Byte-key trees are detached whole and re-homed at the end */
+    AVLBytesTree** bytes_trees = (AVLBytesTree**)malloc(num_shards * sizeof(AVLBytesTree*));
+    if (!bytes_trees) {
+        rebalance_job_free(&job);
+        return;
+    }
+    for (size_t i = 0; i < num_shards; i++) {
+        bytes_trees[i] = shard_detach_bytes(tree->shards[i]);
     }
+    
+    /* Step 2: Partition every source's keys into per-destination runs */
+    worker_pool_run(pool, num_shards, rebalance_scatter_task, &job);
+    
+    /* Step 3: Merge each destination's runs and rebuild its tree in O(n) */
     redirect_index_clear(tree->redirect_index);
+    worker_pool_run(pool, num_shards, rebalance_build_task, &job);
     
-    /* Step 3: Recreate router with STATIC_HASH for consistent routing */
+    /* Step 4: Fresh STATIC_HASH router with the new loads */
     router_destroy(tree->router);
-    tree->router = router_create(tree->num_shards, ROUTER_STATIC_HASH);
-    
-    /* Step 4: Re-insert everything using simple hash (no redirections) */
-    for (size_t i = 0; i < total_extracted; i++) {
-        uint64_t hash = pavl_hash(all_data[i].key);
-        size_t target = (size_t)(hash % tree->num_shards);
-        shard_insert(tree->shards[target], all_data[i].key, all_data[i].value);
-        router_record_insertion(tree->router, target);
+    tree->router = router_create(num_shards, ROUTER_STATIC_HASH);
+    size_t total_loaded = 0;
+    for (size_t j = 0; j < num_shards; j++) {
+        router_record_insertions(tree->router, j, job.loaded[j]);
+        total_loaded += job.loaded[j];
     }
+    rebalance_job_free(&job);
     
-    free(all_data);
+    for (size_t i = 0; i < num_shards; i++) {
+        bytes_rehome(tree, bytes_trees[i]);
+    }
+    free(bytes_trees);
     
     /* Reset stats and flags */
-    atomic_store_size(&tree->total_ops, total_extracted);
+    atomic_store_size(&tree->total_ops, total_loaded);
     atomic_store_size(&tree->redirect_hits, 0);
     atomic_store_bool(&tree->topology_changed, false);
     atomic_store_bool(&tree->has_redirects, false);
@@ -488,6 +1414,9 @@ ParallelAVLStats parallel_avl_get_stats(const ParallelAVL* tree) {
                               (stats.redirect_index_hits * 100.0 / stats.total_ops) : 0.0;
     stats.redirect_index_memory_bytes = redirect_index_memory_bytes(tree->redirect_index);
     
+    stats.migrating = atomic_load_bool(&((ParallelAVL*)tree)->migrating);
+    stats.migrated_keys = atomic_load_size(&((ParallelAVL*)tree)->migration.moved_keys);
+    
     return stats;
 }
 
@@ -530,6 +1459,12 @@ void parallel_avl_print_stats(const ParallelAVL* tree) {
     printf("  Hit rate: %.2f%%\n", stats.redirect_hit_rate);
     printf("  Memory: %.2f KB\n", stats.redirect_index_memory_bytes / 1024.0);
     
+    if (tree->ring) {
+        printf("\nRing Migration:\n");
+        printf("  In progress: %s\n", stats.migrating ? "yes" : "no");
+        printf("  Keys moved: %zu\n", stats.migrated_keys);
+    }
+    
     printf("\nShard Distribution:\n");
     if (stats.shard_sizes) {
         for (size_t i = 0; i < stats.num_shards; i++) {
@@ -104,8 +104,8 @@ RedirectIndexStats redirect_index_get_stats(const RedirectIndex* index) {
 size_t redirect_index_memory_bytes(const RedirectIndex* index) {
     if (!index) return 0;
     
-    /* Approximate: each entry = sizeof(int64_t) + sizeof(size_t) + overhead */
-    return hash_table_size(index->redirects) * (sizeof(int64_t) + sizeof(size_t) + 16);
+    /* Control bytes + entry array, including free slots */
+    return hash_table_memory_bytes(index->redirects);
 }
 
 size_t redirect_index_gc(RedirectIndex* index, GetCurrentShardFunc get_current_shard, void* ctx) {
@@ -94,29 +94,7 @@ static size_t route_load_aware(Router* router, size_t natural_shard) {
 }
 
 static size_t route_consistent_hash(const Router* router, int64_t key) {
-    if (ROUTER_UNLIKELY(!router->virtual_nodes || router->num_virtual_nodes == 0)) {
-        return router_natural_shard(router, key);
-    }
-    
-    uint64_t key_hash = router_hash(key);
-    
-    /* Binary search for first vnode >= key_hash */
-    size_t lo = 0, hi = router->num_virtual_nodes;
-    while (lo < hi) {
-        size_t mid = lo + (hi - lo) / 2;
-        if (router->virtual_nodes[mid].hash_value < key_hash) {
-            lo = mid + 1;
-        } else {
-            hi = mid;
-        }
-    }
-    
-    /* Wrap around if needed */
-    if (lo >= router->num_virtual_nodes) {
-        lo = 0;
-    }
-    
-    return router->virtual_nodes[lo].shard_id;
+    return router_ring_shard(router, router_hash(key));
 }
 
 static void update_stats_cache(Router* router) {
@@ -260,11 +238,40 @@ size_t ROUTER_HOT router_route(Router* router, int64_t key) {
     }
 }
 
+size_t ROUTER_HOT router_ring_shard(const Router* router, uint64_t key_hash) {
+    if (ROUTER_UNLIKELY(!router->virtual_nodes || router->num_virtual_nodes == 0)) {
+        return router_fast_shard(key_hash, router->num_shards, router->mask);
+    }
+    
+    /* Binary search for first vnode >= key_hash */
+    size_t lo = 0, hi = router->num_virtual_nodes;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (router->virtual_nodes[mid].hash_value < key_hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    
+    /* Wrap around if needed */
+    if (lo >= router->num_virtual_nodes) {
+        lo = 0;
+    }
+    
+    return router->virtual_nodes[lo].shard_id;
+}
+
 void router_record_insertion(Router* router, size_t shard_idx) {
     if (!router || shard_idx >= router->num_shards) return;
     atomic_increment_size(&router->shard_loads[shard_idx]);
 }
 
+void router_record_insertions(Router* router, size_t shard_idx, size_t count) {
+    if (!router || shard_idx >= router->num_shards) return;
+    atomic_fetch_add_size(&router->shard_loads[shard_idx], count);
+}
+
 void router_record_removal(Router* router, size_t shard_idx) {
     if (!router || shard_idx >= router->num_shards) return;
     
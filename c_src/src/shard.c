@@ -84,6 +84,8 @@ TreeShard* shard_create(void) {
     atomic_store_int64(&shard->min_key, INT64_MAX);
     atomic_store_int64(&shard->max_key, INT64_MIN);
     atomic_store_bool(&shard->has_keys, false);
+    shard->bytes_tree = NULL;
+    atomic_store_size(&shard->bytes_size, 0);
     
     return shard;
 }
@@ -93,6 +95,7 @@ void shard_destroy(TreeShard* shard) {
     
     SHARD_MUTEX_DESTROY(&shard->mutex);
     avl_tree_destroy(shard->tree);
+    avl_bytes_tree_destroy(shard->bytes_tree);
     free(shard);
 }
 
@@ -115,16 +118,12 @@ void shard_insert(TreeShard* shard, int64_t key, void* value) {
     SHARD_MUTEX_UNLOCK(&shard->mutex);
 }
 
-bool shard_remove(TreeShard* shard, int64_t key) {
-    if (!shard) return false;
-    
-    SHARD_MUTEX_LOCK(&shard->mutex);
-    
+/* Caller holds shard->mutex */
+static bool remove_locked(TreeShard* shard, int64_t key) {
     bool removed = avl_tree_remove(shard->tree, key);
     
     if (removed) {
         atomic_decrement_size(&shard->size);
-        atomic_increment_size(&shard->remove_count);
         
         /* Recompute bounds if removed key was min or max */
         int64_t min = atomic_load_int64(&shard->min_key);
@@ -133,12 +132,82 @@ bool shard_remove(TreeShard* shard, int64_t key) {
             recompute_bounds(shard);
         }
     }
+    return removed;
+}
+
+bool shard_remove(TreeShard* shard, int64_t key) {
+    if (!shard) return false;
     
+    SHARD_MUTEX_LOCK(&shard->mutex);
+    bool removed = remove_locked(shard, key);
+    if (removed) {
+        atomic_increment_size(&shard->remove_count);
+    }
     SHARD_MUTEX_UNLOCK(&shard->mutex);
     
     return removed;
 }
 
+/* Both locks, in address order, so concurrent pairs cannot deadlock */
+static void lock_pair(TreeShard* a, TreeShard* b, TreeShard** first, TreeShard** second) {
+    *first = (uintptr_t)a < (uintptr_t)b ? a : b;
+    *second = *first == a ? b : a;
+    SHARD_MUTEX_LOCK(&(*first)->mutex);
+    SHARD_MUTEX_LOCK(&(*second)->mutex);
+}
+
+ShardMoveResult shard_move_key(TreeShard* src, TreeShard* dst, int64_t key, void** out_value) {
+    if (!src || !dst || src == dst) return SHARD_MOVE_ABSENT;
+    
+    TreeShard *first, *second;
+    lock_pair(src, dst, &first, &second);
+    
+    ShardMoveResult result = SHARD_MOVE_ABSENT;
+    bool found = false, dst_found = false;
+    void* value = avl_tree_get(src->tree, key, &found);
+    void* current = avl_tree_get(dst->tree, key, &dst_found);
+    if (found) {
+        if (dst_found) {
+            value = current;    /* A newer write already landed in dst */
+            result = SHARD_MOVE_DROPPED;
+        } else {
+            avl_tree_insert(dst->tree, key, value);
+            atomic_increment_size(&dst->size);
+            update_bounds(dst, key);
+            result = SHARD_MOVE_MOVED;
+        }
+        remove_locked(src, key);
+    } else if (dst_found) {
+        value = current;        /* Moved by someone else since the caller's miss */
+        result = SHARD_MOVE_IN_DST;
+    }
+    if (result != SHARD_MOVE_ABSENT && out_value) *out_value = value;
+    
+    SHARD_MUTEX_UNLOCK(&second->mutex);
+    SHARD_MUTEX_UNLOCK(&first->mutex);
+    return result;
+}
+
+bool shard_remove_either(TreeShard* a, TreeShard* b, int64_t key,
+                         bool* removed_a, bool* removed_b) {
+    bool in_a = false, in_b = false;
+    if (a && b && a != b) {
+        TreeShard *first, *second;
+        lock_pair(a, b, &first, &second);
+        in_a = remove_locked(a, key);
+        in_b = remove_locked(b, key);
+        if (in_a) atomic_increment_size(&a->remove_count);
+        if (in_b) atomic_increment_size(&b->remove_count);
+        SHARD_MUTEX_UNLOCK(&second->mutex);
+        SHARD_MUTEX_UNLOCK(&first->mutex);
+    } else if (a) {
+        in_a = shard_remove(a, key);
+    }
+    if (removed_a) *removed_a = in_a;
+    if (removed_b) *removed_b = in_b;
+    return in_a || in_b;
+}
+
 bool shard_contains(TreeShard* shard, int64_t key) {
     if (!shard) return false;
     
@@ -162,6 +231,46 @@ void* shard_get(TreeShard* shard, int64_t key, bool* found) {
     return result;
 }
 
+size_t shard_get_many(TreeShard* shard, const int64_t* keys, size_t n,
+                      void** out_values, bool* out_found) {
+    if (!shard || !out_found) return 0;
+
+    SHARD_MUTEX_LOCK(&shard->mutex);
+    avl_tree_get_many(shard->tree, keys, n, out_values, out_found);
+    atomic_fetch_add_size(&shard->lookup_count, n);
+    SHARD_MUTEX_UNLOCK(&shard->mutex);
+
+    size_t hits = 0;
+    for (size_t i = 0; i < n; i++) {
+        hits += out_found[i];
+    }
+    return hits;
+}
+
+size_t shard_insert_many(TreeShard* shard, const int64_t* keys, void* const* values,
+                         size_t n, bool* out_inserted) {
+    if (!shard || !keys) return 0;
+
+    SHARD_MUTEX_LOCK(&shard->mutex);
+
+    size_t added = 0;
+    for (size_t i = 0; i < n; i++) {
+        size_t old_size = avl_tree_size(shard->tree);
+        avl_tree_insert(shard->tree, keys[i], values ? values[i] : NULL);
+        bool inserted = avl_tree_size(shard->tree) > old_size;
+        if (inserted) {
+            update_bounds(shard, keys[i]);
+            added++;
+        }
+        if (out_inserted) out_inserted[i] = inserted;
+    }
+    atomic_fetch_add_size(&shard->size, added);
+    atomic_fetch_add_size(&shard->insert_count, n);
+
+    SHARD_MUTEX_UNLOCK(&shard->mutex);
+    return added;
+}
+
 bool shard_intersects_range(const TreeShard* shard, int64_t lo, int64_t hi) {
     if (!shard) return false;
     if (!atomic_load_bool(&((TreeShard*)shard)->has_keys)) return false;
@@ -188,6 +297,74 @@ void shard_range_query(TreeShard* shard, int64_t lo, int64_t hi,
     SHARD_MUTEX_UNLOCK(&shard->mutex);
 }
 
+bool shard_insert_bytes(TreeShard* shard, const void* key, size_t len, void* value) {
+    if (!shard) return false;
+    
+    SHARD_MUTEX_LOCK(&shard->mutex);
+    
+    if (!shard->bytes_tree) {
+        shard->bytes_tree = avl_bytes_tree_create(NULL);
+    }
+    bool inserted = avl_bytes_tree_insert(shard->bytes_tree, key, len, value);
+    if (inserted) {
+        atomic_increment_size(&shard->bytes_size);
+    }
+    atomic_increment_size(&shard->insert_count);
+    
+    SHARD_MUTEX_UNLOCK(&shard->mutex);
+    
+    return inserted;
+}
+
+bool shard_remove_bytes(TreeShard* shard, const void* key, size_t len) {
+    if (!shard) return false;
+    
+    SHARD_MUTEX_LOCK(&shard->mutex);
+    bool removed = avl_bytes_tree_remove(shard->bytes_tree, key, len);
+    if (removed) {
+        atomic_decrement_size(&shard->bytes_size);
+        atomic_increment_size(&shard->remove_count);
+    }
+    SHARD_MUTEX_UNLOCK(&shard->mutex);
+    
+    return removed;
+}
+
+bool shard_contains_bytes(TreeShard* shard, const void* key, size_t len) {
+    if (!shard) return false;
+    
+    SHARD_MUTEX_LOCK(&shard->mutex);
+    bool result = avl_bytes_tree_contains(shard->bytes_tree, key, len);
+    atomic_increment_size(&shard->lookup_count);
+    SHARD_MUTEX_UNLOCK(&shard->mutex);
+    
+    return result;
+}
+
+void* shard_get_bytes(TreeShard* shard, const void* key, size_t len, bool* found) {
+    if (found) *found = false;
+    if (!shard) return NULL;
+    
+    SHARD_MUTEX_LOCK(&shard->mutex);
+    void* result = avl_bytes_tree_get(shard->bytes_tree, key, len, found);
+    atomic_increment_size(&shard->lookup_count);
+    SHARD_MUTEX_UNLOCK(&shard->mutex);
+    
+    return result;
+}
+
+AVLBytesTree* shard_detach_bytes(TreeShard* shard) {
+    if (!shard) return NULL;
+    
+    SHARD_MUTEX_LOCK(&shard->mutex);
+    AVLBytesTree* detached = shard->bytes_tree;
+    shard->bytes_tree = NULL;
+    atomic_store_size(&shard->bytes_size, 0);
+    SHARD_MUTEX_UNLOCK(&shard->mutex);
+    
+    return detached;
+}
+
 ShardStats shard_get_stats(const TreeShard* shard) {
     ShardStats stats = {0};
     
@@ -214,6 +391,8 @@ void shard_clear(TreeShard* shard) {
     SHARD_MUTEX_LOCK(&shard->mutex);
     
     avl_tree_clear(shard->tree);
+    avl_bytes_tree_clear(shard->bytes_tree);
+    atomic_store_size(&shard->bytes_size, 0);
     
     atomic_store_size(&shard->size, 0);
     atomic_store_size(&shard->insert_count, 0);
@@ -233,3 +412,52 @@ void shard_extract_all(TreeShard* shard, AVLKeyValue* out_array, size_t* out_cou
     avl_tree_extract_all(shard->tree, out_array, out_count);
     SHARD_MUTEX_UNLOCK(&shard->mutex);
 }
+
+AVLKeyValue* shard_extract_all_alloc(TreeShard* shard, size_t* out_count) {
+    if (!shard || !out_count) return NULL;
+    *out_count = 0;
+
+    SHARD_MUTEX_LOCK(&shard->mutex);
+    size_t n = avl_tree_size(shard->tree);
+    AVLKeyValue* items = (AVLKeyValue*)malloc((n ? n : 1) * sizeof(AVLKeyValue));
+    if (items) {
+        avl_tree_extract_all(shard->tree, items, out_count);
+    }
+    SHARD_MUTEX_UNLOCK(&shard->mutex);
+
+    return items;
+}
+
+bool shard_load_sorted(TreeShard* shard, const AVLKeyValue* items, size_t n) {
+    if (!shard || (n && !items)) return false;
+
+    SHARD_MUTEX_LOCK(&shard->mutex);
+
+    avl_tree_clear(shard->tree);
+    bool built = avl_tree_build_sorted(shard->tree, items, n);
+    size_t size = built ? n : 0;
+
+    atomic_store_size(&shard->size, size);
+    atomic_fetch_add_size(&shard->insert_count, size);
+    if (size > 0) {
+        atomic_store_int64(&shard->min_key, items[0].key);
+        atomic_store_int64(&shard->max_key, items[n - 1].key);
+        atomic_store_bool(&shard->has_keys, true);
+    } else {
+        atomic_store_bool(&shard->has_keys, false);
+        atomic_store_int64(&shard->min_key, INT64_MAX);
+        atomic_store_int64(&shard->max_key, INT64_MIN);
+    }
+
+    SHARD_MUTEX_UNLOCK(&shard->mutex);
+    return built;
+}
+
+size_t shard_trim(TreeShard* shard) {
+    if (!shard) return 0;
+
+    SHARD_MUTEX_LOCK(&shard->mutex);
+    size_t released = avl_tree_trim(shard->tree);
+    SHARD_MUTEX_UNLOCK(&shard->mutex);
+    return released;
+}
@@ -0,0 +1,270 @@
+/**
+ * @file worker_pool.c
+ * @brief Fixed-size thread pool for the library's bulk operations
+ */
+
+#include "../include/worker_pool.h"
+#include "../include/atomics.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+typedef SRWLOCK wp_mutex_t;
+typedef CONDITION_VARIABLE wp_cond_t;
+typedef HANDLE wp_thread_t;
+#define WP_MUTEX_INIT(m)      InitializeSRWLock(m)
+#define WP_MUTEX_DESTROY(m)   ((void)(m))
+#define WP_MUTEX_LOCK(m)      AcquireSRWLockExclusive(m)
+#define WP_MUTEX_UNLOCK(m)    ReleaseSRWLockExclusive(m)
+#define WP_COND_INIT(c)       InitializeConditionVariable(c)
+#define WP_COND_DESTROY(c)    ((void)(c))
+#define WP_COND_WAIT(c, m)    SleepConditionVariableSRW((c), (m), INFINITE, 0)
+#define WP_COND_SIGNAL(c)     WakeConditionVariable(c)
+#define WP_COND_BROADCAST(c)  WakeAllConditionVariable(c)
+#else
+#include <pthread.h>
+#include <unistd.h>
+typedef pthread_mutex_t wp_mutex_t;
+typedef pthread_cond_t wp_cond_t;
+typedef pthread_t wp_thread_t;
+#define WP_MUTEX_INIT(m)      pthread_mutex_init((m), NULL)
+#define WP_MUTEX_DESTROY(m)   pthread_mutex_destroy(m)
+#define WP_MUTEX_LOCK(m)      pthread_mutex_lock(m)
+#define WP_MUTEX_UNLOCK(m)    pthread_mutex_unlock(m)
+#define WP_COND_INIT(c)       pthread_cond_init((c), NULL)
+#define WP_COND_DESTROY(c)    pthread_cond_destroy(c)
+#define WP_COND_WAIT(c, m)    pthread_cond_wait((c), (m))
+#define WP_COND_SIGNAL(c)     pthread_cond_signal(c)
+#define WP_COND_BROADCAST(c)  pthread_cond_broadcast(c)
+#endif
+
+struct WorkerPool {
+    wp_mutex_t run_lock;            /* one worker_pool_run at a time */
+    wp_mutex_t lock;
+    wp_cond_t wake;                 /* new job or stop */
+    wp_cond_t done;                 /* last helper left the job */
+
+    /* Current job, guarded by lock (next is claimed lock-free) */
+    uint64_t generation;
+    WorkerTask task;
+    void* ctx;
+    size_t num_tasks;
+    atomic_size next;
+    size_t active;                  /* helpers still inside the job */
+    bool stop;
+
+    size_t num_threads;
+    wp_thread_t* threads;
+};
+
+static void run_tasks(WorkerPool* pool, WorkerTask task, void* ctx, size_t num_tasks) {
+    size_t i;
+    while ((i = atomic_fetch_add_size(&pool->next, 1)) < num_tasks) {
+        task(ctx, i);
+    }
+}
+
+static void worker_loop(WorkerPool* pool) {
+    uint64_t seen = 0;
+
+    WP_MUTEX_LOCK(&pool->lock);
+    for (;;) {
+        while (!pool->stop && pool->generation == seen) {
+            WP_COND_WAIT(&pool->wake, &pool->lock);
+        }
+        if (pool->stop) break;
+
+        seen = pool->generation;
+        WorkerTask task = pool->task;
+        void* ctx = pool->ctx;
+        size_t num_tasks = pool->num_tasks;
+        WP_MUTEX_UNLOCK(&pool->lock);
+
+        run_tasks(pool, task, ctx, num_tasks);
+
+        WP_MUTEX_LOCK(&pool->lock);
+        if (--pool->active == 0) {
+            WP_COND_SIGNAL(&pool->done);
+        }
+    }
+    WP_MUTEX_UNLOCK(&pool->lock);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI worker_main(LPVOID arg) {
+    worker_loop((WorkerPool*)arg);
+    return 0;
+}
+#else
+static void* worker_main(void* arg) {
+    worker_loop((WorkerPool*)arg);
+    return NULL;
+}
+#endif
+
+static bool thread_start(wp_thread_t* thread, WorkerPool* pool) {
+#if defined(_WIN32)
+    *thread = CreateThread(NULL, 0, worker_main, pool, 0, NULL);
+    return *thread != NULL;
+#else
+    return pthread_create(thread, NULL, worker_main, pool) == 0;
+#endif
+}
+
+static void thread_join(wp_thread_t thread) {
+#if defined(_WIN32)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+/* Stops and joins the first count helpers */
+static void stop_threads(WorkerPool* pool, size_t count) {
+    WP_MUTEX_LOCK(&pool->lock);
+    pool->stop = true;
+    WP_COND_BROADCAST(&pool->wake);
+    WP_MUTEX_UNLOCK(&pool->lock);
+
+    for (size_t i = 0; i < count; i++) {
+        thread_join(pool->threads[i]);
+    }
+}
+
+static void pool_free(WorkerPool* pool) {
+    WP_COND_DESTROY(&pool->done);
+    WP_COND_DESTROY(&pool->wake);
+    WP_MUTEX_DESTROY(&pool->lock);
+    WP_MUTEX_DESTROY(&pool->run_lock);
+    free(pool->threads);
+    free(pool);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+WorkerPool* worker_pool_create(size_t num_threads) {
+    if (num_threads > WORKER_POOL_MAX_THREADS) num_threads = WORKER_POOL_MAX_THREADS;
+
+    WorkerPool* pool = (WorkerPool*)calloc(1, sizeof(WorkerPool));
+    if (!pool) return NULL;
+
+    pool->threads = (wp_thread_t*)calloc(num_threads ? num_threads : 1, sizeof(wp_thread_t));
+    if (!pool->threads) {
+        free(pool);
+        return NULL;
+    }
+
+    WP_MUTEX_INIT(&pool->run_lock);
+    WP_MUTEX_INIT(&pool->lock);
+    WP_COND_INIT(&pool->wake);
+    WP_COND_INIT(&pool->done);
+    atomic_store_size(&pool->next, 0);
+
+    for (size_t i = 0; i < num_threads; i++) {
+        if (!thread_start(&pool->threads[i], pool)) {
+            stop_threads(pool, i);
+            pool_free(pool);
+            return NULL;
+        }
+    }
+    pool->num_threads = num_threads;
+    return pool;
+}
+
+void worker_pool_destroy(WorkerPool* pool) {
+    if (!pool) return;
+
+    stop_threads(pool, pool->num_threads);
+    pool_free(pool);
+}
+
+size_t worker_pool_threads(const WorkerPool* pool) {
+    return pool ? pool->num_threads : 0;
+}
+
+void worker_pool_run(WorkerPool* pool, size_t num_tasks, WorkerTask task, void* ctx) {
+    if (!task || num_tasks == 0) return;
+
+    if (!pool || pool->num_threads == 0 || num_tasks == 1) {
+        for (size_t i = 0; i < num_tasks; i++) {
+            task(ctx, i);
+        }
+        return;
+    }
+
+    WP_MUTEX_LOCK(&pool->run_lock);
+
+    WP_MUTEX_LOCK(&pool->lock);
+    pool->task = task;
+    pool->ctx = ctx;
+    pool->num_tasks = num_tasks;
+    atomic_store_size(&pool->next, 0);
+    pool->active = pool->num_threads;
+    pool->generation++;
+    WP_COND_BROADCAST(&pool->wake);
+    WP_MUTEX_UNLOCK(&pool->lock);
+
+    run_tasks(pool, task, ctx, num_tasks);
+
+    /* Helpers may still be finishing a task they claimed */
+    WP_MUTEX_LOCK(&pool->lock);
+    while (pool->active > 0) {
+        WP_COND_WAIT(&pool->done, &pool->lock);
+    }
+    WP_MUTEX_UNLOCK(&pool->lock);
+
+    WP_MUTEX_UNLOCK(&pool->run_lock);
+}
+
+/* ============================================================================
+ * Shared Pool
+ * ============================================================================ */
+
+static WorkerPool* g_shared_pool = NULL;
+
+static size_t online_cpus(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (size_t)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (size_t)n : 1;
+#else
+    return 1;
+#endif
+}
+
+static void shared_pool_init(void) {
+    size_t cpus = online_cpus();
+    g_shared_pool = worker_pool_create(cpus > 1 ? cpus - 1 : 0);
+}
+
+#if defined(_WIN32)
+static INIT_ONCE g_shared_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK shared_pool_init_once(PINIT_ONCE once, PVOID param, PVOID* context) {
+    (void)once;
+    (void)param;
+    (void)context;
+    shared_pool_init();
+    return TRUE;
+}
+
+WorkerPool* worker_pool_shared(void) {
+    InitOnceExecuteOnce(&g_shared_once, shared_pool_init_once, NULL, NULL);
+    return g_shared_pool;
+}
+#else
+static pthread_once_t g_shared_once = PTHREAD_ONCE_INIT;
+
+WorkerPool* worker_pool_shared(void) {
+    pthread_once(&g_shared_once, shared_pool_init);
+    return g_shared_pool;
+}
+#endif
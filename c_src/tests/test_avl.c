@@ -6,6 +6,8 @@
 #include "../include/parallel_avl.h"
 #include "../include/avl_tree.h"
 #include "../include/hash_table.h"
+#include "../include/bytes_tree.h"
+#include "../include/worker_pool.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -130,6 +132,60 @@ TEST(avl_balance) {
     avl_tree_destroy(tree);
 }
 
+static int subtree_height(const AVLNode* node, bool* ok) {
+    if (!node) return 0;
+    int lh = subtree_height(node->left, ok);
+    int rh = subtree_height(node->right, ok);
+    if (node->height != 1 + (lh > rh ? lh : rh) || lh - rh > 1 || rh - lh > 1) *ok = false;
+    if (node->left && node->left->parent != node) *ok = false;
+    if (node->right && node->right->parent != node) *ok = false;
+    return node->height;
+}
+
+TEST(avl_build_sorted) {
+    enum { N = 1000 };
+    AVLKeyValue* items = (AVLKeyValue*)malloc(N * sizeof(AVLKeyValue));
+    ASSERT(items != NULL);
+    for (int i = 0; i < N; i++) {
+        items[i].key = i * 3;
+        items[i].value = (void*)(intptr_t)(i + 1);
+    }
+    
+    AVLTree* tree = avl_tree_create(NULL);
+    ASSERT(avl_tree_build_sorted(tree, items, N));
+    ASSERT(avl_tree_size(tree) == N);
+    
+    /* Perfectly balanced: height ceil(log2(N + 1)) = 10 */
+    bool ok = true;
+    ASSERT(subtree_height(avl_tree_get_root(tree), &ok) == 10);
+    ASSERT(ok);
+    for (int i = 0; i < N; i++) {
+        bool found = false;
+        ASSERT(avl_tree_get(tree, i * 3, &found) == (void*)(intptr_t)(i + 1) && found);
+        ASSERT(!avl_tree_contains(tree, i * 3 + 1));
+    }
+    
+    /* Only into an empty tree */
+    ASSERT(!avl_tree_build_sorted(tree, items, N));
+    
+    /* Regular updates keep working on the built tree */
+    for (int i = 0; i < N; i += 2) {
+        ASSERT(avl_tree_remove(tree, i * 3));
+    }
+    avl_tree_insert(tree, 1, NULL);
+    ASSERT(avl_tree_size(tree) == N / 2 + 1);
+    ok = true;
+    subtree_height(avl_tree_get_root(tree), &ok);
+    ASSERT(ok);
+    
+    avl_tree_clear(tree);
+    ASSERT(avl_tree_build_sorted(tree, items, 0));
+    ASSERT(avl_tree_empty(tree));
+    
+    avl_tree_destroy(tree);
+    free(items);
+}
+
 TEST(avl_node_pool) {
     AVLTree* tree = avl_tree_create(NULL);
     
@@ -154,6 +210,83 @@ TEST(avl_node_pool) {
     avl_tree_destroy(tree);
 }
 
+TEST(avl_huge_page_pool) {
+    AVLHugePageMode modes[] = { AVL_HUGE_PAGES_TRANSPARENT, AVL_HUGE_PAGES_EXPLICIT };
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        AVLHugePageStats before, after;
+        avl_huge_pages_get_stats(&before);
+        avl_huge_pages_set_mode(modes[m]);
+
+        /* Enough nodes to span several 2 MB regions */
+        AVLTree* tree = avl_tree_create(NULL);
+        for (int i = 0; i < 200000; i++) {
+            avl_tree_insert(tree, (int64_t)i * 7919 % 1000003, NULL);
+        }
+        ASSERT(avl_tree_size(tree) == 200000);
+        for (int i = 0; i < 200000; i += 2) {
+            ASSERT(avl_tree_remove(tree, (int64_t)i * 7919 % 1000003));
+        }
+        for (int i = 1; i < 200000; i += 2) {
+            ASSERT(avl_tree_contains(tree, (int64_t)i * 7919 % 1000003));
+        }
+        avl_tree_clear(tree);
+        avl_tree_insert(tree, 42, NULL);
+        ASSERT(avl_tree_contains(tree, 42));
+        avl_tree_destroy(tree);
+
+        avl_huge_pages_get_stats(&after);
+        /* Each region either got the requested kind or was counted as a fallback */
+        ASSERT(after.explicit_regions + after.transparent_regions + after.fallbacks >
+               before.explicit_regions + before.transparent_regions + before.fallbacks);
+    }
+    avl_huge_pages_set_mode(AVL_HUGE_PAGES_OFF);
+}
+
+TEST(avl_pool_trim) {
+    avl_pool_depot_trim();
+    AVLTree* tree = avl_tree_create(NULL);
+    for (int i = 0; i < 100000; i++) {
+        avl_tree_insert(tree, i, NULL);
+    }
+    AVLPoolStats peak;
+    avl_pool_get_stats(&tree->pool, &peak);
+    ASSERT(peak.live_nodes == 100000);
+
+    /* Sequential deletes leave whole blocks free */
+    for (int i = 0; i < 90000; i++) {
+        ASSERT(avl_tree_remove(tree, i));
+    }
+    AVLPoolStats after;
+    avl_pool_get_stats(&tree->pool, &after);
+    ASSERT(after.live_nodes == 10000);
+    ASSERT(after.empty_blocks <= AVL_POOL_KEEP_EMPTY);
+    ASSERT(after.bytes < peak.bytes / 2);
+    ASSERT(avl_pool_depot_blocks() > 0);
+
+    size_t released = avl_tree_trim(tree);
+    ASSERT(released == after.empty_blocks * AVL_POOL_BLOCK_BYTES);
+    avl_pool_get_stats(&tree->pool, &after);
+    ASSERT(after.empty_blocks == 0);
+    for (int i = 90000; i < 100000; i++) {
+        ASSERT(avl_tree_contains(tree, i));
+    }
+
+    /* A second tree grows from the depot before calling malloc */
+    size_t depot = avl_pool_depot_blocks();
+    AVLTree* other = avl_tree_create(NULL);
+    for (int i = 0; i < 1000; i++) {
+        avl_tree_insert(other, i, NULL);
+    }
+    ASSERT(avl_pool_depot_blocks() < depot);
+    avl_tree_destroy(other);
+
+    ASSERT(avl_pool_depot_trim() > 0);
+    ASSERT(avl_pool_depot_blocks() == 0);
+    avl_tree_destroy(tree);
+    avl_pool_depot_trim();
+}
+
 /* ============================================================================
  * Hash Table Tests
  * ============================================================================ */
@@ -247,6 +380,50 @@ TEST(hash_robin_hood) {
     hash_table_destroy(table);
 }
 
+TEST(hash_group_probe_churn) {
+    HashTable* table = hash_table_create(16);
+    enum { KEYS = 4096 };
+    static size_t model[KEYS];      /* 0 = absent, else value */
+    memset(model, 0, sizeof(model));
+    
+    /* Random insert/update/remove mix: exercises tombstones, in-place
+     * rehash and growth against a direct-mapped model */
+    uint64_t rng = 88172645463325252ULL;
+    for (int op = 0; op < 200000; op++) {
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        int64_t key = (int64_t)(rng % KEYS);
+        if ((rng >> 32) % 3 == 0) {
+            bool removed = hash_table_remove(table, key * 977 - 5000);
+            ASSERT(removed == (model[key] != 0));
+            model[key] = 0;
+        } else {
+            size_t value = (size_t)op + 1;
+            ASSERT(hash_table_insert(table, key * 977 - 5000, value));
+            model[key] = value;
+        }
+    }
+    
+    size_t expected = 0;
+    for (int64_t k = 0; k < KEYS; k++) {
+        size_t value = 0;
+        bool found = hash_table_lookup(table, k * 977 - 5000, &value);
+        ASSERT(found == (model[k] != 0));
+        if (found) ASSERT(value == model[k]);
+        expected += model[k] != 0;
+    }
+    ASSERT(hash_table_size(table) == expected);
+    
+    /* Iterator sees exactly the live entries */
+    HashTableIterator iter = hash_table_iterator(table);
+    int64_t key;
+    size_t value, seen = 0;
+    while (hash_table_next(&iter, &key, &value)) seen++;
+    ASSERT(seen == expected);
+    ASSERT(hash_table_memory_bytes(table) >= expected * sizeof(HashEntry));
+    
+    hash_table_destroy(table);
+}
+
 /* ============================================================================
  * Parallel AVL Tests
  * ============================================================================ */
@@ -329,6 +506,158 @@ TEST(parallel_range_query) {
     parallel_avl_destroy(tree);
 }
 
+typedef struct {
+    int64_t last;
+    size_t count;
+    size_t stop_after;
+    bool ordered;
+} RangeWalk;
+
+static bool range_walk_callback(int64_t key, void* value, void* ctx) {
+    RangeWalk* w = (RangeWalk*)ctx;
+    (void)value;
+    if (w->count > 0 && key <= w->last) w->ordered = false;
+    w->last = key;
+    return ++w->count < w->stop_after;
+}
+
+TEST(parallel_range_foreach) {
+    ParallelAVL* tree = parallel_avl_create(8, ROUTER_STATIC_HASH);
+    for (int i = 0; i < 5000; i++) {
+        parallel_avl_insert(tree, (int64_t)i * 3, NULL);
+    }
+    parallel_avl_insert(tree, INT64_MIN, NULL);
+    parallel_avl_insert(tree, INT64_MAX, NULL);
+
+    /* Spans many batches per shard */
+    RangeWalk w = {0, 0, SIZE_MAX, true};
+    parallel_avl_range_foreach(tree, 0, 14997, range_walk_callback, &w);
+    ASSERT(w.ordered);
+    ASSERT(w.count == 5000);
+    ASSERT(w.last == 14997);
+
+    /* Early stop */
+    RangeWalk stop = {0, 0, 10, true};
+    parallel_avl_range_foreach(tree, 100, 14997, range_walk_callback, &stop);
+    ASSERT(stop.count == 10);
+    ASSERT(stop.last == 102 + 9 * 3);
+
+    /* Full keyspace including the extremes */
+    RangeWalk all = {0, 0, SIZE_MAX, true};
+    parallel_avl_range_foreach(tree, INT64_MIN, INT64_MAX, range_walk_callback, &all);
+    ASSERT(all.ordered);
+    ASSERT(all.count == 5002);
+    ASSERT(all.last == INT64_MAX);
+
+    /* Keys moved by a topology change are still merged in order */
+    parallel_avl_add_shard(tree);
+    parallel_avl_force_rebalance(tree);
+    RangeWalk moved = {0, 0, SIZE_MAX, true};
+    parallel_avl_range_foreach(tree, 0, INT64_MAX, range_walk_callback, &moved);
+    ASSERT(moved.ordered);
+    ASSERT(moved.count == 5001);
+
+    parallel_avl_destroy(tree);
+}
+
+TEST(parallel_range_page) {
+    ParallelAVL* tree = parallel_avl_create(4, ROUTER_STATIC_HASH);
+    for (int i = 0; i < 1000; i++) {
+        parallel_avl_insert(tree, i, (void*)(intptr_t)i);
+    }
+
+    /* Page through [100, 899] 70 keys at a time */
+    AVLKeyValue page[70];
+    int64_t lo = 100;
+    int64_t expect = 100;
+    size_t pages = 0;
+    bool more = true;
+    while (more) {
+        size_t count = 0;
+        more = parallel_avl_range_page(tree, lo, 899, page, 70, &count, &lo);
+        for (size_t i = 0; i < count; i++) {
+            ASSERT(page[i].key == expect);
+            ASSERT((intptr_t)page[i].value == expect);
+            expect++;
+        }
+        pages++;
+    }
+    ASSERT(expect == 900);
+    ASSERT(pages == 12);
+
+    /* Exact fit reports no further page */
+    size_t count = 0;
+    ASSERT(!parallel_avl_range_page(tree, 990, 999, page, 10, &count, &lo));
+    ASSERT(count == 10);
+
+    parallel_avl_destroy(tree);
+}
+
+TEST(avl_get_many) {
+    AVLTree* tree = avl_tree_create(NULL);
+    for (int i = 0; i < 1000; i += 2) {
+        avl_tree_insert(tree, i, (void*)(intptr_t)(i + 1));
+    }
+
+    /* 21 keys: two full interleaved groups plus a tail */
+    int64_t keys[21];
+    void* values[21];
+    bool found[21];
+    for (int i = 0; i < 21; i++) keys[i] = i * 37;
+    avl_tree_get_many(tree, keys, 21, values, found);
+    for (int i = 0; i < 21; i++) {
+        ASSERT(found[i] == (keys[i] % 2 == 0));
+        ASSERT((intptr_t)values[i] == (found[i] ? keys[i] + 1 : 0));
+    }
+    avl_tree_destroy(tree);
+}
+
+TEST(parallel_batched_ops) {
+    ParallelAVL* tree = parallel_avl_create(8, ROUTER_LOAD_AWARE);
+    enum { N = 3000 };
+    static int64_t keys[N];
+    static void* values[N];
+    static bool found[N];
+
+    for (int i = 0; i < N; i++) {
+        keys[i] = (int64_t)i * 7919 % 100003;
+        values[i] = (void*)(intptr_t)(i + 1);
+    }
+    ASSERT(parallel_avl_insert_many(tree, keys, values, N) == N);
+    ASSERT(parallel_avl_size(tree) == N);
+    /* Re-inserting updates values only */
+    ASSERT(parallel_avl_insert_many(tree, keys, values, N) == 0);
+    ASSERT(parallel_avl_size(tree) == N);
+
+    for (int i = 0; i < N; i++) {
+        ASSERT(parallel_avl_contains(tree, keys[i]));
+    }
+
+    /* Mix of hits and misses, scattered back to caller order */
+    static int64_t probe[2 * N];
+    static void* out[2 * N];
+    static bool hit[2 * N];
+    for (int i = 0; i < N; i++) {
+        probe[2 * i] = keys[i];
+        probe[2 * i + 1] = -1 - i;
+    }
+    ASSERT(parallel_avl_get_many(tree, probe, 2 * N, out, hit) == N);
+    for (int i = 0; i < N; i++) {
+        ASSERT(hit[2 * i] && (intptr_t)out[2 * i] == i + 1);
+        ASSERT(!hit[2 * i + 1] && out[2 * i + 1] == NULL);
+    }
+
+    /* Still found after keys move between shards */
+    parallel_avl_add_shard(tree);
+    parallel_avl_force_rebalance(tree);
+    ASSERT(parallel_avl_get_many(tree, keys, N, NULL, found) == N);
+    for (int i = 0; i < N; i++) {
+        ASSERT(found[i]);
+    }
+
+    parallel_avl_destroy(tree);
+}
+
 TEST(parallel_add_shard) {
     ParallelAVL* tree = parallel_avl_create(2, ROUTER_STATIC_HASH);
     
@@ -385,6 +714,305 @@ TEST(parallel_force_rebalance) {
     parallel_avl_destroy(tree);
 }
 
+typedef struct PoolCounter {
+    atomic_size sum;
+    atomic_size calls;
+} PoolCounter;
+
+static void pool_count_task(void* ctx, size_t index) {
+    PoolCounter* c = (PoolCounter*)ctx;
+    atomic_fetch_add_size(&c->sum, index);
+    atomic_fetch_add_size(&c->calls, 1);
+}
+
+TEST(worker_pool_run) {
+    WorkerPool* pool = worker_pool_create(4);
+    ASSERT(pool != NULL);
+    ASSERT(worker_pool_threads(pool) == 4);
+    
+    for (int round = 0; round < 50; round++) {
+        PoolCounter c;
+        atomic_store_size(&c.sum, 0);
+        atomic_store_size(&c.calls, 0);
+        worker_pool_run(pool, 1000, pool_count_task, &c);
+        ASSERT(atomic_load_size(&c.calls) == 1000);
+        ASSERT(atomic_load_size(&c.sum) == 1000 * 999 / 2);
+    }
+    worker_pool_destroy(pool);
+    
+    /* No pool / no helpers: serial on the caller */
+    PoolCounter c;
+    atomic_store_size(&c.sum, 0);
+    atomic_store_size(&c.calls, 0);
+    worker_pool_run(NULL, 10, pool_count_task, &c);
+    pool = worker_pool_create(0);
+    ASSERT(pool != NULL);
+    worker_pool_run(pool, 10, pool_count_task, &c);
+    worker_pool_destroy(pool);
+    ASSERT(atomic_load_size(&c.calls) == 20);
+    
+    ASSERT(worker_pool_shared() == worker_pool_shared());
+}
+
+TEST(parallel_rebalance_large) {
+    enum { N = 60000 };
+    ParallelAVL* tree = parallel_avl_create(6, ROUTER_LOAD_AWARE);
+    
+    /* Skewed keys push load-aware routing into redirects */
+    for (int i = 0; i < N; i++) {
+        parallel_avl_insert(tree, (int64_t)i * 6, (void*)(intptr_t)(i + 1));
+    }
+    ASSERT(parallel_avl_add_shard(tree));
+    ASSERT(parallel_avl_add_shard(tree));
+    
+    parallel_avl_force_rebalance(tree);
+    ASSERT(parallel_avl_size(tree) == N);
+    
+    size_t num_shards = parallel_avl_num_shards(tree);
+    for (int i = 0; i < N; i++) {
+        int64_t key = (int64_t)i * 6;
+        /* Every key sits in its hash shard */
+        TreeShard* home = tree->shards[pavl_hash(key) % num_shards];
+        bool found = false;
+        ASSERT(shard_get(home, key, &found) == (void*)(intptr_t)(i + 1) && found);
+    }
+    
+    /* Rebuilt shards carry exact key bounds */
+    for (size_t s = 0; s < num_shards; s++) {
+        ShardStats st = shard_get_stats(tree->shards[s]);
+        bool found = false;
+        ASSERT(st.has_keys);
+        ASSERT(st.min_key == avl_tree_min_key(tree->shards[s]->tree, &found) && found);
+        ASSERT(st.max_key == avl_tree_max_key(tree->shards[s]->tree, &found) && found);
+    }
+    
+    ParallelAVLStats stats = parallel_avl_get_stats(tree);
+    ASSERT(stats.total_size == N);
+    parallel_avl_free_stats(&stats);
+    ASSERT(parallel_avl_balance_score(tree) > 0.8);
+    
+    /* Range queries see every key once, in order */
+    AVLKeyValue page[128];
+    size_t count = 0;
+    int64_t next_lo = 0;
+    ASSERT(parallel_avl_range_page(tree, 600, 6000, page, 128, &count, &next_lo));
+    ASSERT(count == 128 && page[0].key == 600 && page[127].key == 600 + 127 * 6);
+    ASSERT(next_lo == 600 + 127 * 6 + 1);
+    
+    parallel_avl_destroy(tree);
+}
+
+TEST(parallel_remove_shard_large) {
+    enum { N = 40000 };
+    RouterStrategy strategies[] = {ROUTER_INTELLIGENT, ROUTER_CONSISTENT_HASH};
+    
+    for (size_t t = 0; t < 2; t++) {
+        ParallelAVL* tree = parallel_avl_create(6, strategies[t]);
+        for (int i = 0; i < N; i++) {
+            parallel_avl_insert(tree, i, (void*)(intptr_t)(i + 1));
+        }
+        
+        ASSERT(parallel_avl_remove_shard(tree));
+        ASSERT(parallel_avl_remove_shard(tree));
+        ASSERT(parallel_avl_num_shards(tree) == 4);
+        ASSERT(parallel_avl_size(tree) == N);
+        
+        for (int i = 0; i < N; i++) {
+            bool found = false;
+            ASSERT(parallel_avl_get(tree, i, &found) == (void*)(intptr_t)(i + 1) && found);
+        }
+        
+        parallel_avl_destroy(tree);
+    }
+}
+
+/* Sum of per-shard lookup counters */
+static size_t shards_probed(ParallelAVL* tree, size_t* lookups) {
+    size_t changed = 0;
+    for (size_t i = 0; i < tree->num_shards; i++) {
+        size_t now = shard_get_stats(tree->shards[i]).lookups;
+        changed += now != lookups[i];
+        lookups[i] = now;
+    }
+    return changed;
+}
+
+TEST(parallel_ring_scaling) {
+    enum { N = 20000 };
+    ParallelAVL* tree = parallel_avl_create(4, ROUTER_CONSISTENT_HASH);
+    ASSERT(tree->ring);
+    for (int i = 0; i < N; i++) {
+        parallel_avl_insert(tree, i, (void*)(intptr_t)(i + 1));
+    }
+    ASSERT(!tree->has_redirects);
+
+    ASSERT(parallel_avl_add_shard(tree));
+    ASSERT(parallel_avl_migrating(tree));
+    ASSERT(!tree->topology_changed);
+    ASSERT(parallel_avl_size(tree) == N);
+
+    /* A miss probes the home shard and at most one previous owner */
+    size_t lookups[8] = {0};
+    shards_probed(tree, lookups);
+    for (int i = 0; i < 100; i++) {
+        ASSERT(!parallel_avl_contains(tree, -1 - i));
+        ASSERT(shards_probed(tree, lookups) <= 2);
+    }
+
+    /* Interleave operations with a partial migration */
+    ASSERT(parallel_avl_migrate_step(tree, 1000) <= 1000);
+    for (int i = 0; i < N; i += 3) {
+        bool found = false;
+        ASSERT((intptr_t)parallel_avl_get(tree, i, &found) == i + 1);
+        ASSERT(found);
+    }
+    for (int i = 1; i < N; i += 3) {
+        parallel_avl_insert(tree, i, (void*)(intptr_t)(i + 2));
+    }
+    for (int i = 2; i < N; i += 30) {
+        ASSERT(parallel_avl_remove(tree, i));
+    }
+    size_t expected = N - (N - 2 + 29) / 30;
+    ASSERT(parallel_avl_size(tree) == expected);
+
+    parallel_avl_migrate_step(tree, SIZE_MAX);
+    ASSERT(!parallel_avl_migrating(tree));
+    ASSERT(parallel_avl_size(tree) == expected);
+
+    /* The new shard took a share of the keys (moved or rewritten there) */
+    ParallelAVLStats stats = parallel_avl_get_stats(tree);
+    size_t new_share = stats.shard_sizes[4];
+    ASSERT(new_share > expected / 20 && new_share < expected / 2);
+    ASSERT(stats.migrated_keys > 0 && stats.migrated_keys <= new_share);
+    parallel_avl_free_stats(&stats);
+
+    for (int i = 0; i < N; i++) {
+        bool found = false;
+        void* value = parallel_avl_get(tree, i, &found);
+        if (i % 30 == 2) {
+            ASSERT(!found);
+        } else {
+            ASSERT(found);
+            ASSERT((intptr_t)value == (i % 3 == 1 ? i + 2 : i + 1));
+        }
+    }
+
+    /* Every key is on its ring owner: misses probe one shard */
+    shards_probed(tree, lookups);
+    ASSERT(!parallel_avl_contains(tree, -5));
+    ASSERT(shards_probed(tree, lookups) == 1);
+
+    /* Shrinking re-places only the removed shard's keys */
+    ASSERT(parallel_avl_remove_shard(tree));
+    ASSERT(tree->num_shards == 4);
+    ASSERT(parallel_avl_size(tree) == expected);
+    ASSERT(!parallel_avl_migrating(tree));
+    for (int i = 0; i < N; i += 7) {
+        ASSERT(parallel_avl_contains(tree, i) == (i % 30 != 2));
+    }
+
+    parallel_avl_destroy(tree);
+}
+
+TEST(parallel_ring_repeated_growth) {
+    ParallelAVL* tree = parallel_avl_create(2, ROUTER_CONSISTENT_HASH);
+    for (int i = 0; i < 5000; i++) {
+        parallel_avl_insert(tree, (int64_t)i * 104729, NULL);
+    }
+    /* Each add settles the previous migration first */
+    for (int round = 0; round < 4; round++) {
+        ASSERT(parallel_avl_add_shard(tree));
+        parallel_avl_migrate_step(tree, 500);
+    }
+    ASSERT(tree->num_shards == 6);
+
+    static int64_t keys[5000];
+    static bool found[5000];
+    for (int i = 0; i < 5000; i++) keys[i] = (int64_t)i * 104729;
+    ASSERT(parallel_avl_get_many(tree, keys, 5000, NULL, found) == 5000);
+
+    RangeWalk w = {0, 0, SIZE_MAX, true};
+    parallel_avl_range_foreach(tree, 0, INT64_MAX, range_walk_callback, &w);
+    ASSERT(w.ordered);
+    ASSERT(w.count == 5000);
+
+    parallel_avl_force_rebalance(tree);
+    ASSERT(!parallel_avl_migrating(tree));
+    ASSERT(parallel_avl_size(tree) == 5000);
+    parallel_avl_destroy(tree);
+}
+
+/*
+ * Task 0 drives the migration in small steps. Task t > 0 owns the key pairs
+ * (2j, 2j + 1) with j % (num_tasks - 1) == t - 1: it keeps reading the odd
+ * keys and removes the even ones meanwhile. A key moved between a home miss
+ * and the stale-owner probe must still be found.
+ */
+typedef struct {
+    ParallelAVL* tree;
+    size_t num_tasks;
+    int pairs;
+    atomic_size errors;
+} RingRace;
+
+static void ring_race_task(void* ctx, size_t index) {
+    RingRace* r = (RingRace*)ctx;
+    if (index == 0) {
+        while (parallel_avl_migrating(r->tree)) {
+            parallel_avl_migrate_step(r->tree, 16);
+        }
+        return;
+    }
+    int workers = (int)r->num_tasks - 1;
+    int next_remove = (int)index - 1;
+    do {
+        for (int j = (int)index - 1; j < r->pairs; j += workers) {
+            int64_t key = 2 * j + 1;
+            bool found = false;
+            void* value = parallel_avl_get(r->tree, key, &found);
+            if (!found || (intptr_t)value != key + 1) atomic_fetch_add_size(&r->errors, 1);
+            if (!parallel_avl_contains(r->tree, key)) atomic_fetch_add_size(&r->errors, 1);
+            
+            if (next_remove < r->pairs) {
+                if (!parallel_avl_remove(r->tree, 2 * next_remove)) {
+                    atomic_fetch_add_size(&r->errors, 1);
+                }
+                next_remove += workers;
+            }
+        }
+    } while (parallel_avl_migrating(r->tree));
+}
+
+TEST(parallel_ring_concurrent_migration) {
+    enum { N = 20000 };
+    WorkerPool* pool = worker_pool_create(4);
+    ASSERT(pool != NULL);
+    
+    for (int round = 0; round < 20; round++) {
+        ParallelAVL* tree = parallel_avl_create(4, ROUTER_CONSISTENT_HASH);
+        for (int i = 0; i < N; i++) {
+            parallel_avl_insert(tree, i, (void*)(intptr_t)(i + 1));
+        }
+        ASSERT(parallel_avl_add_shard(tree));
+        ASSERT(parallel_avl_migrating(tree));
+        
+        RingRace r = {tree, 5, N / 2, 0};
+        atomic_store_size(&r.errors, 0);
+        worker_pool_run(pool, r.num_tasks, ring_race_task, &r);
+        ASSERT(atomic_load_size(&r.errors) == 0);
+        ASSERT(!parallel_avl_migrating(tree));
+        ASSERT(parallel_avl_size(tree) == N / 2);
+        
+        /* Router loads match the shards: no insertion counted twice */
+        for (size_t s = 0; s < tree->num_shards; s++) {
+            ASSERT(atomic_load_size(&tree->router->shard_loads[s]) ==
+                   shard_size(tree->shards[s]));
+        }
+        parallel_avl_destroy(tree);
+    }
+    worker_pool_destroy(pool);
+}
+
 TEST(parallel_routing_strategies) {
     RouterStrategy strategies[] = {
         ROUTER_STATIC_HASH,
@@ -429,6 +1057,179 @@ TEST(parallel_large_scale) {
     parallel_avl_destroy(tree);
 }
 
+TEST(parallel_trim) {
+    ParallelAVL* tree = parallel_avl_create(8, ROUTER_STATIC_HASH);
+    for (int i = 0; i < 200000; i++) {
+        parallel_avl_insert(tree, i, NULL);
+    }
+    /* Peak-then-baseline: drop 80% of the keys */
+    for (int i = 0; i < 160000; i++) {
+        ASSERT(parallel_avl_remove(tree, i));
+    }
+    ASSERT(parallel_avl_trim(tree) > 0);
+    ASSERT(avl_pool_depot_blocks() == 0);
+    ASSERT(parallel_avl_trim(tree) == 0);
+
+    ASSERT(parallel_avl_size(tree) == 40000);
+    for (int i = 160000; i < 200000; i += 97) {
+        ASSERT(parallel_avl_contains(tree, i));
+    }
+    parallel_avl_destroy(tree);
+    avl_pool_depot_trim();
+}
+
+/* ============================================================================
+ * Byte-String Key Tests
+ * ============================================================================ */
+
+/* Key i: "k" + zero-padded decimal, long keys get a shared 16-byte stem */
+static size_t make_bytes_key(char* buf, int i, bool long_key) {
+    if (long_key) return (size_t)sprintf(buf, "shared/prefix/%08d", i);
+    return (size_t)sprintf(buf, "k%05d", i);
+}
+
+typedef struct {
+    char prev[64];
+    size_t prev_len;
+    size_t count;
+    bool ordered;
+} BytesOrderCtx;
+
+static bool bytes_order_callback(const void* key, size_t len, void* value, void* ctx) {
+    BytesOrderCtx* c = (BytesOrderCtx*)ctx;
+    (void)value;
+    if (c->count > 0) {
+        size_t m = len < c->prev_len ? len : c->prev_len;
+        int cmp = memcmp(c->prev, key, m);
+        if (cmp > 0 || (cmp == 0 && c->prev_len >= len)) c->ordered = false;
+    }
+    memcpy(c->prev, key, len);
+    c->prev_len = len;
+    c->count++;
+    return true;
+}
+
+TEST(bytes_tree_order) {
+    AVLBytesTree* tree = avl_bytes_tree_create(NULL);
+    
+    /* Prefix-of-each-other keys, embedded zeros, short and long */
+    const char* keys[] = {"", "a", "ab", "ab\0", "abcdefgh", "abcdefgh\0",
+                          "abcdefghi", "abcdefghij", "b", "abcdefgg~~~~~~~~~~"};
+    size_t lens[] = {0, 1, 2, 3, 8, 9, 9, 10, 1, 18};
+    size_t n = sizeof(lens) / sizeof(lens[0]);
+    
+    for (size_t i = 0; i < n; i++) {
+        ASSERT(avl_bytes_tree_insert(tree, keys[i], lens[i], (void*)(intptr_t)(i + 1)));
+    }
+    ASSERT(!avl_bytes_tree_insert(tree, "ab", 2, (void*)(intptr_t)99));
+    ASSERT(avl_bytes_tree_size(tree) == n);
+    
+    for (size_t i = 0; i < n; i++) {
+        bool found;
+        void* v = avl_bytes_tree_get(tree, keys[i], lens[i], &found);
+        ASSERT(found);
+        ASSERT((intptr_t)v == (i == 2 ? 99 : (intptr_t)(i + 1)));
+    }
+    ASSERT(!avl_bytes_tree_contains(tree, "abcdefghk", 9));
+    
+    BytesOrderCtx ctx = {{0}, 0, 0, true};
+    avl_bytes_tree_foreach(tree, bytes_order_callback, &ctx);
+    ASSERT(ctx.ordered);
+    ASSERT(ctx.count == n);
+    
+    /* [ab, abcdefgh]: ab, ab\0, abcdefgg~..., abcdefgh */
+    ctx.count = 0;
+    avl_bytes_tree_range_foreach(tree, "ab", 2, "abcdefgh", 8, bytes_order_callback, &ctx);
+    ASSERT(ctx.ordered);
+    ASSERT(ctx.count == 4);
+    
+    avl_bytes_tree_destroy(tree);
+}
+
+TEST(bytes_tree_churn) {
+    AVLBytesTree* tree = avl_bytes_tree_create(NULL);
+    char buf[64];
+    
+    for (int i = 0; i < 5000; i++) {
+        size_t len = make_bytes_key(buf, i, i % 2 == 0);
+        ASSERT(avl_bytes_tree_insert(tree, buf, len, (void*)(intptr_t)i));
+    }
+    size_t peak_key_bytes = avl_bytes_tree_key_bytes(tree);
+    ASSERT(peak_key_bytes > 0);
+    
+    for (int i = 0; i < 5000; i += 2) {
+        size_t len = make_bytes_key(buf, i, true);
+        ASSERT(avl_bytes_tree_remove(tree, buf, len));
+    }
+    ASSERT(avl_bytes_tree_size(tree) == 2500);
+    ASSERT(avl_bytes_tree_key_bytes(tree) == 0);
+    
+    /* Freed key slots are reused, not bump-allocated again */
+    for (int i = 0; i < 5000; i += 2) {
+        size_t len = make_bytes_key(buf, i, true);
+        ASSERT(avl_bytes_tree_insert(tree, buf, len, (void*)(intptr_t)i));
+    }
+    ASSERT(avl_bytes_tree_key_bytes(tree) == peak_key_bytes);
+    
+    /* Keys above the arena's largest class go to malloc */
+    char big[2000];
+    memset(big, 'x', sizeof(big));
+    ASSERT(avl_bytes_tree_insert(tree, big, sizeof(big), NULL));
+    ASSERT(avl_bytes_tree_contains(tree, big, sizeof(big)));
+    ASSERT(avl_bytes_tree_remove(tree, big, sizeof(big)));
+    
+    for (int i = 0; i < 5000; i++) {
+        size_t len = make_bytes_key(buf, i, i % 2 == 0);
+        bool found;
+        void* v = avl_bytes_tree_get(tree, buf, len, &found);
+        ASSERT(found && (intptr_t)v == i);
+    }
+    
+    avl_bytes_tree_destroy(tree);
+}
+
+TEST(parallel_bytes_keys) {
+    ParallelAVL* tree = parallel_avl_create(4, ROUTER_INTELLIGENT);
+    char buf[64];
+    
+    for (int i = 0; i < 2000; i++) {
+        size_t len = make_bytes_key(buf, i, i % 3 == 0);
+        ASSERT(parallel_avl_insert_bytes(tree, buf, len, (void*)(intptr_t)i));
+    }
+    /* int64 keyspace is independent */
+    parallel_avl_insert(tree, 7, NULL);
+    ASSERT(parallel_avl_bytes_size(tree) == 2000);
+    ASSERT(parallel_avl_size(tree) == 1);
+    
+    ASSERT(parallel_avl_add_shard(tree));
+    for (int i = 0; i < 2000; i++) {
+        size_t len = make_bytes_key(buf, i, i % 3 == 0);
+        bool found;
+        void* v = parallel_avl_get_bytes(tree, buf, len, &found);
+        ASSERT(found && (intptr_t)v == i);
+    }
+    /* Update after resize stays in the key's old shard: no duplicate */
+    ASSERT(!parallel_avl_insert_bytes(tree, "k00001", 6, (void*)(intptr_t)-1));
+    ASSERT(parallel_avl_bytes_size(tree) == 2000);
+    
+    ASSERT(parallel_avl_remove_shard(tree));
+    ASSERT(parallel_avl_remove_shard(tree));
+    ASSERT(parallel_avl_bytes_size(tree) == 2000);
+    
+    parallel_avl_force_rebalance(tree);
+    ASSERT(parallel_avl_bytes_size(tree) == 2000);
+    for (int i = 0; i < 2000; i++) {
+        size_t len = make_bytes_key(buf, i, i % 3 == 0);
+        ASSERT(parallel_avl_contains_bytes(tree, buf, len));
+        if (i % 2) ASSERT(parallel_avl_remove_bytes(tree, buf, len));
+    }
+    ASSERT(parallel_avl_bytes_size(tree) == 1000);
+    ASSERT(!parallel_avl_contains_bytes(tree, "k00001", 6));
+    ASSERT(parallel_avl_contains(tree, 7));
+    
+    parallel_avl_destroy(tree);
+}
+
 /* ============================================================================
  * Main
  * ============================================================================ */
@@ -442,6 +1243,11 @@ int main(void) {
     RUN_TEST(avl_min_max);
     RUN_TEST(avl_balance);
     RUN_TEST(avl_node_pool);
+    RUN_TEST(avl_huge_page_pool);
+    RUN_TEST(avl_pool_trim);
+    RUN_TEST(avl_get_many);
+    RUN_TEST(avl_build_sorted);
+    RUN_TEST(worker_pool_run);
     
     printf("\n=== Hash Table Unit Tests ===\n");
     RUN_TEST(hash_create_destroy);
@@ -449,6 +1255,7 @@ int main(void) {
     RUN_TEST(hash_remove);
     RUN_TEST(hash_resize);
     RUN_TEST(hash_robin_hood);
+    RUN_TEST(hash_group_probe_churn);
     
     printf("\n=== Parallel AVL Unit Tests ===\n");
     RUN_TEST(parallel_create_destroy);
@@ -456,11 +1263,25 @@ int main(void) {
     RUN_TEST(parallel_remove);
     RUN_TEST(parallel_get);
     RUN_TEST(parallel_range_query);
+    RUN_TEST(parallel_range_foreach);
+    RUN_TEST(parallel_range_page);
+    RUN_TEST(parallel_batched_ops);
     RUN_TEST(parallel_add_shard);
     RUN_TEST(parallel_remove_shard);
     RUN_TEST(parallel_force_rebalance);
+    RUN_TEST(parallel_rebalance_large);
+    RUN_TEST(parallel_remove_shard_large);
     RUN_TEST(parallel_routing_strategies);
+    RUN_TEST(parallel_ring_scaling);
+    RUN_TEST(parallel_ring_repeated_growth);
+    RUN_TEST(parallel_ring_concurrent_migration);
     RUN_TEST(parallel_large_scale);
+    RUN_TEST(parallel_trim);
+    
+    printf("\n=== Byte-String Key Unit Tests ===\n");
+    RUN_TEST(bytes_tree_order);
+    RUN_TEST(bytes_tree_churn);
+    RUN_TEST(parallel_bytes_keys);
     
     printf("\n=== Results ===\n");
     printf("Passed: %d\n", tests_passed);
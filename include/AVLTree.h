@@ -2,18 +2,37 @@
 #define AVL_TREE_H
 
 #include "BinarySearchTree.h"
+#include "Monoids.h"
 #include <algorithm>
+#include <type_traits>
+
+// Per-node storage for the subtree aggregate (nothing for NoAggregate)
+template<typename Monoid>
+struct AggregateSlot {
+    typename Monoid::value_type agg{};
+};
+
+template<>
+struct AggregateSlot<NoAggregate> {};
 
 // AVL tree implementation derived from BinarySearchTree. The Node used by the
 // base class already stores the required links, we only add a height field to
 // assist with balancing.
+//
+// With a Monoid (see Monoids.h) every node also stores the aggregate of its
+// subtree. It is recomputed together with the height, so inserts, removes and
+// rotations keep it current at no extra asymptotic cost, and reduceRange()
+// answers in O(log n) by combining whole-subtree aggregates.
 
-template<typename Key, typename Value = Key>
-class AVLTree : public BinarySearchTree<Key, Value> {
-    using Base = BinarySearchTree<Key, Value>;
+template<typename Key, typename Value = Key, typename Monoid = NoAggregate>
+class AVLTree : public BinarySearchTree<Key, Value, AggregateSlot<Monoid>> {
+    using Base = BinarySearchTree<Key, Value, AggregateSlot<Monoid>>;
+
+    static constexpr bool kAggregates = !std::is_same_v<Monoid, NoAggregate>;
 
 public:
     using Node = typename Base::Node;
+    using MonoidType = Monoid;
 
 private:
 
@@ -22,7 +41,24 @@ private:
     int balanceFactor(Node* n) const { return height(n->right) - height(n->left); }
 
     void updateHeight(Node* n) {
-        if (n) n->height = 1 + std::max(height(n->left), height(n->right));
+        if (n) {
+            n->height = 1 + std::max(height(n->left), height(n->right));
+            if constexpr (kAggregates) pullAggregate(n);
+        }
+    }
+
+    static auto aggregateOf(const Node* n) {
+        return n ? n->agg : Monoid::identity();
+    }
+
+    static auto lift(const Node* n) {
+        return Monoid::lift(n->key, n->value);
+    }
+
+    // agg = left + self + right, in key order
+    static void pullAggregate(Node* n) {
+        n->agg = Monoid::combine(aggregateOf(n->left),
+                                 Monoid::combine(lift(n), aggregateOf(n->right)));
     }
 
     Node* rotateLeft(Node* x) {
@@ -87,11 +123,63 @@ protected:
         }
     }
 
+    void valueUpdated(Node* node) override {
+        if constexpr (kAggregates) {
+            for (Node* n = node; n; n = n->parent) {
+                pullAggregate(n);
+            }
+        } else {
+            (void)node;
+        }
+    }
+
 public:
     AVLTree() : Base() {}
 
     // Allow access to root for parallel tree extraction
     Node* getRoot() const { return this->root_; }
+
+    // Aggregate of the whole tree
+    auto aggregate() const {
+        static_assert(kAggregates, "AVLTree needs a Monoid for aggregates");
+        return aggregateOf(this->root_);
+    }
+
+    // Aggregate of all entries with keys in [lo, hi], in O(log n): find the
+    // node where the search paths for lo and hi split, then walk both paths
+    // and take whole subtrees that lie entirely inside the range.
+    auto reduceRange(const Key& lo, const Key& hi) const {
+        static_assert(kAggregates, "AVLTree needs a Monoid for aggregates");
+        Node* split = this->root_;
+        while (split && !(split->key >= lo && split->key <= hi)) {
+            split = (split->key < lo) ? split->right : split->left;
+        }
+        if (!split) return Monoid::identity();
+
+        // Left path: keys >= lo, gathered right to left
+        auto left = Monoid::identity();
+        for (Node* n = split->left; n;) {
+            if (n->key >= lo) {
+                left = Monoid::combine(lift(n), Monoid::combine(aggregateOf(n->right), left));
+                n = n->left;
+            } else {
+                n = n->right;
+            }
+        }
+
+        // Right path: keys <= hi, gathered left to right
+        auto right = Monoid::identity();
+        for (Node* n = split->right; n;) {
+            if (n->key <= hi) {
+                right = Monoid::combine(right, Monoid::combine(aggregateOf(n->left), lift(n)));
+                n = n->right;
+            } else {
+                n = n->left;
+            }
+        }
+
+        return Monoid::combine(left, Monoid::combine(lift(split), right));
+    }
 };
 
 #endif // AVL_TREE_H
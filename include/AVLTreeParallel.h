@@ -3,6 +3,7 @@
 
 #include "BaseTree.h"
 #include "AVLTree.h"
+#include "queue_lock.hpp"
 #include <vector>
 #include <mutex>
 #include <memory>
@@ -44,7 +45,7 @@ private:
     // Cada "shard" es un árbol AVL independiente con su lock
     struct TreeShard {
         AVLTree<Key, Value> tree;
-        mutable std::mutex lock;
+        mutable DefaultShardMutex lock;
         size_t local_size;
 
         // Para range-based routing
@@ -102,7 +103,7 @@ public:
         size_t shard_idx = getShardIndex(key);
         auto& shard = shards_[shard_idx];
 
-        std::lock_guard<std::mutex> lock(shard->lock);
+        std::lock_guard<DefaultShardMutex> lock(shard->lock);
 
         size_t old_size = shard->tree.size();
         shard->tree.insert(key, value);
@@ -118,7 +119,7 @@ public:
         size_t shard_idx = getShardIndex(key);
         auto& shard = shards_[shard_idx];
 
-        std::lock_guard<std::mutex> lock(shard->lock);
+        std::lock_guard<DefaultShardMutex> lock(shard->lock);
 
         size_t old_size = shard->tree.size();
         shard->tree.remove(key);
@@ -134,7 +135,7 @@ public:
         size_t shard_idx = getShardIndex(key);
         auto& shard = shards_[shard_idx];
 
-        std::lock_guard<std::mutex> lock(shard->lock);
+        std::lock_guard<DefaultShardMutex> lock(shard->lock);
         return shard->tree.contains(key);
     }
 
@@ -143,7 +144,7 @@ public:
         size_t shard_idx = getShardIndex(key);
         auto& shard = shards_[shard_idx];
 
-        std::lock_guard<std::mutex> lock(shard->lock);
+        std::lock_guard<DefaultShardMutex> lock(shard->lock);
         return shard->tree.get(key);
     }
 
@@ -152,7 +153,7 @@ public:
         std::size_t total = 0;
 
         // Lock todos los shards para consistencia
-        std::vector<std::unique_lock<std::mutex>> locks;
+        std::vector<std::unique_lock<DefaultShardMutex>> locks;
         for (const auto& shard : shards_) {
             locks.emplace_back(shard->lock);
         }
@@ -166,7 +167,7 @@ public:
 
     void clear() {
         for (auto& shard : shards_) {
-            std::lock_guard<std::mutex> lock(shard->lock);
+            std::lock_guard<DefaultShardMutex> lock(shard->lock);
             shard->tree.clear();
             shard->local_size = 0;
         }
@@ -177,6 +178,7 @@ public:
         size_t shard_id;
         size_t element_count;
         double load_percentage;
+        LockContentionStats lock;
     };
 
     std::vector<ShardStats> getShardStats() const {
@@ -184,12 +186,13 @@ public:
         size_t total = size();
 
         for (size_t i = 0; i < num_shards_; ++i) {
-            std::lock_guard<std::mutex> lock(shards_[i]->lock);
+            std::lock_guard<DefaultShardMutex> lock(shards_[i]->lock);
 
             ShardStats s;
             s.shard_id = i;
             s.element_count = shards_[i]->local_size;
             s.load_percentage = total > 0 ? (100.0 * s.element_count / total) : 0.0;
+            s.lock = shards_[i]->lock.contention_stats();
 
             stats.push_back(s);
         }
@@ -258,7 +261,7 @@ public:
     // Rebalanceo entre árboles (si un árbol tiene mucho más que otros)
     void rebalanceShards(double threshold = 2.0) {
         // Lock todos los shards para operación atómica
-        std::vector<std::unique_lock<std::mutex>> locks;
+        std::vector<std::unique_lock<DefaultShardMutex>> locks;
         for (auto& shard : shards_) {
             locks.emplace_back(shard->lock);
         }
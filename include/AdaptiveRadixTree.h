@@ -0,0 +1,648 @@
+#ifndef ADAPTIVE_RADIX_TREE_H
+#define ADAPTIVE_RADIX_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Adaptive radix tree (Leis et al., ICDE'13) for integral keys, with the same
+// sequential API as AVLTree so it can back a TreeShard:
+// TreeShard<Key, Value, AdaptiveRadixTree<Key, Value>>.
+//
+// A key is indexed by its bytes, most significant first, so a lookup takes at
+// most sizeof(Key) steps no matter how many keys are stored, and never
+// compares whole keys except once at the leaf. Inner nodes grow and shrink
+// between four layouts (Node4/16/48/256) to keep dense and sparse fan-outs
+// compact. Path compression stores runs of single-child bytes in the node
+// prefix; keys are at most 8 bytes, so prefixes are always stored in full.
+//
+// Signed keys are stored with the sign bit flipped, which makes byte order
+// equal numeric order: children are visited in byte order, so in-order
+// traversal and range scans come out sorted.
+
+template<typename Key, typename Value = Key>
+class AdaptiveRadixTree {
+    static_assert(std::is_integral_v<Key>, "AdaptiveRadixTree requires integral keys");
+
+public:
+    static constexpr int KEY_BYTES = static_cast<int>(sizeof(Key));
+
+private:
+    enum NodeType : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+    struct Node {
+        NodeType type;
+        uint8_t prefix_len = 0;
+        uint16_t count = 0;
+        uint8_t prefix[KEY_BYTES]{};
+
+        explicit Node(NodeType t) : type(t) {}
+    };
+
+    struct Node4 : Node {
+        uint8_t keys[4]{};
+        Node* children[4]{};
+        Node4() : Node(NODE4) {}
+    };
+
+    struct Node16 : Node {
+        alignas(16) uint8_t keys[16]{};
+        Node* children[16]{};
+        Node16() : Node(NODE16) {}
+    };
+
+    struct Node48 : Node {
+        uint8_t child_index[256]{};   // 0 = empty, otherwise slot + 1
+        Node* children[48]{};
+        Node48() : Node(NODE48) {}
+    };
+
+    struct Node256 : Node {
+        Node* children[256]{};
+        Node256() : Node(NODE256) {}
+    };
+
+    struct Leaf {
+        Key key;
+        Value value;
+    };
+
+    // Leaves are stored in child slots as tagged pointers (low bit set)
+    static bool is_leaf(const Node* n) { return reinterpret_cast<uintptr_t>(n) & 1; }
+    static Leaf* as_leaf(const Node* n) {
+        return reinterpret_cast<Leaf*>(reinterpret_cast<uintptr_t>(n) & ~uintptr_t{1});
+    }
+    static Node* tag_leaf(Leaf* l) {
+        return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(l) | 1);
+    }
+
+    using KeyBytes = uint8_t[KEY_BYTES];
+
+    static void to_bytes(const Key& key, KeyBytes out) {
+        using U = std::make_unsigned_t<Key>;
+        U u = static_cast<U>(key);
+        if constexpr (std::is_signed_v<Key>) {
+            u ^= U{1} << (KEY_BYTES * 8 - 1);
+        }
+        for (int i = KEY_BYTES - 1; i >= 0; --i) {
+            out[i] = static_cast<uint8_t>(u & 0xFF);
+            u = static_cast<U>(u >> 8);
+        }
+    }
+
+    Node* root_ = nullptr;
+    size_t size_ = 0;
+
+    // ------------------------------------------------------------------------
+    // Child lookup
+    // ------------------------------------------------------------------------
+
+    static Node** find_child(Node* node, uint8_t byte) {
+        switch (node->type) {
+            case NODE4: {
+                Node4* n = static_cast<Node4*>(node);
+                for (int i = 0; i < n->count; ++i) {
+                    if (n->keys[i] == byte) return &n->children[i];
+                }
+                return nullptr;
+            }
+            case NODE16: {
+                Node16* n = static_cast<Node16*>(node);
+#if defined(__SSE2__)
+                __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                             _mm_load_si128(reinterpret_cast<const __m128i*>(n->keys)));
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1u << n->count) - 1);
+                return mask ? &n->children[__builtin_ctz(mask)] : nullptr;
+#else
+                for (int i = 0; i < n->count; ++i) {
+                    if (n->keys[i] == byte) return &n->children[i];
+                }
+                return nullptr;
+#endif
+            }
+            case NODE48: {
+                Node48* n = static_cast<Node48*>(node);
+                uint8_t slot = n->child_index[byte];
+                return slot ? &n->children[slot - 1] : nullptr;
+            }
+            case NODE256: {
+                Node256* n = static_cast<Node256*>(node);
+                return n->children[byte] ? &n->children[byte] : nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    // Number of prefix bytes of node that match key starting at depth
+    static int prefix_match(const Node* node, const KeyBytes kb, int depth) {
+        int i = 0;
+        while (i < node->prefix_len && node->prefix[i] == kb[depth + i]) ++i;
+        return i;
+    }
+
+    // ------------------------------------------------------------------------
+    // Growth / shrink between node layouts
+    // ------------------------------------------------------------------------
+
+    static void copy_header(Node* dst, const Node* src) {
+        dst->count = src->count;
+        dst->prefix_len = src->prefix_len;
+        std::memcpy(dst->prefix, src->prefix, KEY_BYTES);
+    }
+
+    // Inserts byte -> child into node (which has no child for byte), growing
+    // it into the next layout through ref when it is full
+    static void add_child(Node*& ref, uint8_t byte, Node* child) {
+        Node* node = ref;
+        switch (node->type) {
+            case NODE4: {
+                Node4* n = static_cast<Node4*>(node);
+                if (n->count < 4) {
+                    insert_sorted(n->keys, n->children, n->count, byte, child);
+                    return;
+                }
+                Node16* g = new Node16();
+                copy_header(g, n);
+                std::copy(n->keys, n->keys + 4, g->keys);
+                std::copy(n->children, n->children + 4, g->children);
+                delete n;
+                ref = g;
+                insert_sorted(g->keys, g->children, g->count, byte, child);
+                return;
+            }
+            case NODE16: {
+                Node16* n = static_cast<Node16*>(node);
+                if (n->count < 16) {
+                    insert_sorted(n->keys, n->children, n->count, byte, child);
+                    return;
+                }
+                Node48* g = new Node48();
+                copy_header(g, n);
+                for (int i = 0; i < 16; ++i) {
+                    g->children[i] = n->children[i];
+                    g->child_index[n->keys[i]] = static_cast<uint8_t>(i + 1);
+                }
+                delete n;
+                ref = g;
+                add_child(ref, byte, child);
+                return;
+            }
+            case NODE48: {
+                Node48* n = static_cast<Node48*>(node);
+                if (n->count < 48) {
+                    int slot = 0;
+                    while (n->children[slot]) ++slot;
+                    n->children[slot] = child;
+                    n->child_index[byte] = static_cast<uint8_t>(slot + 1);
+                    n->count++;
+                    return;
+                }
+                Node256* g = new Node256();
+                copy_header(g, n);
+                for (int b = 0; b < 256; ++b) {
+                    if (n->child_index[b]) g->children[b] = n->children[n->child_index[b] - 1];
+                }
+                delete n;
+                ref = g;
+                add_child(ref, byte, child);
+                return;
+            }
+            case NODE256: {
+                Node256* n = static_cast<Node256*>(node);
+                n->children[byte] = child;
+                n->count++;
+                return;
+            }
+        }
+    }
+
+    static void insert_sorted(uint8_t* keys, Node** children, uint16_t& count, uint8_t byte, Node* child) {
+        int pos = 0;
+        while (pos < count && keys[pos] < byte) ++pos;
+        std::copy_backward(keys + pos, keys + count, keys + count + 1);
+        std::copy_backward(children + pos, children + count, children + count + 1);
+        keys[pos] = byte;
+        children[pos] = child;
+        count++;
+    }
+
+    static void erase_sorted(uint8_t* keys, Node** children, uint16_t& count, Node** slot) {
+        int pos = static_cast<int>(slot - children);
+        std::copy(keys + pos + 1, keys + count, keys + pos);
+        std::copy(children + pos + 1, children + count, children + pos);
+        count--;
+    }
+
+    // Removes the child at slot (already freed) and shrinks node through ref.
+    // Thresholds sit below the growth points to avoid grow/shrink ping-pong.
+    static void remove_child(Node*& ref, Node** slot, uint8_t byte) {
+        Node* node = ref;
+        switch (node->type) {
+            case NODE4: {
+                Node4* n = static_cast<Node4*>(node);
+                erase_sorted(n->keys, n->children, n->count, slot);
+                if (n->count == 1) collapse(ref);
+                return;
+            }
+            case NODE16: {
+                Node16* n = static_cast<Node16*>(node);
+                erase_sorted(n->keys, n->children, n->count, slot);
+                if (n->count == 3) {
+                    Node4* s = new Node4();
+                    copy_header(s, n);
+                    std::copy(n->keys, n->keys + 3, s->keys);
+                    std::copy(n->children, n->children + 3, s->children);
+                    delete n;
+                    ref = s;
+                }
+                return;
+            }
+            case NODE48: {
+                Node48* n = static_cast<Node48*>(node);
+                *slot = nullptr;
+                n->child_index[byte] = 0;
+                n->count--;
+                if (n->count == 12) {
+                    Node16* s = new Node16();
+                    copy_header(s, n);
+                    int j = 0;
+                    for (int b = 0; b < 256; ++b) {
+                        if (n->child_index[b]) {
+                            s->keys[j] = static_cast<uint8_t>(b);
+                            s->children[j++] = n->children[n->child_index[b] - 1];
+                        }
+                    }
+                    delete n;
+                    ref = s;
+                }
+                return;
+            }
+            case NODE256: {
+                Node256* n = static_cast<Node256*>(node);
+                *slot = nullptr;
+                n->count--;
+                if (n->count == 37) {
+                    Node48* s = new Node48();
+                    copy_header(s, n);
+                    int j = 0;
+                    for (int b = 0; b < 256; ++b) {
+                        if (n->children[b]) {
+                            s->children[j] = n->children[b];
+                            s->child_index[b] = static_cast<uint8_t>(++j);
+                        }
+                    }
+                    delete n;
+                    ref = s;
+                }
+                return;
+            }
+        }
+    }
+
+    // Node4 left with one child: splice the child in, merging prefixes
+    static void collapse(Node*& ref) {
+        Node4* n = static_cast<Node4*>(ref);
+        Node* child = n->children[0];
+        if (!is_leaf(child)) {
+            // New prefix = n.prefix + edge byte + child.prefix (fits: depth <= KEY_BYTES)
+            uint8_t merged[KEY_BYTES];
+            int len = n->prefix_len;
+            std::memcpy(merged, n->prefix, len);
+            merged[len++] = n->keys[0];
+            std::memcpy(merged + len, child->prefix, child->prefix_len);
+            len += child->prefix_len;
+            std::memcpy(child->prefix, merged, len);
+            child->prefix_len = static_cast<uint8_t>(len);
+        }
+        delete n;
+        ref = child;
+    }
+
+    static void free_node(Node* node) {
+        switch (node->type) {
+            case NODE4: delete static_cast<Node4*>(node); break;
+            case NODE16: delete static_cast<Node16*>(node); break;
+            case NODE48: delete static_cast<Node48*>(node); break;
+            case NODE256: delete static_cast<Node256*>(node); break;
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // Ordered traversal
+    // ------------------------------------------------------------------------
+
+    // Visits children in byte order; f returns false to stop early
+    template<typename F>
+    static bool for_each_child(Node* node, int from, F f) {
+        switch (node->type) {
+            case NODE4: {
+                Node4* n = static_cast<Node4*>(node);
+                for (int i = 0; i < n->count; ++i) {
+                    if (n->keys[i] >= from && !f(n->keys[i], n->children[i])) return false;
+                }
+                return true;
+            }
+            case NODE16: {
+                Node16* n = static_cast<Node16*>(node);
+                for (int i = 0; i < n->count; ++i) {
+                    if (n->keys[i] >= from && !f(n->keys[i], n->children[i])) return false;
+                }
+                return true;
+            }
+            case NODE48: {
+                Node48* n = static_cast<Node48*>(node);
+                for (int b = from; b < 256; ++b) {
+                    uint8_t slot = n->child_index[b];
+                    if (slot && !f(static_cast<uint8_t>(b), n->children[slot - 1])) return false;
+                }
+                return true;
+            }
+            case NODE256: {
+                Node256* n = static_cast<Node256*>(node);
+                for (int b = from; b < 256; ++b) {
+                    if (n->children[b] && !f(static_cast<uint8_t>(b), n->children[b])) return false;
+                }
+                return true;
+            }
+        }
+        return true;
+    }
+
+    // lo_tight/hi_tight: the path so far equals the prefix of lo/hi, so bytes
+    // below lo (above hi) at this depth can be pruned. Returns false once the
+    // scan passed hi.
+    template<typename F>
+    bool range_rec(Node* node, int depth, const KeyBytes lo, const KeyBytes hi,
+                   bool lo_tight, bool hi_tight, const Key& klo, const Key& khi, F& f) const {
+        if (is_leaf(node)) {
+            const Leaf* leaf = as_leaf(node);
+            if (khi < leaf->key) return false;
+            if (!(leaf->key < klo)) f(leaf->key, leaf->value);
+            return true;
+        }
+
+        for (int i = 0; i < node->prefix_len; ++i, ++depth) {
+            uint8_t b = node->prefix[i];
+            if (lo_tight) {
+                if (b < lo[depth]) return true;     // whole subtree below lo
+                if (b > lo[depth]) lo_tight = false;
+            }
+            if (hi_tight) {
+                if (b > hi[depth]) return false;    // whole subtree above hi
+                if (b < hi[depth]) hi_tight = false;
+            }
+        }
+
+        int from = lo_tight ? lo[depth] : 0;
+        return for_each_child(node, from, [&](uint8_t b, Node* child) {
+            if (hi_tight && b > hi[depth]) return false;
+            return range_rec(child, depth + 1, lo, hi,
+                             lo_tight && b == lo[depth], hi_tight && b == hi[depth], klo, khi, f);
+        });
+    }
+
+    template<typename F>
+    static void for_each_rec(Node* node, F& f) {
+        if (is_leaf(node)) {
+            const Leaf* leaf = as_leaf(node);
+            f(leaf->key, leaf->value);
+            return;
+        }
+        for_each_child(node, 0, [&f](uint8_t, Node* child) {
+            for_each_rec(child, f);
+            return true;
+        });
+    }
+
+    // Leftmost (Min) or rightmost leaf under node
+    template<bool Min>
+    static const Leaf* extreme_leaf(Node* node) {
+        while (node && !is_leaf(node)) {
+            Node* next = nullptr;
+            if constexpr (Min) {
+                for_each_child(node, 0, [&next](uint8_t, Node* child) {
+                    next = child;
+                    return false;
+                });
+            } else {
+                for_each_child(node, 0, [&next](uint8_t, Node* child) {
+                    next = child;
+                    return true;
+                });
+            }
+            node = next;
+        }
+        return node ? as_leaf(node) : nullptr;
+    }
+
+    static void destroy(Node* node) {
+        if (!node) return;
+        if (is_leaf(node)) {
+            delete as_leaf(node);
+            return;
+        }
+        for_each_child(node, 0, [](uint8_t, Node* child) {
+            destroy(child);
+            return true;
+        });
+        free_node(node);
+    }
+
+    // ------------------------------------------------------------------------
+    // Insert / remove
+    // ------------------------------------------------------------------------
+
+    // Returns true if a new key was added (false: value updated)
+    bool insert_rec(Node*& ref, const KeyBytes kb, int depth, const Key& key, const Value& value) {
+        Node* node = ref;
+        if (!node) {
+            ref = tag_leaf(new Leaf{key, value});
+            return true;
+        }
+
+        if (is_leaf(node)) {
+            Leaf* existing = as_leaf(node);
+            if (existing->key == key) {
+                existing->value = value;
+                return false;
+            }
+            // Split: new Node4 holding both leaves under their common prefix
+            KeyBytes eb;
+            to_bytes(existing->key, eb);
+            int i = depth;
+            while (kb[i] == eb[i]) ++i;
+
+            Node4* n = new Node4();
+            n->prefix_len = static_cast<uint8_t>(i - depth);
+            std::memcpy(n->prefix, kb + depth, i - depth);
+            Node* nref = n;
+            add_child(nref, eb[i], node);
+            add_child(nref, kb[i], tag_leaf(new Leaf{key, value}));
+            ref = nref;
+            return true;
+        }
+
+        if (node->prefix_len) {
+            int p = prefix_match(node, kb, depth);
+            if (p < node->prefix_len) {
+                // Prefix mismatch: split the compressed path at p
+                Node4* n = new Node4();
+                n->prefix_len = static_cast<uint8_t>(p);
+                std::memcpy(n->prefix, node->prefix, p);
+                uint8_t edge = node->prefix[p];
+                node->prefix_len = static_cast<uint8_t>(node->prefix_len - p - 1);
+                std::memmove(node->prefix, node->prefix + p + 1, node->prefix_len);
+
+                Node* nref = n;
+                add_child(nref, edge, node);
+                add_child(nref, kb[depth + p], tag_leaf(new Leaf{key, value}));
+                ref = nref;
+                return true;
+            }
+            depth += node->prefix_len;
+        }
+
+        Node** child = find_child(node, kb[depth]);
+        if (child) {
+            return insert_rec(*child, kb, depth + 1, key, value);
+        }
+        add_child(ref, kb[depth], tag_leaf(new Leaf{key, value}));
+        return true;
+    }
+
+    bool remove_rec(Node*& ref, const KeyBytes kb, int depth, const Key& key) {
+        Node* node = ref;
+        if (is_leaf(node)) {
+            // Only reachable for a root leaf
+            if (as_leaf(node)->key != key) return false;
+            delete as_leaf(node);
+            ref = nullptr;
+            return true;
+        }
+
+        if (prefix_match(node, kb, depth) < node->prefix_len) return false;
+        depth += node->prefix_len;
+
+        Node** child = find_child(node, kb[depth]);
+        if (!child) return false;
+
+        if (is_leaf(*child)) {
+            if (as_leaf(*child)->key != key) return false;
+            delete as_leaf(*child);
+            remove_child(ref, child, kb[depth]);
+            return true;
+        }
+        return remove_rec(*child, kb, depth + 1, key);
+    }
+
+public:
+    AdaptiveRadixTree() = default;
+
+    ~AdaptiveRadixTree() {
+        destroy(root_);
+    }
+
+    AdaptiveRadixTree(const AdaptiveRadixTree&) = delete;
+    AdaptiveRadixTree& operator=(const AdaptiveRadixTree&) = delete;
+
+    AdaptiveRadixTree(AdaptiveRadixTree&& other) noexcept
+        : root_(other.root_), size_(other.size_) {
+        other.root_ = nullptr;
+        other.size_ = 0;
+    }
+
+    AdaptiveRadixTree& operator=(AdaptiveRadixTree&& other) noexcept {
+        if (this != &other) {
+            destroy(root_);
+            root_ = other.root_;
+            size_ = other.size_;
+            other.root_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    void insert(const Key& key, const Value& value) {
+        KeyBytes kb;
+        to_bytes(key, kb);
+        if (insert_rec(root_, kb, 0, key, value)) {
+            ++size_;
+        }
+    }
+
+    void remove(const Key& key) {
+        if (!root_) return;
+        KeyBytes kb;
+        to_bytes(key, kb);
+        if (remove_rec(root_, kb, 0, key)) {
+            --size_;
+        }
+    }
+
+    // Pointer to the stored value, or nullptr. Prefixes are skipped on the
+    // way down and checked once against the full key at the leaf.
+    const Value* find(const Key& key) const {
+        KeyBytes kb;
+        to_bytes(key, kb);
+        Node* node = root_;
+        int depth = 0;
+        while (node && !is_leaf(node)) {
+            depth += node->prefix_len;
+            Node** child = find_child(node, kb[depth]);
+            if (!child) return nullptr;
+            node = *child;
+            ++depth;
+        }
+        if (node && as_leaf(node)->key == key) {
+            return &as_leaf(node)->value;
+        }
+        return nullptr;
+    }
+
+    bool contains(const Key& key) const {
+        return find(key) != nullptr;
+    }
+
+    Value get(const Key& key) const {
+        const Value* v = find(key);
+        return v ? *v : Value{};
+    }
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    Key minKey() const {
+        const Leaf* leaf = extreme_leaf<true>(root_);
+        return leaf ? leaf->key : Key{};
+    }
+
+    Key maxKey() const {
+        const Leaf* leaf = extreme_leaf<false>(root_);
+        return leaf ? leaf->key : Key{};
+    }
+
+    // In-order visit of keys in [lo, hi]
+    template<typename F>
+    void forEachInRange(const Key& lo, const Key& hi, F f) const {
+        if (!root_ || hi < lo) return;
+        KeyBytes lb, hb;
+        to_bytes(lo, lb);
+        to_bytes(hi, hb);
+        range_rec(root_, 0, lb, hb, true, true, lo, hi, f);
+    }
+
+    template<typename F>
+    void forEach(F f) const {
+        if (root_) for_each_rec(root_, f);
+    }
+};
+
+#endif // ADAPTIVE_RADIX_TREE_H
@@ -0,0 +1,575 @@
+#ifndef BPLUS_TREE_H
+#define BPLUS_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Cache-conscious B+-tree with the same sequential API as AVLTree, so it can
+// back a TreeShard: TreeShard<Key, Value, BPlusTree<Key, Value>>.
+//
+// A binary tree pays one cache miss per level (~24 levels at 10M keys). Here
+// every node keeps its keys in one contiguous 256-byte array, so a lookup
+// touches one node per level (3-4 levels at 10M keys) and the in-node search
+// runs over cache lines that are already loaded. For 4- and 8-byte integral
+// keys the in-node search is a SIMD compare + popcount (AVX2, SSE2 or SSE4.2,
+// whatever the build enables); other key types use binary search.
+//
+// All values live in the leaves and leaves are doubly linked, so range scans
+// walk contiguous arrays instead of chasing parent pointers.
+
+template<typename Key, typename Value = Key>
+class BPlusTree {
+public:
+    static constexpr size_t NODE_BYTES = 256;
+
+    // Keys per node: fill NODE_BYTES, at least 8, multiple of 8 so SIMD loads
+    // never run past the array
+    static constexpr int NODE_KEYS =
+        static_cast<int>(std::max<size_t>(8, (NODE_BYTES / sizeof(Key)) & ~size_t{7}));
+
+    // Underflow threshold. A quarter (not half) leaves hysteresis between
+    // split and merge so alternating insert/remove at a boundary doesn't thrash
+    static constexpr int MIN_KEYS = NODE_KEYS / 4;
+
+private:
+    struct Node {
+        bool leaf;
+        int count = 0;
+
+        explicit Node(bool is_leaf) : leaf(is_leaf) {}
+    };
+
+    struct Leaf : Node {
+        alignas(64) Key keys[NODE_KEYS]{};
+        Value values[NODE_KEYS]{};
+        Leaf* prev = nullptr;
+        Leaf* next = nullptr;
+
+        Leaf() : Node(true) {}
+    };
+
+    struct Inner : Node {
+        // children[i] holds keys in [keys[i-1], keys[i])
+        alignas(64) Key keys[NODE_KEYS]{};
+        Node* children[NODE_KEYS + 1]{};
+
+        Inner() : Node(false) {}
+    };
+
+    Node* root_ = nullptr;
+    Leaf* head_ = nullptr;   // leftmost leaf
+    Leaf* tail_ = nullptr;   // rightmost leaf
+    size_t size_ = 0;
+
+    // ------------------------------------------------------------------------
+    // In-node search
+    // ------------------------------------------------------------------------
+
+    // Number of keys[i] (i < n) that are < target, or <= target if Inclusive.
+    // Keys are sorted, so this is lower_bound / upper_bound.
+    template<bool Inclusive>
+    static int rank(const Key* keys, int n, const Key& target) {
+        if constexpr (std::is_integral_v<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8)) {
+            return rank_simd<Inclusive>(keys, n, target);
+        } else {
+            const Key* it = Inclusive ? std::upper_bound(keys, keys + n, target)
+                                      : std::lower_bound(keys, keys + n, target);
+            return static_cast<int>(it - keys);
+        }
+    }
+
+    template<bool Inclusive>
+    static int rank_scalar(const Key* keys, int n, const Key& target) {
+        // Branch-free linear count: nodes are small and already in cache
+        int r = 0;
+        for (int i = 0; i < n; ++i) {
+            r += Inclusive ? !(target < keys[i]) : (keys[i] < target);
+        }
+        return r;
+    }
+
+    // Bits of the lanes that hold valid keys in a chunk starting at i
+    static unsigned valid_lanes(int i, int n, int lanes) {
+        int valid = std::min(lanes, n - i);
+        return valid >= 32 ? ~0u : ((1u << valid) - 1);
+    }
+
+    template<bool Inclusive>
+    static int rank_simd(const Key* keys, int n, const Key& target) {
+        // Signed compares only: unsigned keys are biased by flipping the sign bit
+        using SignedKey = std::make_signed_t<Key>;
+        constexpr bool is_unsigned = std::is_unsigned_v<Key>;
+        constexpr uint64_t sign_bit = uint64_t{1} << (sizeof(Key) * 8 - 1);
+        (void)sign_bit;
+
+#if defined(__AVX2__)
+        if constexpr (sizeof(Key) == 4) {
+            const __m256i bias = _mm256_set1_epi32(is_unsigned ? static_cast<int>(sign_bit) : 0);
+            const __m256i t = _mm256_xor_si256(_mm256_set1_epi32(static_cast<SignedKey>(target)), bias);
+            return rank_chunks<Inclusive, 8>(n, [&](int i) {
+                __m256i k = _mm256_xor_si256(
+                    _mm256_load_si256(reinterpret_cast<const __m256i*>(keys + i)), bias);
+                __m256i hit = Inclusive ? _mm256_cmpgt_epi32(k, t) : _mm256_cmpgt_epi32(t, k);
+                return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(hit)));
+            });
+        } else {
+            const __m256i bias = _mm256_set1_epi64x(is_unsigned ? static_cast<long long>(sign_bit) : 0);
+            const __m256i t = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<SignedKey>(target)), bias);
+            return rank_chunks<Inclusive, 4>(n, [&](int i) {
+                __m256i k = _mm256_xor_si256(
+                    _mm256_load_si256(reinterpret_cast<const __m256i*>(keys + i)), bias);
+                __m256i hit = Inclusive ? _mm256_cmpgt_epi64(k, t) : _mm256_cmpgt_epi64(t, k);
+                return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(hit)));
+            });
+        }
+#elif defined(__SSE2__)
+        if constexpr (sizeof(Key) == 4) {
+            const __m128i bias = _mm_set1_epi32(is_unsigned ? static_cast<int>(sign_bit) : 0);
+            const __m128i t = _mm_xor_si128(_mm_set1_epi32(static_cast<SignedKey>(target)), bias);
+            return rank_chunks<Inclusive, 4>(n, [&](int i) {
+                __m128i k = _mm_xor_si128(
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(keys + i)), bias);
+                __m128i hit = Inclusive ? _mm_cmpgt_epi32(k, t) : _mm_cmpgt_epi32(t, k);
+                return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(hit)));
+            });
+        } else {
+#if defined(__SSE4_2__)
+            const __m128i bias = _mm_set1_epi64x(is_unsigned ? static_cast<long long>(sign_bit) : 0);
+            const __m128i t = _mm_xor_si128(_mm_set1_epi64x(static_cast<SignedKey>(target)), bias);
+            return rank_chunks<Inclusive, 2>(n, [&](int i) {
+                __m128i k = _mm_xor_si128(
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(keys + i)), bias);
+                __m128i hit = Inclusive ? _mm_cmpgt_epi64(k, t) : _mm_cmpgt_epi64(t, k);
+                return static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(hit)));
+            });
+#else
+            // SSE2 has no 64-bit compare
+            return rank_scalar<Inclusive>(keys, n, target);
+#endif
+        }
+#else
+        (void)is_unsigned;
+        return rank_scalar<Inclusive>(keys, n, target);
+#endif
+    }
+
+    // Runs the per-chunk compare. Strict: the mask marks keys < target.
+    // Inclusive: the mask marks keys > target, so the count is its complement.
+    // Keys are sorted, so the first chunk that is not all-hit ends the search.
+    template<bool Inclusive, int Lanes, typename ChunkMask>
+    static int rank_chunks(int n, ChunkMask chunk_mask) {
+        int r = 0;
+        for (int i = 0; i < n; i += Lanes) {
+            unsigned valid = valid_lanes(i, n, Lanes);
+            unsigned mask = chunk_mask(i);
+            int hits = Inclusive ? __builtin_popcount(~mask & valid)
+                                 : __builtin_popcount(mask & valid);
+            r += hits;
+            if (hits < Lanes) break;
+        }
+        return r;
+    }
+
+    // ------------------------------------------------------------------------
+    // Navigation
+    // ------------------------------------------------------------------------
+
+    static int child_index(const Inner* in, const Key& key) {
+        return rank<true>(in->keys, in->count, key);
+    }
+
+    Leaf* find_leaf(const Key& key) const {
+        Node* node = root_;
+        if (!node) return nullptr;
+        while (!node->leaf) {
+            const Inner* in = static_cast<const Inner*>(node);
+            node = in->children[child_index(in, key)];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    // ------------------------------------------------------------------------
+    // Insert (splits full nodes on the way down, so parents always have room)
+    // ------------------------------------------------------------------------
+
+    // Splits full child children[i] of parent; parent is not full
+    void split_child(Inner* parent, int i) {
+        Node* child = parent->children[i];
+        Key separator;
+        Node* right;
+
+        if (child->leaf) {
+            Leaf* left = static_cast<Leaf*>(child);
+            Leaf* nl = new Leaf();
+            int mid = left->count / 2;
+            nl->count = left->count - mid;
+            std::move(left->keys + mid, left->keys + left->count, nl->keys);
+            std::move(left->values + mid, left->values + left->count, nl->values);
+            left->count = mid;
+
+            nl->next = left->next;
+            nl->prev = left;
+            if (left->next) left->next->prev = nl;
+            else tail_ = nl;
+            left->next = nl;
+
+            separator = nl->keys[0];
+            right = nl;
+        } else {
+            Inner* left = static_cast<Inner*>(child);
+            Inner* ni = new Inner();
+            int mid = left->count / 2;
+            separator = left->keys[mid];
+            ni->count = left->count - mid - 1;
+            std::move(left->keys + mid + 1, left->keys + left->count, ni->keys);
+            std::copy(left->children + mid + 1, left->children + left->count + 1, ni->children);
+            left->count = mid;
+            right = ni;
+        }
+
+        std::move_backward(parent->keys + i, parent->keys + parent->count,
+                           parent->keys + parent->count + 1);
+        std::copy_backward(parent->children + i + 1, parent->children + parent->count + 1,
+                           parent->children + parent->count + 2);
+        parent->keys[i] = separator;
+        parent->children[i + 1] = right;
+        parent->count++;
+    }
+
+    // ------------------------------------------------------------------------
+    // Remove (bottom-up: borrow from a sibling, otherwise merge)
+    // ------------------------------------------------------------------------
+
+    bool remove_rec(Node* node, const Key& key) {
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            int pos = rank<false>(leaf->keys, leaf->count, key);
+            if (pos == leaf->count || key < leaf->keys[pos]) return false;
+            std::move(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+            std::move(leaf->values + pos + 1, leaf->values + leaf->count, leaf->values + pos);
+            leaf->count--;
+            return true;
+        }
+
+        Inner* in = static_cast<Inner*>(node);
+        int i = child_index(in, key);
+        if (!remove_rec(in->children[i], key)) return false;
+        if (in->children[i]->count < MIN_KEYS) {
+            fix_underflow(in, i);
+        }
+        return true;
+    }
+
+    void fix_underflow(Inner* parent, int i) {
+        Node* left = i > 0 ? parent->children[i - 1] : nullptr;
+        Node* right = i < parent->count ? parent->children[i + 1] : nullptr;
+
+        if (left && left->count > MIN_KEYS) {
+            borrow_from_left(parent, i);
+        } else if (right && right->count > MIN_KEYS) {
+            borrow_from_right(parent, i);
+        } else if (left) {
+            merge(parent, i - 1);
+        } else if (right) {
+            merge(parent, i);
+        }
+    }
+
+    void borrow_from_left(Inner* parent, int i) {
+        if (parent->children[i]->leaf) {
+            Leaf* child = static_cast<Leaf*>(parent->children[i]);
+            Leaf* left = static_cast<Leaf*>(parent->children[i - 1]);
+            std::move_backward(child->keys, child->keys + child->count, child->keys + child->count + 1);
+            std::move_backward(child->values, child->values + child->count,
+                               child->values + child->count + 1);
+            child->keys[0] = std::move(left->keys[left->count - 1]);
+            child->values[0] = std::move(left->values[left->count - 1]);
+            left->count--;
+            child->count++;
+            parent->keys[i - 1] = child->keys[0];
+        } else {
+            Inner* child = static_cast<Inner*>(parent->children[i]);
+            Inner* left = static_cast<Inner*>(parent->children[i - 1]);
+            std::move_backward(child->keys, child->keys + child->count, child->keys + child->count + 1);
+            std::copy_backward(child->children, child->children + child->count + 1,
+                               child->children + child->count + 2);
+            child->keys[0] = std::move(parent->keys[i - 1]);
+            child->children[0] = left->children[left->count];
+            parent->keys[i - 1] = std::move(left->keys[left->count - 1]);
+            left->count--;
+            child->count++;
+        }
+    }
+
+    void borrow_from_right(Inner* parent, int i) {
+        if (parent->children[i]->leaf) {
+            Leaf* child = static_cast<Leaf*>(parent->children[i]);
+            Leaf* right = static_cast<Leaf*>(parent->children[i + 1]);
+            child->keys[child->count] = std::move(right->keys[0]);
+            child->values[child->count] = std::move(right->values[0]);
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            std::move(right->values + 1, right->values + right->count, right->values);
+            right->count--;
+            child->count++;
+            parent->keys[i] = right->keys[0];
+        } else {
+            Inner* child = static_cast<Inner*>(parent->children[i]);
+            Inner* right = static_cast<Inner*>(parent->children[i + 1]);
+            child->keys[child->count] = std::move(parent->keys[i]);
+            child->children[child->count + 1] = right->children[0];
+            parent->keys[i] = std::move(right->keys[0]);
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            std::copy(right->children + 1, right->children + right->count + 1, right->children);
+            right->count--;
+            child->count++;
+        }
+    }
+
+    // Merges children[i + 1] into children[i] and drops separator keys[i]
+    void merge(Inner* parent, int i) {
+        Node* l = parent->children[i];
+        Node* r = parent->children[i + 1];
+
+        if (l->leaf) {
+            Leaf* left = static_cast<Leaf*>(l);
+            Leaf* right = static_cast<Leaf*>(r);
+            std::move(right->keys, right->keys + right->count, left->keys + left->count);
+            std::move(right->values, right->values + right->count, left->values + left->count);
+            left->count += right->count;
+            left->next = right->next;
+            if (right->next) right->next->prev = left;
+            else tail_ = left;
+            delete right;
+        } else {
+            Inner* left = static_cast<Inner*>(l);
+            Inner* right = static_cast<Inner*>(r);
+            left->keys[left->count] = std::move(parent->keys[i]);
+            std::move(right->keys, right->keys + right->count, left->keys + left->count + 1);
+            std::copy(right->children, right->children + right->count + 1,
+                      left->children + left->count + 1);
+            left->count += right->count + 1;
+            delete right;
+        }
+
+        std::move(parent->keys + i + 1, parent->keys + parent->count, parent->keys + i);
+        std::copy(parent->children + i + 2, parent->children + parent->count + 1,
+                  parent->children + i + 1);
+        parent->count--;
+    }
+
+    void destroy(Node* node) {
+        if (!node) return;
+        if (node->leaf) {
+            delete static_cast<Leaf*>(node);
+            return;
+        }
+        Inner* in = static_cast<Inner*>(node);
+        for (int i = 0; i <= in->count; ++i) {
+            destroy(in->children[i]);
+        }
+        delete in;
+    }
+
+public:
+    BPlusTree() = default;
+
+    ~BPlusTree() {
+        destroy(root_);
+    }
+
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+
+    BPlusTree(BPlusTree&& other) noexcept
+        : root_(other.root_), head_(other.head_), tail_(other.tail_), size_(other.size_) {
+        other.root_ = nullptr;
+        other.head_ = other.tail_ = nullptr;
+        other.size_ = 0;
+    }
+
+    BPlusTree& operator=(BPlusTree&& other) noexcept {
+        if (this != &other) {
+            destroy(root_);
+            root_ = other.root_;
+            head_ = other.head_;
+            tail_ = other.tail_;
+            size_ = other.size_;
+            other.root_ = nullptr;
+            other.head_ = other.tail_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    void insert(const Key& key, const Value& value) {
+        if (!root_) {
+            head_ = tail_ = new Leaf();
+            root_ = head_;
+        }
+        if (root_->count == NODE_KEYS) {
+            Inner* new_root = new Inner();
+            new_root->children[0] = root_;
+            root_ = new_root;
+            split_child(new_root, 0);
+        }
+
+        Node* node = root_;
+        while (!node->leaf) {
+            Inner* in = static_cast<Inner*>(node);
+            int i = child_index(in, key);
+            if (in->children[i]->count == NODE_KEYS) {
+                split_child(in, i);
+                if (!(key < in->keys[i])) ++i;
+            }
+            node = in->children[i];
+        }
+
+        Leaf* leaf = static_cast<Leaf*>(node);
+        int pos = rank<false>(leaf->keys, leaf->count, key);
+        if (pos < leaf->count && !(key < leaf->keys[pos])) {
+            // Key exists, update value
+            leaf->values[pos] = value;
+            return;
+        }
+        std::move_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+        std::move_backward(leaf->values + pos, leaf->values + leaf->count,
+                           leaf->values + leaf->count + 1);
+        leaf->keys[pos] = key;
+        leaf->values[pos] = value;
+        leaf->count++;
+        ++size_;
+    }
+
+    void remove(const Key& key) {
+        if (!root_ || !remove_rec(root_, key)) return;
+        --size_;
+
+        // Shrink: an inner root with a single child, or an empty leaf root
+        if (!root_->leaf && root_->count == 0) {
+            Inner* old = static_cast<Inner*>(root_);
+            root_ = old->children[0];
+            delete old;
+        } else if (root_->leaf && root_->count == 0) {
+            delete static_cast<Leaf*>(root_);
+            root_ = nullptr;
+            head_ = tail_ = nullptr;
+        }
+    }
+
+    // Pointer to the stored value, or nullptr (single descent for get())
+    const Value* find(const Key& key) const {
+        const Leaf* leaf = find_leaf(key);
+        if (!leaf) return nullptr;
+        int pos = rank<false>(leaf->keys, leaf->count, key);
+        if (pos < leaf->count && !(key < leaf->keys[pos])) {
+            return &leaf->values[pos];
+        }
+        return nullptr;
+    }
+
+    bool contains(const Key& key) const {
+        return find(key) != nullptr;
+    }
+
+    Value get(const Key& key) const {
+        const Value* v = find(key);
+        return v ? *v : Value{};
+    }
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    Key minKey() const {
+        return head_ && head_->count ? head_->keys[0] : Key{};
+    }
+
+    Key maxKey() const {
+        return tail_ && tail_->count ? tail_->keys[tail_->count - 1] : Key{};
+    }
+
+    // In-order visit of keys in [lo, hi] along the leaf chain
+    template<typename F>
+    void forEachInRange(const Key& lo, const Key& hi, F f) const {
+        const Leaf* leaf = find_leaf(lo);
+        if (!leaf) return;
+        int pos = rank<false>(leaf->keys, leaf->count, lo);
+        while (leaf) {
+            for (; pos < leaf->count; ++pos) {
+                if (hi < leaf->keys[pos]) return;
+                f(leaf->keys[pos], leaf->values[pos]);
+            }
+            leaf = leaf->next;
+            pos = 0;
+        }
+    }
+
+    template<typename F>
+    void forEach(F f) const {
+        for (const Leaf* leaf = head_; leaf; leaf = leaf->next) {
+            for (int i = 0; i < leaf->count; ++i) {
+                f(leaf->keys[i], leaf->values[i]);
+            }
+        }
+    }
+
+    // Structural check for tests: sorted keys, separator bounds, fill factor,
+    // uniform leaf depth and a consistent leaf chain
+    bool validate() const {
+        if (!root_) return size_ == 0 && !head_ && !tail_;
+        int leaf_depth = -1;
+        size_t count = 0;
+        if (!validate_rec(root_, nullptr, nullptr, 0, leaf_depth, count)) return false;
+        if (count != size_) return false;
+
+        size_t chained = 0;
+        const Leaf* prev = nullptr;
+        for (const Leaf* leaf = head_; leaf; leaf = leaf->next) {
+            if (leaf->prev != prev) return false;
+            if (prev && prev->count && leaf->count &&
+                !(prev->keys[prev->count - 1] < leaf->keys[0])) return false;
+            chained += leaf->count;
+            prev = leaf;
+        }
+        return prev == tail_ && chained == size_;
+    }
+
+private:
+    bool validate_rec(const Node* node, const Key* lo, const Key* hi, int depth,
+                      int& leaf_depth, size_t& count) const {
+        if (node != root_ && node->count < MIN_KEYS) return false;
+        if (node->count > NODE_KEYS) return false;
+
+        const Key* keys = node->leaf ? static_cast<const Leaf*>(node)->keys
+                                     : static_cast<const Inner*>(node)->keys;
+        for (int i = 0; i < node->count; ++i) {
+            if (i > 0 && !(keys[i - 1] < keys[i])) return false;
+            if (lo && keys[i] < *lo) return false;
+            if (hi && !(keys[i] < *hi)) return false;
+        }
+
+        if (node->leaf) {
+            if (leaf_depth < 0) leaf_depth = depth;
+            count += node->count;
+            return leaf_depth == depth;
+        }
+
+        const Inner* in = static_cast<const Inner*>(node);
+        for (int i = 0; i <= in->count; ++i) {
+            const Key* clo = i > 0 ? &in->keys[i - 1] : lo;
+            const Key* chi = i < in->count ? &in->keys[i] : hi;
+            if (!in->children[i]) return false;
+            if (!validate_rec(in->children[i], clo, chi, depth + 1, leaf_depth, count)) return false;
+        }
+        return true;
+    }
+};
+
+#endif // BPLUS_TREE_H
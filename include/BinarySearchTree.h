@@ -1,16 +1,27 @@
 #ifndef BINARY_SEARCH_TREE_H
 #define BINARY_SEARCH_TREE_H
 
+#include "NodeArena.h"
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 // Base Binary Search Tree implementation
 // Provides foundation for AVL tree with virtual rebalance hook
 
-template<typename Key, typename Value = Key>
+// Empty per-node payload (default). Derived trees may pass their own type to
+// store extra data in every node, e.g. AVLTree's subtree aggregates.
+struct NoNodeExtra {};
+
+template<typename Key, typename Value = Key, typename NodeExtra = NoNodeExtra>
 class BinarySearchTree {
 public:
-    struct Node {
+    struct Node : NodeExtra {
         Key key;
         Value value;
         Node* left = nullptr;
@@ -22,12 +33,55 @@ public:
     };
 
 protected:
+    using Arena = NodeArena<Node>;
+
     Node* root_ = nullptr;
     size_t size_ = 0;
 
+    // Nodes live in arena_. While a relocation is in progress, oldArena_ holds
+    // the nodes not yet moved and new nodes already go to arena_.
+    std::unique_ptr<Arena> arena_;
+    std::unique_ptr<Arena> oldArena_;
+
+    // Relocation work list in breadth-first order. The pointer is trusted only
+    // if no node has been linked, unlinked or moved since the item was queued
+    // (stamp == shapeVersion_); otherwise the node is looked up again by key.
+    struct RelocItem {
+        Node* node;
+        Key key;
+        uint64_t stamp;
+    };
+    std::deque<RelocItem> relocQueue_;
+    uint64_t shapeVersion_ = 0;
+
+    // Rotations between steps can hang old-arena nodes under moved ones,
+    // where the breadth-first pass no longer reaches them. Once the queue is
+    // empty an in-order sweep finds them; it resumes from its last key, so it
+    // survives changes between steps.
+    struct RelocSweep {
+        bool started = false;
+        Node* node = nullptr;   // trusted while stamp == shapeVersion_
+        Key key{};
+        uint64_t stamp = 0;
+    };
+    RelocSweep sweep_;
+
+    Node* allocNode(const Key& key, const Value& value) {
+        if (!arena_) arena_ = std::make_unique<Arena>();
+        return new (arena_->allocate()) Node(key, value);
+    }
+
+    void freeNode(Node* node) {
+        node->~Node();
+        Arena::ownerOf(node)->deallocate(node);
+    }
+
     // Virtual rebalance hook for derived classes (AVL, etc.)
     virtual void rebalance(Node* start) { (void)start; }
 
+    // Hook called after insert() overwrote the value of an existing node
+    virtual void valueUpdated(Node* node) { (void)node; }
+
     Node* findNode(const Key& key) const {
         Node* current = root_;
         while (current) {
@@ -69,19 +123,125 @@ protected:
         }
     }
 
-    void destroyTree(Node* node) {
+    template<typename F>
+    void forEachInRangeRec(Node* node, const Key& lo, const Key& hi, F& f) const {
+        if (!node) return;
+
+        // In-order traversal with pruning
+        if (node->key > lo) {
+            forEachInRangeRec(node->left, lo, hi, f);
+        }
+        if (node->key >= lo && node->key <= hi) {
+            f(node->key, node->value);
+        }
+        if (node->key < hi) {
+            forEachInRangeRec(node->right, lo, hi, f);
+        }
+    }
+
+    template<typename F>
+    void forEachRec(Node* node, F& f) const {
+        if (!node) return;
+        forEachRec(node->left, f);
+        f(node->key, node->value);
+        forEachRec(node->right, f);
+    }
+
+    // Destroy all nodes and drop the arenas. Post-order walk over parent
+    // links (no recursion); skipped entirely for trivially destructible nodes.
+    void destroyTree() {
+        if constexpr (!std::is_trivially_destructible_v<Node>) {
+            Node* node = root_;
+            while (node) {
+                if (node->left) {
+                    node = node->left;
+                } else if (node->right) {
+                    node = node->right;
+                } else {
+                    Node* parent = node->parent;
+                    if (parent) {
+                        if (parent->left == node) parent->left = nullptr;
+                        else parent->right = nullptr;
+                    }
+                    node->~Node();
+                    node = parent;
+                }
+            }
+        }
+        root_ = nullptr;
+        size_ = 0;
+        arena_.reset();
+        oldArena_.reset();
+        relocQueue_.clear();
+        sweep_ = RelocSweep();
+    }
+
+    // First node with a key greater than key
+    Node* upperBound(const Key& key) const {
+        Node* current = root_;
+        Node* best = nullptr;
+        while (current) {
+            if (key < current->key) {
+                best = current;
+                current = current->left;
+            } else {
+                current = current->right;
+            }
+        }
+        return best;
+    }
+
+    Node* successor(Node* node) const {
+        if (node->right) return findMin(node->right);
+        while (node->parent && node == node->parent->right) {
+            node = node->parent;
+        }
+        return node->parent;
+    }
+
+    // Next node of the relocation sweep in key order, nullptr at the end
+    Node* sweepNext() {
+        Node* node;
+        if (!sweep_.started) {
+            node = findMin(root_);
+        } else if (sweep_.stamp == shapeVersion_) {
+            node = successor(sweep_.node);
+        } else {
+            node = upperBound(sweep_.key);
+        }
+        sweep_.started = node != nullptr;
         if (node) {
-            destroyTree(node->left);
-            destroyTree(node->right);
-            delete node;
+            sweep_.node = node;
+            sweep_.key = node->key;
+            sweep_.stamp = shapeVersion_;
+        }
+        return node;
+    }
+
+    // Move one node into arena_ and patch the three links pointing at it.
+    // Bumps shapeVersion_: a queued pointer to the old slot must not be
+    // trusted once it has been freed.
+    Node* relocateNode(Node* node) {
+        Node* moved = new (arena_->allocate()) Node(std::move(*node));
+        if (!moved->parent) {
+            root_ = moved;
+        } else if (moved->parent->left == node) {
+            moved->parent->left = moved;
+        } else {
+            moved->parent->right = moved;
         }
+        if (moved->left) moved->left->parent = moved;
+        if (moved->right) moved->right->parent = moved;
+        freeNode(node);
+        ++shapeVersion_;
+        return moved;
     }
 
 public:
     BinarySearchTree() = default;
 
     virtual ~BinarySearchTree() {
-        destroyTree(root_);
+        destroyTree();
     }
 
     // Prevent copying (has raw pointers)
@@ -90,18 +250,30 @@ public:
 
     // Allow move
     BinarySearchTree(BinarySearchTree&& other) noexcept
-        : root_(other.root_), size_(other.size_) {
+        : root_(other.root_), size_(other.size_),
+          arena_(std::move(other.arena_)), oldArena_(std::move(other.oldArena_)),
+          relocQueue_(std::move(other.relocQueue_)), shapeVersion_(other.shapeVersion_),
+          sweep_(std::move(other.sweep_)) {
         other.root_ = nullptr;
         other.size_ = 0;
+        other.relocQueue_.clear();
+        other.sweep_ = RelocSweep();
     }
 
     BinarySearchTree& operator=(BinarySearchTree&& other) noexcept {
         if (this != &other) {
-            destroyTree(root_);
+            destroyTree();
             root_ = other.root_;
             size_ = other.size_;
+            arena_ = std::move(other.arena_);
+            oldArena_ = std::move(other.oldArena_);
+            relocQueue_ = std::move(other.relocQueue_);
+            shapeVersion_ = other.shapeVersion_;
+            sweep_ = std::move(other.sweep_);
             other.root_ = nullptr;
             other.size_ = 0;
+            other.relocQueue_.clear();
+            other.sweep_ = RelocSweep();
         }
         return *this;
     }
@@ -119,11 +291,12 @@ public:
             } else {
                 // Key exists, update value
                 current->value = value;
+                valueUpdated(current);
                 return;
             }
         }
 
-        Node* newNode = new Node(key, value);
+        Node* newNode = allocNode(key, value);
         newNode->parent = parent;
 
         if (!parent) {
@@ -135,6 +308,7 @@ public:
         }
 
         ++size_;
+        ++shapeVersion_;
         rebalance(newNode);
     }
 
@@ -165,8 +339,9 @@ public:
             successor->left->parent = successor;
         }
 
-        delete node;
+        freeNode(node);
         --size_;
+        ++shapeVersion_;
 
         if (rebalanceStart) {
             rebalance(rebalanceStart);
@@ -177,6 +352,72 @@ public:
         return findNode(key) != nullptr;
     }
 
+    // Pointer to the stored value, or nullptr (single descent for lookups)
+    const Value* find(const Key& key) const {
+        Node* node = findNode(key);
+        return node ? &node->value : nullptr;
+    }
+
+    // Number of searches advanced in lockstep by findBatch
+    static constexpr size_t BATCH_GROUP = 16;
+
+    // Batched lookup with interleaved descents (AMAC: asynchronous memory
+    // access chaining). A single descent stalls on a cache miss at every
+    // level; here each in-flight search advances one level, prefetches its
+    // next node and yields to the next search, so up to BATCH_GROUP misses
+    // overlap. A finished slot is refilled with the next key right away.
+    // out[i] receives find(keys[i]).
+    void findBatch(const Key* keys, size_t n, const Value** out) const {
+        struct Slot {
+            size_t idx;
+            Node* node;
+        };
+        Slot slots[BATCH_GROUP];
+        size_t next = 0;
+        size_t active = 0;
+        while (active < BATCH_GROUP && next < n) {
+            slots[active++] = Slot{next++, root_};
+        }
+
+        while (active > 0) {
+            for (size_t s = 0; s < active;) {
+                Slot& slot = slots[s];
+                Node* node = slot.node;
+                const Key& key = keys[slot.idx];
+
+                Node* child = nullptr;
+                bool done = !node;
+                if (!done) {
+                    if (key < node->key) {
+                        child = node->left;
+                    } else if (key > node->key) {
+                        child = node->right;
+                    } else {
+                        done = true;
+                    }
+                }
+
+                if (!done) {
+                    if (child) {
+                        __builtin_prefetch(child);
+                        slot.node = child;
+                        ++s;
+                        continue;
+                    }
+                    node = nullptr;  // fell off the tree: not found
+                }
+
+                out[slot.idx] = node ? &node->value : nullptr;
+                if (next < n) {
+                    slot = Slot{next++, root_};
+                    ++s;
+                } else {
+                    slot = slots[--active];
+                }
+            }
+        }
+    }
+
     Value get(const Key& key) const {
         Node* node = findNode(key);
         if (node) {
@@ -198,6 +439,92 @@ public:
         Node* node = findMax(root_);
         return node ? node->key : Key{};
     }
+
+    // Bytes held by node arenas (including free slots)
+    size_t memoryBytes() const {
+        return (arena_ ? arena_->bytes() : 0) + (oldArena_ ? oldArena_->bytes() : 0);
+    }
+
+    // ---- Online defragmentation ----
+    // After heavy churn, nodes sit wherever the free list put them and every
+    // traversal step is a random access. Relocation copies the nodes in
+    // breadth-first order into a fresh arena: the top levels end up packed
+    // together and an in-order scan reads each level as a forward stream.
+    // The old arena is freed as a whole once its last node has moved, which
+    // also returns the memory left behind by deletes.
+    //
+    // The work is split into relocateStep() calls of bounded size so a caller
+    // can release its lock in between; inserts and removes may run between
+    // steps (new nodes go straight to the fresh arena). The budget counts
+    // every node a step visits, moved or not, so the final sweep is split
+    // across steps too.
+
+    bool relocating() const { return oldArena_ != nullptr; }
+
+    void beginRelocation() {
+        if (relocating() || !root_) return;
+        oldArena_ = std::move(arena_);
+        arena_ = std::make_unique<Arena>();
+        sweep_ = RelocSweep();
+        relocQueue_.push_back(RelocItem{root_, root_->key, shapeVersion_});
+    }
+
+    // Visit up to `budget` nodes. Returns true once relocation is complete.
+    // The emptied old arena goes to retire(std::unique_ptr<...>): releasing
+    // it frees every chunk at once, which a caller holding a lock may rather
+    // do after unlocking.
+    template<typename Retire>
+    bool relocateStep(size_t budget, Retire retire) {
+        if (!relocating()) return true;
+
+        while (budget > 0) {
+            --budget;
+            if (relocQueue_.empty()) {
+                if (oldArena_->live() == 0) {
+                    sweep_ = RelocSweep();
+                    retire(std::move(oldArena_));
+                    return true;
+                }
+                Node* node = sweepNext();
+                if (node && oldArena_->owns(node)) {
+                    relocQueue_.push_back(RelocItem{node, node->key, shapeVersion_});
+                }
+                continue;
+            }
+
+            RelocItem item = std::move(relocQueue_.front());
+            relocQueue_.pop_front();
+            Node* node = item.stamp == shapeVersion_ ? item.node : findNode(item.key);
+            // Removed, or queued twice after rotations and already moved
+            if (!node || !oldArena_->owns(node)) continue;
+
+            node = relocateNode(node);
+            if (node->left) relocQueue_.push_back(RelocItem{node->left, node->left->key, shapeVersion_});
+            if (node->right) relocQueue_.push_back(RelocItem{node->right, node->right->key, shapeVersion_});
+        }
+        return false;
+    }
+
+    bool relocateStep(size_t budget) {
+        return relocateStep(budget, [](std::unique_ptr<Arena>) {});
+    }
+
+    // Relocate the whole tree in one go
+    void defragment() {
+        beginRelocation();
+        while (!relocateStep(SIZE_MAX)) {}
+    }
+
+    // In-order visit of keys in [lo, hi]
+    template<typename F>
+    void forEachInRange(const Key& lo, const Key& hi, F f) const {
+        forEachInRangeRec(root_, lo, hi, f);
+    }
+
+    template<typename F>
+    void forEach(F f) const {
+        forEachRec(root_, f);
+    }
 };
 
 #endif // BINARY_SEARCH_TREE_H
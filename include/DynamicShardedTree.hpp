@@ -2,6 +2,7 @@
 #define DYNAMIC_SHARDED_TREE_HPP
 
 #include "AVLTree.h"
+#include "queue_lock.hpp"
 #include <vector>
 #include <mutex>
 #include <atomic>
@@ -37,16 +38,17 @@ public:
         size_t total_elements;
         double balance_score;
         std::vector<size_t> elements_per_shard;
+        std::vector<LockContentionStats> lock_per_shard;
     };
 
 private:
     // =========================================================================
-    // Shard Structure - Simple mutex por shard
+    // Shard Structure - Un lock por shard (DefaultShardMutex, queue_lock.hpp)
     // =========================================================================
     
     struct Shard {
         AVLTree<Key, Value> tree;
-        mutable std::mutex lock;
+        mutable DefaultShardMutex lock;
         std::atomic<size_t> size{0};
         
         Shard() = default;
@@ -177,7 +179,7 @@ public:
             shard_id = find_shard_locked(hash_key(key));
         }
         
-        std::lock_guard<std::mutex> shard_lock(shards_[shard_id]->lock);
+        std::lock_guard<DefaultShardMutex> shard_lock(shards_[shard_id]->lock);
         
         size_t old_size = shards_[shard_id]->tree.size();
         shards_[shard_id]->tree.insert(key, value);
@@ -197,7 +199,7 @@ public:
         
         // Buscar primero en el shard esperado
         {
-            std::lock_guard<std::mutex> lock(shards_[expected_shard]->lock);
+            std::lock_guard<DefaultShardMutex> lock(shards_[expected_shard]->lock);
             if (shards_[expected_shard]->tree.contains(key)) {
                 return true;
             }
@@ -207,7 +209,7 @@ public:
         for (size_t i = 0; i < n_shards; ++i) {
             if (i == expected_shard) continue;
             
-            std::lock_guard<std::mutex> lock(shards_[i]->lock);
+            std::lock_guard<DefaultShardMutex> lock(shards_[i]->lock);
             if (shards_[i]->tree.contains(key)) {
                 // Encontrado en shard incorrecto - migrar
                 Value val = shards_[i]->tree.get(key);
@@ -215,7 +217,7 @@ public:
                 shards_[i]->size.fetch_sub(1, std::memory_order_relaxed);
                 
                 // Insertar en shard correcto
-                std::lock_guard<std::mutex> dest_lock(shards_[expected_shard]->lock);
+                std::lock_guard<DefaultShardMutex> dest_lock(shards_[expected_shard]->lock);
                 shards_[expected_shard]->tree.insert(key, val);
                 shards_[expected_shard]->size.fetch_add(1, std::memory_order_relaxed);
                 
@@ -237,7 +239,7 @@ public:
         
         // Buscar en shard esperado
         {
-            std::lock_guard<std::mutex> lock(shards_[expected_shard]->lock);
+            std::lock_guard<DefaultShardMutex> lock(shards_[expected_shard]->lock);
             if (shards_[expected_shard]->tree.contains(key)) {
                 return shards_[expected_shard]->tree.get(key);
             }
@@ -247,13 +249,13 @@ public:
         for (size_t i = 0; i < n_shards; ++i) {
             if (i == expected_shard) continue;
             
-            std::lock_guard<std::mutex> lock(shards_[i]->lock);
+            std::lock_guard<DefaultShardMutex> lock(shards_[i]->lock);
             if (shards_[i]->tree.contains(key)) {
                 Value val = shards_[i]->tree.get(key);
                 shards_[i]->tree.remove(key);
                 shards_[i]->size.fetch_sub(1, std::memory_order_relaxed);
                 
-                std::lock_guard<std::mutex> dest_lock(shards_[expected_shard]->lock);
+                std::lock_guard<DefaultShardMutex> dest_lock(shards_[expected_shard]->lock);
                 shards_[expected_shard]->tree.insert(key, val);
                 shards_[expected_shard]->size.fetch_add(1, std::memory_order_relaxed);
                 
@@ -272,7 +274,7 @@ public:
         }
         
         for (size_t i = 0; i < n_shards; ++i) {
-            std::lock_guard<std::mutex> lock(shards_[i]->lock);
+            std::lock_guard<DefaultShardMutex> lock(shards_[i]->lock);
             if (shards_[i]->tree.contains(key)) {
                 shards_[i]->tree.remove(key);
                 shards_[i]->size.fetch_sub(1, std::memory_order_relaxed);
@@ -313,7 +315,7 @@ public:
         // Extraer datos del shard que se elimina
         std::vector<std::pair<Key, Value>> to_redistribute;
         {
-            std::lock_guard<std::mutex> shard_lock(shards_[removing_id]->lock);
+            std::lock_guard<DefaultShardMutex> shard_lock(shards_[removing_id]->lock);
             extract_all(shards_[removing_id]->tree.getRoot(), to_redistribute);
         }
         
@@ -326,7 +328,7 @@ public:
         // Re-insertar datos (ahora van a shards correctos)
         for (const auto& [key, value] : to_redistribute) {
             size_t shard_id = find_shard_locked(hash_key(key));
-            std::lock_guard<std::mutex> shard_lock(shards_[shard_id]->lock);
+            std::lock_guard<DefaultShardMutex> shard_lock(shards_[shard_id]->lock);
             shards_[shard_id]->tree.insert(key, value);
             shards_[shard_id]->size.fetch_add(1, std::memory_order_relaxed);
         }
@@ -339,7 +341,7 @@ public:
         // Extraer todo
         std::vector<std::pair<Key, Value>> all_data;
         for (auto& shard : shards_) {
-            std::lock_guard<std::mutex> shard_lock(shard->lock);
+            std::lock_guard<DefaultShardMutex> shard_lock(shard->lock);
             extract_all(shard->tree.getRoot(), all_data);
         }
         
@@ -353,7 +355,7 @@ public:
         // Re-insertar en shards correctos
         for (const auto& [key, value] : all_data) {
             size_t shard_id = find_shard_locked(hash_key(key));
-            std::lock_guard<std::mutex> shard_lock(shards_[shard_id]->lock);
+            std::lock_guard<DefaultShardMutex> shard_lock(shards_[shard_id]->lock);
             shards_[shard_id]->tree.insert(key, value);
             shards_[shard_id]->size.fetch_add(1, std::memory_order_relaxed);
         }
@@ -368,10 +370,12 @@ public:
         stats.num_shards = num_shards_.load(std::memory_order_acquire);
         stats.total_elements = 0;
         stats.elements_per_shard.reserve(stats.num_shards);
+        stats.lock_per_shard.reserve(stats.num_shards);
         
         for (size_t i = 0; i < stats.num_shards; ++i) {
             size_t count = shards_[i]->size.load(std::memory_order_relaxed);
             stats.elements_per_shard.push_back(count);
+            stats.lock_per_shard.push_back(shards_[i]->lock.contention_stats());
             stats.total_elements += count;
         }
         
@@ -0,0 +1,68 @@
+#ifndef MONOIDS_H
+#define MONOIDS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+// Monoids for AVLTree subtree aggregates. A monoid provides:
+//   value_type                                  the aggregate type
+//   static value_type identity()                neutral element
+//   static value_type lift(const K&, const V&)  aggregate of a single entry
+//   static value_type combine(a, b)             associative, a before b
+// The tree applies combine in key order, so it need not be commutative.
+// ParallelAVL::reduce_range merges shards in arbitrary order and therefore
+// expects a commutative combine (all monoids below are).
+
+// Default: no aggregate is stored or maintained
+struct NoAggregate {};
+
+template<typename T>
+struct SumMonoid {
+    using value_type = T;
+    static value_type identity() { return T{}; }
+    template<typename K, typename V>
+    static value_type lift(const K&, const V& v) { return static_cast<T>(v); }
+    static value_type combine(const value_type& a, const value_type& b) { return a + b; }
+};
+
+template<typename T>
+struct MinMonoid {
+    using value_type = T;
+    static value_type identity() { return std::numeric_limits<T>::max(); }
+    template<typename K, typename V>
+    static value_type lift(const K&, const V& v) { return static_cast<T>(v); }
+    static value_type combine(const value_type& a, const value_type& b) { return std::min(a, b); }
+};
+
+template<typename T>
+struct MaxMonoid {
+    using value_type = T;
+    static value_type identity() { return std::numeric_limits<T>::lowest(); }
+    template<typename K, typename V>
+    static value_type lift(const K&, const V& v) { return static_cast<T>(v); }
+    static value_type combine(const value_type& a, const value_type& b) { return std::max(a, b); }
+};
+
+// count/sum/min/max in one pass, e.g. for time-bucket rollups
+template<typename T>
+struct StatsMonoid {
+    struct value_type {
+        size_t count = 0;
+        T sum = T{};
+        T min = std::numeric_limits<T>::max();
+        T max = std::numeric_limits<T>::lowest();
+    };
+    static value_type identity() { return value_type{}; }
+    template<typename K, typename V>
+    static value_type lift(const K&, const V& v) {
+        T x = static_cast<T>(v);
+        return value_type{1, x, x, x};
+    }
+    static value_type combine(const value_type& a, const value_type& b) {
+        return value_type{a.count + b.count, a.sum + b.sum,
+                          std::min(a.min, b.min), std::max(a.max, b.max)};
+    }
+};
+
+#endif // MONOIDS_H
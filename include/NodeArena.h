@@ -0,0 +1,226 @@
+#ifndef NODE_ARENA_H
+#define NODE_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// Where arena chunks come from. Off: one aligned_alloc per chunk.
+// Transparent: 2 MB aligned regions marked MADV_HUGEPAGE, so the kernel can
+// back each with a single huge page. Explicit: MAP_HUGETLB from the reserved
+// hugetlbfs pool, falling back to Transparent when the pool is empty and to
+// Off when mmap fails or the platform has neither.
+//
+// Huge pages cut TLB misses on deep traversals: a 2 MB page covers the
+// region that would otherwise need 512 TLB entries. Each non-empty arena
+// then maps at least one 2 MB region, so enable it for large trees only.
+enum class HugePageMode { Off, Transparent, Explicit };
+
+class ArenaPages {
+public:
+    static constexpr size_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+
+    struct Stats {
+        size_t explicitRegions;
+        size_t transparentRegions;
+        size_t fallbacks;       // regions that could not get the requested kind
+    };
+
+    static void setMode(HugePageMode mode) { mode_.store(mode, std::memory_order_relaxed); }
+
+    static HugePageMode mode() { return mode_.load(std::memory_order_relaxed); }
+
+    static Stats stats() {
+        return Stats{explicit_.load(std::memory_order_relaxed),
+                     transparent_.load(std::memory_order_relaxed),
+                     fallbacks_.load(std::memory_order_relaxed)};
+    }
+
+    // HUGE_PAGE_BYTES region aligned to its size, or nullptr
+    static void* allocateRegion(HugePageMode mode) {
+#if defined(__linux__)
+#ifdef MAP_HUGETLB
+        if (mode == HugePageMode::Explicit) {
+            void* p = mmap(nullptr, HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                explicit_.fetch_add(1, std::memory_order_relaxed);
+                return p;
+            }
+            fallbacks_.fetch_add(1, std::memory_order_relaxed);
+        }
+#endif
+        // Over-map by one huge page and trim to an aligned window
+        size_t span = 2 * HUGE_PAGE_BYTES;
+        void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            fallbacks_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (start + HUGE_PAGE_BYTES - 1) & ~(uintptr_t)(HUGE_PAGE_BYTES - 1);
+        if (aligned > start) munmap(raw, aligned - start);
+        uintptr_t tail = aligned + HUGE_PAGE_BYTES;
+        if (start + span > tail) munmap(reinterpret_cast<void*>(tail), start + span - tail);
+        void* p = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+        madvise(p, HUGE_PAGE_BYTES, MADV_HUGEPAGE);
+#endif
+        transparent_.fetch_add(1, std::memory_order_relaxed);
+        return p;
+#else
+        (void)mode;
+        fallbacks_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+#endif
+    }
+
+    static void freeRegion(void* p) {
+#if defined(__linux__)
+        munmap(p, HUGE_PAGE_BYTES);
+#else
+        (void)p;
+#endif
+    }
+
+private:
+    static inline std::atomic<HugePageMode> mode_{HugePageMode::Off};
+    static inline std::atomic<size_t> explicit_{0};
+    static inline std::atomic<size_t> transparent_{0};
+    static inline std::atomic<size_t> fallbacks_{0};
+};
+
+// Fixed-size slot allocator for tree nodes. Slots are carved from chunks
+// aligned to their own size, so the chunk (and the arena owning it) of any
+// slot is found with a mask. Freed slots go to a free list and are reused;
+// memory goes back to the system only when the whole arena is dropped, which
+// is what BinarySearchTree's relocation relies on: nodes are moved into a
+// fresh arena in traversal order and the old one is released at once.
+// With huge pages enabled (ArenaPages), chunks are carved from 2 MB regions.
+
+template<typename T>
+class NodeArena {
+public:
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+
+private:
+    struct ChunkHeader {
+        NodeArena* owner;
+    };
+
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static constexpr size_t HEADER_BYTES =
+        (sizeof(ChunkHeader) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+    static constexpr size_t SLOTS_PER_CHUNK = (CHUNK_BYTES - HEADER_BYTES) / sizeof(Slot);
+    static_assert(SLOTS_PER_CHUNK >= 16, "node type too large for arena chunk");
+
+    static_assert(ArenaPages::HUGE_PAGE_BYTES % CHUNK_BYTES == 0,
+                  "chunks must tile a huge page region");
+
+    std::vector<void*> chunks_;     // aligned_alloc'ed chunks
+    std::vector<void*> regions_;    // huge page regions, carved into chunks
+    char* regionCursor_ = nullptr;
+    char* regionEnd_ = nullptr;
+    Slot* freeList_ = nullptr;
+    Slot* bump_ = nullptr;      // next never-used slot in the newest chunk
+    Slot* bumpEnd_ = nullptr;
+    size_t live_ = 0;
+
+    void* chunkFromRegion() {
+        if (regionCursor_ == regionEnd_) {
+            HugePageMode mode = ArenaPages::mode();
+            if (mode == HugePageMode::Off) return nullptr;
+            void* region = ArenaPages::allocateRegion(mode);
+            if (!region) return nullptr;
+            regions_.push_back(region);
+            regionCursor_ = static_cast<char*>(region);
+            regionEnd_ = regionCursor_ + ArenaPages::HUGE_PAGE_BYTES;
+        }
+        void* chunk = regionCursor_;
+        regionCursor_ += CHUNK_BYTES;
+        return chunk;
+    }
+
+    void addChunk() {
+        void* chunk = chunkFromRegion();
+        if (!chunk) {
+            chunk = std::aligned_alloc(CHUNK_BYTES, CHUNK_BYTES);
+            if (!chunk) throw std::bad_alloc();
+            chunks_.push_back(chunk);
+        }
+        static_cast<ChunkHeader*>(chunk)->owner = this;
+        bump_ = reinterpret_cast<Slot*>(static_cast<char*>(chunk) + HEADER_BYTES);
+        bumpEnd_ = bump_ + SLOTS_PER_CHUNK;
+    }
+
+    static ChunkHeader* chunkOf(const void* p) {
+        return reinterpret_cast<ChunkHeader*>(
+            reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(CHUNK_BYTES - 1));
+    }
+
+public:
+    NodeArena() = default;
+
+    ~NodeArena() { release(); }
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    // Uninitialized storage for one T
+    void* allocate() {
+        Slot* slot;
+        if (freeList_) {
+            slot = freeList_;
+            freeList_ = slot->next;
+        } else {
+            if (bump_ == bumpEnd_) addChunk();
+            slot = bump_++;
+        }
+        ++live_;
+        return slot;
+    }
+
+    // Return storage obtained from allocate() (object already destroyed)
+    void deallocate(void* p) {
+        Slot* slot = static_cast<Slot*>(p);
+        slot->next = freeList_;
+        freeList_ = slot;
+        --live_;
+    }
+
+    // Arena that handed out p (p must come from some NodeArena<T>)
+    static NodeArena* ownerOf(const void* p) { return chunkOf(p)->owner; }
+
+    bool owns(const void* p) const { return ownerOf(p) == this; }
+
+    // Free every chunk. Objects still alive are not destroyed.
+    void release() {
+        for (void* chunk : chunks_) std::free(chunk);
+        for (void* region : regions_) ArenaPages::freeRegion(region);
+        chunks_.clear();
+        regions_.clear();
+        regionCursor_ = regionEnd_ = nullptr;
+        freeList_ = bump_ = bumpEnd_ = nullptr;
+        live_ = 0;
+    }
+
+    size_t live() const { return live_; }
+
+    size_t bytes() const {
+        return chunks_.size() * CHUNK_BYTES + regions_.size() * ArenaPages::HUGE_PAGE_BYTES;
+    }
+};
+
+#endif // NODE_ARENA_H
@@ -0,0 +1,250 @@
+#ifndef ADMISSION_CONTROL_HPP
+#define ADMISSION_CONTROL_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// =============================================================================
+// Admission control - Límite de concurrencia y backpressure por shard
+// =============================================================================
+//
+// Con un shard caliente los threads se apilan en su mutex y la latencia
+// crece sin techo. AdmissionGate limita cuántas operaciones pueden estar
+// dentro del shard a la vez (in_flight <= limit); el resto espera en una
+// cola acotada por deadline o se rechaza en el acto:
+//
+//   try_acquire()          falla si el shard está lleno (shedding)
+//   acquire_until(t)       espera hasta t, luego falla
+//   acquire()              espera lo necesario (ops normales)
+//
+// El fast path es un CAS sobre in_flight_; el mutex/condvar solo se toca si
+// hay que esperar. Se registra la profundidad de cola (waiting, máximo
+// visto) y un histograma de tiempos de espera.
+// =============================================================================
+
+// Histograma log2 de tiempos en ns, contadores atómicos relaxed.
+// Bucket 0: sin espera; bucket i > 0: [2^(i-1), 2^i) ns
+class WaitHistogram {
+public:
+    static constexpr size_t BUCKETS = 40;   // hasta ~9 minutos
+
+    void record(uint64_t ns) {
+        size_t bucket = 0;
+        if (ns > 0) {
+            bucket = 64 - static_cast<size_t>(__builtin_clzll(ns));
+            if (bucket >= BUCKETS) bucket = BUCKETS - 1;
+        }
+        counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::array<size_t, BUCKETS> snapshot() const {
+        std::array<size_t, BUCKETS> out{};
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            out[i] = counts_[i].load(std::memory_order_relaxed);
+        }
+        return out;
+    }
+
+    // Cota superior (ns) del percentil q en [0, 1]
+    static uint64_t percentile(const std::array<size_t, BUCKETS>& counts, double q) {
+        size_t total = 0;
+        for (size_t c : counts) total += c;
+        if (total == 0) return 0;
+        // Nearest-rank: el menor valor con al menos q * total muestras <= él
+        size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(total)));
+        if (rank == 0) rank = 1;
+        size_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) return i == 0 ? 0 : (uint64_t(1) << i) - 1;
+        }
+        return (uint64_t(1) << (BUCKETS - 1)) - 1;
+    }
+
+    void reset() {
+        for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<size_t>, BUCKETS> counts_{};
+};
+
+class AdmissionGate {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        size_t limit;           // 0 = sin límite
+        size_t in_flight;
+        size_t waiting;         // profundidad de cola actual
+        size_t max_waiting;
+        size_t admitted;
+        size_t rejected;        // try_acquire con el shard lleno
+        size_t timed_out;       // acquire_until vencido
+        uint64_t wait_p50_ns;
+        uint64_t wait_p99_ns;
+        uint64_t wait_p999_ns;
+        std::array<size_t, WaitHistogram::BUCKETS> wait_histogram;
+    };
+
+    AdmissionGate() = default;
+    AdmissionGate(const AdmissionGate&) = delete;
+    AdmissionGate& operator=(const AdmissionGate&) = delete;
+
+    void set_limit(size_t limit) {
+        limit_.store(limit, std::memory_order_relaxed);
+        // Un límite más alto puede admitir a los que esperan
+        std::lock_guard lock(mutex_);
+        cv_.notify_all();
+    }
+
+    size_t limit() const { return limit_.load(std::memory_order_relaxed); }
+
+    bool try_acquire() {
+        if (enter()) {
+            admitted(0);
+            return true;
+        }
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool acquire_until(Clock::time_point deadline) {
+        if (enter()) {
+            admitted(0);
+            return true;
+        }
+        return wait(&deadline);
+    }
+
+    void acquire() {
+        if (enter()) {
+            admitted(0);
+            return;
+        }
+        wait(nullptr);
+    }
+
+    void release() {
+        // seq_cst con wait(): o el que espera ve el lugar libre, o acá se ve
+        // que hay alguien esperando
+        in_flight_.fetch_sub(1);
+        if (waiting_.load() > 0) {
+            std::lock_guard lock(mutex_);
+            cv_.notify_one();
+        }
+    }
+
+    Stats stats() const {
+        Stats s;
+        s.limit = limit();
+        s.in_flight = in_flight_.load(std::memory_order_relaxed);
+        s.waiting = waiting_.load(std::memory_order_relaxed);
+        s.max_waiting = max_waiting_.load(std::memory_order_relaxed);
+        s.admitted = admitted_.load(std::memory_order_relaxed);
+        s.rejected = rejected_.load(std::memory_order_relaxed);
+        s.timed_out = timed_out_.load(std::memory_order_relaxed);
+        s.wait_histogram = wait_times_.snapshot();
+        s.wait_p50_ns = WaitHistogram::percentile(s.wait_histogram, 0.50);
+        s.wait_p99_ns = WaitHistogram::percentile(s.wait_histogram, 0.99);
+        s.wait_p999_ns = WaitHistogram::percentile(s.wait_histogram, 0.999);
+        return s;
+    }
+
+    void reset_stats() {
+        max_waiting_.store(0, std::memory_order_relaxed);
+        admitted_.store(0, std::memory_order_relaxed);
+        rejected_.store(0, std::memory_order_relaxed);
+        timed_out_.store(0, std::memory_order_relaxed);
+        wait_times_.reset();
+    }
+
+private:
+    std::atomic<size_t> limit_{0};
+    std::atomic<size_t> in_flight_{0};
+    std::atomic<size_t> waiting_{0};
+    std::atomic<size_t> max_waiting_{0};
+    std::atomic<size_t> admitted_{0};
+    std::atomic<size_t> rejected_{0};
+    std::atomic<size_t> timed_out_{0};
+    WaitHistogram wait_times_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+
+    // Tomar un lugar si hay; sin límite siempre entra (y se cuenta igual)
+    bool enter() {
+        size_t limit = limit_.load(std::memory_order_relaxed);
+        if (limit == 0) {
+            in_flight_.fetch_add(1, std::memory_order_acquire);
+            return true;
+        }
+        size_t current = in_flight_.load();
+        while (current < limit) {
+            if (in_flight_.compare_exchange_weak(current, current + 1,
+                                                 std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void admitted(uint64_t wait_ns) {
+        admitted_.fetch_add(1, std::memory_order_relaxed);
+        wait_times_.record(wait_ns);
+    }
+
+    // Slow path: encolarse hasta que release() libere un lugar o venza deadline
+    bool wait(const Clock::time_point* deadline) {
+        auto start = Clock::now();
+        size_t depth = waiting_.fetch_add(1) + 1;
+        size_t max = max_waiting_.load(std::memory_order_relaxed);
+        while (depth > max && !max_waiting_.compare_exchange_weak(max, depth,
+                                                                  std::memory_order_relaxed)) {}
+
+        bool ok;
+        {
+            std::unique_lock lock(mutex_);
+            auto ready = [this] { return enter(); };
+            if (deadline) {
+                ok = cv_.wait_until(lock, *deadline, ready);
+            } else {
+                cv_.wait(lock, ready);
+                ok = true;
+            }
+        }
+        waiting_.fetch_sub(1, std::memory_order_acq_rel);
+
+        if (!ok) {
+            timed_out_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+        admitted(static_cast<uint64_t>(waited.count()));
+        return true;
+    }
+};
+
+// Lugar tomado en un AdmissionGate; lo devuelve al destruirse. Vacío si la
+// operación no pasó por un gate
+class AdmissionTicket {
+public:
+    AdmissionTicket() = default;
+    explicit AdmissionTicket(AdmissionGate* gate) : gate_(gate) {}
+    AdmissionTicket(AdmissionTicket&& other) noexcept : gate_(other.gate_) { other.gate_ = nullptr; }
+    AdmissionTicket& operator=(AdmissionTicket&&) = delete;
+    AdmissionTicket(const AdmissionTicket&) = delete;
+    ~AdmissionTicket() { if (gate_) gate_->release(); }
+
+private:
+    AdmissionGate* gate_ = nullptr;
+};
+
+#endif // ADMISSION_CONTROL_HPP
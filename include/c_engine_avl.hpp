@@ -0,0 +1,287 @@
+#ifndef C_ENGINE_AVL_HPP
+#define C_ENGINE_AVL_HPP
+
+// =============================================================================
+// CEngineParallelAVL - ParallelAVL sobre el motor en C (c_src/)
+// =============================================================================
+//
+// Misma interfaz que ParallelAVL<int64_t, Value> (insert, get, contains,
+// remove, range_query, get_batch, add_shard, remove_shard, force_rebalance,
+// get_stats...) pero delegando en libparallel_avl.a: nodos en pool, shards
+// con padding y builds -O3 -march=native -flto.
+//
+// El valor se guarda inline en el slot void* de cada nodo (memcpy), así que
+// solo sirven valores trivialmente copiables que quepan en un puntero.
+//
+// Selección automática:
+//   AutoParallelAVL<int64_t, int64_t> a(8);   // -> CEngineParallelAVL<int64_t>
+//   AutoParallelAVL<int, std::string> b(8);   // -> ParallelAVL<int, std::string>
+//
+// Requiere enlazar el motor en C:
+//   make -C c_src lib CFLAGS="-std=gnu11 -O3"
+//   g++ ... -I include app.cpp c_src/build/libparallel_avl.a -pthread
+//
+// No hay set_capacity / TTL / admisión: esas variantes siguen en la versión
+// template.
+//
+// =============================================================================
+
+#include "parallel_avl.hpp"
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Cabeceras de sistema que usan las del motor: se incluyen aquí, fuera del
+// namespace, para que dentro de c_engine solo entren las declaraciones del
+// motor (cuyos ParallelAVL, TreeShard, RedirectIndex... chocarían con las
+// clases template del namespace global).
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace c_engine {
+#include "../c_src/include/parallel_avl.h"
+}
+
+// Valores que el motor en C puede guardar inline en su slot void*
+template<typename Value>
+struct c_engine_storable : std::bool_constant<
+    std::is_trivially_copyable_v<Value> &&
+    std::is_default_constructible_v<Value> &&
+    sizeof(Value) <= sizeof(void*) &&
+    alignof(Value) <= alignof(void*)> {};
+
+template<typename Key, typename Value>
+struct uses_c_engine : std::bool_constant<
+    std::is_same_v<Key, int64_t> && c_engine_storable<Value>::value> {};
+
+template<typename Value>
+class CEngineParallelAVL {
+    static_assert(c_engine_storable<Value>::value,
+                  "CEngineParallelAVL: Value debe ser trivialmente copiable y caber en un void*");
+
+public:
+    using Key = int64_t;
+    using RouterStrategy = typename AdversaryResistantRouter<Key>::Strategy;
+
+private:
+    c_engine::ParallelAVL* tree_;
+
+    // Pares por página en range_query: el merge del motor se reanuda desde
+    // next_lo, y el OutputIt se llama siempre fuera del código C
+    static constexpr size_t RANGE_PAGE = 1024;
+
+    static void* to_slot(const Value& value) {
+        void* slot = nullptr;
+        std::memcpy(&slot, &value, sizeof(Value));
+        return slot;
+    }
+
+    static Value from_slot(void* slot) {
+        Value value;
+        std::memcpy(&value, &slot, sizeof(Value));
+        return value;
+    }
+
+    static c_engine::RouterStrategy to_c_strategy(RouterStrategy strategy) {
+        switch (strategy) {
+            case RouterStrategy::STATIC_HASH:     return c_engine::ROUTER_STATIC_HASH;
+            case RouterStrategy::LOAD_AWARE:      return c_engine::ROUTER_LOAD_AWARE;
+            case RouterStrategy::CONSISTENT_HASH:
+            case RouterStrategy::VIRTUAL_NODES:   return c_engine::ROUTER_CONSISTENT_HASH;
+            case RouterStrategy::INTELLIGENT:     break;
+        }
+        return c_engine::ROUTER_INTELLIGENT;
+    }
+
+public:
+    explicit CEngineParallelAVL(
+        size_t num_shards = 8,
+        RouterStrategy strategy = RouterStrategy::INTELLIGENT
+    ) : tree_(c_engine::parallel_avl_create(num_shards, to_c_strategy(strategy)))
+    {
+        if (!tree_) {
+            throw std::bad_alloc();
+        }
+    }
+
+    ~CEngineParallelAVL() {
+        c_engine::parallel_avl_destroy(tree_);
+    }
+
+    CEngineParallelAVL(const CEngineParallelAVL&) = delete;
+    CEngineParallelAVL& operator=(const CEngineParallelAVL&) = delete;
+
+    void insert(const Key& key, const Value& value) {
+        c_engine::parallel_avl_insert(tree_, key, to_slot(value));
+    }
+
+    bool contains(const Key& key) const {
+        return c_engine::parallel_avl_contains(tree_, key);
+    }
+
+    std::optional<Value> get(const Key& key) const {
+        bool found = false;
+        void* slot = c_engine::parallel_avl_get(tree_, key, &found);
+        if (!found) return std::nullopt;
+        return from_slot(slot);
+    }
+
+    bool remove(const Key& key) {
+        return c_engine::parallel_avl_remove(tree_, key);
+    }
+
+    // Get en lote: parallel_avl_get_many agrupa por shard e intercala las
+    // búsquedas con prefetch
+    std::vector<std::optional<Value>> get_batch(const std::vector<Key>& keys) const {
+        size_t n = keys.size();
+        std::vector<void*> slots(n);
+        std::unique_ptr<bool[]> found(new bool[n]);
+        c_engine::parallel_avl_get_many(tree_, keys.data(), n, slots.data(), found.get());
+
+        std::vector<std::optional<Value>> results(n);
+        for (size_t i = 0; i < n; ++i) {
+            if (found[i]) results[i] = from_slot(slots[i]);
+        }
+        return results;
+    }
+
+    // Pares (key, value) con key en [lo, hi], ordenados
+    template<typename OutputIt>
+    void range_query(const Key& lo, const Key& hi, OutputIt out) const {
+        std::vector<c_engine::AVLKeyValue> page(RANGE_PAGE);
+        Key next_lo = lo;
+        bool more = lo <= hi;
+        while (more) {
+            size_t count = 0;
+            more = c_engine::parallel_avl_range_page(tree_, next_lo, hi, page.data(),
+                                                     page.size(), &count, &next_lo);
+            for (size_t i = 0; i < count; ++i) {
+                *out++ = std::make_pair(page[i].key, from_slot(page[i].value));
+            }
+        }
+    }
+
+    size_t size() const {
+        return c_engine::parallel_avl_size(tree_);
+    }
+
+    // Mismos campos que ParallelAVL::Stats, más el estado de migración del
+    // anillo (CONSISTENT_HASH)
+    struct Stats {
+        size_t num_shards;
+        size_t total_size;
+        size_t total_ops;
+
+        std::vector<size_t> shard_sizes;
+        std::vector<size_t> shard_inserts;
+        std::vector<size_t> shard_lookups;
+
+        double balance_score;
+        bool has_hotspot;
+        size_t suspicious_patterns;
+        size_t blocked_redirects;
+
+        size_t redirect_index_size;
+        size_t redirect_index_hits;
+        double redirect_hit_rate;
+
+        size_t redirect_index_memory_bytes;
+
+        bool migrating;
+        size_t migrated_keys;
+    };
+
+    Stats get_stats() const {
+        c_engine::ParallelAVLStats raw = c_engine::parallel_avl_get_stats(tree_);
+
+        Stats stats{};
+        stats.num_shards = raw.num_shards;
+        stats.total_size = raw.total_size;
+        stats.total_ops = raw.total_ops;
+        if (raw.shard_sizes) {
+            stats.shard_sizes.assign(raw.shard_sizes, raw.shard_sizes + raw.num_shards);
+            stats.shard_inserts.assign(raw.shard_inserts, raw.shard_inserts + raw.num_shards);
+            stats.shard_lookups.assign(raw.shard_lookups, raw.shard_lookups + raw.num_shards);
+        }
+        stats.balance_score = raw.balance_score;
+        stats.has_hotspot = raw.has_hotspot;
+        stats.suspicious_patterns = raw.suspicious_patterns;
+        stats.blocked_redirects = raw.blocked_redirects;
+        stats.redirect_index_size = raw.redirect_index_size;
+        stats.redirect_index_hits = raw.redirect_index_hits;
+        stats.redirect_hit_rate = raw.redirect_hit_rate;
+        stats.redirect_index_memory_bytes = raw.redirect_index_memory_bytes;
+        stats.migrating = raw.migrating;
+        stats.migrated_keys = raw.migrated_keys;
+
+        c_engine::parallel_avl_free_stats(&raw);
+        return stats;
+    }
+
+    void print_stats() const {
+        c_engine::parallel_avl_print_stats(tree_);
+    }
+
+    void clear() {
+        c_engine::parallel_avl_clear(tree_);
+    }
+
+    // Devuelve memoria de nodos libres al sistema (ver c_src/README)
+    size_t trim() {
+        return c_engine::parallel_avl_trim(tree_);
+    }
+
+    // =========================================================================
+    // Dynamic Scaling
+    // =========================================================================
+
+    void add_shard() {
+        if (!c_engine::parallel_avl_add_shard(tree_)) {
+            throw std::bad_alloc();
+        }
+    }
+
+    void remove_shard() {
+        c_engine::parallel_avl_remove_shard(tree_);
+    }
+
+    void force_rebalance() {
+        c_engine::parallel_avl_force_rebalance(tree_);
+    }
+
+    size_t get_num_shards() const {
+        return c_engine::parallel_avl_num_shards(tree_);
+    }
+
+    double get_balance_score() const {
+        return c_engine::parallel_avl_balance_score(tree_);
+    }
+};
+
+// ParallelAVL con keys int64_t y valores inline -> motor en C; el resto de
+// combinaciones -> la versión template
+template<typename Key, typename Value>
+using AutoParallelAVL = std::conditional_t<
+    uses_c_engine<Key, Value>::value,
+    CEngineParallelAVL<Value>,
+    ParallelAVL<Key, Value>>;
+
+#endif // C_ENGINE_AVL_HPP
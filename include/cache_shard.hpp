@@ -0,0 +1,574 @@
+#ifndef CACHE_SHARD_HPP
+#define CACHE_SHARD_HPP
+
+#include "AVLTree.h"
+#include "timer_wheel.hpp"
+#include "deferred_destroyer.hpp"
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <optional>
+#include <limits>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+
+// =============================================================================
+// CacheShard - Shard con presupuesto de memoria/entradas y eviction S3-FIFO
+// =============================================================================
+//
+// Para usar ParallelAVL como cache acotado sin borrar keys desde afuera. El
+// shard lleva la cuenta exacta de sus bytes y, al pasarse del presupuesto en
+// un insert, expulsa entradas él mismo: sin lock global ni recorrer el árbol.
+//
+// Política S3-FIFO (Yang et al., SOSP'23), por shard:
+//   - small_: FIFO de entradas nuevas (~10% del shard). La mayoría de las
+//     keys de un solo uso salen de acá sin tocar main_.
+//   - main_:  FIFO de entradas que tuvieron hits. Al llegar al frente, una
+//     entrada con freq > 0 se reencola con freq - 1 (CLOCK); con 0 se expulsa.
+//   - ghost_: hashes de keys expulsadas desde small_. Si vuelven a
+//     insertarse entran directo a main_.
+//   Cada hit sube freq (2 bits, tope 3) bajo el lock que el get ya toma.
+//
+// Las colas guardan (key, seq). Un remove deja un item viejo en la cola; se
+// reconoce porque la key ya no está o su seq no coincide, y se descarta al
+// desencolar. Si los items viejos superan a los vivos, las colas
+// se compactan (amortizado O(1) por operación).
+//
+// Bytes por entrada: nodo del árbol + item de cola + memoria dinámica de key
+// y value (CacheSizeOf, con soporte para std::string/std::vector; se puede
+// especializar para otros tipos).
+//
+// TTL: insert_tracked(key, value, deadline) guarda el vencimiento en la
+// entrada y programa un timer en el TimerWheel del shard (ticks de 1 ms).
+// Lecturas (get/contains/range_query) tratan como ausente lo vencido sin
+// esperar al wheel; los inserts y expire() avanzan el wheel y liberan lo
+// vencido en O(1) amortizado. Hasta entonces size() y el presupuesto lo
+// siguen contando. Un insert sin deadline quita el TTL (como SET en Redis).
+//
+// Misma interfaz que TreeShard: ParallelAVL<K, V, CacheShard<K, V>>, con
+// ParallelAVL::set_capacity(max_entries, max_bytes) repartido entre shards.
+//
+// ClockT (default steady_clock) es la fuente de tiempo del TTL: cualquier
+// tipo con la interfaz de un reloj de <chrono> (now(), time_point). Los
+// tests usan uno manual para vencer entradas sin dormir.
+// =============================================================================
+
+// Memoria dinámica de un valor, además de sizeof(T). Default: contenedores
+// con capacity()/data() cuyo buffer no está dentro del objeto (SSO)
+template<typename T, typename = void>
+struct CacheSizeOf {
+    static size_t heap_bytes(const T&) { return 0; }
+};
+
+template<typename T>
+struct CacheSizeOf<T, std::void_t<decltype(std::declval<const T&>().capacity()),
+                                  decltype(std::declval<const T&>().data()),
+                                  typename T::value_type>> {
+    static size_t heap_bytes(const T& v) {
+        const char* data = reinterpret_cast<const char*>(v.data());
+        const char* self = reinterpret_cast<const char*>(&v);
+        if (data >= self && data < self + sizeof(T)) return 0;  // SSO
+        return v.capacity() * sizeof(typename T::value_type);
+    }
+};
+
+template<typename Key, typename Value, typename ClockT = std::chrono::steady_clock>
+class CacheShard {
+public:
+    // 0 = sin límite
+    struct Budget {
+        size_t max_entries = 0;
+        size_t max_bytes = 0;
+    };
+
+    struct InsertResult {
+        bool inserted;      // key nueva (no update)
+        size_t evicted;     // entradas expulsadas por este insert
+    };
+
+    using Clock = ClockT;
+    using TimePoint = typename Clock::time_point;
+
+    // Entrada con su vencimiento, para redistribuir sin perder el TTL
+    struct ExpiringItem {
+        Key first;
+        Value second;
+        TimePoint expires_at;       // TimePoint::max() = sin TTL
+    };
+
+    static constexpr uint8_t MAX_FREQ = 3;
+    static constexpr size_t SMALL_RATIO = 10;   // small_ ~ 1/10 del shard
+
+private:
+    struct Entry {
+        Value value;
+        uint64_t seq;
+        size_t bytes;
+        uint64_t expires_at;    // tick de vencimiento, 0 = sin TTL
+        mutable uint8_t freq;   // hits, actualizado en lecturas bajo el lock
+        bool in_main;
+    };
+
+    struct QueueItem {
+        Key key;
+        uint64_t seq;
+    };
+
+    using Tree = AVLTree<Key, Entry>;
+
+    // Lo que clear() desengancha bajo el lock para destruirlo afuera
+    struct Retired {
+        Tree tree;
+        std::deque<QueueItem> small;
+        std::deque<QueueItem> main;
+        std::deque<size_t> ghost_fifo;
+        std::unordered_map<size_t, uint32_t> ghost;
+        TimerWheel<Key> timers;
+    };
+
+    Tree tree_;
+    mutable std::mutex mutex_;
+
+    std::deque<QueueItem> small_;
+    std::deque<QueueItem> main_;
+    size_t small_live_ = 0;
+    size_t main_live_ = 0;
+    size_t stale_ = 0;              // items de cola que ya no son válidos
+    uint64_t next_seq_ = 0;
+
+    std::deque<size_t> ghost_fifo_;
+    std::unordered_map<size_t, uint32_t> ghost_;
+
+    TimerWheel<Key> timers_{now_tick()};
+    size_t expirations_ = 0;
+
+    Budget budget_;
+    size_t bytes_ = 0;
+    size_t evictions_ = 0;
+    size_t ghost_hits_ = 0;
+
+    std::atomic<size_t> size_{0};
+    std::atomic<size_t> insert_count_{0};
+    std::atomic<size_t> remove_count_{0};
+    mutable std::atomic<size_t> lookup_count_{0};
+
+    // Bounds conservadores (como TieredShard): se resetean al vaciarse
+    std::atomic<Key> min_key_{std::numeric_limits<Key>::max()};
+    std::atomic<Key> max_key_{std::numeric_limits<Key>::min()};
+    std::atomic<bool> has_keys_{false};
+
+    static size_t entry_bytes(const Key& key, const Value& value) {
+        return sizeof(typename Tree::Node) + sizeof(QueueItem) +
+               CacheSizeOf<Key>::heap_bytes(key) + CacheSizeOf<Value>::heap_bytes(value);
+    }
+
+    static uint64_t to_tick(TimePoint tp) {
+        return static_cast<uint64_t>(
+            std::chrono::ceil<std::chrono::milliseconds>(tp.time_since_epoch()).count());
+    }
+
+    static uint64_t now_tick() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            Clock::now().time_since_epoch()).count());
+    }
+
+    static bool expired(const Entry& e) {
+        return e.expires_at != 0 && e.expires_at <= now_tick();
+    }
+
+    // Liberar todo lo vencido según el wheel
+    size_t expire_nl() {
+        if (timers_.empty()) return 0;
+        size_t expired_now = 0;
+        timers_.advance(now_tick(), [this, &expired_now](uint64_t tick, const Key& key) {
+            const Entry* e = tree_.find(key);
+            // El timer de una entrada borrada o con otro TTL ya no vale
+            if (!e || e->expires_at != tick) return;
+            drop_nl(key, *e);
+            stale_++;
+            expired_now++;
+        });
+        expirations_ += expired_now;
+        if (expired_now) {
+            if (tree_.size() == 0) has_keys_.store(false, std::memory_order_release);
+            maybe_purge_nl();
+        }
+        return expired_now;
+    }
+
+    static size_t key_hash(const Key& key) {
+        size_t h = std::hash<Key>{}(key);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    void update_bounds(const Key& key) {
+        if (!has_keys_.load(std::memory_order_relaxed)) {
+            min_key_.store(key, std::memory_order_relaxed);
+            max_key_.store(key, std::memory_order_relaxed);
+            has_keys_.store(true, std::memory_order_release);
+        } else {
+            if (key < min_key_.load(std::memory_order_relaxed)) {
+                min_key_.store(key, std::memory_order_relaxed);
+            }
+            if (key > max_key_.load(std::memory_order_relaxed)) {
+                max_key_.store(key, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool over_budget_nl() const {
+        size_t n = tree_.size();
+        if (n == 0) return false;
+        return (budget_.max_entries && n > budget_.max_entries) ||
+               (budget_.max_bytes && bytes_ > budget_.max_bytes);
+    }
+
+    // Entrada viva a la que apunta el item, o nullptr si el item es viejo
+    Entry* resolve_nl(const QueueItem& item, bool in_main) {
+        const Entry* e = tree_.find(item.key);
+        if (!e || e->seq != item.seq || e->in_main != in_main) return nullptr;
+        return const_cast<Entry*>(e);
+    }
+
+    void ghost_add_nl(const Key& key) {
+        size_t h = key_hash(key);
+        ghost_fifo_.push_back(h);
+        ghost_[h]++;
+        // Acotada al tamaño de main_ (mínimo 16)
+        size_t limit = std::max<size_t>(main_live_, 16);
+        while (ghost_fifo_.size() > limit) {
+            size_t old = ghost_fifo_.front();
+            ghost_fifo_.pop_front();
+            auto it = ghost_.find(old);
+            if (it != ghost_.end() && --it->second == 0) ghost_.erase(it);
+        }
+    }
+
+    bool ghost_take_nl(const Key& key) {
+        auto it = ghost_.find(key_hash(key));
+        if (it == ghost_.end()) return false;
+        // Queda en la FIFO; el contador evita sacar otra copia por error
+        if (--it->second == 0) ghost_.erase(it);
+        ghost_hits_++;
+        return true;
+    }
+
+    void drop_nl(const Key& key, const Entry& e) {
+        bytes_ -= e.bytes;
+        if (e.in_main) main_live_--; else small_live_--;
+        tree_.remove(key);
+        size_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Expulsar una entrada. false si no quedó nada que expulsar
+    bool evict_one_nl() {
+        for (;;) {
+            bool from_small = !small_.empty() &&
+                (small_live_ * SMALL_RATIO >= tree_.size() || main_live_ == 0);
+            std::deque<QueueItem>& queue = from_small ? small_ : main_;
+            if (queue.empty()) return false;
+
+            QueueItem item = std::move(queue.front());
+            queue.pop_front();
+            Entry* e = resolve_nl(item, !from_small);
+            if (!e) {
+                stale_--;
+                continue;
+            }
+
+            if (from_small) {
+                if (e->freq > 0) {
+                    // Tuvo hits en small_: promover a main_
+                    e->freq = 0;
+                    e->in_main = true;
+                    small_live_--;
+                    main_live_++;
+                    main_.push_back(std::move(item));
+                    continue;
+                }
+                ghost_add_nl(item.key);
+            } else if (e->freq > 0) {
+                e->freq--;
+                main_.push_back(std::move(item));
+                continue;
+            }
+
+            drop_nl(item.key, *e);
+            evictions_++;
+            return true;
+        }
+    }
+
+    size_t enforce_budget_nl() {
+        size_t evicted = 0;
+        while (over_budget_nl() && evict_one_nl()) evicted++;
+        if (tree_.size() == 0) has_keys_.store(false, std::memory_order_release);
+        return evicted;
+    }
+
+    // Reconstruir colas sin items viejos cuando éstos dominan
+    void maybe_purge_nl() {
+        if (stale_ < 1024 || stale_ < tree_.size()) return;
+        auto filter = [this](std::deque<QueueItem>& queue, bool in_main) {
+            std::deque<QueueItem> kept;
+            for (auto& item : queue) {
+                if (resolve_nl(item, in_main)) kept.push_back(std::move(item));
+            }
+            queue.swap(kept);
+        };
+        filter(small_, false);
+        filter(main_, true);
+        stale_ = 0;
+    }
+
+public:
+    CacheShard() = default;
+
+    // Fijar presupuesto; expulsa en el acto si ya se excede
+    void set_budget(const Budget& budget) {
+        std::lock_guard lock(mutex_);
+        budget_ = budget;
+        enforce_budget_nl();
+    }
+
+    Budget budget() const {
+        std::lock_guard lock(mutex_);
+        return budget_;
+    }
+
+    // evicted incluye las entradas vencidas que este insert liberó. Un
+    // deadline ya pasado no inserta (y borra la key si existía)
+    InsertResult insert_tracked(const Key& key, const Value& value,
+                                TimePoint deadline = TimePoint::max()) {
+        std::lock_guard lock(mutex_);
+        insert_count_.fetch_add(1, std::memory_order_relaxed);
+        size_t reclaimed = expire_nl();
+
+        uint64_t expires_at = 0;
+        if (deadline != TimePoint::max()) {
+            expires_at = to_tick(deadline);
+            if (expires_at <= now_tick()) {
+                const Entry* e = tree_.find(key);
+                if (e) {
+                    drop_nl(key, *e);
+                    stale_++;
+                    reclaimed++;
+                    if (tree_.size() == 0) has_keys_.store(false, std::memory_order_release);
+                }
+                return InsertResult{false, reclaimed};
+            }
+            timers_.schedule(expires_at, key);
+        }
+
+        if (const Entry* found = tree_.find(key)) {
+            Entry* e = const_cast<Entry*>(found);
+            size_t bytes = entry_bytes(key, value);
+            bytes_ = bytes_ - e->bytes + bytes;
+            e->value = value;
+            e->bytes = bytes;
+            e->expires_at = expires_at;
+            if (e->freq < MAX_FREQ) e->freq++;
+            return InsertResult{false, reclaimed + enforce_budget_nl()};
+        }
+
+        bool to_main = ghost_take_nl(key);
+        uint64_t seq = next_seq_++;
+        size_t bytes = entry_bytes(key, value);
+        tree_.insert(key, Entry{value, seq, bytes, expires_at, 0, to_main});
+        bytes_ += bytes;
+        if (to_main) {
+            main_.push_back(QueueItem{key, seq});
+            main_live_++;
+        } else {
+            small_.push_back(QueueItem{key, seq});
+            small_live_++;
+        }
+        size_.fetch_add(1, std::memory_order_relaxed);
+        update_bounds(key);
+
+        return InsertResult{true, reclaimed + enforce_budget_nl()};
+    }
+
+    void insert(const Key& key, const Value& value) {
+        insert_tracked(key, value);
+    }
+
+    // Liberar ya las entradas vencidas (p.ej. desde un thread de
+    // mantenimiento). Devuelve cuántas se liberaron
+    size_t expire() {
+        std::lock_guard lock(mutex_);
+        return expire_nl();
+    }
+
+    bool remove(const Key& key) {
+        std::lock_guard lock(mutex_);
+        const Entry* e = tree_.find(key);
+        if (!e || expired(*e)) return false;  // lo vencido lo libera el wheel
+        drop_nl(key, *e);
+        stale_++;
+        remove_count_.fetch_add(1, std::memory_order_relaxed);
+        if (tree_.size() == 0) has_keys_.store(false, std::memory_order_release);
+        maybe_purge_nl();
+        return true;
+    }
+
+    bool contains(const Key& key) const {
+        std::lock_guard lock(mutex_);
+        lookup_count_.fetch_add(1, std::memory_order_relaxed);
+        const Entry* e = tree_.find(key);
+        if (!e || expired(*e)) return false;
+        if (e->freq < MAX_FREQ) e->freq++;
+        return true;
+    }
+
+    std::optional<Value> get(const Key& key) const {
+        std::lock_guard lock(mutex_);
+        lookup_count_.fetch_add(1, std::memory_order_relaxed);
+        const Entry* e = tree_.find(key);
+        if (!e || expired(*e)) return std::nullopt;
+        if (e->freq < MAX_FREQ) e->freq++;
+        return e->value;
+    }
+
+    // Bytes contabilizados (nodos + colas + memoria dinámica de keys/values)
+    size_t memory_bytes() const {
+        std::lock_guard lock(mutex_);
+        return bytes_;
+    }
+
+    size_t size() const {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    size_t insert_count() const {
+        return insert_count_.load(std::memory_order_relaxed);
+    }
+
+    size_t remove_count() const {
+        return remove_count_.load(std::memory_order_relaxed);
+    }
+
+    size_t lookup_count() const {
+        return lookup_count_.load(std::memory_order_relaxed);
+    }
+
+    bool intersects_range(const Key& lo, const Key& hi) const {
+        if (!has_keys_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        Key shard_min = min_key_.load(std::memory_order_relaxed);
+        Key shard_max = max_key_.load(std::memory_order_relaxed);
+        return !(shard_max < lo || shard_min > hi);
+    }
+
+    // Range query (no cuenta como hit)
+    template<typename OutputIt>
+    void range_query(const Key& lo, const Key& hi, OutputIt out) const {
+        std::lock_guard lock(mutex_);
+        uint64_t now = now_tick();
+        tree_.forEachInRange(lo, hi, [&out, now](const Key& k, const Entry& e) {
+            if (e.expires_at != 0 && e.expires_at <= now) return;
+            *out++ = std::make_pair(k, e.value);
+        });
+    }
+
+    struct Stats {
+        size_t size;
+        size_t inserts;
+        size_t removes;
+        size_t lookups;
+        std::optional<Key> min_key;
+        std::optional<Key> max_key;
+        size_t bytes;
+        size_t evictions;
+        size_t ghost_hits;
+        size_t expirations;
+        size_t pending_timers;
+        size_t small_entries;
+        size_t main_entries;
+    };
+
+    Stats get_stats() const {
+        Stats stats;
+        stats.size = size_.load(std::memory_order_relaxed);
+        stats.inserts = insert_count_.load(std::memory_order_relaxed);
+        stats.removes = remove_count_.load(std::memory_order_relaxed);
+        stats.lookups = lookup_count_.load(std::memory_order_relaxed);
+
+        if (has_keys_.load(std::memory_order_acquire)) {
+            stats.min_key = min_key_.load(std::memory_order_relaxed);
+            stats.max_key = max_key_.load(std::memory_order_relaxed);
+        }
+
+        std::lock_guard lock(mutex_);
+        stats.bytes = bytes_;
+        stats.evictions = evictions_;
+        stats.ghost_hits = ghost_hits_;
+        stats.expirations = expirations_;
+        stats.pending_timers = timers_.size();
+        stats.small_entries = small_live_;
+        stats.main_entries = main_live_;
+        return stats;
+    }
+
+    // Clear (para testing); el presupuesto se mantiene
+    // Como TreeShard::clear: bajo el lock solo se desenganchan árbol, colas,
+    // ghosts y timers (moves); destruirlos queda para el DeferredDestroyer
+    void clear() {
+        auto old = std::make_unique<Retired>();
+        {
+            std::lock_guard lock(mutex_);
+            old->tree = std::move(tree_);
+            tree_ = Tree();
+            old->small.swap(small_);
+            old->main.swap(main_);
+            old->ghost_fifo.swap(ghost_fifo_);
+            old->ghost.swap(ghost_);
+            old->timers = std::move(timers_);
+            timers_ = TimerWheel<Key>(now_tick());
+            small_live_ = main_live_ = stale_ = 0;
+            bytes_ = 0;
+            size_.store(0, std::memory_order_relaxed);
+            insert_count_.store(0, std::memory_order_relaxed);
+            remove_count_.store(0, std::memory_order_relaxed);
+            lookup_count_.store(0, std::memory_order_relaxed);
+            has_keys_.store(false, std::memory_order_release);
+        }
+        DeferredDestroyer::dispose(std::move(old));
+    }
+
+    template<typename OutputIt>
+    void extract_all(OutputIt out) const {
+        std::lock_guard lock(mutex_);
+        uint64_t now = now_tick();
+        tree_.forEach([&out, now](const Key& k, const Entry& e) {
+            if (e.expires_at != 0 && e.expires_at <= now) return;
+            *out++ = std::make_pair(k, e.value);
+        });
+    }
+
+    // Como extract_all, con el vencimiento de cada entrada
+    template<typename OutputIt>
+    void extract_all_expiring(OutputIt out) const {
+        std::lock_guard lock(mutex_);
+        uint64_t now = now_tick();
+        tree_.forEach([&out, now](const Key& k, const Entry& e) {
+            if (e.expires_at != 0 && e.expires_at <= now) return;
+            TimePoint deadline = e.expires_at == 0 ? TimePoint::max()
+                : TimePoint(std::chrono::milliseconds(e.expires_at));
+            *out++ = ExpiringItem{k, e.value, deadline};
+        });
+    }
+};
+
+#endif // CACHE_SHARD_HPP
@@ -0,0 +1,874 @@
+#ifndef CONCURRENT_AVL_SHARD_HPP
+#define CONCURRENT_AVL_SHARD_HPP
+
+#include "epoch_reclaimer.hpp"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <optional>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// =============================================================================
+// ConcurrentAVLShard - AVL concurrente de grano fino (Bronson et al., PPoPP'10)
+// =============================================================================
+//
+// TreeShard serializa todo el shard con un mutex: un shard caliente es
+// single-threaded. Cuando el rango caliente no puede redirigirse (range
+// queries sobre ese rango), la única salida es paralelizar DENTRO del shard.
+//
+// Algoritmo (optimistic hand-over-hand validation):
+//   - Cada nodo tiene un número de versión. Una rotación marca al nodo que
+//     baja como SHRINKING y al terminar incrementa su contador.
+//   - Lecturas sin locks: se lee el hijo, se valida que la versión del padre
+//     no cambió y se desciende. Si cambió, se reintenta desde el nivel
+//     anterior (no desde la raíz).
+//   - Escrituras: descenso optimista + lock sólo del nodo a modificar.
+//   - Remove de nodos con dos hijos: el nodo queda como "routing node"
+//     (valor nulo) y se desenlaza cuando pierde un hijo.
+//   - Balance relajado: las alturas se corrigen después de la modificación,
+//     con locks por nodo (padre → nodo → hijo) durante las rotaciones.
+//
+// Memoria: los nodos desenlazados y los valores reemplazados se liberan via
+// EpochReclaimer (los lectores pueden seguir viéndolos).
+//
+// Misma interfaz que TreeShard: se usa como ParallelAVL<K, V, ConcurrentAVLShard<K, V>>.
+// =============================================================================
+
+template<typename Key, typename Value>
+class ConcurrentAVLShard {
+private:
+    // Bits de versión
+    static constexpr uint64_t UNLINKED = 0x1;
+    static constexpr uint64_t SHRINKING = 0x2;
+    static constexpr uint64_t SHRINK_COUNT_INCR = 0x4;
+
+    // Resultados de node_condition (alturas válidas son >= 1)
+    static constexpr int UNLINK_REQUIRED = -1;
+    static constexpr int REBALANCE_REQUIRED = -2;
+    static constexpr int NOTHING_REQUIRED = -3;
+
+    static constexpr int SPINS_BEFORE_YIELD = 100;
+
+    // Spinlock de 1 byte: las secciones críticas por nodo son de pocas instrucciones
+    class NodeLock {
+        std::atomic<bool> locked_{false};
+
+    public:
+        void lock() {
+            while (locked_.exchange(true, std::memory_order_acquire)) {
+                int spins = 0;
+                while (locked_.load(std::memory_order_relaxed)) {
+                    if (++spins > SPINS_BEFORE_YIELD) {
+                        std::this_thread::yield();
+                        spins = 0;
+                    }
+                }
+            }
+        }
+
+        void unlock() {
+            locked_.store(false, std::memory_order_release);
+        }
+    };
+
+    struct Node {
+        // key/height/lock juntos para no desperdiciar padding
+        const Key key;
+        std::atomic<int> height;
+        NodeLock lock;
+        std::atomic<uint64_t> version{0};
+        std::atomic<Value*> value;        // nullptr = routing node (ausente)
+        std::atomic<Node*> parent;
+        std::atomic<Node*> left{nullptr};
+        std::atomic<Node*> right{nullptr};
+
+        Node(const Key& k, Value* v, int h, Node* p)
+            : key(k), height(h), value(v), parent(p) {}
+
+        ~Node() {
+            delete value.load(std::memory_order_relaxed);
+        }
+
+        Node* child(int dir) const {
+            return dir < 0 ? left.load() : right.load();
+        }
+
+        void set_child(int dir, Node* c) {
+            if (dir < 0) left.store(c);
+            else right.store(c);
+        }
+    };
+
+    enum class Status { FOUND, NOT_FOUND, INSERTED, UPDATED, REMOVED, RETRY, DONE, STOP };
+
+    using NodeGuard = std::lock_guard<NodeLock>;
+    using SubtreeGuard = std::unique_lock<NodeLock>;
+
+    // root_holder_.right es la raíz real; su versión nunca cambia
+    mutable Node root_holder_{Key{}, nullptr, 1, nullptr};
+
+    // Estadísticas atómicas (lock-free reads)
+    std::atomic<size_t> size_{0};
+    std::atomic<size_t> insert_count_{0};
+    std::atomic<size_t> remove_count_{0};
+    mutable std::atomic<size_t> lookup_count_{0};
+
+    // Bounds conservadores: sólo se ensanchan (remove no los achica), así
+    // intersects_range puede dar falsos positivos pero nunca falsos negativos
+    std::atomic<Key> min_key_{std::numeric_limits<Key>::max()};
+    std::atomic<Key> max_key_{std::numeric_limits<Key>::min()};
+    std::atomic<bool> has_keys_{false};
+
+    static int compare(const Key& a, const Key& b) {
+        return a < b ? -1 : (b < a ? 1 : 0);
+    }
+
+    static int height(const Node* n) {
+        return n ? n->height.load(std::memory_order_relaxed) : 0;
+    }
+
+    static uint64_t begin_shrink(uint64_t ovl) { return ovl | SHRINKING; }
+    static uint64_t end_shrink(uint64_t ovl) { return ovl + SHRINK_COUNT_INCR; }
+
+    static void wait_until_not_changing(Node* n) {
+        for (int i = 0; i < SPINS_BEFORE_YIELD; ++i) {
+            if (!(n->version.load() & SHRINKING)) return;
+        }
+        // Quien rota tiene el lock del nodo: esperar a que lo suelte
+        NodeGuard g(n->lock);
+    }
+
+    void update_bounds(const Key& key) {
+        Key cur = min_key_.load(std::memory_order_relaxed);
+        while (key < cur && !min_key_.compare_exchange_weak(cur, key, std::memory_order_relaxed)) {}
+        cur = max_key_.load(std::memory_order_relaxed);
+        while (cur < key && !max_key_.compare_exchange_weak(cur, key, std::memory_order_relaxed)) {}
+        if (!has_keys_.load(std::memory_order_relaxed)) {
+            has_keys_.store(true, std::memory_order_release);
+        }
+    }
+
+    // =========================================================================
+    // Búsqueda optimista
+    // =========================================================================
+
+    // Busca key en el subárbol node->child(dir), validando node contra node_v
+    Status attempt_get(const Key& key, Node* node, int dir, uint64_t node_v,
+                       std::optional<Value>* out) const {
+        while (true) {
+            Node* child = node->child(dir);
+            if (node->version.load() != node_v) return Status::RETRY;
+            if (!child) return Status::NOT_FOUND;
+
+            int next_d = compare(key, child->key);
+            if (next_d == 0) {
+                Value* v = child->value.load(std::memory_order_acquire);
+                if (!v) return Status::NOT_FOUND;
+                if (out) *out = *v;
+                return Status::FOUND;
+            }
+
+            uint64_t ch_v = child->version.load();
+            if (ch_v & SHRINKING) {
+                wait_until_not_changing(child);
+            } else if (ch_v != UNLINKED && child == node->child(dir)) {
+                if (node->version.load() != node_v) return Status::RETRY;
+                Status s = attempt_get(key, child, next_d, ch_v, out);
+                if (s != Status::RETRY) return s;
+            }
+        }
+    }
+
+    // =========================================================================
+    // Insert / update
+    // =========================================================================
+
+    Status attempt_put(const Key& key, Value* nv, Node* node, int dir, uint64_t node_v) {
+        Status p = Status::RETRY;
+        do {
+            Node* child = node->child(dir);
+            if (node->version.load() != node_v) return Status::RETRY;
+
+            if (!child) {
+                Node* damaged = nullptr;
+                {
+                    NodeGuard g(node->lock);
+                    if (node->version.load() != node_v) return Status::RETRY;
+                    if (node->child(dir) == nullptr) {
+                        node->set_child(dir, new Node(key, nv, 1, node));
+                        damaged = fix_height_nl(node);
+                        p = Status::INSERTED;
+                    }
+                }
+                if (p == Status::INSERTED) {
+                    fix_height_and_rebalance(damaged);
+                }
+            } else {
+                int next_d = compare(key, child->key);
+                if (next_d == 0) {
+                    p = attempt_update(child, nv);
+                } else {
+                    uint64_t ch_v = child->version.load();
+                    if (ch_v & SHRINKING) {
+                        wait_until_not_changing(child);
+                    } else if (ch_v != UNLINKED && child == node->child(dir)) {
+                        if (node->version.load() != node_v) return Status::RETRY;
+                        p = attempt_put(key, nv, child, next_d, ch_v);
+                    }
+                }
+            }
+        } while (p == Status::RETRY);
+        return p;
+    }
+
+    Status attempt_update(Node* n, Value* nv) {
+        NodeGuard g(n->lock);
+        if (n->version.load() == UNLINKED) return Status::RETRY;
+        Value* prev = n->value.exchange(nv, std::memory_order_acq_rel);
+        if (prev) {
+            EpochReclaimer::retire(prev);
+            return Status::UPDATED;
+        }
+        return Status::INSERTED;  // routing node revivido
+    }
+
+    // =========================================================================
+    // Remove
+    // =========================================================================
+
+    Status attempt_remove(const Key& key, Node* node, int dir, uint64_t node_v) {
+        Status p = Status::RETRY;
+        do {
+            Node* child = node->child(dir);
+            if (node->version.load() != node_v) return Status::RETRY;
+            if (!child) return Status::NOT_FOUND;
+
+            int next_d = compare(key, child->key);
+            if (next_d == 0) {
+                p = attempt_rm_node(node, child);
+            } else {
+                uint64_t ch_v = child->version.load();
+                if (ch_v & SHRINKING) {
+                    wait_until_not_changing(child);
+                } else if (ch_v != UNLINKED && child == node->child(dir)) {
+                    if (node->version.load() != node_v) return Status::RETRY;
+                    p = attempt_remove(key, child, next_d, ch_v);
+                }
+            }
+        } while (p == Status::RETRY);
+        return p;
+    }
+
+    static bool can_unlink(const Node* n) {
+        return n->left.load() == nullptr || n->right.load() == nullptr;
+    }
+
+    Status attempt_rm_node(Node* par, Node* n) {
+        if (n->value.load() == nullptr) return Status::NOT_FOUND;
+
+        Value* prev;
+        if (!can_unlink(n)) {
+            // Dos hijos: convertir en routing node
+            NodeGuard g(n->lock);
+            if (n->version.load() == UNLINKED || can_unlink(n)) return Status::RETRY;
+            prev = n->value.exchange(nullptr);
+            if (!prev) return Status::NOT_FOUND;
+            EpochReclaimer::retire(prev);
+            return Status::REMOVED;
+        }
+
+        Node* damaged;
+        {
+            NodeGuard gp(par->lock);
+            if (par->version.load() == UNLINKED || n->parent.load() != par) return Status::RETRY;
+            NodeGuard gn(n->lock);
+            prev = n->value.load();
+            if (!prev) return Status::NOT_FOUND;
+            if (!attempt_unlink_nl(par, n)) return Status::RETRY;
+            damaged = fix_height_nl(par);
+        }
+        EpochReclaimer::retire(prev);
+        fix_height_and_rebalance(damaged);
+        return Status::REMOVED;
+    }
+
+    // Requiere locks de parent y n. Desenlaza n (que tiene a lo sumo un hijo)
+    bool attempt_unlink_nl(Node* parent, Node* n) {
+        Node* parent_l = parent->left.load();
+        Node* parent_r = parent->right.load();
+        if (parent_l != n && parent_r != n) return false;
+
+        Node* l = n->left.load();
+        Node* r = n->right.load();
+        if (l && r) return false;
+
+        Node* splice = l ? l : r;
+        if (parent_l == n) parent->left.store(splice);
+        else parent->right.store(splice);
+        if (splice) splice->parent.store(parent);
+
+        n->version.store(UNLINKED);
+        n->value.store(nullptr);
+        EpochReclaimer::retire(n);
+        return true;
+    }
+
+    // =========================================================================
+    // Balance relajado
+    // =========================================================================
+
+    int node_condition(Node* node) const {
+        Node* nl = node->left.load();
+        Node* nr = node->right.load();
+        if ((!nl || !nr) && node->value.load() == nullptr) return UNLINK_REQUIRED;
+
+        int hn = node->height.load(std::memory_order_relaxed);
+        int hl0 = height(nl);
+        int hr0 = height(nr);
+        int hn_repl = 1 + std::max(hl0, hr0);
+        int bal = hl0 - hr0;
+
+        if (bal < -1 || bal > 1) return REBALANCE_REQUIRED;
+        return hn != hn_repl ? hn_repl : NOTHING_REQUIRED;
+    }
+
+    // Requiere lock de node. Devuelve el próximo nodo dañado (o nullptr)
+    Node* fix_height_nl(Node* node) {
+        int c = node_condition(node);
+        switch (c) {
+            case REBALANCE_REQUIRED:
+            case UNLINK_REQUIRED:
+                return node;  // necesita el lock del padre
+            case NOTHING_REQUIRED:
+                return nullptr;
+            default:
+                node->height.store(c, std::memory_order_relaxed);
+                return node->parent.load();
+        }
+    }
+
+    void fix_height_and_rebalance(Node* node) {
+        while (node && node->parent.load()) {
+            int c = node_condition(node);
+            if (node->version.load() == UNLINKED) return;
+            if (c == NOTHING_REQUIRED) {
+                // Confirmar bajo el lock: una rotación en curso sobre node pudo
+                // haber leído alturas de hijos que otro thread está cambiando
+                NodeGuard g(node->lock);
+                c = node_condition(node);
+                if (c == NOTHING_REQUIRED) return;
+                continue;
+            }
+
+            if (c != UNLINK_REQUIRED && c != REBALANCE_REQUIRED) {
+                NodeGuard g(node->lock);
+                node = fix_height_nl(node);
+            } else {
+                Node* n_parent = node->parent.load();
+                NodeGuard gp(n_parent->lock);
+                if (n_parent->version.load() != UNLINKED && node->parent.load() == n_parent) {
+                    NodeGuard gn(node->lock);
+                    node = rebalance_nl(n_parent, node);
+                }
+            }
+        }
+    }
+
+    // Requiere locks de n_parent y n
+    Node* rebalance_nl(Node* n_parent, Node* n) {
+        Node* nl = n->left.load();
+        Node* nr = n->right.load();
+
+        if ((!nl || !nr) && n->value.load() == nullptr) {
+            if (attempt_unlink_nl(n_parent, n)) {
+                return fix_height_nl(n_parent);
+            }
+            return n;
+        }
+
+        int hn = n->height.load(std::memory_order_relaxed);
+        int hl0 = height(nl);
+        int hr0 = height(nr);
+        int hn_repl = 1 + std::max(hl0, hr0);
+        int bal = hl0 - hr0;
+
+        if (bal > 1) return rebalance_to_right_nl(n_parent, n, nl, hr0);
+        if (bal < -1) return rebalance_to_left_nl(n_parent, n, nr, hl0);
+        if (hn_repl != hn) {
+            n->height.store(hn_repl, std::memory_order_relaxed);
+            return fix_height_nl(n_parent);
+        }
+        return nullptr;
+    }
+
+    Node* rebalance_to_right_nl(Node* n_parent, Node* n, Node* nl, int hr0) {
+        NodeGuard gl(nl->lock);
+        int hl = nl->height.load(std::memory_order_relaxed);
+        if (hl - hr0 <= 1) return n;  // cambió, reintentar
+
+        Node* nlr = nl->right.load();
+        int hll0 = height(nl->left.load());
+        int hlr0 = height(nlr);
+        if (hll0 >= hlr0) {
+            SubtreeGuard gm = lock_subtree(nlr);
+            return rotate_right_nl(n_parent, n, nl, hr0, hll0, nlr, height(nlr));
+        }
+
+        {
+            NodeGuard glr(nlr->lock);
+            int hlr = nlr->height.load(std::memory_order_relaxed);
+            if (hll0 >= hlr) {
+                return rotate_right_nl(n_parent, n, nl, hr0, hll0, nlr, hlr);
+            }
+            int hlrl = height(nlr->left.load());
+            int b = hll0 - hlrl;
+            if (b >= -1 && b <= 1 && !((hll0 == 0 || hlrl == 0) && nl->value.load() == nullptr)) {
+                return rotate_right_over_left_nl(n_parent, n, nl, hr0, hll0, nlr, hlrl);
+            }
+
+            // Rotación doble no aplicable: primero rotar nl a la izquierda.
+            // Incondicional: si se declinara, n quedaría desbalanceado sin
+            // ningún thread a cargo de corregirlo
+            Node* nlrl = nlr->left.load();
+            SubtreeGuard gm = lock_subtree(nlrl);
+            return rotate_left_nl(n, nl, hll0, nlr, nlrl, height(nlrl), height(nlr->right.load()));
+        }
+    }
+
+    Node* rebalance_to_left_nl(Node* n_parent, Node* n, Node* nr, int hl0) {
+        NodeGuard gr(nr->lock);
+        int hr = nr->height.load(std::memory_order_relaxed);
+        if (hl0 - hr >= -1) return n;
+
+        Node* nrl = nr->left.load();
+        int hrl0 = height(nrl);
+        int hrr0 = height(nr->right.load());
+        if (hrr0 >= hrl0) {
+            SubtreeGuard gm = lock_subtree(nrl);
+            return rotate_left_nl(n_parent, n, hl0, nr, nrl, height(nrl), hrr0);
+        }
+
+        {
+            NodeGuard grl(nrl->lock);
+            int hrl = nrl->height.load(std::memory_order_relaxed);
+            if (hrr0 >= hrl) {
+                return rotate_left_nl(n_parent, n, hl0, nr, nrl, hrl, hrr0);
+            }
+            int hrlr = height(nrl->right.load());
+            int b = hrr0 - hrlr;
+            if (b >= -1 && b <= 1 && !((hrr0 == 0 || hrlr == 0) && nr->value.load() == nullptr)) {
+                return rotate_left_over_right_nl(n_parent, n, hl0, nr, nrl, hrr0, hrlr);
+            }
+
+            Node* nrlr = nrl->right.load();
+            SubtreeGuard gm = lock_subtree(nrlr);
+            return rotate_right_nl(n, nr, nrl, hrr0, height(nrl->left.load()), nrlr, height(nrlr));
+        }
+    }
+
+    // Los subárboles que cambian de padre en una rotación se bloquean: si no,
+    // un thread que actualiza su altura subiría al padre viejo y el nuevo
+    // padre quedaría con una altura calculada sobre un valor obsoleto
+    static SubtreeGuard lock_subtree(Node* n) {
+        return n ? SubtreeGuard(n->lock) : SubtreeGuard();
+    }
+
+    void replace_child(Node* n_parent, Node* old_child, Node* new_child) {
+        if (n_parent->left.load() == old_child) n_parent->left.store(new_child);
+        else n_parent->right.store(new_child);
+        new_child->parent.store(n_parent);
+    }
+
+    Node* rotate_right_nl(Node* n_parent, Node* n, Node* nl, int hr, int hll, Node* nlr, int hlr) {
+        uint64_t node_ovl = n->version.load();
+        n->version.store(begin_shrink(node_ovl));
+
+        n->left.store(nlr);
+        if (nlr) nlr->parent.store(n);
+        nl->right.store(n);
+        n->parent.store(nl);
+        replace_child(n_parent, n, nl);
+
+        int hn_repl = 1 + std::max(hlr, hr);
+        n->height.store(hn_repl, std::memory_order_relaxed);
+        nl->height.store(1 + std::max(hll, hn_repl), std::memory_order_relaxed);
+
+        n->version.store(end_shrink(node_ovl));
+
+        int bal_n = hlr - hr;
+        if (bal_n < -1 || bal_n > 1) return n;
+        if ((!nlr || hr == 0) && n->value.load() == nullptr) return n;
+        int bal_l = hll - hn_repl;
+        if (bal_l < -1 || bal_l > 1) return nl;
+        if (hll == 0 && nl->value.load() == nullptr) return nl;
+        return fix_height_nl(n_parent);
+    }
+
+    Node* rotate_left_nl(Node* n_parent, Node* n, int hl, Node* nr, Node* nrl, int hrl, int hrr) {
+        uint64_t node_ovl = n->version.load();
+        n->version.store(begin_shrink(node_ovl));
+
+        n->right.store(nrl);
+        if (nrl) nrl->parent.store(n);
+        nr->left.store(n);
+        n->parent.store(nr);
+        replace_child(n_parent, n, nr);
+
+        int hn_repl = 1 + std::max(hl, hrl);
+        n->height.store(hn_repl, std::memory_order_relaxed);
+        nr->height.store(1 + std::max(hn_repl, hrr), std::memory_order_relaxed);
+
+        n->version.store(end_shrink(node_ovl));
+
+        int bal_n = hrl - hl;
+        if (bal_n < -1 || bal_n > 1) return n;
+        if ((!nrl || hl == 0) && n->value.load() == nullptr) return n;
+        int bal_r = hrr - hn_repl;
+        if (bal_r < -1 || bal_r > 1) return nr;
+        if (hrr == 0 && nr->value.load() == nullptr) return nr;
+        return fix_height_nl(n_parent);
+    }
+
+    Node* rotate_right_over_left_nl(Node* n_parent, Node* n, Node* nl, int hr, int hll,
+                                    Node* nlr, int hlrl) {
+        uint64_t node_ovl = n->version.load();
+        uint64_t left_ovl = nl->version.load();
+        Node* nlrl = nlr->left.load();
+        Node* nlrr = nlr->right.load();
+        SubtreeGuard gml = lock_subtree(nlrl);
+        SubtreeGuard gmr = lock_subtree(nlrr);
+        hlrl = height(nlrl);
+        int hlrr = height(nlrr);
+
+        n->version.store(begin_shrink(node_ovl));
+        nl->version.store(begin_shrink(left_ovl));
+
+        n->left.store(nlrr);
+        if (nlrr) nlrr->parent.store(n);
+        nl->right.store(nlrl);
+        if (nlrl) nlrl->parent.store(nl);
+        nlr->left.store(nl);
+        nl->parent.store(nlr);
+        nlr->right.store(n);
+        n->parent.store(nlr);
+        replace_child(n_parent, n, nlr);
+
+        int hn_repl = 1 + std::max(hlrr, hr);
+        n->height.store(hn_repl, std::memory_order_relaxed);
+        int hl_repl = 1 + std::max(hll, hlrl);
+        nl->height.store(hl_repl, std::memory_order_relaxed);
+        nlr->height.store(1 + std::max(hl_repl, hn_repl), std::memory_order_relaxed);
+
+        n->version.store(end_shrink(node_ovl));
+        nl->version.store(end_shrink(left_ovl));
+
+        int bal_n = hlrr - hr;
+        if (bal_n < -1 || bal_n > 1) return n;
+        if ((!nlrr || hr == 0) && n->value.load() == nullptr) return n;
+        int bal_lr = hl_repl - hn_repl;
+        if (bal_lr < -1 || bal_lr > 1) return nlr;
+        return fix_height_nl(n_parent);
+    }
+
+    Node* rotate_left_over_right_nl(Node* n_parent, Node* n, int hl, Node* nr, Node* nrl,
+                                    int hrr, int hrlr) {
+        uint64_t node_ovl = n->version.load();
+        uint64_t right_ovl = nr->version.load();
+        Node* nrll = nrl->left.load();
+        Node* nrlr = nrl->right.load();
+        SubtreeGuard gml = lock_subtree(nrll);
+        SubtreeGuard gmr = lock_subtree(nrlr);
+        int hrll = height(nrll);
+        hrlr = height(nrlr);
+
+        n->version.store(begin_shrink(node_ovl));
+        nr->version.store(begin_shrink(right_ovl));
+
+        n->right.store(nrll);
+        if (nrll) nrll->parent.store(n);
+        nr->left.store(nrlr);
+        if (nrlr) nrlr->parent.store(nr);
+        nrl->right.store(nr);
+        nr->parent.store(nrl);
+        nrl->left.store(n);
+        n->parent.store(nrl);
+        replace_child(n_parent, n, nrl);
+
+        int hn_repl = 1 + std::max(hl, hrll);
+        n->height.store(hn_repl, std::memory_order_relaxed);
+        int hr_repl = 1 + std::max(hrlr, hrr);
+        nr->height.store(hr_repl, std::memory_order_relaxed);
+        nrl->height.store(1 + std::max(hn_repl, hr_repl), std::memory_order_relaxed);
+
+        n->version.store(end_shrink(node_ovl));
+        nr->version.store(end_shrink(right_ovl));
+
+        int bal_n = hrll - hl;
+        if (bal_n < -1 || bal_n > 1) return n;
+        if ((!nrll || hl == 0) && n->value.load() == nullptr) return n;
+        int bal_rl = hr_repl - hn_repl;
+        if (bal_rl < -1 || bal_rl > 1) return nrl;
+        return fix_height_nl(n_parent);
+    }
+
+    // =========================================================================
+    // Recorrido en orden con validación
+    // =========================================================================
+    //
+    // Cada nivel valida su versión antes de leer hijos o emitir. Si un nivel
+    // inferior detecta una rotación, se reintenta desde el nivel actual y
+    // `last` (última key emitida) evita duplicados: las keys presentes durante
+    // todo el recorrido se emiten exactamente una vez, en orden.
+
+    struct ScanBounds {
+        const Key* lo;
+        const Key* hi;
+        std::optional<Key> last;
+    };
+
+    template<typename F>
+    Status scan_child(Node* node, int dir, uint64_t node_v, ScanBounds& b, F& emit) const {
+        while (true) {
+            Node* child = node->child(dir);
+            if (node->version.load() != node_v) return Status::RETRY;
+            if (!child) return Status::DONE;
+
+            uint64_t ch_v = child->version.load();
+            if (ch_v & SHRINKING) {
+                wait_until_not_changing(child);
+                continue;
+            }
+            if (ch_v == UNLINKED || child != node->child(dir)) continue;
+            if (node->version.load() != node_v) return Status::RETRY;
+
+            Status s = scan_node(child, ch_v, b, emit);
+            if (s != Status::RETRY) return s;
+        }
+    }
+
+    template<typename F>
+    Status scan_node(Node* n, uint64_t n_v, ScanBounds& b, F& emit) const {
+        const Key& key = n->key;
+
+        bool need_left = (!b.lo || *b.lo < key) && (!b.last || *b.last < key);
+        if (need_left) {
+            Status s;
+            while ((s = scan_child(n, -1, n_v, b, emit)) == Status::RETRY) {
+                if (n->version.load() != n_v) return Status::RETRY;
+            }
+            if (s == Status::STOP) return s;
+        }
+
+        if (n->version.load() != n_v) return Status::RETRY;
+
+        bool in_range = (!b.lo || !(key < *b.lo)) && (!b.hi || !(*b.hi < key));
+        if (in_range && (!b.last || *b.last < key)) {
+            Value* v = n->value.load(std::memory_order_acquire);
+            if (v) {
+                b.last = key;
+                if (!emit(key, *v)) return Status::STOP;
+            }
+        }
+
+        if (b.hi && !(key < *b.hi)) return Status::DONE;
+
+        Status s;
+        while ((s = scan_child(n, 1, n_v, b, emit)) == Status::RETRY) {
+            if (n->version.load() != n_v) return Status::RETRY;
+        }
+        return s;
+    }
+
+    template<typename F>
+    void scan(const Key* lo, const Key* hi, F emit) const {
+        EpochReclaimer::Guard guard;
+        ScanBounds b{lo, hi, std::nullopt};
+        while (scan_child(&root_holder_, 1, 0, b, emit) == Status::RETRY) {}
+    }
+
+    static void destroy_subtree(Node* root, bool deferred) {
+        std::vector<Node*> stack;
+        if (root) stack.push_back(root);
+        while (!stack.empty()) {
+            Node* n = stack.back();
+            stack.pop_back();
+            if (Node* l = n->left.load(std::memory_order_relaxed)) stack.push_back(l);
+            if (Node* r = n->right.load(std::memory_order_relaxed)) stack.push_back(r);
+            if (deferred) EpochReclaimer::retire(n);
+            else delete n;
+        }
+    }
+
+public:
+    ConcurrentAVLShard() = default;
+
+    ~ConcurrentAVLShard() {
+        destroy_subtree(root_holder_.right.load(), false);
+    }
+
+    ConcurrentAVLShard(const ConcurrentAVLShard&) = delete;
+    ConcurrentAVLShard& operator=(const ConcurrentAVLShard&) = delete;
+
+    // Operaciones básicas (sin lock global)
+
+    void insert(const Key& key, const Value& value) {
+        EpochReclaimer::Guard guard;
+        Value* nv = new Value(value);
+        Status s = attempt_put(key, nv, &root_holder_, 1, 0);
+
+        if (s == Status::INSERTED) {
+            size_.fetch_add(1, std::memory_order_relaxed);
+            update_bounds(key);
+        }
+        insert_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool remove(const Key& key) {
+        EpochReclaimer::Guard guard;
+        if (attempt_remove(key, &root_holder_, 1, 0) == Status::REMOVED) {
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            remove_count_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    bool contains(const Key& key) const {
+        EpochReclaimer::Guard guard;
+        return attempt_get(key, &root_holder_, 1, 0, nullptr) == Status::FOUND;
+    }
+
+    std::optional<Value> get(const Key& key) const {
+        EpochReclaimer::Guard guard;
+        std::optional<Value> out;
+        attempt_get(key, &root_holder_, 1, 0, &out);
+        return out;
+    }
+
+    // Lock-free reads de estadísticas
+    size_t size() const {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    size_t insert_count() const {
+        return insert_count_.load(std::memory_order_relaxed);
+    }
+
+    size_t remove_count() const {
+        return remove_count_.load(std::memory_order_relaxed);
+    }
+
+    size_t lookup_count() const {
+        return lookup_count_.load(std::memory_order_relaxed);
+    }
+
+    bool intersects_range(const Key& lo, const Key& hi) const {
+        if (!has_keys_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        Key shard_min = min_key_.load(std::memory_order_relaxed);
+        Key shard_max = max_key_.load(std::memory_order_relaxed);
+        return !(shard_max < lo || shard_min > hi);
+    }
+
+    // Range query concurrente con escritores: resultado ordenado y sin
+    // duplicados; las keys insertadas/removidas durante el scan pueden o no verse
+    template<typename OutputIt>
+    void range_query(const Key& lo, const Key& hi, OutputIt out) const {
+        scan(&lo, &hi, [&out](const Key& k, const Value& v) {
+            *out++ = std::make_pair(k, v);
+            return true;
+        });
+    }
+
+    struct Stats {
+        size_t size;
+        size_t inserts;
+        size_t removes;
+        size_t lookups;
+        std::optional<Key> min_key;
+        std::optional<Key> max_key;
+    };
+
+    Stats get_stats() const {
+        Stats stats;
+        stats.size = size_.load(std::memory_order_relaxed);
+        stats.inserts = insert_count_.load(std::memory_order_relaxed);
+        stats.removes = remove_count_.load(std::memory_order_relaxed);
+        stats.lookups = lookup_count_.load(std::memory_order_relaxed);
+
+        if (has_keys_.load(std::memory_order_acquire)) {
+            stats.min_key = min_key_.load(std::memory_order_relaxed);
+            stats.max_key = max_key_.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    // Clear: los lectores concurrentes son seguros (EBR), pero no debe haber
+    // escritores concurrentes (mismo contrato que ParallelAVL::force_rebalance)
+    void clear() {
+        EpochReclaimer::Guard guard;
+        Node* old_root;
+        {
+            NodeGuard g(root_holder_.lock);
+            old_root = root_holder_.right.exchange(nullptr);
+        }
+        destroy_subtree(old_root, true);
+
+        size_.store(0, std::memory_order_relaxed);
+        insert_count_.store(0, std::memory_order_relaxed);
+        remove_count_.store(0, std::memory_order_relaxed);
+        lookup_count_.store(0, std::memory_order_relaxed);
+        min_key_.store(std::numeric_limits<Key>::max(), std::memory_order_relaxed);
+        max_key_.store(std::numeric_limits<Key>::min(), std::memory_order_relaxed);
+        has_keys_.store(false, std::memory_order_release);
+    }
+
+    template<typename OutputIt>
+    void extract_all(OutputIt out) const {
+        scan(nullptr, nullptr, [&out](const Key& k, const Value& v) {
+            *out++ = std::make_pair(k, v);
+            return true;
+        });
+    }
+
+    // Validación de invariantes (sólo en quiescencia, para tests):
+    // orden BST, punteros parent consistentes y balance AVL (|bf| <= 1
+    // una vez que el rebalanceo relajado terminó)
+    bool validate() const {
+        std::optional<Key> prev;
+        std::vector<Node*> inorder;
+
+        // In-order iterativo
+        Node* cur = root_holder_.right.load();
+        std::vector<Node*> path;
+        while (cur || !path.empty()) {
+            while (cur) {
+                path.push_back(cur);
+                cur = cur->left.load();
+            }
+            cur = path.back();
+            path.pop_back();
+            if (prev && !(*prev < cur->key)) return false;
+            prev = cur->key;
+            inorder.push_back(cur);
+            cur = cur->right.load();
+        }
+
+        for (Node* n : inorder) {
+            Node* l = n->left.load();
+            Node* r = n->right.load();
+            if (l && l->parent.load() != n) return false;
+            if (r && r->parent.load() != n) return false;
+            int hl = height(l), hr = height(r);
+            if (n->height.load() != 1 + std::max(hl, hr)) return false;
+            if (hl - hr > 1 || hr - hl > 1) return false;
+        }
+        return true;
+    }
+};
+
+#endif // CONCURRENT_AVL_SHARD_HPP
@@ -0,0 +1,156 @@
+#ifndef DEFERRED_DESTROYER_HPP
+#define DEFERRED_DESTROYER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// =============================================================================
+// DeferredDestroyer - Destrucción en background de estructuras desenganchadas
+// =============================================================================
+//
+// Destruir un árbol de millones de nodos (clear, remove_shard,
+// force_rebalance, destructores) cuesta millones de destructores y frees. Si
+// eso corre con el lock del shard tomado, el shard queda bloqueado todo ese
+// tiempo. El patrón es: desenganchar el árbol bajo el lock (O(1), un move) y
+// entregarlo acá; un único thread de background lo destruye fuera del camino
+// crítico.
+//
+// Uso:
+//   auto old = std::make_unique<Tree>();
+//   { std::lock_guard lock(mutex_); *old = std::move(tree_); }
+//   DeferredDestroyer::dispose(std::move(old));
+//
+// El thread arranca con el primer dispose(). Al terminar el proceso se
+// destruye lo pendiente y se hace join; un dispose() posterior (p.ej. desde
+// destructores de objetos estáticos) destruye en el thread que llama. Si no
+// se puede crear el thread, también se destruye en línea.
+// =============================================================================
+
+class DeferredDestroyer {
+private:
+    struct Item {
+        virtual ~Item() = default;
+    };
+
+    template<typename T>
+    struct Holder : Item {
+        std::unique_ptr<T> object;
+        explicit Holder(std::unique_ptr<T> obj) : object(std::move(obj)) {}
+    };
+
+    enum State : int { NOT_STARTED = 0, RUNNING = 1, SHUT_DOWN = 2 };
+
+    // Inicialización constante: válido aun durante la destrucción estática
+    static inline std::atomic<int> state_{NOT_STARTED};
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable idle_cv_;
+    std::deque<std::unique_ptr<Item>> queue_;
+    bool busy_ = false;
+    bool stop_ = false;
+    std::atomic<size_t> destroyed_{0};
+    std::thread worker_;
+
+    DeferredDestroyer() {
+        try {
+            worker_ = std::thread([this] { run(); });
+            state_.store(RUNNING, std::memory_order_release);
+        } catch (...) {
+            state_.store(SHUT_DOWN, std::memory_order_release);
+        }
+    }
+
+    ~DeferredDestroyer() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        work_cv_.notify_one();
+        if (worker_.joinable()) worker_.join();
+        state_.store(SHUT_DOWN, std::memory_order_release);
+    }
+
+    static DeferredDestroyer& instance() {
+        static DeferredDestroyer destroyer;
+        return destroyer;
+    }
+
+    void run() {
+        std::unique_lock lock(mutex_);
+        for (;;) {
+            work_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) break;  // stop_ y nada pendiente
+
+            std::unique_ptr<Item> item = std::move(queue_.front());
+            queue_.pop_front();
+            busy_ = true;
+            lock.unlock();
+            item.reset();  // la destrucción real, sin lock
+            destroyed_.fetch_add(1, std::memory_order_relaxed);
+            lock.lock();
+            busy_ = false;
+            if (queue_.empty()) idle_cv_.notify_all();
+        }
+        idle_cv_.notify_all();
+    }
+
+    void enqueue(std::unique_ptr<Item> item) {
+        {
+            std::lock_guard lock(mutex_);
+            if (!stop_) {
+                queue_.push_back(std::move(item));
+            }
+        }
+        if (item) {
+            item.reset();  // ya cerrando: destruir en línea
+        } else {
+            work_cv_.notify_one();
+        }
+    }
+
+public:
+    DeferredDestroyer(const DeferredDestroyer&) = delete;
+    DeferredDestroyer& operator=(const DeferredDestroyer&) = delete;
+
+    // Tomar ownership de obj y destruirlo en background
+    template<typename T>
+    static void dispose(std::unique_ptr<T> obj) {
+        if (!obj) return;
+        if (state_.load(std::memory_order_acquire) == SHUT_DOWN) {
+            obj.reset();
+            return;
+        }
+        DeferredDestroyer& self = instance();
+        if (state_.load(std::memory_order_acquire) != RUNNING) {
+            obj.reset();
+            return;
+        }
+        self.enqueue(std::make_unique<Holder<T>>(std::move(obj)));
+    }
+
+    // Esperar a que todo lo entregado hasta ahora esté destruido (tests,
+    // benchmarks, o antes de medir memoria)
+    static void drain() {
+        if (state_.load(std::memory_order_acquire) != RUNNING) return;
+        DeferredDestroyer& self = instance();
+        std::unique_lock lock(self.mutex_);
+        self.idle_cv_.wait(lock, [&self] {
+            return (self.queue_.empty() && !self.busy_) || self.stop_;
+        });
+    }
+
+    // Objetos ya destruidos por el thread de background
+    static size_t destroyed_count() {
+        if (state_.load(std::memory_order_acquire) != RUNNING) return 0;
+        return instance().destroyed_.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // DEFERRED_DESTROYER_HPP
@@ -0,0 +1,217 @@
+#ifndef EPOCH_RECLAIMER_HPP
+#define EPOCH_RECLAIMER_HPP
+
+#include <atomic>
+#include <array>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <stdexcept>
+
+// =============================================================================
+// EpochReclaimer - Reclamación de memoria basada en épocas (EBR)
+// =============================================================================
+//
+// Las estructuras concurrentes sin lock global (ConcurrentAVLShard, skip list)
+// desenlazan nodos mientras otros threads todavía pueden estar leyéndolos.
+// No se puede hacer delete inmediato: el nodo se "retira" y se libera cuando
+// ningún thread que pudiera tener un puntero a él sigue activo.
+//
+// Protocolo:
+//   1. Toda operación que lee nodos compartidos corre dentro de un Guard,
+//      que publica la época global vista al entrar.
+//   2. retire(ptr) anota el objeto con la época actual.
+//   3. La época global avanza sólo cuando todos los threads activos ya
+//      observaron la época vigente. Un objeto retirado en la época E es
+//      seguro de liberar cuando la global llega a E + 2.
+//
+// Uso:
+//   {
+//       EpochReclaimer::Guard guard;        // entrar a la sección crítica
+//       ... leer / desenlazar nodos ...
+//       EpochReclaimer::retire(node);       // liberar más tarde
+//   }
+//
+// Dominio único por proceso: las listas de retirados son por thread, así que
+// retire() no toma locks en el caso común.
+// =============================================================================
+
+class EpochReclaimer {
+public:
+    static constexpr size_t MAX_THREADS = 1024;
+    static constexpr size_t RETIRE_THRESHOLD = 128;
+
+private:
+    static constexpr uint64_t QUIESCENT = ~uint64_t{0};
+
+    struct Retired {
+        void* ptr;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+
+    // Un slot por thread registrado, en su propia línea de cache
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{QUIESCENT};
+        std::atomic<bool> in_use{false};
+    };
+
+    std::atomic<uint64_t> global_epoch_{1};
+    std::array<Slot, MAX_THREADS> slots_;
+
+    // Retirados de threads que terminaron antes de poder liberarlos
+    std::mutex orphans_mutex_;
+    std::vector<Retired> orphans_;
+
+    struct ThreadState {
+        EpochReclaimer& domain;
+        Slot* slot;
+        unsigned nesting = 0;
+        std::vector<Retired> retired;
+
+        explicit ThreadState(EpochReclaimer& d) : domain(d), slot(d.acquire_slot()) {}
+
+        ~ThreadState() {
+            domain.collect(retired);
+            if (!retired.empty()) {
+                std::lock_guard lock(domain.orphans_mutex_);
+                domain.orphans_.insert(domain.orphans_.end(), retired.begin(), retired.end());
+            }
+            slot->epoch.store(QUIESCENT, std::memory_order_release);
+            slot->in_use.store(false, std::memory_order_release);
+        }
+    };
+
+    EpochReclaimer() = default;
+
+    ~EpochReclaimer() {
+        // Fin del proceso: ya no quedan lectores
+        for (const auto& r : orphans_) {
+            r.deleter(r.ptr);
+        }
+    }
+
+    static EpochReclaimer& instance() {
+        static EpochReclaimer domain;
+        return domain;
+    }
+
+    static ThreadState& local() {
+        static thread_local ThreadState state(instance());
+        return state;
+    }
+
+    Slot* acquire_slot() {
+        for (auto& slot : slots_) {
+            bool expected = false;
+            if (!slot.in_use.load(std::memory_order_relaxed) &&
+                slot.in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                return &slot;
+            }
+        }
+        throw std::runtime_error("EpochReclaimer: too many threads");
+    }
+
+    // Avanzar la época si todos los threads activos ya vieron la actual
+    bool try_advance() {
+        uint64_t current = global_epoch_.load(std::memory_order_acquire);
+        for (const auto& slot : slots_) {
+            if (!slot.in_use.load(std::memory_order_acquire)) continue;
+            uint64_t e = slot.epoch.load(std::memory_order_acquire);
+            if (e != QUIESCENT && e != current) {
+                return false;
+            }
+        }
+        return global_epoch_.compare_exchange_strong(current, current + 1,
+                                                     std::memory_order_acq_rel);
+    }
+
+    // Liberar todo lo retirado hace al menos dos épocas
+    void collect(std::vector<Retired>& list) {
+        try_advance();
+        uint64_t safe = global_epoch_.load(std::memory_order_acquire);
+
+        size_t kept = 0;
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (list[i].epoch + 2 <= safe) {
+                list[i].deleter(list[i].ptr);
+            } else {
+                list[kept++] = list[i];
+            }
+        }
+        list.resize(kept);
+
+        // Adoptar huérfanos sin bloquear el hot path
+        std::unique_lock lock(orphans_mutex_, std::try_to_lock);
+        if (lock.owns_lock() && !orphans_.empty()) {
+            size_t keep_orphans = 0;
+            for (size_t i = 0; i < orphans_.size(); ++i) {
+                if (orphans_[i].epoch + 2 <= safe) {
+                    orphans_[i].deleter(orphans_[i].ptr);
+                } else {
+                    orphans_[keep_orphans++] = orphans_[i];
+                }
+            }
+            orphans_.resize(keep_orphans);
+        }
+    }
+
+public:
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    // RAII: sección crítica de lectura. Reentrante.
+    class Guard {
+        ThreadState& state_;
+
+    public:
+        Guard() : state_(local()) {
+            if (state_.nesting++ == 0) {
+                uint64_t e = state_.domain.global_epoch_.load(std::memory_order_acquire);
+                // seq_cst: la publicación debe ser visible antes de leer nodos
+                state_.slot->epoch.store(e, std::memory_order_seq_cst);
+            }
+        }
+
+        ~Guard() {
+            if (--state_.nesting == 0) {
+                state_.slot->epoch.store(QUIESCENT, std::memory_order_release);
+            }
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    // Retirar un objeto ya desenlazado (debe llamarse dentro de un Guard)
+    template<typename T>
+    static void retire(T* ptr) {
+        if (!ptr) return;
+        retire(static_cast<void*>(ptr), [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    static void retire(void* ptr, void (*deleter)(void*)) {
+        ThreadState& state = local();
+        uint64_t e = state.domain.global_epoch_.load(std::memory_order_acquire);
+        state.retired.push_back(Retired{ptr, deleter, e});
+        if (state.retired.size() >= RETIRE_THRESHOLD) {
+            state.domain.collect(state.retired);
+        }
+    }
+
+    // Forzar un intento de reclamación (útil en tests y al cerrar)
+    static void quiesce() {
+        ThreadState& state = local();
+        if (state.nesting == 0) {
+            for (int i = 0; i < 3; ++i) {
+                state.domain.collect(state.retired);
+            }
+        }
+    }
+
+    static uint64_t current_epoch() {
+        return instance().global_epoch_.load(std::memory_order_acquire);
+    }
+};
+
+#endif // EPOCH_RECLAIMER_HPP
@@ -0,0 +1,189 @@
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// =============================================================================
+// LatencyHistogram - Histograma log-lineal estilo HDR para latencias
+// =============================================================================
+//
+// Memoria constante (~18 KB) y error relativo acotado, sin guardar muestras:
+//
+//   - Valores en ns. Cada potencia de dos [2^e, 2^(e+1)) se parte en
+//     2^SUB_BUCKET_BITS sub-buckets iguales: error relativo <= 1/64 (~1.6%)
+//     en todo el rango. Por debajo de 2^SUB_BUCKET_BITS ns el valor es exacto.
+//   - Rango hasta 2^MAX_EXPONENT ns (~18 min); lo que pase va al último bucket.
+//
+// Un histograma por thread: record() es de un solo escritor (load + store
+// relaxed, sin lock ni RMW), así medir no serializa a los threads medidos.
+// Otro thread puede leerlo mientras tanto (percentiles aproximados) y al
+// final se juntan con merge():
+//
+//   std::vector<LatencyHistogram> per_thread(T);
+//   ... per_thread[tid].record(ns) ...
+//   LatencyHistogram total;
+//   for (auto& h : per_thread) total.merge(h);
+//   total.percentile(0.9999);
+//
+// percentile() devuelve el mayor valor equivalente del bucket (como
+// HdrHistogram): nunca subestima la cola.
+// =============================================================================
+
+// alignas: histogramas por thread contiguos no comparten línea de caché
+class alignas(64) LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 6;
+    static constexpr unsigned MAX_EXPONENT = 40;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+    static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MAX_EXPONENT) - 1;
+
+    struct Summary {
+        uint64_t count;
+        uint64_t min;
+        double mean;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t p999;
+        uint64_t p9999;
+        uint64_t max;
+    };
+
+    LatencyHistogram() {
+        reset();
+    }
+
+    LatencyHistogram(const LatencyHistogram& other) : LatencyHistogram() {
+        merge(other);
+    }
+
+    LatencyHistogram& operator=(const LatencyHistogram& other) {
+        if (this != &other) {
+            reset();
+            merge(other);
+        }
+        return *this;
+    }
+
+    // Solo el thread dueño
+    void record(uint64_t ns) {
+        if (ns > MAX_VALUE) ns = MAX_VALUE;
+        bump(counts_[bucket_of(ns)], 1);
+        bump(count_, 1);
+        bump(sum_, ns);
+        if (ns < min_.load(std::memory_order_relaxed)) min_.store(ns, std::memory_order_relaxed);
+        if (ns > max_.load(std::memory_order_relaxed)) max_.store(ns, std::memory_order_relaxed);
+    }
+
+    template<typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> elapsed) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+    }
+
+    // Suma other a este histograma. La llama el dueño de this (o con su
+    // escritor parado); other puede seguir registrando (foto aproximada)
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            uint64_t c = other.counts_[i].load(std::memory_order_relaxed);
+            if (c) bump(counts_[i], c);
+        }
+        bump(count_, other.count_.load(std::memory_order_relaxed));
+        bump(sum_, other.sum_.load(std::memory_order_relaxed));
+        uint64_t omin = other.min_.load(std::memory_order_relaxed);
+        uint64_t omax = other.max_.load(std::memory_order_relaxed);
+        if (omin < min_.load(std::memory_order_relaxed)) min_.store(omin, std::memory_order_relaxed);
+        if (omax > max_.load(std::memory_order_relaxed)) max_.store(omax, std::memory_order_relaxed);
+    }
+
+    void reset() {
+        for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+    uint64_t min() const {
+        return count() ? min_.load(std::memory_order_relaxed) : 0;
+    }
+
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    double mean() const {
+        uint64_t n = count();
+        return n ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / n : 0.0;
+    }
+
+    // Percentil q en [0, 1], nearest-rank; acotado por el máximo registrado
+    uint64_t percentile(double q) const {
+        uint64_t total = 0;
+        for (const auto& c : counts_) total += c.load(std::memory_order_relaxed);
+        if (total == 0) return 0;
+
+        uint64_t rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total)));
+        if (rank == 0) rank = 1;
+        if (rank > total) rank = total;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                uint64_t high = highest_equivalent(i);
+                uint64_t top = max();
+                return high < top ? high : top;
+            }
+        }
+        return max();
+    }
+
+    Summary summary() const {
+        return {count(), min(), mean(),
+                percentile(0.50), percentile(0.90), percentile(0.99),
+                percentile(0.999), percentile(0.9999), max()};
+    }
+
+    // Índice del bucket de un valor (ns <= MAX_VALUE)
+    static size_t bucket_of(uint64_t ns) {
+        if (ns < SUB_BUCKETS) return static_cast<size_t>(ns);
+        unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(ns));
+        unsigned shift = exponent - SUB_BUCKET_BITS;
+        return (shift + 1) * SUB_BUCKETS + static_cast<size_t>((ns >> shift) - SUB_BUCKETS);
+    }
+
+    // Rango [lowest, highest] de valores que caen en el bucket i
+    static uint64_t lowest_equivalent(size_t i) {
+        if (i < SUB_BUCKETS) return i;
+        unsigned shift = static_cast<unsigned>(i / SUB_BUCKETS - 1);
+        return (SUB_BUCKETS + i % SUB_BUCKETS) << shift;
+    }
+
+    static uint64_t highest_equivalent(size_t i) {
+        if (i < SUB_BUCKETS) return i;
+        unsigned shift = static_cast<unsigned>(i / SUB_BUCKETS - 1);
+        return lowest_equivalent(i) + (uint64_t(1) << shift) - 1;
+    }
+
+private:
+    // Un solo escritor: load + store en vez de fetch_add (sin lock prefix)
+    static void bump(std::atomic<uint64_t>& counter, uint64_t delta) {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKETS> counts_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
+
+#endif // LATENCY_HISTOGRAM_HPP
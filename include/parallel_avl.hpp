@@ -23,11 +23,34 @@
 //   tree.contains(42);  // true
 //   tree.add_shard();   // Escalar a 9 shards
 //
+// Implementación de shard (tercer parámetro, default TreeShard):
+//   ParallelAVL<int, int, ConcurrentAVLShard<int, int>> tree(8);
+//   Cualquier tipo con la interfaz de TreeShard sirve (insert, remove,
+//   contains, get, size, intersects_range, range_query, get_stats, clear,
+//   extract_all). get_batch es opcional: si falta, get_batch() del árbol
+//   hace un get() por key.
+//
+// Cache acotado con TTL (CacheShard):
+//   ParallelAVL<int, Session, CacheShard<int, Session>> sessions(8);
+//   sessions.set_capacity(1'000'000);
+//   sessions.insert_with_ttl(id, s, std::chrono::minutes(30));
+//
+// Backpressure: con set_admission_limit(n) cada shard admite hasta n
+// operaciones a la vez; try_insert/try_get fallan en el acto y
+// insert_until/get_until al vencer el deadline, en vez de apilarse en el
+// mutex de un shard caliente. insert/get/remove/contains esperan su turno;
+// get_batch espera uno por shard tocado y lo usa para todo su grupo. Una
+// lectura o remove que sigue un redirect o la búsqueda exhaustiva pide
+// lugar también en cada shard que visita, de a uno (nunca con otro ticket
+// tomado: dos ops esperándose en cruz se trabarían con límite 1).
+//
 // =============================================================================
 
 #include "shard.hpp"
 #include "router.hpp"
 #include "redirect_index.hpp"
+#include "deferred_destroyer.hpp"
+#include "admission_control.hpp"
 #include <vector>
 #include <memory>
 #include <optional>
@@ -35,15 +58,80 @@
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <type_traits>
+#include <chrono>
+
+// El shard ofrece get_batch?
+template<typename S, typename Key, typename Value, typename = void>
+struct has_get_batch : std::false_type {};
+
+template<typename S, typename Key, typename Value>
+struct has_get_batch<S, Key, Value, std::void_t<decltype(std::declval<const S&>().get_batch(
+    std::declval<const Key*>(), size_t{}, std::declval<std::optional<Value>*>()))>> : std::true_type {};
+
+// El shard soporta desfragmentación online?
+template<typename S, typename = void>
+struct has_defragment : std::false_type {};
+
+template<typename S>
+struct has_defragment<S, std::void_t<decltype(std::declval<S&>().defragment())>> : std::true_type {};
+
+// El shard informa si el insert agregó una key y cuántas expulsó (CacheShard)?
+template<typename S, typename Key, typename Value, typename = void>
+struct has_insert_tracked : std::false_type {};
+
+template<typename S, typename Key, typename Value>
+struct has_insert_tracked<S, Key, Value, std::void_t<decltype(std::declval<S&>().insert_tracked(
+    std::declval<const Key&>(), std::declval<const Value&>()))>> : std::true_type {};
+
+// El shard acepta presupuesto de memoria/entradas?
+template<typename S, typename = void>
+struct has_set_budget : std::false_type {};
 
-template<typename Key, typename Value>
+template<typename S>
+struct has_set_budget<S, std::void_t<decltype(std::declval<S&>().set_budget(
+    std::declval<typename S::Budget>()))>> : std::true_type {};
+
+// El shard soporta vencimiento por entrada?
+template<typename S, typename = void>
+struct has_ttl : std::false_type {};
+
+template<typename S>
+struct has_ttl<S, std::void_t<typename S::ExpiringItem,
+                              decltype(std::declval<S&>().expire())>> : std::true_type {};
+
+// El shard tiene lock configurable y escrituras en lote (TreeShard)?
+template<typename S, typename = void>
+struct has_lock_mode : std::false_type {};
+
+template<typename S>
+struct has_lock_mode<S, std::void_t<decltype(std::declval<S&>().set_lock_mode(
+    ShardLockMode::EXCLUSIVE, size_t{})), decltype(std::declval<S&>().set_write_batching(true))>>
+    : std::true_type {};
+
+// El shard reporta la contención de su lock?
+template<typename S, typename = void>
+struct has_lock_stats : std::false_type {};
+
+template<typename S>
+struct has_lock_stats<S, std::void_t<decltype(std::declval<const S&>().lock_stats())>>
+    : std::true_type {};
+
+// Lo que se extrae de un shard para redistribuir: con TTL, también el vencimiento
+template<typename S, typename Key, typename Value, bool = has_ttl<S>::value>
+struct extracted_item { using type = std::pair<Key, Value>; };
+
+template<typename S, typename Key, typename Value>
+struct extracted_item<S, Key, Value, true> { using type = typename S::ExpiringItem; };
+
+template<typename Key, typename Value, typename ShardType = TreeShard<Key, Value>>
 class ParallelAVL {
     static_assert(std::is_default_constructible_v<Key>, "Key must be default constructible");
     static_assert(std::is_copy_constructible_v<Key>, "Key must be copy constructible");
 
 public:
     // Public type aliases
-    using Shard = TreeShard<Key, Value>;
+    using Shard = ShardType;
     using Router = AdversaryResistantRouter<Key>;
     using RouterStrategy = typename Router::Strategy;
 
@@ -72,6 +160,75 @@ private:
     std::atomic<bool> topology_changed_{false};  // Necesita búsqueda exhaustiva
     std::atomic<bool> has_redirects_{false};     // Fast-path: evitar redirect_index si vacío
 
+    // Admission control por shard (0 = desactivado: ni se toca el gate)
+    using Deadline = AdmissionGate::Clock::time_point;
+    std::vector<std::unique_ptr<AdmissionGate>> gates_;
+    std::atomic<size_t> admission_limit_{0};
+
+    // Esperar lugar en el shard (ops normales); ticket vacío si no hay límite
+    AdmissionTicket admit(size_t shard) const {
+        if (admission_limit_.load(std::memory_order_relaxed) == 0) return AdmissionTicket();
+        gates_[shard]->acquire();
+        return AdmissionTicket(gates_[shard].get());
+    }
+
+    // Cómo espera lugar una lectura: WAIT (get/contains), NONE (try_get) o
+    // hasta deadline (get_until)
+    struct AdmitPolicy {
+        enum Mode { WAIT, NONE, UNTIL } mode;
+        Deadline deadline{};
+    };
+
+    // Ticket según la política; nullopt si el shard no dio lugar a tiempo
+    std::optional<AdmissionTicket> admit(size_t shard, const AdmitPolicy& policy) const {
+        if (admission_limit_.load(std::memory_order_relaxed) == 0) return AdmissionTicket();
+        AdmissionGate* gate = gates_[shard].get();
+        switch (policy.mode) {
+            case AdmitPolicy::WAIT:
+                gate->acquire();
+                break;
+            case AdmitPolicy::NONE:
+                if (!gate->try_acquire()) return std::nullopt;
+                break;
+            case AdmitPolicy::UNTIL:
+                if (!gate->acquire_until(policy.deadline)) return std::nullopt;
+                break;
+        }
+        return AdmissionTicket(gate);
+    }
+
+    void add_gate() {
+        gates_.push_back(std::make_unique<AdmissionGate>());
+        gates_.back()->set_limit(admission_limit_.load(std::memory_order_relaxed));
+    }
+
+    // Modo de lock y batching de escrituras, también para shards nuevos
+    ShardLockMode lock_mode_ = ShardLockMode::EXCLUSIVE;
+    size_t reads_per_write_ = ShardLock::DEFAULT_READS_PER_WRITE;
+    bool write_batching_ = false;
+
+    void configure_shard(Shard& shard) {
+        if constexpr (has_lock_mode<Shard>::value) {
+            shard.set_lock_mode(lock_mode_, reads_per_write_);
+            shard.set_write_batching(write_batching_);
+        }
+    }
+
+    // Capacidad total (0 = sin límite), repartida entre shards con presupuesto
+    size_t capacity_entries_ = 0;
+    size_t capacity_bytes_ = 0;
+
+    void apply_capacity() {
+        if constexpr (has_set_budget<Shard>::value) {
+            typename Shard::Budget budget;
+            budget.max_entries = (capacity_entries_ + num_shards_ - 1) / num_shards_;
+            budget.max_bytes = (capacity_bytes_ + num_shards_ - 1) / num_shards_;
+            for (auto& shard : shards_) {
+                shard->set_budget(budget);
+            }
+        }
+    }
+
 public:
     explicit ParallelAVL(
         size_t num_shards = 8,
@@ -82,6 +239,7 @@ public:
         shards_.reserve(num_shards_);
         for (size_t i = 0; i < num_shards_; ++i) {
             shards_.push_back(std::make_unique<Shard>());
+            add_gate();
         }
 
         // Crear router
@@ -91,24 +249,52 @@ public:
         redirect_index_ = std::make_unique<RedirectIndex<Key>>();
     }
 
-    // Insert con linearizabilidad
-    void insert(const Key& key, const Value& value) {
-        total_ops_.fetch_add(1, std::memory_order_relaxed);
+    // Los shards se destruyen en background: soltar un árbol grande no
+    // bloquea al thread que lo destruye
+    ~ParallelAVL() {
+        for (auto& shard : shards_) {
+            DeferredDestroyer::dispose(std::move(shard));
+        }
+    }
+
+private:
+    using ExtractedItem = typename extracted_item<Shard, Key, Value>::type;
 
+    // expiry... vacío, o el vencimiento para shards con TTL
+    template<typename... Expiry>
+    void insert_impl(const Key& key, const Value& value, const Expiry&... expiry) {
         // Determinar shard via router (puede haber redirección)
-        size_t natural_shard = robust_hash(key) % num_shards_;
         size_t target_shard = router_->route(key);
+        auto ticket = admit(target_shard);
+        insert_at(target_shard, key, value, expiry...);
+    }
 
-        // Capturar tamaño antes de insertar
-        size_t old_size = shards_[target_shard]->size();
-        
-        // Insertar en el shard target
-        shards_[target_shard]->insert(key, value);
-        
-        // Solo notificar al router si realmente se insertó una key nueva
-        // FIX: Evita inflar shard_loads_ con duplicados
-        size_t new_size = shards_[target_shard]->size();
-        if (new_size > old_size) {
+    template<typename... Expiry>
+    void insert_at(size_t target_shard, const Key& key, const Value& value,
+                   const Expiry&... expiry) {
+        total_ops_.fetch_add(1, std::memory_order_relaxed);
+        size_t natural_shard = robust_hash(key) % num_shards_;
+
+        bool inserted;
+        if constexpr (has_insert_tracked<Shard, Key, Value>::value) {
+            // Con eviction el tamaño puede no crecer aunque la key sea nueva
+            auto result = shards_[target_shard]->insert_tracked(key, value, expiry...);
+            inserted = result.inserted;
+            for (size_t i = 0; i < result.evicted; ++i) {
+                router_->record_removal(target_shard);
+            }
+        } else {
+            // Capturar tamaño antes de insertar
+            size_t old_size = shards_[target_shard]->size();
+
+            // Insertar en el shard target
+            shards_[target_shard]->insert(key, value);
+
+            // Solo notificar al router si realmente se insertó una key nueva
+            // FIX: Evita inflar shard_loads_ con duplicados
+            inserted = shards_[target_shard]->size() > old_size;
+        }
+        if (inserted) {
             router_->record_insertion(target_shard);
             
             // Si hubo redirección, registrar en el índice
@@ -119,13 +305,74 @@ public:
         }
     }
 
+public:
+    // Insert con linearizabilidad
+    void insert(const Key& key, const Value& value) {
+        insert_impl(key, value);
+    }
+
+    // Insert con vencimiento (requiere shard con TTL, ej. CacheShard): pasado
+    // ttl la key deja de verse y su shard la libera sin remove() externo
+    template<typename Rep, typename Period>
+    void insert_with_ttl(const Key& key, const Value& value,
+                         std::chrono::duration<Rep, Period> ttl) {
+        static_assert(has_ttl<Shard>::value, "Shard type has no TTL support");
+        using Clock = typename Shard::Clock;
+        insert_impl(key, value,
+                    Clock::now() + std::chrono::duration_cast<typename Clock::duration>(ttl));
+    }
+
+    // Insert que no espera: false si el shard destino está al límite
+    bool try_insert(const Key& key, const Value& value) {
+        size_t target_shard = router_->route(key);
+        if (admission_limit_.load(std::memory_order_relaxed) == 0) {
+            insert_at(target_shard, key, value);
+            return true;
+        }
+        if (!gates_[target_shard]->try_acquire()) return false;
+        AdmissionTicket ticket(gates_[target_shard].get());
+        insert_at(target_shard, key, value);
+        return true;
+    }
+
+    // Insert que espera lugar hasta deadline; false si venció sin insertar
+    bool insert_until(const Key& key, const Value& value, Deadline deadline) {
+        size_t target_shard = router_->route(key);
+        if (admission_limit_.load(std::memory_order_relaxed) == 0) {
+            insert_at(target_shard, key, value);
+            return true;
+        }
+        if (!gates_[target_shard]->acquire_until(deadline)) return false;
+        AdmissionTicket ticket(gates_[target_shard].get());
+        insert_at(target_shard, key, value);
+        return true;
+    }
+
+    // Liberar ya lo vencido en todos los shards. Los inserts lo hacen solos
+    // en su shard; esto sirve para shards sin escrituras. Devuelve cuántas
+    // entradas se liberaron
+    size_t expire() {
+        static_assert(has_ttl<Shard>::value, "Shard type has no TTL support");
+        size_t total = 0;
+        for (size_t i = 0; i < num_shards_; ++i) {
+            size_t expired = shards_[i]->expire();
+            for (size_t j = 0; j < expired; ++j) {
+                router_->record_removal(i);
+            }
+            total += expired;
+        }
+        return total;
+    }
+
     // Contains con linearizabilidad garantizada - OPTIMIZADO
     bool contains(const Key& key) const {
         // Fast path: buscar en shard natural (caso común)
         size_t natural_shard = robust_hash(key) % num_shards_;
-        
-        if (shards_[natural_shard]->contains(key)) {
-            return true;
+        {
+            auto ticket = admit(natural_shard);
+            if (shards_[natural_shard]->contains(key)) {
+                return true;
+            }
         }
 
         // Solo continuar si hay posibilidad de que esté en otro lugar
@@ -141,6 +388,7 @@ public:
             auto redirected_shard = redirect_index_->lookup(key);
             if (redirected_shard.has_value()) {
                 redirect_index_hits_.fetch_add(1, std::memory_order_relaxed);
+                auto ticket = admit(*redirected_shard);
                 return shards_[*redirected_shard]->contains(key);
             }
         }
@@ -149,6 +397,7 @@ public:
         if (topology_changed_.load(std::memory_order_acquire)) {
             for (size_t i = 0; i < num_shards_; ++i) {
                 if (i == natural_shard) continue;
+                auto ticket = admit(i);
                 if (shards_[i]->contains(key)) {
                     return true;
                 }
@@ -160,18 +409,153 @@ public:
 
     // Get con linearizabilidad - OPTIMIZADO
     std::optional<Value> get(const Key& key) const {
-        // Fast path: buscar en shard natural
-        size_t natural_shard = robust_hash(key) % num_shards_;
-        auto result = shards_[natural_shard]->get(key);
+        std::optional<Value> out;
+        get_routed(key, AdmitPolicy{AdmitPolicy::WAIT}, out);
+        return out;
+    }
+
+    // Get que no espera: false si algún shard que hay que mirar está al
+    // límite (out sin tocar)
+    bool try_get(const Key& key, std::optional<Value>& out) const {
+        return get_routed(key, AdmitPolicy{AdmitPolicy::NONE}, out);
+    }
+
+    // Get que espera lugar hasta deadline; false si venció
+    bool get_until(const Key& key, Deadline deadline, std::optional<Value>& out) const {
+        return get_routed(key, AdmitPolicy{AdmitPolicy::UNTIL, deadline}, out);
+    }
 
-        if (result.has_value()) {
-            return result;
+    // Límite de operaciones simultáneas por shard (0 = sin límite)
+    void set_admission_limit(size_t max_in_flight) {
+        admission_limit_.store(max_in_flight, std::memory_order_relaxed);
+        for (auto& gate : gates_) {
+            gate->set_limit(max_in_flight);
         }
+    }
+
+    // Prioridad de lectura en los shards: READER_PRIORITY, o FAIR con a lo
+    // sumo reads_per_write lecturas por delante de cada writer que espera.
+    // Llamar antes de usar el árbol concurrentemente
+    void set_shard_lock_mode(ShardLockMode mode,
+                             size_t reads_per_write = ShardLock::DEFAULT_READS_PER_WRITE) {
+        static_assert(has_lock_mode<Shard>::value, "Shard type has no configurable lock");
+        lock_mode_ = mode;
+        reads_per_write_ = reads_per_write;
+        for (auto& shard : shards_) configure_shard(*shard);
+    }
+
+    // Escrituras encoladas por shard y aplicadas en lotes por un combiner:
+    // menos adquisiciones exclusivas entre las lecturas
+    void set_write_batching(bool enabled) {
+        static_assert(has_lock_mode<Shard>::value, "Shard type has no write batching");
+        write_batching_ = enabled;
+        for (auto& shard : shards_) configure_shard(*shard);
+    }
+
+    // Contención del lock de cada shard (adquisiciones, esperas, spins,
+    // bloqueos y tiempo esperando)
+    std::vector<LockContentionStats> get_lock_stats() const {
+        static_assert(has_lock_stats<Shard>::value, "Shard type has no lock stats");
+        std::vector<LockContentionStats> stats;
+        stats.reserve(shards_.size());
+        for (const auto& shard : shards_) {
+            stats.push_back(shard->lock_stats());
+        }
+        return stats;
+    }
 
+    // Profundidad de cola, rechazos y tiempos de espera de cada shard
+    std::vector<AdmissionGate::Stats> get_admission_stats() const {
+        std::vector<AdmissionGate::Stats> stats;
+        stats.reserve(gates_.size());
+        for (const auto& gate : gates_) {
+            stats.push_back(gate->stats());
+        }
+        return stats;
+    }
+
+    // Get en lote: agrupa las keys por shard natural y resuelve cada grupo
+    // con un solo lock (TreeShard::get_batch intercala las búsquedas con
+    // prefetch). Las que no están en su shard natural siguen el camino
+    // normal de get() (redirects / búsqueda exhaustiva). Con admission
+    // control cada grupo ocupa un lugar de su shard mientras se resuelve, y
+    // cada shard que visita el camino lento se admite aparte.
+    std::vector<std::optional<Value>> get_batch(const std::vector<Key>& keys) const {
+        size_t n = keys.size();
+        std::vector<std::optional<Value>> results(n);
+
+        // Counting sort por shard natural
+        std::vector<size_t> shard_of(n);
+        std::vector<size_t> offsets(num_shards_ + 1, 0);
+        for (size_t i = 0; i < n; ++i) {
+            shard_of[i] = robust_hash(keys[i]) % num_shards_;
+            offsets[shard_of[i] + 1]++;
+        }
+        for (size_t s = 0; s < num_shards_; ++s) {
+            offsets[s + 1] += offsets[s];
+        }
+        std::vector<size_t> order(n);
+        std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < n; ++i) {
+            order[cursor[shard_of[i]]++] = i;
+        }
+
+        std::vector<Key> grouped(n);
+        for (size_t j = 0; j < n; ++j) {
+            grouped[j] = keys[order[j]];
+        }
+        std::vector<std::optional<Value>> grouped_results(n);
+
+        for (size_t s = 0; s < num_shards_; ++s) {
+            size_t begin = offsets[s], end = offsets[s + 1];
+            if (begin == end) continue;
+            auto ticket = admit(s);
+            if constexpr (has_get_batch<Shard, Key, Value>::value) {
+                shards_[s]->get_batch(grouped.data() + begin, end - begin,
+                                      grouped_results.data() + begin);
+            } else {
+                for (size_t j = begin; j < end; ++j) {
+                    grouped_results[j] = shards_[s]->get(grouped[j]);
+                }
+            }
+        }
+
+        for (size_t j = 0; j < n; ++j) {
+            size_t i = order[j];
+            if (grouped_results[j].has_value()) {
+                results[i] = std::move(grouped_results[j]);
+            } else {
+                get_slow(keys[i], shard_of[i], AdmitPolicy{AdmitPolicy::WAIT}, results[i]);
+            }
+        }
+        return results;
+    }
+
+private:
+    // Fast path de get(): shard natural y, si no está, el camino lento
+    bool get_routed(const Key& key, const AdmitPolicy& policy, std::optional<Value>& out) const {
+        size_t natural_shard = robust_hash(key) % num_shards_;
+        {
+            auto ticket = admit(natural_shard, policy);
+            if (!ticket) return false;
+            auto result = shards_[natural_shard]->get(key);
+            if (result.has_value()) {
+                out = std::move(result);
+                return true;
+            }
+        }
+        return get_slow(key, natural_shard, policy, out);
+    }
+
+    // Camino lento de get(): la key no está en su shard natural. Cada shard
+    // visitado se admite aparte; false si alguno no dio lugar (out sin tocar)
+    bool get_slow(const Key& key, size_t natural_shard, const AdmitPolicy& policy,
+                  std::optional<Value>& out) const {
         // Fast exit si no hay redirects ni cambios
         if (!has_redirects_.load(std::memory_order_relaxed) && 
             !topology_changed_.load(std::memory_order_relaxed)) {
-            return std::nullopt;
+            out = std::nullopt;
+            return true;
         }
 
         total_ops_.fetch_add(1, std::memory_order_relaxed);
@@ -181,7 +565,10 @@ public:
             auto redirected_shard = redirect_index_->lookup(key);
             if (redirected_shard.has_value()) {
                 redirect_index_hits_.fetch_add(1, std::memory_order_relaxed);
-                return shards_[*redirected_shard]->get(key);
+                auto ticket = admit(*redirected_shard, policy);
+                if (!ticket) return false;
+                out = shards_[*redirected_shard]->get(key);
+                return true;
             }
         }
 
@@ -189,33 +576,42 @@ public:
         if (topology_changed_.load(std::memory_order_acquire)) {
             for (size_t i = 0; i < num_shards_; ++i) {
                 if (i == natural_shard) continue;
+                auto ticket = admit(i, policy);
+                if (!ticket) return false;
                 auto res = shards_[i]->get(key);
                 if (res.has_value()) {
-                    return res;
+                    out = std::move(res);
+                    return true;
                 }
             }
         }
 
-        return std::nullopt;
+        out = std::nullopt;
+        return true;
     }
 
+public:
+
     // Remove
     bool remove(const Key& key) {
         total_ops_.fetch_add(1, std::memory_order_relaxed);
 
         // Buscar en shard natural primero
         size_t natural_shard = robust_hash(key) % num_shards_;
-
-        if (shards_[natural_shard]->remove(key)) {
-            router_->record_removal(natural_shard);
-            redirect_index_->remove(key);  // Limpiar del índice si estaba
-            return true;
+        {
+            auto ticket = admit(natural_shard);
+            if (shards_[natural_shard]->remove(key)) {
+                router_->record_removal(natural_shard);
+                redirect_index_->remove(key);  // Limpiar del índice si estaba
+                return true;
+            }
         }
 
         // Buscar en shard redirigido
         auto redirected_shard = redirect_index_->lookup(key);
 
         if (redirected_shard.has_value()) {
+            auto ticket = admit(*redirected_shard);
             if (shards_[*redirected_shard]->remove(key)) {
                 router_->record_removal(*redirected_shard);
                 redirect_index_->remove(key);
@@ -227,6 +623,7 @@ public:
         if (topology_changed_.load(std::memory_order_acquire)) {
             for (size_t i = 0; i < num_shards_; ++i) {
                 if (i == natural_shard) continue;
+                auto ticket = admit(i);
                 if (shards_[i]->remove(key)) {
                     router_->record_removal(i);
                     return true;
@@ -261,6 +658,24 @@ public:
         std::copy(results.begin(), results.end(), out);
     }
 
+    // Reducción de los valores con keys en [lo, hi] usando los agregados por
+    // subárbol de cada shard: O(log n) por shard en vez de copiar k pares.
+    // Requiere shards con reduce_range, ej.
+    //   ParallelAVL<K, V, TreeShard<K, V, AVLTree<K, V, StatsMonoid<long>>>>
+    // Los shards se combinan en orden arbitrario: el monoid debe ser conmutativo.
+    auto reduce_range(const Key& lo, const Key& hi) const {
+        using Monoid = typename ShardType::TreeType::MonoidType;
+        total_ops_.fetch_add(1, std::memory_order_relaxed);
+
+        auto result = Monoid::identity();
+        for (size_t i = 0; i < num_shards_; ++i) {
+            if (shards_[i]->intersects_range(lo, hi)) {
+                result = Monoid::combine(result, shards_[i]->reduce_range(lo, hi));
+            }
+        }
+        return result;
+    }
+
     // Size total
     size_t size() const {
         size_t total = 0;
@@ -378,6 +793,27 @@ public:
         std::cout << std::endl;
     }
 
+    // Desfragmentar shard por shard (no-op si el shard no lo soporta). Cada
+    // shard sigue atendiendo operaciones entre pasos
+    void defragment() {
+        if constexpr (has_defragment<Shard>::value) {
+            for (auto& shard : shards_) {
+                shard->defragment();
+            }
+        }
+    }
+
+    // Modo cache: tope de entradas y/o bytes para todo el árbol (0 = sin
+    // límite). Se reparte en partes iguales entre shards y cada shard expulsa
+    // por su cuenta al insertar, sin lock global. Requiere un shard con
+    // presupuesto, ej. ParallelAVL<K, V, CacheShard<K, V>>
+    void set_capacity(size_t max_entries, size_t max_bytes = 0) {
+        static_assert(has_set_budget<Shard>::value, "Shard type has no memory budget");
+        capacity_entries_ = max_entries;
+        capacity_bytes_ = max_bytes;
+        apply_capacity();
+    }
+
     // Clear (para testing)
     void clear() {
         for (auto& shard : shards_) {
@@ -398,6 +834,8 @@ public:
     void add_shard() {
         // Crear nuevo shard
         shards_.push_back(std::make_unique<Shard>());
+        configure_shard(*shards_.back());
+        add_gate();
         num_shards_++;
 
         // Recrear router con nuevo número de shards
@@ -408,6 +846,9 @@ public:
 
         // Marcar que hubo cambio de topología para habilitar búsqueda exhaustiva
         topology_changed_.store(true, std::memory_order_release);
+
+        // Repartir la capacidad también al shard nuevo
+        apply_capacity();
     }
 
     // Eliminar el último shard y redistribuir sus elementos
@@ -417,11 +858,13 @@ public:
         size_t removing_id = num_shards_ - 1;
 
         // Extraer todos los elementos del shard a eliminar
-        std::vector<std::pair<Key, Value>> to_redistribute;
+        std::vector<ExtractedItem> to_redistribute;
         extract_shard_data(removing_id, to_redistribute);
 
-        // Eliminar el shard
+        // Eliminar el shard (sus nodos se liberan en background)
+        DeferredDestroyer::dispose(std::move(shards_.back()));
         shards_.pop_back();
+        gates_.pop_back();
         num_shards_--;
 
         // Recrear router
@@ -435,19 +878,22 @@ public:
             return removing_id;  // Forzar eliminación de entries obsoletas
         });
 
+        // Repartir la capacidad antes de recibir los datos redistribuidos
+        apply_capacity();
+
         // Re-insertar datos del shard eliminado (van a sus nuevos shards naturales)
-        for (const auto& [key, value] : to_redistribute) {
-            size_t target = router_->route(key);
-            shards_[target]->insert(key, value);
-            router_->record_insertion(target);
+        for (const auto& item : to_redistribute) {
+            reinsert(router_->route(item.first), item);
         }
+        DeferredDestroyer::dispose(
+            std::make_unique<std::vector<ExtractedItem>>(std::move(to_redistribute)));
     }
 
     // Forzar rebalanceo: redistribuir TODAS las keys según routing actual
     // Útil después de agregar/quitar varios shards o detectar desbalance severo
     void force_rebalance() {
         // Paso 1: Extraer todos los datos
-        std::vector<std::pair<Key, Value>> all_data;
+        std::vector<ExtractedItem> all_data;
         for (size_t i = 0; i < num_shards_; ++i) {
             extract_shard_data(i, all_data);
         }
@@ -462,16 +908,17 @@ public:
         router_ = std::make_unique<Router>(num_shards_, RouterStrategy::STATIC_HASH);
 
         // Paso 4: Re-insertar todo usando hash simple (sin redirecciones)
-        for (const auto& [key, value] : all_data) {
-            size_t target = robust_hash(key) % num_shards_;
-            shards_[target]->insert(key, value);
-            router_->record_insertion(target);
+        for (const auto& item : all_data) {
+            reinsert(robust_hash(item.first) % num_shards_, item);
         }
 
         // Reset stats y flag de topología - ahora todo está en su shard natural
         total_ops_.store(all_data.size(), std::memory_order_relaxed);
         redirect_index_hits_.store(0, std::memory_order_relaxed);
         topology_changed_.store(false, std::memory_order_release);
+
+        DeferredDestroyer::dispose(
+            std::make_unique<std::vector<ExtractedItem>>(std::move(all_data)));
     }
 
     // Obtener número de shards
@@ -486,8 +933,29 @@ public:
 
 private:
     // Helper: extraer datos de un shard específico
-    void extract_shard_data(size_t shard_id, std::vector<std::pair<Key, Value>>& out) {
-        shards_[shard_id]->extract_all(std::back_inserter(out));
+    void extract_shard_data(size_t shard_id, std::vector<ExtractedItem>& out) {
+        if constexpr (has_ttl<Shard>::value) {
+            shards_[shard_id]->extract_all_expiring(std::back_inserter(out));
+        } else {
+            shards_[shard_id]->extract_all(std::back_inserter(out));
+        }
+    }
+
+    // Helper: re-insertar una entrada extraída y llevar la carga al router
+    // (con eviction/TTL el shard puede expulsar o descartar al insertar)
+    void reinsert(size_t target, const ExtractedItem& item) {
+        if constexpr (has_ttl<Shard>::value) {
+            auto result = shards_[target]->insert_tracked(item.first, item.second, item.expires_at);
+            for (size_t i = 0; i < result.evicted; ++i) router_->record_removal(target);
+            if (result.inserted) router_->record_insertion(target);
+        } else if constexpr (has_insert_tracked<Shard, Key, Value>::value) {
+            auto result = shards_[target]->insert_tracked(item.first, item.second);
+            for (size_t i = 0; i < result.evicted; ++i) router_->record_removal(target);
+            if (result.inserted) router_->record_insertion(target);
+        } else {
+            shards_[target]->insert(item.first, item.second);
+            router_->record_insertion(target);
+        }
     }
 };
 
@@ -0,0 +1,95 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Contadores de hardware para benchmarks (perf_event_open, solo Linux).
+// Miden el thread que llama, sin kernel. Si la PMU no está disponible
+// (VMs, contenedores, perf_event_paranoid alto) available() es false y
+// stop() devuelve -1: el benchmark imprime "n/a" en vez de fallar.
+
+class PerfCounter {
+public:
+    enum class Event { DTLB_LOAD_MISSES, ITLB_MISSES, LLC_LOAD_MISSES };
+
+    explicit PerfCounter(Event event) {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        uint64_t cache = PERF_COUNT_HW_CACHE_DTLB;
+        if (event == Event::ITLB_MISSES) cache = PERF_COUNT_HW_CACHE_ITLB;
+        if (event == Event::LLC_LOAD_MISSES) cache = PERF_COUNT_HW_CACHE_LL;
+        attr.config = cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+        (void)event;
+#endif
+    }
+
+    ~PerfCounter() {
+#if defined(__linux__)
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter& operator=(const PerfCounter&) = delete;
+
+    bool available() const { return fd_ >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    // Eventos desde start(), o -1 si no hay contador
+    long long stop() {
+#if defined(__linux__)
+        if (fd_ < 0) return -1;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) return -1;
+        return count;
+#else
+        return -1;
+#endif
+    }
+
+private:
+    int fd_ = -1;
+};
+
+// KB de memoria anónima respaldada por huge pages transparentes en el
+// proceso (AnonHugePages de /proc/self/smaps_rollup), o -1
+inline long long anon_huge_pages_kb() {
+    std::ifstream in("/proc/self/smaps_rollup");
+    std::string field;
+    long long kb;
+    while (in >> field) {
+        if (field == "AnonHugePages:") {
+            return (in >> kb) ? kb : -1;
+        }
+    }
+    return -1;
+}
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,393 @@
+#ifndef QUEUE_LOCK_HPP
+#define QUEUE_LOCK_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// =============================================================================
+// Locks de shard intercambiables (política elegida en compilación)
+// =============================================================================
+//
+//   StdShardMutex:       std::mutex (default). Con muchos threads sobre un
+//                        shard caliente genera tormentas de futex y handoffs
+//                        injustos
+//   McsLock:             cola MCS. Cada waiter espera sobre su propio nodo y
+//                        el dueño le pasa el lock al siguiente en orden FIFO
+//   ClhLock:             cola CLH. Cada waiter espera sobre el nodo de su
+//                        predecesor; un solo exchange para entrar y un store
+//                        para salir
+//   SpinThenParkLock:    spin acotado con try_lock y después bloqueo en el
+//                        kernel. El presupuesto de spin se adapta a lo que
+//                        costaron las últimas adquisiciones
+//
+// Compilar con -DSHARD_LOCK_MCS, -DSHARD_LOCK_CLH o -DSHARD_LOCK_ADAPTIVE
+// cambia DefaultShardMutex, que usan TreeShard (vía ShardLock),
+// AVLTreeParallel y DynamicShardedTree. TreeShard también lo recibe como
+// parámetro de template.
+//
+// Los waiters de MCS/CLH pasan a std::this_thread::yield() después de
+// SPIN_BEFORE_YIELD vueltas: con más threads que cores, el siguiente en la
+// cola puede no estar corriendo y el spin puro colapsa.
+//
+// Todas las políticas cuentan su contención (contention_stats()). Los
+// contadores se actualizan con el lock tomado, así que alcanza con
+// load + store relajados: no agregan RMW compartidos al camino rápido.
+// =============================================================================
+
+struct LockContentionStats {
+    size_t acquisitions = 0;
+    size_t contended = 0;       // adquisiciones que tuvieron que esperar
+    size_t spins = 0;           // vueltas de espera activa
+    size_t parks = 0;           // esperas que terminaron bloqueadas/cediendo el core
+    size_t yields = 0;          // veces que esas esperas cedieron el core (MCS/CLH)
+    uint64_t wait_ns = 0;       // tiempo total esperando (solo las contendidas)
+};
+
+namespace lock_detail {
+
+inline void cpu_relax() {
+#if defined(__SSE2__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+constexpr size_t SPIN_BEFORE_YIELD = 128;
+
+// Espera activa hasta que done() sea true; devuelve las vueltas
+template<typename Pred>
+size_t spin_until(Pred done, size_t& yields) {
+    size_t spins = 0;
+    while (!done()) {
+        if (++spins % SPIN_BEFORE_YIELD == 0) {
+            std::this_thread::yield();
+            yields++;
+        } else {
+            cpu_relax();
+        }
+    }
+    return spins;
+}
+
+inline uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Contadores escritos solo por el dueño del lock
+class ContentionCounters {
+    std::atomic<size_t> acquisitions_{0};
+    std::atomic<size_t> contended_{0};
+    std::atomic<size_t> spins_{0};
+    std::atomic<size_t> parks_{0};
+    std::atomic<size_t> yields_{0};
+    std::atomic<uint64_t> wait_ns_{0};
+
+    template<typename T>
+    static void bump(std::atomic<T>& counter, T n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+public:
+    void uncontended() {
+        bump(acquisitions_, size_t{1});
+    }
+
+    // parked: la espera se bloqueó o cedió el core al menos una vez
+    void contended(size_t spins, bool parked, uint64_t wait_ns, size_t yields = 0) {
+        bump(acquisitions_, size_t{1});
+        bump(contended_, size_t{1});
+        bump(spins_, spins);
+        if (parked) bump(parks_, size_t{1});
+        if (yields) bump(yields_, yields);
+        bump(wait_ns_, wait_ns);
+    }
+
+    LockContentionStats snapshot() const {
+        LockContentionStats s;
+        s.acquisitions = acquisitions_.load(std::memory_order_relaxed);
+        s.contended = contended_.load(std::memory_order_relaxed);
+        s.spins = spins_.load(std::memory_order_relaxed);
+        s.parks = parks_.load(std::memory_order_relaxed);
+        s.yields = yields_.load(std::memory_order_relaxed);
+        s.wait_ns = wait_ns_.load(std::memory_order_relaxed);
+        return s;
+    }
+};
+
+// Nodos de cola reciclados por thread. Un thread puede tener varios locks
+// tomados a la vez (ej. AVLTreeParallel::size() toma todos), así que el nodo
+// se saca del pool en cada lock() y el lock recuerda cuál es el del dueño
+template<typename Node>
+class NodePool {
+    std::vector<Node*> free_;
+
+public:
+    ~NodePool() {
+        for (Node* n : free_) delete n;
+    }
+
+    static NodePool& local() {
+        thread_local NodePool pool;
+        return pool;
+    }
+
+    Node* get() {
+        if (free_.empty()) return new Node();
+        Node* n = free_.back();
+        free_.pop_back();
+        return n;
+    }
+
+    void put(Node* n) {
+        free_.push_back(n);
+    }
+};
+
+} // namespace lock_detail
+
+// -----------------------------------------------------------------------------
+// StdShardMutex: std::mutex con contadores
+// -----------------------------------------------------------------------------
+class StdShardMutex {
+    std::mutex mutex_;
+    lock_detail::ContentionCounters counters_;
+
+public:
+    void lock() {
+        if (mutex_.try_lock()) {
+            counters_.uncontended();
+            return;
+        }
+        uint64_t start = lock_detail::now_ns();
+        mutex_.lock();
+        counters_.contended(0, true, lock_detail::now_ns() - start);
+    }
+
+    bool try_lock() {
+        if (!mutex_.try_lock()) return false;
+        counters_.uncontended();
+        return true;
+    }
+
+    void unlock() { mutex_.unlock(); }
+
+    LockContentionStats contention_stats() const { return counters_.snapshot(); }
+};
+
+// -----------------------------------------------------------------------------
+// McsLock
+// -----------------------------------------------------------------------------
+class McsLock {
+    struct alignas(64) Node {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<bool> locked{false};
+    };
+    using Pool = lock_detail::NodePool<Node>;
+
+    alignas(64) std::atomic<Node*> tail_{nullptr};
+    Node* holder_ = nullptr;        // nodo del dueño actual
+    lock_detail::ContentionCounters counters_;
+
+public:
+    McsLock() = default;
+    McsLock(const McsLock&) = delete;
+    McsLock& operator=(const McsLock&) = delete;
+
+    void lock() {
+        Node* me = Pool::local().get();
+        me->next.store(nullptr, std::memory_order_relaxed);
+        me->locked.store(true, std::memory_order_relaxed);
+
+        Node* pred = tail_.exchange(me, std::memory_order_acq_rel);
+        if (!pred) {
+            holder_ = me;
+            counters_.uncontended();
+            return;
+        }
+
+        uint64_t start = lock_detail::now_ns();
+        pred->next.store(me, std::memory_order_release);
+        size_t yields = 0;
+        size_t spins = lock_detail::spin_until(
+            [me] { return !me->locked.load(std::memory_order_acquire); }, yields);
+        holder_ = me;
+        counters_.contended(spins, yields > 0, lock_detail::now_ns() - start, yields);
+    }
+
+    bool try_lock() {
+        Node* me = Pool::local().get();
+        me->next.store(nullptr, std::memory_order_relaxed);
+        Node* expected = nullptr;
+        if (!tail_.compare_exchange_strong(expected, me, std::memory_order_acq_rel,
+                                           std::memory_order_relaxed)) {
+            Pool::local().put(me);
+            return false;
+        }
+        holder_ = me;
+        counters_.uncontended();
+        return true;
+    }
+
+    void unlock() {
+        Node* me = holder_;
+        Node* succ = me->next.load(std::memory_order_acquire);
+        if (!succ) {
+            Node* expected = me;
+            if (tail_.compare_exchange_strong(expected, nullptr, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+                Pool::local().put(me);
+                return;
+            }
+            // Alguien ya hizo el exchange pero todavía no se enganchó
+            while (!(succ = me->next.load(std::memory_order_acquire))) {
+                lock_detail::cpu_relax();
+            }
+        }
+        succ->locked.store(false, std::memory_order_release);
+        Pool::local().put(me);
+    }
+
+    LockContentionStats contention_stats() const { return counters_.snapshot(); }
+};
+
+// -----------------------------------------------------------------------------
+// ClhLock
+// -----------------------------------------------------------------------------
+// Al salir, el dueño se queda con el nodo de su predecesor (ya nadie lo mira)
+// y deja el propio para el siguiente. Sin try_lock: la cola implícita no
+// permite saber si el lock está libre sin encolarse
+class ClhLock {
+    struct alignas(64) Node {
+        std::atomic<bool> locked{false};
+    };
+    using Pool = lock_detail::NodePool<Node>;
+
+    alignas(64) std::atomic<Node*> tail_;
+    Node* holder_ = nullptr;
+    Node* holder_pred_ = nullptr;
+    lock_detail::ContentionCounters counters_;
+
+public:
+    ClhLock() : tail_(new Node()) {}
+    ClhLock(const ClhLock&) = delete;
+    ClhLock& operator=(const ClhLock&) = delete;
+
+    ~ClhLock() {
+        delete tail_.load(std::memory_order_relaxed);
+    }
+
+    void lock() {
+        Node* me = Pool::local().get();
+        me->locked.store(true, std::memory_order_relaxed);
+
+        Node* pred = tail_.exchange(me, std::memory_order_acq_rel);
+        if (!pred->locked.load(std::memory_order_acquire)) {
+            holder_ = me;
+            holder_pred_ = pred;
+            counters_.uncontended();
+            return;
+        }
+
+        uint64_t start = lock_detail::now_ns();
+        size_t yields = 0;
+        size_t spins = lock_detail::spin_until(
+            [pred] { return !pred->locked.load(std::memory_order_acquire); }, yields);
+        holder_ = me;
+        holder_pred_ = pred;
+        counters_.contended(spins, yields > 0, lock_detail::now_ns() - start, yields);
+    }
+
+    void unlock() {
+        Node* me = holder_;
+        Node* pred = holder_pred_;
+        me->locked.store(false, std::memory_order_release);
+        Pool::local().put(pred);
+    }
+
+    LockContentionStats contention_stats() const { return counters_.snapshot(); }
+};
+
+// -----------------------------------------------------------------------------
+// SpinThenParkLock
+// -----------------------------------------------------------------------------
+// Reintenta try_lock con backoff exponencial hasta spin_limit_ pausas y
+// después se bloquea en el std::mutex (futex). spin_limit_ sigue un
+// promedio móvil de las pausas que hicieron falta, como
+// PTHREAD_MUTEX_ADAPTIVE_NP: si el lock suele liberarse rápido se spinea más,
+// si nunca alcanza se deja de gastar CPU
+class SpinThenParkLock {
+    static constexpr size_t MAX_SPIN = 1024;
+    static constexpr size_t MIN_SPIN = 16;
+
+    std::mutex mutex_;
+    std::atomic<size_t> spin_limit_{128};
+    lock_detail::ContentionCounters counters_;
+
+    void adapt(size_t spent) {
+        size_t limit = spin_limit_.load(std::memory_order_relaxed);
+        long next = static_cast<long>(limit) +
+                    (static_cast<long>(spent) - static_cast<long>(limit)) / 8;
+        if (next < static_cast<long>(MIN_SPIN)) next = MIN_SPIN;
+        if (next > static_cast<long>(MAX_SPIN)) next = MAX_SPIN;
+        spin_limit_.store(static_cast<size_t>(next), std::memory_order_relaxed);
+    }
+
+public:
+    void lock() {
+        if (mutex_.try_lock()) {
+            counters_.uncontended();
+            return;
+        }
+        uint64_t start = lock_detail::now_ns();
+        size_t limit = spin_limit_.load(std::memory_order_relaxed);
+        size_t spent = 0;
+        for (size_t backoff = 1; spent < limit; backoff = std::min<size_t>(backoff * 2, 64)) {
+            for (size_t i = 0; i < backoff; ++i) lock_detail::cpu_relax();
+            spent += backoff;
+            if (mutex_.try_lock()) {
+                adapt(spent);
+                counters_.contended(spent, false, lock_detail::now_ns() - start);
+                return;
+            }
+        }
+        mutex_.lock();
+        adapt(limit * 2);
+        counters_.contended(spent, true, lock_detail::now_ns() - start);
+    }
+
+    bool try_lock() {
+        if (!mutex_.try_lock()) return false;
+        counters_.uncontended();
+        return true;
+    }
+
+    void unlock() { mutex_.unlock(); }
+
+    size_t spin_limit() const { return spin_limit_.load(std::memory_order_relaxed); }
+
+    LockContentionStats contention_stats() const { return counters_.snapshot(); }
+};
+
+#if defined(SHARD_LOCK_MCS)
+using DefaultShardMutex = McsLock;
+#elif defined(SHARD_LOCK_CLH)
+using DefaultShardMutex = ClhLock;
+#elif defined(SHARD_LOCK_ADAPTIVE)
+using DefaultShardMutex = SpinThenParkLock;
+#else
+using DefaultShardMutex = StdShardMutex;
+#endif
+
+#endif // QUEUE_LOCK_HPP
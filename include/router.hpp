@@ -159,7 +159,8 @@ public:
             recent_inserts_[i] = 0;
         }
 
-        if (strategy_ == Strategy::CONSISTENT_HASH || strategy_ == Strategy::INTELLIGENT) {
+        if (strategy_ == Strategy::CONSISTENT_HASH || strategy_ == Strategy::VIRTUAL_NODES ||
+            strategy_ == Strategy::INTELLIGENT) {
             init_virtual_nodes();
         }
     }
@@ -2,18 +2,75 @@
 #define SHARD_HPP
 
 #include "AVLTree.h"
+#include "BPlusTree.h"
+#include "AdaptiveRadixTree.h"
+#include "deferred_destroyer.hpp"
+#include "shard_lock.hpp"
 #include <mutex>
+#include <shared_mutex>
+#include <vector>
 #include <atomic>
 #include <optional>
 #include <limits>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <thread>
+
+// El árbol secuencial ofrece findBatch (búsquedas intercaladas con prefetch)?
+template<typename Tree, typename Key, typename Value, typename = void>
+struct has_find_batch : std::false_type {};
+
+template<typename Tree, typename Key, typename Value>
+struct has_find_batch<Tree, Key, Value, std::void_t<decltype(std::declval<const Tree&>().findBatch(
+    std::declval<const Key*>(), size_t{}, std::declval<const Value**>()))>> : std::true_type {};
 
 // TreeShard: Contenedor thread-safe para un AVL tree individual
 // Mantiene estadísticas y metadatos para optimizaciones
-template<typename Key, typename Value>
+//
+// El árbol secuencial es intercambiable (default AVLTree). Cualquier tipo con
+// la API de AVLTree sirve: insert, remove, find, size, minKey, maxKey,
+// forEachInRange, forEach y move-assignment. Ej: TreeShard<K, V, BPlusTree<K, V>>,
+// TreeShard<K, V, AdaptiveRadixTree<K, V>> (keys enteras)
+//
+// Lock: ShardLock, por default un mutex exclusivo. set_lock_mode() habilita
+// lecturas concurrentes con prioridad de lectura o una proporción
+// lecturas/escritura (ver shard_lock.hpp). set_write_batching(true) hace que
+// los writers encolen sus operaciones y uno de ellos (el combiner) las
+// aplique todas con una sola adquisición exclusiva; cada insert/remove
+// retorna recién aplicado, así que la semántica no cambia.
+//
+// Mutex es el lock exclusivo debajo de ShardLock: DefaultShardMutex
+// (std::mutex salvo -DSHARD_LOCK_*), McsLock, ClhLock o SpinThenParkLock
+// (ver queue_lock.hpp). lock_stats() reporta su contención.
+template<typename Key, typename Value, typename Tree = AVLTree<Key, Value>,
+         typename Mutex = DefaultShardMutex>
 class TreeShard {
+public:
+    using TreeType = Tree;
+    using LockType = BasicShardLock<Mutex>;
+
 private:
-    AVLTree<Key, Value> tree_;
-    mutable std::mutex mutex_;
+    Tree tree_;
+    mutable LockType mutex_;
+
+    // Escrituras en lote (flat combining)
+    struct WriteOp {
+        const Key* key;
+        const Value* value;     // nullptr = remove
+        bool result;
+        std::atomic<bool> done{false};
+
+        WriteOp(const Key* k, const Value* v) : key(k), value(v), result(false) {}
+    };
+
+    std::atomic<bool> write_batching_{false};
+    std::atomic<bool> combining_{false};
+    std::mutex queue_mutex_;
+    std::vector<WriteOp*> write_queue_;
+    std::vector<WriteOp*> combine_buffer_;     // solo lo usa el combiner
+    std::atomic<size_t> write_batches_{0};
+    std::atomic<size_t> batched_writes_{0};
 
     // Estadísticas atómicas (lock-free reads)
     std::atomic<size_t> size_{0};
@@ -58,14 +115,8 @@ private:
         }
     }
 
-public:
-    TreeShard() = default;
-
-    // Operaciones básicas con locking
-
-    void insert(const Key& key, const Value& value) {
-        std::lock_guard lock(mutex_);
-
+    // Con el lock exclusivo tomado
+    bool insert_nl(const Key& key, const Value& value) {
         size_t old_size = tree_.size();
         tree_.insert(key, value);
         size_t new_size = tree_.size();
@@ -76,11 +127,10 @@ public:
         }
 
         insert_count_.fetch_add(1, std::memory_order_relaxed);
+        return new_size > old_size;
     }
 
-    bool remove(const Key& key) {
-        std::lock_guard lock(mutex_);
-
+    bool remove_nl(const Key& key) {
         size_t old_size = tree_.size();
         tree_.remove(key);
         size_t new_size = tree_.size();
@@ -103,21 +153,123 @@ public:
         return false;
     }
 
-    bool contains(const Key& key) const {
+    // Encolar op y esperar a que algún combiner la aplique (quizás éste)
+    bool submit_write(WriteOp& op) {
+        {
+            std::lock_guard queue_lock(queue_mutex_);
+            write_queue_.push_back(&op);
+        }
+        while (!op.done.load(std::memory_order_acquire)) {
+            if (combining_.exchange(true, std::memory_order_acquire)) {
+                std::this_thread::yield();
+                continue;
+            }
+            {
+                std::lock_guard queue_lock(queue_mutex_);
+                combine_buffer_.swap(write_queue_);
+            }
+            if (!combine_buffer_.empty()) {
+                {
+                    std::lock_guard lock(mutex_);
+                    for (WriteOp* w : combine_buffer_) {
+                        w->result = w->value ? insert_nl(*w->key, *w->value) : remove_nl(*w->key);
+                    }
+                }
+                write_batches_.fetch_add(1, std::memory_order_relaxed);
+                batched_writes_.fetch_add(combine_buffer_.size(), std::memory_order_relaxed);
+                // Después de done el WriteOp puede dejar de existir
+                for (WriteOp* w : combine_buffer_) {
+                    w->done.store(true, std::memory_order_release);
+                }
+                combine_buffer_.clear();
+            }
+            combining_.store(false, std::memory_order_release);
+        }
+        return op.result;
+    }
+
+public:
+    TreeShard() = default;
+
+    // Modo del lock; fijarlo antes de usar el shard concurrentemente
+    void set_lock_mode(ShardLockMode mode,
+                       size_t reads_per_write = LockType::DEFAULT_READS_PER_WRITE) {
+        mutex_.set_mode(mode, reads_per_write);
+    }
+
+    ShardLockMode lock_mode() const {
+        return mutex_.mode();
+    }
+
+    LockContentionStats lock_stats() const {
+        return mutex_.contention_stats();
+    }
+
+    void set_write_batching(bool enabled) {
+        write_batching_.store(enabled, std::memory_order_relaxed);
+    }
+
+    // Operaciones básicas con locking
+
+    void insert(const Key& key, const Value& value) {
+        if (write_batching_.load(std::memory_order_relaxed)) {
+            WriteOp op(&key, &value);
+            submit_write(op);
+            return;
+        }
+        std::lock_guard lock(mutex_);
+        insert_nl(key, value);
+    }
+
+    bool remove(const Key& key) {
+        if (write_batching_.load(std::memory_order_relaxed)) {
+            WriteOp op(&key, nullptr);
+            return submit_write(op);
+        }
         std::lock_guard lock(mutex_);
+        return remove_nl(key);
+    }
+
+    bool contains(const Key& key) const {
+        std::shared_lock lock(mutex_);
         return tree_.contains(key);
     }
 
     std::optional<Value> get(const Key& key) const {
-        std::lock_guard lock(mutex_);
-        // Optimizado: llamar directamente a get sin contains primero
-        // Si la key no existe, tree_.get() retorna Value{} - manejarlo
-        if (tree_.contains(key)) {
-            return tree_.get(key);
+        std::shared_lock lock(mutex_);
+        // Un solo descenso: find() devuelve nullptr si la key no existe
+        const Value* value = tree_.find(key);
+        if (value) {
+            return *value;
         }
         return std::nullopt;
     }
 
+    // Get en lote: un solo lock para todo el lote. Si el árbol tiene
+    // findBatch, las búsquedas avanzan intercaladas y sus cache misses se
+    // solapan; si no, un find() por key.
+    void get_batch(const Key* keys, size_t n, std::optional<Value>* out) const {
+        std::shared_lock lock(mutex_);
+        if constexpr (has_find_batch<Tree, Key, Value>::value) {
+            constexpr size_t CHUNK = 64;
+            const Value* found[CHUNK];
+            for (size_t base = 0; base < n; base += CHUNK) {
+                size_t len = std::min(CHUNK, n - base);
+                tree_.findBatch(keys + base, len, found);
+                for (size_t i = 0; i < len; ++i) {
+                    if (found[i]) out[base + i] = *found[i];
+                    else out[base + i] = std::nullopt;
+                }
+            }
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                const Value* value = tree_.find(keys[i]);
+                if (value) out[i] = *value;
+                else out[i] = std::nullopt;
+            }
+        }
+    }
+
     // Lock-free reads de estadísticas
     size_t size() const {
         return size_.load(std::memory_order_relaxed);
@@ -151,33 +303,19 @@ public:
     // Range query: collect keys in range [lo, hi]
     template<typename OutputIt>
     void range_query(const Key& lo, const Key& hi, OutputIt out) const {
-        std::lock_guard lock(mutex_);
-        range_query_recursive(tree_.getRoot(), lo, hi, out);
+        std::shared_lock lock(mutex_);
+        tree_.forEachInRange(lo, hi, [&out](const Key& k, const Value& v) {
+            *out++ = std::make_pair(k, v);
+        });
     }
 
-private:
-    template<typename OutputIt>
-    void range_query_recursive(typename AVLTree<Key, Value>::Node* node,
-                               const Key& lo,
-                               const Key& hi,
-                               OutputIt out) const {
-        if (!node) return;
-
-        // In-order traversal con pruning
-        if (node->key > lo) {
-            range_query_recursive(node->left, lo, hi, out);
-        }
-
-        if (node->key >= lo && node->key <= hi) {
-            *out++ = std::make_pair(node->key, node->value);
-        }
-
-        if (node->key < hi) {
-            range_query_recursive(node->right, lo, hi, out);
-        }
+    // Reducción sobre [lo, hi] con agregados por subárbol: O(log n) bajo el
+    // lock. Requiere un Tree con reduceRange, ej. AVLTree<K, V, SumMonoid<long>>
+    auto reduce_range(const Key& lo, const Key& hi) const {
+        std::shared_lock lock(mutex_);
+        return tree_.reduceRange(lo, hi);
     }
 
-public:
     // Estadísticas completas
     struct Stats {
         size_t size;
@@ -186,6 +324,9 @@ public:
         size_t lookups;
         std::optional<Key> min_key;
         std::optional<Key> max_key;
+        size_t write_batches;       // adquisiciones exclusivas del combiner
+        size_t batched_writes;      // escrituras aplicadas en esos lotes
+        LockContentionStats lock;
     };
 
     Stats get_stats() const {
@@ -199,36 +340,69 @@ public:
             stats.min_key = min_key_.load(std::memory_order_relaxed);
             stats.max_key = max_key_.load(std::memory_order_relaxed);
         }
+        stats.write_batches = write_batches_.load(std::memory_order_relaxed);
+        stats.batched_writes = batched_writes_.load(std::memory_order_relaxed);
+        stats.lock = mutex_.contention_stats();
 
         return stats;
     }
 
-    // Clear (para testing)
+    // Clear: bajo el lock solo se desengancha el árbol (un move); destruir
+    // sus nodos queda para el DeferredDestroyer, fuera de la sección crítica
     void clear() {
-        std::lock_guard lock(mutex_);
-        // No podemos llamar clear() directamente, reconstruir el tree
-        tree_ = AVLTree<Key, Value>();
-        size_.store(0, std::memory_order_relaxed);
-        insert_count_.store(0, std::memory_order_relaxed);
-        remove_count_.store(0, std::memory_order_relaxed);
-        lookup_count_.store(0, std::memory_order_relaxed);
-        has_keys_.store(false, std::memory_order_release);
+        auto old = std::make_unique<Tree>();
+        {
+            std::lock_guard lock(mutex_);
+            *old = std::move(tree_);
+            tree_ = Tree();
+            size_.store(0, std::memory_order_relaxed);
+            insert_count_.store(0, std::memory_order_relaxed);
+            remove_count_.store(0, std::memory_order_relaxed);
+            lookup_count_.store(0, std::memory_order_relaxed);
+            has_keys_.store(false, std::memory_order_release);
+        }
+        DeferredDestroyer::dispose(std::move(old));
     }
 
-    // Extract all elements from this shard (para dynamic scaling)
-    template<typename OutputIt>
-    void extract_all(OutputIt out) const {
-        std::lock_guard lock(mutex_);
-        extract_all_recursive(tree_.getRoot(), out);
+    // Desfragmentación online: reubica los nodos en orden BFS dentro de una
+    // arena nueva y libera la vieja. Avanza de a `step` nodos visitados y
+    // suelta el lock entre pasos, así los writers esperan a lo sumo un paso.
+    // La arena vieja se libera en el DeferredDestroyer, fuera del lock.
+    // Requiere un Tree con relocación (AVLTree)
+    static constexpr size_t DEFRAG_STEP = 4096;
+
+    template<typename T = Tree>
+    auto defragment(size_t step = DEFRAG_STEP)
+        -> decltype(std::declval<T&>().relocateStep(step), void()) {
+        {
+            std::lock_guard lock(mutex_);
+            tree_.beginRelocation();
+        }
+        for (;;) {
+            bool done;
+            {
+                std::lock_guard lock(mutex_);
+                done = tree_.relocateStep(step, [](auto old_arena) {
+                    DeferredDestroyer::dispose(std::move(old_arena));
+                });
+            }
+            if (done) break;
+            std::this_thread::yield();
+        }
     }
 
-private:
+    size_t memory_bytes() const {
+        std::shared_lock lock(mutex_);
+        return tree_.memoryBytes();
+    }
+
+    // Extract all elements from this shard (para dynamic scaling)
     template<typename OutputIt>
-    void extract_all_recursive(typename AVLTree<Key, Value>::Node* node, OutputIt out) const {
-        if (!node) return;
-        extract_all_recursive(node->left, out);
-        *out++ = std::make_pair(node->key, node->value);
-        extract_all_recursive(node->right, out);
+    void extract_all(OutputIt out) const {
+        std::shared_lock lock(mutex_);
+        tree_.forEach([&out](const Key& k, const Value& v) {
+            *out++ = std::make_pair(k, v);
+        });
     }
 };
 
@@ -0,0 +1,158 @@
+#ifndef SHARD_LOCK_HPP
+#define SHARD_LOCK_HPP
+
+#include "queue_lock.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+
+// =============================================================================
+// ShardLock - Lock de shard con prioridad de lectura configurable
+// =============================================================================
+//
+// Modos:
+//   EXCLUSIVE:       un Mutex (DefaultShardMutex, ver queue_lock.hpp);
+//                    lecturas y escrituras se serializan (default)
+//   READER_PRIORITY: lecturas concurrentes; un writer entra solo cuando no
+//                    hay lectores activos ni esperando. Protege el p99 de
+//                    lectura a costa de poder demorar writers indefinidamente
+//   FAIR:            lecturas concurrentes; con writers esperando entran a
+//                    lo sumo reads_per_write lectores más antes de que pase
+//                    uno. reads_per_write = 0 da prioridad a los writers
+//
+// READER_PRIORITY es FAIR con reads_per_write infinito: después de cada
+// escritura los lectores tienen reader_turns_ turnos por delante de los
+// writers que esperan.
+//
+// Cumple Lockable y SharedLockable (std::lock_guard / std::shared_lock). El
+// modo se fija con el shard sin uso: cambiarlo con el lock tomado rompe el
+// unlock correspondiente.
+//
+// contention_stats() son los del Mutex, o sea los del modo EXCLUSIVE; los
+// modos con lectores concurrentes esperan en condition variables propias.
+// =============================================================================
+
+enum class ShardLockMode {
+    EXCLUSIVE,
+    READER_PRIORITY,
+    FAIR
+};
+
+template<typename Mutex = DefaultShardMutex>
+class BasicShardLock {
+public:
+    static constexpr size_t DEFAULT_READS_PER_WRITE = 8;
+
+    BasicShardLock() = default;
+    BasicShardLock(const BasicShardLock&) = delete;
+    BasicShardLock& operator=(const BasicShardLock&) = delete;
+
+    void set_mode(ShardLockMode mode, size_t reads_per_write = DEFAULT_READS_PER_WRITE) {
+        std::lock_guard guard(mutex_);
+        mode_ = mode;
+        reads_per_write_ = mode == ShardLockMode::READER_PRIORITY
+            ? std::numeric_limits<size_t>::max() : reads_per_write;
+        reader_turns_ = reads_per_write_;
+    }
+
+    ShardLockMode mode() const { return mode_; }
+
+    size_t reads_per_write() const { return reads_per_write_; }
+
+    LockContentionStats contention_stats() const { return exclusive_.contention_stats(); }
+
+    // Threads bloqueados en lock() / lock_shared() (modos con lectores
+    // concurrentes; en EXCLUSIVE siempre 0). Un lector que entra sin esperar
+    // nunca se ve acá: el contador sube y baja sin soltar mutex_
+    size_t waiting_writers() const {
+        std::lock_guard guard(mutex_);
+        return waiting_writers_;
+    }
+
+    size_t waiting_readers() const {
+        std::lock_guard guard(mutex_);
+        return waiting_readers_;
+    }
+
+    void lock() {
+        if (mode_ == ShardLockMode::EXCLUSIVE) {
+            exclusive_.lock();
+            return;
+        }
+        std::unique_lock guard(mutex_);
+        waiting_writers_++;
+        writers_cv_.wait(guard, [this] {
+            return !writer_active_ && active_readers_ == 0 &&
+                   (waiting_readers_ == 0 || reader_turns_ == 0);
+        });
+        waiting_writers_--;
+        writer_active_ = true;
+    }
+
+    void unlock() {
+        if (mode_ == ShardLockMode::EXCLUSIVE) {
+            exclusive_.unlock();
+            return;
+        }
+        {
+            std::lock_guard guard(mutex_);
+            writer_active_ = false;
+            reader_turns_ = reads_per_write_;
+        }
+        readers_cv_.notify_all();
+        writers_cv_.notify_all();
+    }
+
+    void lock_shared() {
+        if (mode_ == ShardLockMode::EXCLUSIVE) {
+            exclusive_.lock();
+            return;
+        }
+        std::unique_lock guard(mutex_);
+        waiting_readers_++;
+        readers_cv_.wait(guard, [this] {
+            return !writer_active_ && (waiting_writers_ == 0 || reader_turns_ > 0);
+        });
+        waiting_readers_--;
+        active_readers_++;
+        if (waiting_writers_ > 0 && reader_turns_ != std::numeric_limits<size_t>::max()) {
+            reader_turns_--;
+        }
+    }
+
+    void unlock_shared() {
+        if (mode_ == ShardLockMode::EXCLUSIVE) {
+            exclusive_.unlock();
+            return;
+        }
+        bool wake_writer;
+        {
+            std::lock_guard guard(mutex_);
+            active_readers_--;
+            wake_writer = active_readers_ == 0 && waiting_writers_ > 0;
+        }
+        if (wake_writer) writers_cv_.notify_all();
+    }
+
+private:
+    // El lock en EXCLUSIVE
+    Mutex exclusive_;
+
+    // Estado de los modos con lectores concurrentes
+    mutable std::mutex mutex_;
+    std::condition_variable readers_cv_;
+    std::condition_variable writers_cv_;
+
+    ShardLockMode mode_ = ShardLockMode::EXCLUSIVE;
+    size_t reads_per_write_ = DEFAULT_READS_PER_WRITE;
+    size_t reader_turns_ = DEFAULT_READS_PER_WRITE;
+    size_t active_readers_ = 0;
+    size_t waiting_readers_ = 0;
+    size_t waiting_writers_ = 0;
+    bool writer_active_ = false;
+};
+
+using ShardLock = BasicShardLock<>;
+
+#endif // SHARD_LOCK_HPP
@@ -0,0 +1,424 @@
+#ifndef SKIPLIST_SHARD_HPP
+#define SKIPLIST_SHARD_HPP
+
+#include "epoch_reclaimer.hpp"
+#include <atomic>
+#include <optional>
+#include <limits>
+#include <new>
+#include <cstdint>
+
+// =============================================================================
+// SkipListShard - Skip list lock-free (Fraser / Herlihy-Shavit)
+// =============================================================================
+//
+// Backend para workloads con muchas escrituras: ninguna operación toma locks.
+//
+//   - Torres de punteros enlazadas con CAS. El bit bajo del puntero `next`
+//     marca al nodo como borrado lógicamente en ese nivel.
+//   - remove(): marca los niveles de arriba hacia abajo; quien marca el
+//     nivel 0 gana la remoción. El desenlace físico lo hace find() al
+//     encontrar nodos marcados en su camino.
+//   - insert() sobre una key existente reemplaza el valor con un swap
+//     atómico del puntero al valor.
+//   - get()/contains() no escriben memoria compartida.
+//
+// Reclamación: un nodo puede seguir enlazado en niveles superiores mientras
+// su insert todavía está construyendo la torre. Cada nodo tiene dos
+// referencias (insert + remove); quien suelta la última hace un find() final
+// que garantiza el desenlace en todos los niveles y lo retira via EpochReclaimer.
+//
+// Misma interfaz que TreeShard: ParallelAVL<K, V, SkipListShard<K, V>>.
+// =============================================================================
+
+template<typename Key, typename Value>
+class SkipListShard {
+private:
+    static constexpr int MAX_LEVEL = 20;   // p = 1/4 → ~4^20 elementos
+
+    struct Node {
+        const Key key;
+        const int top_level;
+        std::atomic<int> refs{2};          // insert en curso + remove pendiente
+        std::atomic<Value*> value;
+
+        Node(const Key& k, Value* v, int levels) : key(k), top_level(levels), value(v) {}
+
+        // La torre se aloja inmediatamente después del nodo
+        std::atomic<uintptr_t>* tower() {
+            return reinterpret_cast<std::atomic<uintptr_t>*>(this + 1);
+        }
+
+        std::atomic<uintptr_t>& next(int level) {
+            return tower()[level];
+        }
+
+        static Node* create(const Key& k, Value* v, int levels) {
+            void* mem = ::operator new(sizeof(Node) + levels * sizeof(std::atomic<uintptr_t>));
+            Node* n = new (mem) Node(k, v, levels);
+            for (int i = 0; i < levels; ++i) {
+                new (&n->tower()[i]) std::atomic<uintptr_t>(0);
+            }
+            return n;
+        }
+
+        static void destroy(void* p) {
+            Node* n = static_cast<Node*>(p);
+            delete n->value.load(std::memory_order_relaxed);
+            n->~Node();
+            ::operator delete(p);
+        }
+    };
+
+    static_assert(sizeof(Node) % alignof(std::atomic<uintptr_t>) == 0,
+                  "tower must be aligned after the node header");
+
+    static bool is_marked(uintptr_t p) { return (p & 1) != 0; }
+    static Node* ptr(uintptr_t p) { return reinterpret_cast<Node*>(p & ~uintptr_t{1}); }
+    static uintptr_t raw(Node* n) { return reinterpret_cast<uintptr_t>(n); }
+
+    Node* head_;
+
+    // Estadísticas atómicas (lock-free reads)
+    std::atomic<size_t> size_{0};
+    std::atomic<size_t> insert_count_{0};
+    std::atomic<size_t> remove_count_{0};
+    mutable std::atomic<size_t> lookup_count_{0};
+
+    // Bounds conservadores (sólo se ensanchan), igual que ConcurrentAVLShard
+    std::atomic<Key> min_key_{std::numeric_limits<Key>::max()};
+    std::atomic<Key> max_key_{std::numeric_limits<Key>::min()};
+    std::atomic<bool> has_keys_{false};
+
+    static int random_level() {
+        // xorshift por thread: sin estado compartido
+        thread_local uint64_t state =
+            0x9E3779B97F4A7C15ULL ^ reinterpret_cast<uintptr_t>(&state);
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        int level = 1;
+        uint64_t bits = state;
+        while (level < MAX_LEVEL && (bits & 3) == 0) {
+            ++level;
+            bits >>= 2;
+        }
+        return level;
+    }
+
+    void update_bounds(const Key& key) {
+        Key cur = min_key_.load(std::memory_order_relaxed);
+        while (key < cur && !min_key_.compare_exchange_weak(cur, key, std::memory_order_relaxed)) {}
+        cur = max_key_.load(std::memory_order_relaxed);
+        while (cur < key && !max_key_.compare_exchange_weak(cur, key, std::memory_order_relaxed)) {}
+        if (!has_keys_.load(std::memory_order_relaxed)) {
+            has_keys_.store(true, std::memory_order_release);
+        }
+    }
+
+    // Busca key llenando preds/succs por nivel y desenlaza nodos marcados en
+    // el camino. Devuelve true si hay un nodo no marcado con esa key.
+    bool find(const Key& key, Node** preds, Node** succs) const {
+    retry:
+        Node* pred = head_;
+        Node* curr = nullptr;
+        for (int level = MAX_LEVEL - 1; level >= 0; --level) {
+            curr = ptr(pred->next(level).load(std::memory_order_acquire));
+            while (curr) {
+                uintptr_t succ = curr->next(level).load(std::memory_order_acquire);
+                while (is_marked(succ)) {
+                    uintptr_t expected = raw(curr);
+                    if (!pred->next(level).compare_exchange_strong(expected, succ & ~uintptr_t{1},
+                                                                   std::memory_order_acq_rel)) {
+                        goto retry;
+                    }
+                    curr = ptr(succ);
+                    if (!curr) break;
+                    succ = curr->next(level).load(std::memory_order_acquire);
+                }
+                if (!curr) break;
+                if (curr->key < key) {
+                    pred = curr;
+                    curr = ptr(succ);
+                } else {
+                    break;
+                }
+            }
+            preds[level] = pred;
+            succs[level] = curr;
+        }
+        return curr && !(key < curr->key);
+    }
+
+    // Soltar una referencia; el último asegura el desenlace y retira el nodo
+    void release(Node* node) {
+        if (node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Node* preds[MAX_LEVEL];
+            Node* succs[MAX_LEVEL];
+            find(node->key, preds, succs);
+            EpochReclaimer::retire(node, &Node::destroy);
+        }
+    }
+
+    // Búsqueda sin escrituras: salta nodos marcados sin desenlazarlos
+    Node* find_readonly(const Key& key) const {
+        Node* pred = head_;
+        Node* curr = nullptr;
+        for (int level = MAX_LEVEL - 1; level >= 0; --level) {
+            curr = ptr(pred->next(level).load(std::memory_order_acquire));
+            while (curr) {
+                uintptr_t succ = curr->next(level).load(std::memory_order_acquire);
+                if (is_marked(succ)) {
+                    curr = ptr(succ);
+                } else if (curr->key < key) {
+                    pred = curr;
+                    curr = ptr(succ);
+                } else {
+                    break;
+                }
+            }
+        }
+        if (curr && !(key < curr->key) &&
+            !is_marked(curr->next(0).load(std::memory_order_acquire))) {
+            return curr;
+        }
+        return nullptr;
+    }
+
+    // Recorrido del nivel 0 desde la primera key >= lo (opcional)
+    template<typename F>
+    void scan(const Key* lo, const Key* hi, F emit) const {
+        EpochReclaimer::Guard guard;
+
+        Node* pred = head_;
+        if (lo) {
+            for (int level = MAX_LEVEL - 1; level >= 0; --level) {
+                Node* curr = ptr(pred->next(level).load(std::memory_order_acquire));
+                while (curr && curr->key < *lo) {
+                    pred = curr;
+                    curr = ptr(curr->next(level).load(std::memory_order_acquire));
+                }
+            }
+        }
+
+        Node* curr = ptr(pred->next(0).load(std::memory_order_acquire));
+        while (curr) {
+            if (hi && *hi < curr->key) break;
+            uintptr_t succ = curr->next(0).load(std::memory_order_acquire);
+            if (!is_marked(succ) && (!lo || !(curr->key < *lo))) {
+                Value* v = curr->value.load(std::memory_order_acquire);
+                if (!emit(curr->key, *v)) return;
+            }
+            curr = ptr(succ);
+        }
+    }
+
+public:
+    SkipListShard() : head_(Node::create(Key{}, nullptr, MAX_LEVEL)) {}
+
+    ~SkipListShard() {
+        Node* curr = ptr(head_->next(0).load(std::memory_order_relaxed));
+        while (curr) {
+            Node* next = ptr(curr->next(0).load(std::memory_order_relaxed));
+            Node::destroy(curr);
+            curr = next;
+        }
+        Node::destroy(head_);
+    }
+
+    SkipListShard(const SkipListShard&) = delete;
+    SkipListShard& operator=(const SkipListShard&) = delete;
+
+    // Operaciones básicas (lock-free)
+
+    void insert(const Key& key, const Value& value) {
+        EpochReclaimer::Guard guard;
+        insert_count_.fetch_add(1, std::memory_order_relaxed);
+
+        Value* nv = new Value(value);
+        int top = random_level();
+        Node* preds[MAX_LEVEL];
+        Node* succs[MAX_LEVEL];
+
+        while (true) {
+            if (find(key, preds, succs)) {
+                // Key existente: reemplazar el valor
+                Value* old = succs[0]->value.exchange(nv, std::memory_order_acq_rel);
+                EpochReclaimer::retire(old);
+                return;
+            }
+
+            Node* node = Node::create(key, nv, top);
+            for (int i = 0; i < top; ++i) {
+                node->next(i).store(raw(succs[i]), std::memory_order_relaxed);
+            }
+
+            uintptr_t expected = raw(succs[0]);
+            if (!preds[0]->next(0).compare_exchange_strong(expected, raw(node),
+                                                           std::memory_order_release)) {
+                // Nunca publicado: se libera directo (el valor se reutiliza)
+                node->value.store(nullptr, std::memory_order_relaxed);
+                Node::destroy(node);
+                continue;
+            }
+
+            // Linealizado en el nivel 0: completar la torre
+            size_.fetch_add(1, std::memory_order_relaxed);
+            update_bounds(key);
+
+            for (int level = 1; level < top; ++level) {
+                while (true) {
+                    uintptr_t cur_next = node->next(level).load(std::memory_order_acquire);
+                    if (is_marked(cur_next)) goto linked;  // removido mientras tanto
+                    if (ptr(cur_next) != succs[level] &&
+                        !node->next(level).compare_exchange_strong(cur_next, raw(succs[level]),
+                                                                   std::memory_order_acq_rel)) {
+                        continue;
+                    }
+                    uintptr_t exp = raw(succs[level]);
+                    if (preds[level]->next(level).compare_exchange_strong(exp, raw(node),
+                                                                          std::memory_order_release)) {
+                        break;
+                    }
+                    find(key, preds, succs);
+                    if (succs[0] != node) goto linked;
+                }
+            }
+        linked:
+            release(node);
+            return;
+        }
+    }
+
+    bool remove(const Key& key) {
+        EpochReclaimer::Guard guard;
+        Node* preds[MAX_LEVEL];
+        Node* succs[MAX_LEVEL];
+
+        if (!find(key, preds, succs)) return false;
+        Node* node = succs[0];
+
+        // Marcar niveles superiores
+        for (int level = node->top_level - 1; level >= 1; --level) {
+            uintptr_t succ = node->next(level).load(std::memory_order_acquire);
+            while (!is_marked(succ)) {
+                node->next(level).compare_exchange_weak(succ, succ | 1, std::memory_order_acq_rel);
+            }
+        }
+
+        // El nivel 0 decide quién gana
+        uintptr_t succ = node->next(0).load(std::memory_order_acquire);
+        while (true) {
+            if (is_marked(succ)) return false;
+            if (node->next(0).compare_exchange_weak(succ, succ | 1, std::memory_order_acq_rel)) {
+                size_.fetch_sub(1, std::memory_order_relaxed);
+                remove_count_.fetch_add(1, std::memory_order_relaxed);
+                release(node);
+                return true;
+            }
+        }
+    }
+
+    bool contains(const Key& key) const {
+        EpochReclaimer::Guard guard;
+        return find_readonly(key) != nullptr;
+    }
+
+    std::optional<Value> get(const Key& key) const {
+        EpochReclaimer::Guard guard;
+        Node* n = find_readonly(key);
+        if (!n) return std::nullopt;
+        return *n->value.load(std::memory_order_acquire);
+    }
+
+    // Lock-free reads de estadísticas
+    size_t size() const {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    size_t insert_count() const {
+        return insert_count_.load(std::memory_order_relaxed);
+    }
+
+    size_t remove_count() const {
+        return remove_count_.load(std::memory_order_relaxed);
+    }
+
+    size_t lookup_count() const {
+        return lookup_count_.load(std::memory_order_relaxed);
+    }
+
+    bool intersects_range(const Key& lo, const Key& hi) const {
+        if (!has_keys_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        Key shard_min = min_key_.load(std::memory_order_relaxed);
+        Key shard_max = max_key_.load(std::memory_order_relaxed);
+        return !(shard_max < lo || shard_min > hi);
+    }
+
+    // Range query lock-free: ordenada y sin duplicados (nivel 0 es una lista
+    // ordenada); las keys modificadas durante el scan pueden o no verse
+    template<typename OutputIt>
+    void range_query(const Key& lo, const Key& hi, OutputIt out) const {
+        scan(&lo, &hi, [&out](const Key& k, const Value& v) {
+            *out++ = std::make_pair(k, v);
+            return true;
+        });
+    }
+
+    struct Stats {
+        size_t size;
+        size_t inserts;
+        size_t removes;
+        size_t lookups;
+        std::optional<Key> min_key;
+        std::optional<Key> max_key;
+    };
+
+    Stats get_stats() const {
+        Stats stats;
+        stats.size = size_.load(std::memory_order_relaxed);
+        stats.inserts = insert_count_.load(std::memory_order_relaxed);
+        stats.removes = remove_count_.load(std::memory_order_relaxed);
+        stats.lookups = lookup_count_.load(std::memory_order_relaxed);
+
+        if (has_keys_.load(std::memory_order_acquire)) {
+            stats.min_key = min_key_.load(std::memory_order_relaxed);
+            stats.max_key = max_key_.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    // Clear: seguro con lectores concurrentes, no con escritores concurrentes
+    void clear() {
+        EpochReclaimer::Guard guard;
+        Node* curr = ptr(head_->next(0).load(std::memory_order_acquire));
+        for (int level = 0; level < MAX_LEVEL; ++level) {
+            head_->next(level).store(0, std::memory_order_release);
+        }
+        while (curr) {
+            Node* next = ptr(curr->next(0).load(std::memory_order_acquire));
+            EpochReclaimer::retire(curr, &Node::destroy);
+            curr = next;
+        }
+
+        size_.store(0, std::memory_order_relaxed);
+        insert_count_.store(0, std::memory_order_relaxed);
+        remove_count_.store(0, std::memory_order_relaxed);
+        lookup_count_.store(0, std::memory_order_relaxed);
+        min_key_.store(std::numeric_limits<Key>::max(), std::memory_order_relaxed);
+        max_key_.store(std::numeric_limits<Key>::min(), std::memory_order_relaxed);
+        has_keys_.store(false, std::memory_order_release);
+    }
+
+    template<typename OutputIt>
+    void extract_all(OutputIt out) const {
+        scan(nullptr, nullptr, [&out](const Key& k, const Value& v) {
+            *out++ = std::make_pair(k, v);
+            return true;
+        });
+    }
+};
+
+#endif // SKIPLIST_SHARD_HPP
@@ -0,0 +1,529 @@
+#ifndef TIERED_SHARD_HPP
+#define TIERED_SHARD_HPP
+
+#include "AVLTree.h"
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <atomic>
+#include <optional>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+
+// =============================================================================
+// TieredShard - AVL mutable + segmentos ordenados inmutables (layout Eytzinger)
+// =============================================================================
+//
+// En shards de lectura casi exclusiva, recorrer punteros de un AVL cuesta un
+// cache miss por nivel aunque los datos casi no cambien. TieredShard separa:
+//
+//   - delta_: un AVLTree chico con las escrituras recientes (incluye
+//     tombstones para los removes).
+//   - segments_: arrays ordenados inmutables en layout Eytzinger (BFS del
+//     árbol binario implícito). La búsqueda es branchless y los 4 niveles
+//     siguientes comparten línea de cache, así que se prefetchean juntos.
+//
+// Lecturas: delta_ primero, después segmentos del más nuevo al más viejo (el
+// primero que tiene la key decide, tombstone incluido). Range queries mezclan
+// todas las fuentes en orden.
+//
+// Compactación: cuando delta_ supera max(DELTA_MIN, datos/DELTA_RATIO) se
+// vuelca a un segmento nuevo. Política size-tiered: el segmento nuevo absorbe
+// a los más recientes mientras no sean más del doble de grandes, así hay
+// O(log n) segmentos y cada entrada se reescribe O(log n) veces. Los
+// tombstones se descartan al fusionar con el segmento más viejo.
+//
+// La fusión corre fuera del lock. Bajo el lock sólo se congela delta_ (pasa
+// a frozen_, que se sigue leyendo) y se eligen los segmentos a absorber; el
+// writer que cruzó el umbral arma el segmento nuevo sin lock, a partir de
+// fuentes inmutables, y lo instala bajo el lock con un swap de punteros.
+// Lecturas y demás escrituras no esperan la fusión: el lock se toma por
+// O(take) más lo que cueste mover un AVLTree. El costo O(n) de fusionar con
+// el segmento más viejo lo paga sólo el writer que disparó la compactación
+// (o quien llame a compact()). Una compactación a la vez por shard.
+//
+// Misma interfaz que TreeShard: ParallelAVL<K, V, TieredShard<K, V>>.
+// =============================================================================
+
+template<typename Key, typename Value>
+class TieredShard {
+public:
+    static constexpr size_t DELTA_MIN = 4096;
+    static constexpr size_t DELTA_RATIO = 8;
+
+private:
+    struct Entry {
+        Value value{};
+        bool tombstone = false;
+    };
+
+    using Run = std::vector<std::pair<Key, Entry>>;
+
+    // Array ordenado inmutable en layout Eytzinger, 1-based: los hijos de k
+    // son 2k y 2k+1. keys y entries separados para que la búsqueda sólo
+    // toque keys.
+    class Segment {
+        std::vector<Key> keys_;
+        std::vector<Entry> entries_;
+        size_t n_ = 0;
+
+        // Rellenar en in-order recorre el run ordenado en orden
+        void build(const Run& run, size_t& i, size_t k) {
+            if (k > n_) return;
+            build(run, i, 2 * k);
+            keys_[k] = run[i].first;
+            entries_[k] = run[i].second;
+            ++i;
+            build(run, i, 2 * k + 1);
+        }
+
+    public:
+        explicit Segment(const Run& run) : keys_(run.size() + 1), entries_(run.size() + 1), n_(run.size()) {
+            size_t i = 0;
+            build(run, i, 1);
+        }
+
+        size_t size() const { return n_; }
+
+        // Índice Eytzinger de la primera key >= x (0 si no hay)
+        size_t lower_bound(const Key& x) const {
+            const Key* keys = keys_.data();
+            size_t k = 1;
+            while (k <= n_) {
+                // 16 descendientes 4 niveles abajo: una línea de cache para keys de 4 bytes
+                __builtin_prefetch(reinterpret_cast<const void*>(
+                    reinterpret_cast<uintptr_t>(keys) + 16 * k * sizeof(Key)));
+                k = 2 * k + (keys[k] < x);
+            }
+            // Deshacer los pasos a la derecha finales: queda el último ancestro
+            // desde el que se bajó a la izquierda
+            k >>= __builtin_ffsll(static_cast<long long>(~k));
+            return k;
+        }
+
+        const Entry* find(const Key& x) const {
+            size_t k = lower_bound(x);
+            if (k && !(x < keys_[k])) return &entries_[k];
+            return nullptr;
+        }
+
+        // Sucesor in-order (0 al terminar)
+        size_t next(size_t k) const {
+            if (2 * k + 1 <= n_) {
+                k = 2 * k + 1;
+                while (2 * k <= n_) k = 2 * k;
+                return k;
+            }
+            while (k & 1) k >>= 1;
+            return k >> 1;
+        }
+
+        size_t first() const {
+            if (n_ == 0) return 0;
+            size_t k = 1;
+            while (2 * k <= n_) k = 2 * k;
+            return k;
+        }
+
+        const Key& key_at(size_t k) const { return keys_[k]; }
+        const Entry& entry_at(size_t k) const { return entries_[k]; }
+    };
+
+    // Cursor sobre un run ordenado (delta_) o un segmento, para el merge
+    struct Cursor {
+        const Run* run = nullptr;
+        const Segment* seg = nullptr;
+        size_t pos = 0;
+
+        bool valid() const { return run ? pos < run->size() : pos != 0; }
+        const Key& key() const { return run ? (*run)[pos].first : seg->key_at(pos); }
+        const Entry& entry() const { return run ? (*run)[pos].second : seg->entry_at(pos); }
+        void advance() { pos = run ? pos + 1 : seg->next(pos); }
+    };
+
+    // Merge de k vías. cursors[0] es la fuente más nueva: ante keys iguales
+    // gana el índice menor. emit devuelve false para cortar.
+    template<typename Emit>
+    static void merge(std::vector<Cursor>& cursors, const Key* hi, Emit emit) {
+        while (true) {
+            int best = -1;
+            for (size_t i = 0; i < cursors.size(); ++i) {
+                if (!cursors[i].valid()) continue;
+                if (best < 0 || cursors[i].key() < cursors[best].key()) best = static_cast<int>(i);
+            }
+            if (best < 0) return;
+            Key key = cursors[best].key();
+            if (hi && *hi < key) return;
+
+            if (!emit(key, cursors[best].entry())) return;
+            for (auto& c : cursors) {
+                if (c.valid() && !(key < c.key())) c.advance();
+            }
+        }
+    }
+
+    using Delta = AVLTree<Key, Entry>;
+    using SegmentPtr = std::shared_ptr<const Segment>;
+
+    // Compactación en curso: fuentes inmutables a fusionar fuera del lock
+    struct CompactionJob {
+        std::shared_ptr<const Delta> frozen;
+        std::vector<SegmentPtr> inputs;     // del más nuevo al más viejo
+        size_t merged_size = 0;
+        bool bottom = false;                // absorbe todos los segmentos
+        uint64_t epoch = 0;
+    };
+
+    Delta delta_;
+    std::shared_ptr<const Delta> frozen_;   // delta_ congelado mientras se compacta
+    std::vector<SegmentPtr> segments_;      // del más viejo al más nuevo
+    size_t compactions_ = 0;
+    uint64_t epoch_ = 0;                    // clear() invalida la compactación en curso
+    std::atomic<bool> compacting_{false};
+    std::condition_variable compaction_done_;
+    mutable std::mutex mutex_;
+
+    // Estadísticas atómicas (lock-free reads)
+    std::atomic<size_t> size_{0};
+    std::atomic<size_t> insert_count_{0};
+    std::atomic<size_t> remove_count_{0};
+    mutable std::atomic<size_t> lookup_count_{0};
+
+    std::atomic<Key> min_key_{std::numeric_limits<Key>::max()};
+    std::atomic<Key> max_key_{std::numeric_limits<Key>::min()};
+    std::atomic<bool> has_keys_{false};
+
+    // Entrada visible para key (tombstone incluido), o nullptr
+    const Entry* lookup_nl(const Key& key) const {
+        if (const Entry* e = delta_.find(key)) return e;
+        if (frozen_) {
+            if (const Entry* e = frozen_->find(key)) return e;
+        }
+        for (auto it = segments_.rbegin(); it != segments_.rend(); ++it) {
+            if (const Entry* e = (*it)->find(key)) return e;
+        }
+        return nullptr;
+    }
+
+    bool live_nl(const Key& key) const {
+        const Entry* e = lookup_nl(key);
+        return e && !e->tombstone;
+    }
+
+    size_t segment_entries_nl() const {
+        size_t total = 0;
+        for (const auto& s : segments_) total += s->size();
+        return total;
+    }
+
+    // Job a correr fuera del lock si delta_ pasó el umbral
+    std::optional<CompactionJob> maybe_compact_nl() {
+        if (compacting_.load(std::memory_order_relaxed)) return std::nullopt;
+        size_t threshold = std::max(DELTA_MIN, segment_entries_nl() / DELTA_RATIO);
+        if (delta_.size() < threshold) return std::nullopt;
+        return begin_compaction_nl(false);
+    }
+
+    // Bajo el lock: congela delta_ y elige los segmentos más nuevos a
+    // absorber (size-tiered). nullopt si no hay nada que fusionar
+    std::optional<CompactionJob> begin_compaction_nl(bool full) {
+        size_t merged_size = delta_.size();
+        size_t take = 0;
+        while (take < segments_.size()) {
+            const Segment& s = *segments_[segments_.size() - 1 - take];
+            if (!full && s.size() > 2 * merged_size) break;
+            merged_size += s.size();
+            ++take;
+        }
+        if (delta_.size() == 0 && take <= 1 && !full) return std::nullopt;
+
+        CompactionJob job;
+        job.frozen = std::make_shared<const Delta>(std::move(delta_));
+        delta_ = Delta();
+        frozen_ = job.frozen;
+        for (size_t i = 0; i < take; ++i) {
+            job.inputs.push_back(segments_[segments_.size() - 1 - i]);
+        }
+        job.merged_size = merged_size;
+        job.bottom = take == segments_.size();
+        job.epoch = epoch_;
+        compacting_.store(true, std::memory_order_relaxed);
+        return job;
+    }
+
+    // Sin lock: frozen y los segmentos de entrada no cambian más
+    static SegmentPtr build_segment(const CompactionJob& job) {
+        Run delta_run;
+        delta_run.reserve(job.frozen->size());
+        job.frozen->forEach([&delta_run](const Key& k, const Entry& e) {
+            delta_run.emplace_back(k, e);
+        });
+
+        std::vector<Cursor> cursors;
+        cursors.push_back(Cursor{&delta_run, nullptr, 0});
+        for (const auto& s : job.inputs) {
+            cursors.push_back(Cursor{nullptr, s.get(), s->first()});
+        }
+
+        Run merged;
+        merged.reserve(job.merged_size);
+        merge(cursors, nullptr, [&](const Key& k, const Entry& e) {
+            // Sin segmentos debajo, un tombstone ya no oculta nada
+            if (!(job.bottom && e.tombstone)) merged.emplace_back(k, e);
+            return true;
+        });
+        if (merged.empty()) return nullptr;
+        return std::make_shared<const Segment>(merged);
+    }
+
+    // Fusiona fuera del lock e instala el resultado. Los segmentos absorbidos
+    // y el delta congelado se liberan al destruir job, ya sin el lock
+    void run_compaction(CompactionJob& job) {
+        SegmentPtr merged = build_segment(job);
+        {
+            std::lock_guard lock(mutex_);
+            if (job.epoch == epoch_) {
+                // Sólo la compactación en curso toca segments_: los absorbidos
+                // siguen siendo los job.inputs.size() más nuevos
+                segments_.erase(segments_.end() - static_cast<std::ptrdiff_t>(job.inputs.size()),
+                                segments_.end());
+                if (merged) segments_.push_back(std::move(merged));
+                frozen_.reset();
+                ++compactions_;
+            }
+            compacting_.store(false, std::memory_order_relaxed);
+        }
+        compaction_done_.notify_all();
+    }
+
+    void update_bounds(const Key& key) {
+        if (!has_keys_.load(std::memory_order_relaxed)) {
+            min_key_.store(key, std::memory_order_relaxed);
+            max_key_.store(key, std::memory_order_relaxed);
+            has_keys_.store(true, std::memory_order_release);
+        } else {
+            if (key < min_key_.load(std::memory_order_relaxed)) {
+                min_key_.store(key, std::memory_order_relaxed);
+            }
+            if (key > max_key_.load(std::memory_order_relaxed)) {
+                max_key_.store(key, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Recorrido en orden de la vista combinada (sin tombstones)
+    template<typename F>
+    void scan_nl(const Key* lo, const Key* hi, F emit) const {
+        auto collect = [lo, hi](const Delta& tree) {
+            Run run;
+            auto add = [&run](const Key& k, const Entry& e) { run.emplace_back(k, e); };
+            if (lo && hi) {
+                tree.forEachInRange(*lo, *hi, add);
+            } else {
+                tree.forEach(add);
+            }
+            return run;
+        };
+        Run delta_run = collect(delta_);
+        Run frozen_run = frozen_ ? collect(*frozen_) : Run();
+
+        std::vector<Cursor> cursors;
+        cursors.push_back(Cursor{&delta_run, nullptr, 0});
+        cursors.push_back(Cursor{&frozen_run, nullptr, 0});
+        for (auto it = segments_.rbegin(); it != segments_.rend(); ++it) {
+            const Segment& seg = **it;
+            cursors.push_back(Cursor{nullptr, &seg, lo ? seg.lower_bound(*lo) : seg.first()});
+        }
+
+        merge(cursors, hi, [&emit](const Key& k, const Entry& e) {
+            if (!e.tombstone) emit(k, e.value);
+            return true;
+        });
+    }
+
+public:
+    TieredShard() = default;
+
+    // Operaciones básicas con locking
+
+    void insert(const Key& key, const Value& value) {
+        std::optional<CompactionJob> job;
+        {
+            std::lock_guard lock(mutex_);
+
+            bool existed = live_nl(key);
+            delta_.insert(key, Entry{value, false});
+
+            if (!existed) {
+                size_.fetch_add(1, std::memory_order_relaxed);
+                update_bounds(key);
+            }
+            insert_count_.fetch_add(1, std::memory_order_relaxed);
+            job = maybe_compact_nl();
+        }
+        if (job) run_compaction(*job);
+    }
+
+    bool remove(const Key& key) {
+        std::optional<CompactionJob> job;
+        {
+            std::lock_guard lock(mutex_);
+
+            if (!live_nl(key)) return false;
+
+            if (segments_.empty() && !frozen_) {
+                delta_.remove(key);        // nada debajo que ocultar
+            } else {
+                delta_.insert(key, Entry{Value{}, true});
+            }
+            remove_count_.fetch_add(1, std::memory_order_relaxed);
+
+            // Bounds conservadores: recalcular min/max exige un merge de todas
+            // las fuentes, así que sólo se resetean al vaciarse
+            if (size_.fetch_sub(1, std::memory_order_relaxed) == 1) {
+                has_keys_.store(false, std::memory_order_release);
+            }
+            job = maybe_compact_nl();
+        }
+        if (job) run_compaction(*job);
+        return true;
+    }
+
+    bool contains(const Key& key) const {
+        std::lock_guard lock(mutex_);
+        return live_nl(key);
+    }
+
+    std::optional<Value> get(const Key& key) const {
+        std::lock_guard lock(mutex_);
+        const Entry* e = lookup_nl(key);
+        if (e && !e->tombstone) {
+            return e->value;
+        }
+        return std::nullopt;
+    }
+
+    // Volcar delta_ y fusionar todos los segmentos en uno (p.ej. antes de
+    // una fase de sólo lectura). Espera a la compactación en curso; la
+    // fusión corre fuera del lock, así que lo escrito mientras tanto queda
+    // en delta_
+    void compact() {
+        std::optional<CompactionJob> job;
+        {
+            std::unique_lock lock(mutex_);
+            compaction_done_.wait(lock, [this] {
+                return !compacting_.load(std::memory_order_relaxed);
+            });
+            job = begin_compaction_nl(true);
+        }
+        if (job) run_compaction(*job);
+    }
+
+    // Hay una fusión corriendo fuera del lock
+    bool compacting() const {
+        return compacting_.load(std::memory_order_relaxed);
+    }
+
+    size_t segment_count() const {
+        std::lock_guard lock(mutex_);
+        return segments_.size();
+    }
+
+    size_t delta_size() const {
+        std::lock_guard lock(mutex_);
+        return delta_.size();
+    }
+
+    // Lock-free reads de estadísticas
+    size_t size() const {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    size_t insert_count() const {
+        return insert_count_.load(std::memory_order_relaxed);
+    }
+
+    size_t remove_count() const {
+        return remove_count_.load(std::memory_order_relaxed);
+    }
+
+    size_t lookup_count() const {
+        return lookup_count_.load(std::memory_order_relaxed);
+    }
+
+    bool intersects_range(const Key& lo, const Key& hi) const {
+        if (!has_keys_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        Key shard_min = min_key_.load(std::memory_order_relaxed);
+        Key shard_max = max_key_.load(std::memory_order_relaxed);
+        return !(shard_max < lo || shard_min > hi);
+    }
+
+    // Range query: merge ordenado de delta_ y segmentos
+    template<typename OutputIt>
+    void range_query(const Key& lo, const Key& hi, OutputIt out) const {
+        std::lock_guard lock(mutex_);
+        scan_nl(&lo, &hi, [&out](const Key& k, const Value& v) {
+            *out++ = std::make_pair(k, v);
+        });
+    }
+
+    struct Stats {
+        size_t size;
+        size_t inserts;
+        size_t removes;
+        size_t lookups;
+        std::optional<Key> min_key;
+        std::optional<Key> max_key;
+        size_t delta_size;
+        size_t segments;
+        size_t compactions;
+    };
+
+    Stats get_stats() const {
+        Stats stats;
+        stats.size = size_.load(std::memory_order_relaxed);
+        stats.inserts = insert_count_.load(std::memory_order_relaxed);
+        stats.removes = remove_count_.load(std::memory_order_relaxed);
+        stats.lookups = lookup_count_.load(std::memory_order_relaxed);
+
+        if (has_keys_.load(std::memory_order_acquire)) {
+            stats.min_key = min_key_.load(std::memory_order_relaxed);
+            stats.max_key = max_key_.load(std::memory_order_relaxed);
+        }
+
+        std::lock_guard lock(mutex_);
+        stats.delta_size = delta_.size();
+        stats.segments = segments_.size();
+        stats.compactions = compactions_;
+        return stats;
+    }
+
+    // Clear (para testing)
+    void clear() {
+        std::lock_guard lock(mutex_);
+        delta_ = Delta();
+        frozen_.reset();
+        segments_.clear();
+        ++epoch_;
+        size_.store(0, std::memory_order_relaxed);
+        insert_count_.store(0, std::memory_order_relaxed);
+        remove_count_.store(0, std::memory_order_relaxed);
+        lookup_count_.store(0, std::memory_order_relaxed);
+        has_keys_.store(false, std::memory_order_release);
+    }
+
+    template<typename OutputIt>
+    void extract_all(OutputIt out) const {
+        std::lock_guard lock(mutex_);
+        scan_nl(nullptr, nullptr, [&out](const Key& k, const Value& v) {
+            *out++ = std::make_pair(k, v);
+        });
+    }
+};
+
+#endif // TIERED_SHARD_HPP
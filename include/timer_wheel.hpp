@@ -0,0 +1,144 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// =============================================================================
+// TimerWheel - Timing wheel jerárquico (Varghese & Lauck)
+// =============================================================================
+//
+// LEVELS niveles de 64 slots. El nivel l cubre vencimientos a menos de
+// 64^(l+1) ticks; el slot es (vencimiento >> 6l) & 63. Cuando el nivel 0 da
+// la vuelta, el slot que toca del nivel 1 se reparte hacia abajo (cascade),
+// y así sucesivamente. Cada timer se mueve a lo sumo LEVELS veces: programar
+// y vencer cuesta O(1) amortizado, sin heap ni árbol ordenado.
+//
+// Con 4 niveles y ticks de 1 ms el horizonte es 64^4 ms (~4.6 h); un timer
+// más lejano espera en el último nivel y se reprograma al bajar.
+//
+// advance() salta de a 64 ticks mientras el nivel 0 está vacío, así que un
+// shard inactivo por mucho tiempo no paga un paso por tick.
+//
+// No es thread-safe: lo protege el lock del dueño (ej. CacheShard).
+// =============================================================================
+
+template<typename T>
+class TimerWheel {
+public:
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr size_t SLOTS = size_t(1) << SLOT_BITS;
+    static constexpr unsigned LEVELS = 4;
+
+private:
+    static constexpr uint64_t MASK = SLOTS - 1;
+    static constexpr uint64_t HORIZON = uint64_t(1) << (SLOT_BITS * LEVELS);
+
+    struct Timer {
+        uint64_t expires;
+        T payload;
+    };
+
+    std::vector<Timer> slots_[LEVELS][SLOTS];
+    size_t level_count_[LEVELS] = {};
+    size_t size_ = 0;
+    uint64_t now_;      // próximo tick a procesar; todo lo anterior ya venció
+
+    void place(Timer&& timer) {
+        uint64_t expires = timer.expires < now_ ? now_ : timer.expires;
+        uint64_t delta = expires - now_;
+        if (delta >= HORIZON) {
+            expires = now_ + HORIZON - 1;   // se reprograma al bajar
+            delta = HORIZON - 1;
+        }
+        unsigned level = 0;
+        while (delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) level++;
+        size_t slot = (expires >> (SLOT_BITS * level)) & MASK;
+        slots_[level][slot].push_back(std::move(timer));
+        level_count_[level]++;
+    }
+
+    // now_ acaba de cruzar un múltiplo de 64: bajar los niveles que tocan,
+    // de arriba hacia abajo para que lo que baja de un nivel alto se reparta
+    // en el mismo paso
+    void cascade() {
+        unsigned top = 1;
+        while (top + 1 < LEVELS && (now_ & ((uint64_t(1) << (SLOT_BITS * (top + 1))) - 1)) == 0) {
+            top++;
+        }
+        for (unsigned level = top; level >= 1; --level) {
+            size_t slot = (now_ >> (SLOT_BITS * level)) & MASK;
+            std::vector<Timer> timers;
+            timers.swap(slots_[level][slot]);
+            level_count_[level] -= timers.size();
+            for (auto& timer : timers) place(std::move(timer));
+        }
+    }
+
+public:
+    explicit TimerWheel(uint64_t start_tick = 0) : now_(start_tick) {}
+
+    // Programar payload para el tick expires (uno pasado vence en el próximo advance)
+    void schedule(uint64_t expires, T payload) {
+        place(Timer{expires, std::move(payload)});
+        size_++;
+    }
+
+    // Vencer todo lo programado para ticks <= now. on_expire(expires, payload)
+    // recibe cada timer en orden de tick. Devuelve cuántos vencieron.
+    template<typename F>
+    size_t advance(uint64_t now, F&& on_expire) {
+        size_t fired = 0;
+        while (now_ <= now) {
+            if (size_ == 0) {
+                now_ = now + 1;
+                break;
+            }
+            if (level_count_[0] == 0) {
+                // Nada en el nivel 0: saltar al próximo cruce
+                uint64_t next = (now_ | MASK) + 1;
+                if (next > now + 1) {
+                    now_ = now + 1;
+                    break;
+                }
+                now_ = next;
+                cascade();
+                continue;
+            }
+
+            std::vector<Timer>& slot = slots_[0][now_ & MASK];
+            if (!slot.empty()) {
+                std::vector<Timer> timers;
+                timers.swap(slot);
+                level_count_[0] -= timers.size();
+                size_ -= timers.size();
+                for (auto& timer : timers) {
+                    on_expire(timer.expires, timer.payload);
+                }
+                fired += timers.size();
+            }
+            now_++;
+            if ((now_ & MASK) == 0) cascade();
+        }
+        return fired;
+    }
+
+    // Timers pendientes (incluye los de entradas ya borradas o actualizadas)
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    uint64_t now() const { return now_; }
+
+    void clear() {
+        for (auto& level : slots_) {
+            for (auto& slot : level) slot.clear();
+        }
+        for (auto& count : level_count_) count = 0;
+        size_ = 0;
+    }
+};
+
+#endif // TIMER_WHEEL_HPP
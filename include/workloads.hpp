@@ -196,6 +196,78 @@ public:
     }
 };
 
+// Scrambled Zipfian (YCSB): ranking Zipf con θ = 0.99 sobre [0, n), como el
+// ZipfianGenerator de YCSB (Gray et al.), y el rango se pasa por FNV-1a para
+// repartir las keys calientes por todo el espacio en vez de agruparlas en
+// las keys bajas.
+//
+// next_rank() da el rango sin mezclar (0 = el más popular), que es lo que
+// necesita la distribución "latest" del workload D.
+//
+// zeta(n) cuesta O(n): con varios threads, calcular una vez y pasar
+// zeta_n() a los demás constructores.
+template<typename Key = int>
+class ScrambledZipfianGenerator : public WorkloadGenerator<Key> {
+private:
+    static constexpr double THETA = 0.99;
+
+    size_t n_;
+    double zeta_n_;
+    double alpha_;    // 1 / (1 - θ)
+    double eta_;
+
+    std::mt19937_64 gen_;
+    std::uniform_real_distribution<double> uniform_;
+
+    static double zeta(size_t n) {
+        double sum = 0.0;
+        for (size_t i = 1; i <= n; ++i) {
+            sum += 1.0 / std::pow(static_cast<double>(i), THETA);
+        }
+        return sum;
+    }
+
+    static uint64_t fnv1a(uint64_t value) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (int i = 0; i < 8; ++i) {
+            hash ^= value & 0xff;
+            hash *= 0x100000001b3ULL;
+            value >>= 8;
+        }
+        return hash;
+    }
+
+public:
+    ScrambledZipfianGenerator(size_t n, unsigned seed = std::random_device{}(),
+                              double zeta_n = 0.0)
+        : n_(n), zeta_n_(zeta_n > 0.0 ? zeta_n : zeta(n)),
+          alpha_(1.0 / (1.0 - THETA)), gen_(seed), uniform_(0.0, 1.0)
+    {
+        eta_ = (1.0 - std::pow(2.0 / n_, 1.0 - THETA)) / (1.0 - zeta(2) / zeta_n_);
+    }
+
+    size_t next_rank() {
+        double u = uniform_(gen_);
+        double uz = u * zeta_n_;
+
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + std::pow(0.5, THETA)) return 1;
+
+        size_t rank = static_cast<size_t>(n_ * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+        return rank < n_ ? rank : n_ - 1;
+    }
+
+    Key next() override {
+        return static_cast<Key>(fnv1a(next_rank()) % n_);
+    }
+
+    void reset() override {
+        // No state to reset
+    }
+
+    double zeta_n() const { return zeta_n_; }
+};
+
 // Factory para crear workloads
 template<typename Key = int>
 class WorkloadFactory {
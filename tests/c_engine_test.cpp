@@ -0,0 +1,245 @@
+#include "../include/c_engine_avl.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <map>
+#include <string>
+#include <cassert>
+#include <random>
+#include <iterator>
+#include <type_traits>
+
+// Tests del adaptador C++ sobre el motor en C (c_engine_avl.hpp).
+// Mismo contrato que ParallelAVL<int64_t, V>: se comparan contra un
+// std::map y se ejercitan el escalado dinámico y el acceso concurrente.
+
+struct Point {
+    int32_t x;
+    int16_t y;
+};
+
+// Selección automática del backend
+static_assert(std::is_same_v<AutoParallelAVL<int64_t, int64_t>, CEngineParallelAVL<int64_t>>);
+static_assert(std::is_same_v<AutoParallelAVL<int64_t, double>, CEngineParallelAVL<double>>);
+static_assert(std::is_same_v<AutoParallelAVL<int64_t, Point>, CEngineParallelAVL<Point>>);
+static_assert(std::is_same_v<AutoParallelAVL<int, int>, ParallelAVL<int, int>>);
+static_assert(std::is_same_v<AutoParallelAVL<int64_t, std::string>, ParallelAVL<int64_t, std::string>>);
+
+struct Wide { int64_t a, b; };
+static_assert(std::is_same_v<AutoParallelAVL<int64_t, Wide>, ParallelAVL<int64_t, Wide>>);
+
+template<typename Tree>
+static void check_against_model(const Tree& tree, const std::map<int64_t, int64_t>& model) {
+    assert(tree.size() == model.size());
+    for (const auto& [key, value] : model) {
+        auto got = tree.get(key);
+        assert(got.has_value() && *got == value);
+    }
+    (void)tree;
+}
+
+// Test 1: Modelo secuencial contra std::map. Solo estrategias que ubican
+// cada key en un shard fijo: con LOAD_AWARE / INTELLIGENT reinsertar una key
+// existente puede caer en otro shard (igual que en la versión template).
+void test_sequential_model() {
+    std::cout << "\n[TEST] Sequential model check" << std::endl;
+
+    using Strategy = CEngineParallelAVL<int64_t>::RouterStrategy;
+    for (Strategy strategy : {Strategy::STATIC_HASH, Strategy::CONSISTENT_HASH}) {
+        AutoParallelAVL<int64_t, int64_t> tree(8, strategy);
+        std::map<int64_t, int64_t> model;
+        std::mt19937_64 rng(42);
+
+        for (int i = 0; i < 50000; ++i) {
+            int64_t key = static_cast<int64_t>(rng() % 5000) - 2500;
+            switch (rng() % 4) {
+                case 0:
+                case 1: {
+                    int64_t value = static_cast<int64_t>(rng());
+                    tree.insert(key, value);
+                    model[key] = value;
+                    break;
+                }
+                case 2:
+                    assert(tree.remove(key) == (model.erase(key) == 1));
+                    break;
+                default: {
+                    auto got = tree.get(key);
+                    auto it = model.find(key);
+                    assert(got.has_value() == (it != model.end()));
+                    assert(!got.has_value() || *got == it->second);
+                    assert(tree.contains(key) == got.has_value());
+                }
+            }
+        }
+        check_against_model(tree, model);
+
+        std::cout << "  ✓ " << model.size() << " keys match std::map" << std::endl;
+    }
+}
+
+// Test 2: Valores inline de distintos tipos
+void test_inline_values() {
+    std::cout << "\n[TEST] Inline value types" << std::endl;
+
+    AutoParallelAVL<int64_t, double> doubles(4);
+    doubles.insert(1, 3.25);
+    doubles.insert(-7, -0.5);
+    assert(doubles.get(1).value() == 3.25);
+    assert(doubles.get(-7).value() == -0.5);
+
+    AutoParallelAVL<int64_t, Point> points(4);
+    points.insert(10, Point{-123456, 77});
+    auto p = points.get(10);
+    assert(p.has_value() && p->x == -123456 && p->y == 77);
+    assert(!points.get(11).has_value());
+
+    // Un valor "cero" sigue siendo un valor encontrado
+    AutoParallelAVL<int64_t, int64_t> zeros(4);
+    zeros.insert(5, 0);
+    assert(zeros.get(5).has_value() && *zeros.get(5) == 0);
+
+    std::cout << "  ✓ double, struct and zero values round-trip" << std::endl;
+}
+
+// Test 3: range_query ordenado, también más allá de una página
+void test_range_query() {
+    std::cout << "\n[TEST] Range query" << std::endl;
+
+    AutoParallelAVL<int64_t, int64_t> tree(6);
+    for (int64_t k = 0; k < 5000; ++k) {
+        tree.insert(k * 2, k);
+    }
+
+    std::vector<std::pair<int64_t, int64_t>> out;
+    tree.range_query(100, 4100, std::back_inserter(out));
+    assert(out.size() == 2001);
+    for (size_t i = 0; i < out.size(); ++i) {
+        assert(out[i].first == 100 + static_cast<int64_t>(i) * 2);
+        assert(out[i].second == out[i].first / 2);
+    }
+
+    out.clear();
+    tree.range_query(INT64_MIN, INT64_MAX, std::back_inserter(out));
+    assert(out.size() == 5000);
+
+    out.clear();
+    tree.range_query(10, 5, std::back_inserter(out));
+    assert(out.empty());
+
+    std::cout << "  ✓ sorted, paged and empty ranges" << std::endl;
+}
+
+// Test 4: get_batch igual a get() key por key
+void test_get_batch() {
+    std::cout << "\n[TEST] Batched get" << std::endl;
+
+    AutoParallelAVL<int64_t, int64_t> tree(8);
+    for (int64_t k = 0; k < 1000; k += 3) {
+        tree.insert(k, k * 10);
+    }
+
+    std::vector<int64_t> keys;
+    for (int64_t k = 0; k < 1000; ++k) keys.push_back(k);
+    auto results = tree.get_batch(keys);
+    assert(results.size() == keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        assert(results[i] == tree.get(keys[i]));
+    }
+
+    std::cout << "  ✓ " << keys.size() << " keys" << std::endl;
+}
+
+// Test 5: add_shard / remove_shard / force_rebalance conservan los datos
+void test_dynamic_scaling() {
+    std::cout << "\n[TEST] Dynamic scaling" << std::endl;
+
+    using Strategy = CEngineParallelAVL<int64_t>::RouterStrategy;
+    for (Strategy strategy : {Strategy::STATIC_HASH, Strategy::LOAD_AWARE,
+                              Strategy::CONSISTENT_HASH, Strategy::INTELLIGENT}) {
+        AutoParallelAVL<int64_t, int64_t> tree(4, strategy);
+        std::map<int64_t, int64_t> model;
+        for (int64_t k = 0; k < 8000; ++k) {
+            tree.insert(k, -k);
+            model[k] = -k;
+        }
+
+        tree.add_shard();
+        tree.add_shard();
+        assert(tree.get_num_shards() == 6);
+        check_against_model(tree, model);
+
+        tree.remove_shard();
+        assert(tree.get_num_shards() == 5);
+        check_against_model(tree, model);
+
+        tree.force_rebalance();
+        check_against_model(tree, model);
+
+        auto stats = tree.get_stats();
+        assert(stats.num_shards == 5);
+        assert(stats.total_size == model.size());
+        assert(stats.shard_sizes.size() == 5);
+        size_t sum = 0;
+        for (size_t s : stats.shard_sizes) sum += s;
+        assert(sum == model.size());
+        assert(!stats.migrating);
+        double balance = tree.get_balance_score();
+        assert(balance >= 0.0 && balance <= 1.0);
+        (void)balance;
+    }
+
+    std::cout << "  ✓ contents preserved for every strategy" << std::endl;
+}
+
+// Test 6: Escritores y lectores concurrentes sobre keys disjuntas
+void test_concurrent() {
+    std::cout << "\n[TEST] Concurrent writers and readers" << std::endl;
+
+    constexpr size_t NUM_THREADS = 8;
+    constexpr int64_t PER_THREAD = 5000;
+    AutoParallelAVL<int64_t, int64_t> tree(8, CEngineParallelAVL<int64_t>::RouterStrategy::STATIC_HASH);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&tree, t]() {
+            int64_t base = static_cast<int64_t>(t) * PER_THREAD;
+            for (int64_t k = base; k < base + PER_THREAD; ++k) {
+                tree.insert(k, k + 1);
+                auto got = tree.get(k);
+                assert(got.has_value() && *got == k + 1);
+                (void)got;
+            }
+            for (int64_t k = base; k < base + PER_THREAD; k += 2) {
+                assert(tree.remove(k));
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    assert(tree.size() == NUM_THREADS * PER_THREAD / 2);
+    for (int64_t k = 0; k < static_cast<int64_t>(NUM_THREADS) * PER_THREAD; ++k) {
+        assert(tree.contains(k) == (k % 2 == 1));
+    }
+
+    tree.clear();
+    assert(tree.size() == 0);
+
+    std::cout << "  ✓ " << NUM_THREADS << " threads" << std::endl;
+}
+
+int main() {
+    std::cout << "╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  C Engine Adapter Test Suite               ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    test_sequential_model();
+    test_inline_values();
+    test_range_query();
+    test_get_batch();
+    test_dynamic_scaling();
+    test_concurrent();
+
+    std::cout << "\n✓ All C engine adapter tests passed" << std::endl;
+    return 0;
+}
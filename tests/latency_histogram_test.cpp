@@ -0,0 +1,138 @@
+#include "../include/latency_histogram.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// Tests para LatencyHistogram (latency_histogram.hpp)
+
+// Error relativo máximo de un bucket: 1 / SUB_BUCKETS
+static bool within_precision(uint64_t reported, uint64_t exact) {
+    if (exact < LatencyHistogram::SUB_BUCKETS) return reported == exact;
+    double error = std::abs(static_cast<double>(reported) - static_cast<double>(exact)) / exact;
+    return error <= 1.0 / LatencyHistogram::SUB_BUCKETS;
+}
+
+void test_bucket_bounds() {
+    std::cout << "\n[TEST] Bucket bounds" << std::endl;
+
+    // Cada bucket cubre un rango contiguo y el siguiente empieza justo después
+    for (size_t i = 0; i + 1 < LatencyHistogram::BUCKETS; ++i) {
+        uint64_t lo = LatencyHistogram::lowest_equivalent(i);
+        uint64_t hi = LatencyHistogram::highest_equivalent(i);
+        assert(lo <= hi);
+        assert(LatencyHistogram::bucket_of(lo) == i);
+        assert(LatencyHistogram::bucket_of(hi) == i);
+        assert(LatencyHistogram::lowest_equivalent(i + 1) == hi + 1);
+    }
+    assert(LatencyHistogram::bucket_of(LatencyHistogram::MAX_VALUE) == LatencyHistogram::BUCKETS - 1);
+    assert(LatencyHistogram::highest_equivalent(LatencyHistogram::BUCKETS - 1) ==
+           LatencyHistogram::MAX_VALUE);
+
+    std::cout << "  ✓ " << LatencyHistogram::BUCKETS << " contiguous buckets, "
+              << sizeof(LatencyHistogram) << " bytes" << std::endl;
+}
+
+void test_percentiles_match_sorted() {
+    std::cout << "\n[TEST] Percentiles vs sorted samples" << std::endl;
+
+    std::mt19937_64 rng(12345);
+    std::lognormal_distribution<double> dist(7.0, 1.5);   // ~1 μs, cola larga
+
+    LatencyHistogram hist;
+    std::vector<uint64_t> samples;
+    for (size_t i = 0; i < 200000; ++i) {
+        uint64_t ns = static_cast<uint64_t>(dist(rng));
+        samples.push_back(ns);
+        hist.record(ns);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    for (double q : {0.5, 0.9, 0.99, 0.999, 0.9999}) {
+        size_t rank = static_cast<size_t>(std::ceil(q * samples.size()));
+        uint64_t exact = samples[rank - 1];
+        uint64_t reported = hist.percentile(q);
+        assert(reported >= exact && "Never underestimates");
+        assert(within_precision(reported, exact));
+    }
+    assert(hist.count() == samples.size());
+    assert(hist.min() == samples.front());
+    assert(hist.max() == samples.back());
+    assert(hist.percentile(1.0) == samples.back());
+
+    auto s = hist.summary();
+    std::cout << "  p50 " << s.p50 << " ns, p99 " << s.p99 << " ns, p99.99 " << s.p9999
+              << " ns, max " << s.max << " ns" << std::endl;
+    std::cout << "  ✓ p50..p99.99 within " << (100.0 / LatencyHistogram::SUB_BUCKETS)
+              << "% of exact" << std::endl;
+}
+
+void test_merge_threads() {
+    std::cout << "\n[TEST] Per-thread recording + merge" << std::endl;
+
+    constexpr size_t NUM_THREADS = 8;
+    constexpr uint64_t PER_THREAD = 50000;
+    std::vector<LatencyHistogram> per_thread(NUM_THREADS);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&per_thread, t]() {
+            for (uint64_t i = 0; i < PER_THREAD; ++i) {
+                per_thread[t].record(t * PER_THREAD + i);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    LatencyHistogram total;
+    for (const auto& h : per_thread) total.merge(h);
+
+    uint64_t n = NUM_THREADS * PER_THREAD;
+    assert(total.count() == n);
+    assert(total.min() == 0);
+    assert(total.max() == n - 1);
+    assert(std::abs(total.mean() - (n - 1) / 2.0) < 1e-6);
+    assert(within_precision(total.percentile(0.5), n / 2 - 1));
+
+    LatencyHistogram copy = total;
+    assert(copy.count() == n && copy.percentile(0.99) == total.percentile(0.99));
+    total.reset();
+    assert(total.count() == 0 && total.percentile(0.5) == 0 && total.min() == 0);
+
+    std::cout << "  ✓ " << NUM_THREADS << " threads merged" << std::endl;
+}
+
+void test_edge_values() {
+    std::cout << "\n[TEST] Edge values" << std::endl;
+
+    LatencyHistogram hist;
+    assert(hist.summary().count == 0 && hist.mean() == 0.0);
+
+    hist.record(0);
+    hist.record(std::chrono::microseconds(3));
+    hist.record(UINT64_MAX);   // se satura en MAX_VALUE
+    assert(hist.count() == 3);
+    assert(hist.min() == 0);
+    assert(hist.max() == LatencyHistogram::MAX_VALUE);
+    assert(hist.percentile(0.0) == 0);
+    assert(within_precision(hist.percentile(0.5), 3000));
+
+    std::cout << "  ✓ zero, chrono durations and overflow" << std::endl;
+}
+
+int main() {
+    std::cout << "\n╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  Latency Histogram Test Suite              ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    test_bucket_bounds();
+    test_percentiles_match_sorted();
+    test_merge_threads();
+    test_edge_values();
+
+    std::cout << "\n✓ All latency histogram tests passed" << std::endl;
+    return 0;
+}
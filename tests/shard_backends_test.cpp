@@ -0,0 +1,1180 @@
+#include "../include/parallel_avl.hpp"
+#include "../include/concurrent_avl_shard.hpp"
+#include "../include/skiplist_shard.hpp"
+#include "../include/tiered_shard.hpp"
+#include "../include/cache_shard.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <map>
+#include <string>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <type_traits>
+
+// Tests de implementaciones de shard intercambiables.
+// Cada backend corre la misma batería: modelo secuencial contra std::map,
+// escritores concurrentes, lectores concurrentes con escritores, e
+// integración con ParallelAVL.
+
+template<typename T, typename = void>
+struct has_validate : std::false_type {};
+
+template<typename T>
+struct has_validate<T, std::void_t<decltype(std::declval<const T&>().validate())>> : std::true_type {};
+
+template<typename Shard>
+class ShardBackendTest {
+private:
+    static constexpr size_t NUM_THREADS = 8;
+    static constexpr int KEY_SPACE = 4000;
+
+    const char* name_;
+
+    template<typename Func>
+    void run_concurrent(size_t num_threads, Func func) {
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i) {
+            threads.emplace_back(func, i);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    static void check_invariants(const Shard& shard) {
+        if constexpr (has_validate<Shard>::value) {
+            assert(shard.validate() && "Shard invariants violated!");
+        }
+        (void)shard;
+    }
+
+public:
+    explicit ShardBackendTest(const char* name) : name_(name) {}
+
+    // Test 1: Operaciones secuenciales contra un modelo std::map
+    void test_sequential_model() {
+        std::cout << "\n[TEST] " << name_ << " - Sequential model check" << std::endl;
+
+        Shard shard;
+        std::map<int, int> model;
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> key_dist(0, 999);
+        std::uniform_int_distribution<int> op_dist(0, 9);
+
+        for (int i = 0; i < 20000; ++i) {
+            int key = key_dist(gen);
+            int op = op_dist(gen);
+
+            if (op < 4) {
+                shard.insert(key, i);
+                model[key] = i;
+            } else if (op < 7) {
+                bool removed = shard.remove(key);
+                assert(removed == (model.erase(key) == 1));
+            } else {
+                auto result = shard.get(key);
+                auto it = model.find(key);
+                assert(result.has_value() == (it != model.end()));
+                if (result) assert(*result == it->second);
+                assert(shard.contains(key) == (it != model.end()));
+            }
+
+            if (i % 1000 == 0) {
+                int lo = key_dist(gen);
+                int hi = lo + 200;
+                std::vector<std::pair<int, int>> got;
+                shard.range_query(lo, hi, std::back_inserter(got));
+                std::vector<std::pair<int, int>> expected(model.lower_bound(lo), model.upper_bound(hi));
+                assert(got == expected && "Range query mismatch!");
+            }
+        }
+
+        assert(shard.size() == model.size());
+
+        std::vector<std::pair<int, int>> all;
+        shard.extract_all(std::back_inserter(all));
+        std::vector<std::pair<int, int>> expected(model.begin(), model.end());
+        assert(all == expected && "extract_all mismatch!");
+
+        check_invariants(shard);
+
+        shard.clear();
+        assert(shard.size() == 0);
+        assert(!shard.contains(expected.empty() ? 0 : expected.front().first));
+
+        std::cout << "  ✓ " << model.size() << " keys match std::map" << std::endl;
+    }
+
+    // Test 2: Escritores concurrentes sobre keys disjuntas del mismo shard
+    void test_concurrent_writers() {
+        std::cout << "\n[TEST] " << name_ << " - Concurrent writers" << std::endl;
+
+        Shard shard;
+        run_concurrent(NUM_THREADS, [&](size_t tid) {
+            for (int k = static_cast<int>(tid); k < KEY_SPACE; k += NUM_THREADS) {
+                shard.insert(k, k * 2);
+            }
+            // Remover la mitad de las propias
+            for (int k = static_cast<int>(tid); k < KEY_SPACE; k += 2 * NUM_THREADS) {
+                bool removed = shard.remove(k);
+                assert(removed);
+                (void)removed;
+            }
+        });
+
+        size_t missing = 0, unexpected = 0;
+        for (int k = 0; k < KEY_SPACE; ++k) {
+            bool should_exist = (k % (2 * NUM_THREADS)) >= static_cast<int>(NUM_THREADS);
+            auto v = shard.get(k);
+            if (should_exist && (!v || *v != k * 2)) missing++;
+            if (!should_exist && v) unexpected++;
+        }
+
+        assert(shard.size() == KEY_SPACE / 2);
+        check_invariants(shard);
+
+        std::cout << "  Missing: " << missing << ", unexpected: " << unexpected << std::endl;
+        assert(missing == 0 && unexpected == 0 && "Concurrent writer results incorrect!");
+        std::cout << "  ✓ Final contents exact after concurrent churn" << std::endl;
+    }
+
+    // Test 3: Lectores concurrentes con escritores (keys estables siempre visibles)
+    void test_readers_with_writers() {
+        std::cout << "\n[TEST] " << name_ << " - Readers concurrent with writers" << std::endl;
+
+        Shard shard;
+        // Keys pares: estables durante todo el test
+        for (int k = 0; k < KEY_SPACE; k += 2) {
+            shard.insert(k, k);
+        }
+
+        std::atomic<bool> stop{false};
+        std::atomic<size_t> read_failures{0};
+        std::atomic<size_t> range_failures{0};
+
+        run_concurrent(NUM_THREADS, [&](size_t tid) {
+            std::mt19937 gen(static_cast<unsigned>(tid));
+            std::uniform_int_distribution<int> dist(0, KEY_SPACE / 2 - 1);
+
+            if (tid < NUM_THREADS / 2) {
+                // Escritores: churn sobre keys impares
+                for (int i = 0; i < 20000; ++i) {
+                    int k = dist(gen) * 2 + 1;
+                    if (i % 2 == 0) shard.insert(k, k);
+                    else shard.remove(k);
+                }
+                if (tid == 0) stop.store(true);
+            } else {
+                while (!stop.load()) {
+                    int k = dist(gen) * 2;
+                    auto v = shard.get(k);
+                    if (!v || *v != k) read_failures.fetch_add(1);
+
+                    // Range query: ordenada y con todas las pares del rango
+                    int lo = dist(gen) * 2;
+                    int hi = lo + 100;
+                    std::vector<std::pair<int, int>> got;
+                    shard.range_query(lo, hi, std::back_inserter(got));
+                    size_t evens = 0;
+                    for (size_t j = 0; j < got.size(); ++j) {
+                        if (j > 0 && !(got[j - 1].first < got[j].first)) range_failures.fetch_add(1);
+                        if (got[j].first % 2 == 0) evens++;
+                    }
+                    size_t expected_evens = static_cast<size_t>((std::min(hi, KEY_SPACE - 2) - lo) / 2 + 1);
+                    if (evens != expected_evens) range_failures.fetch_add(1);
+                }
+            }
+        });
+
+        check_invariants(shard);
+
+        std::cout << "  Read failures: " << read_failures.load()
+                  << ", range failures: " << range_failures.load() << std::endl;
+        assert(read_failures.load() == 0 && "Stable key not visible during writes!");
+        assert(range_failures.load() == 0 && "Inconsistent range query during writes!");
+        std::cout << "  ✓ Readers never missed stable keys" << std::endl;
+    }
+
+    // Test 4: Integración con ParallelAVL (insert-then-contains)
+    void test_parallel_avl_integration() {
+        std::cout << "\n[TEST] " << name_ << " - ParallelAVL integration" << std::endl;
+
+        ParallelAVL<int, int, Shard> tree(4);
+        std::atomic<size_t> failures{0};
+
+        run_concurrent(NUM_THREADS, [&](size_t tid) {
+            std::mt19937 gen(static_cast<unsigned>(tid));
+            std::uniform_int_distribution<int> dist(0, 9999);
+            for (int i = 0; i < 2000; ++i) {
+                int key = dist(gen);
+                tree.insert(key, key);
+                if (!tree.contains(key)) failures.fetch_add(1);
+            }
+        });
+
+        std::vector<std::pair<int, int>> all;
+        tree.range_query(0, 9999, std::back_inserter(all));
+        assert(all.size() == tree.size());
+
+        assert(failures.load() == 0 && "Linearizability violation with custom shard!");
+
+        // get_batch debe coincidir con get() key por key (incluye ausentes)
+        std::vector<int> batch;
+        for (int k = 0; k < 10000; k += 3) batch.push_back(k);
+        auto batched = tree.get_batch(batch);
+        assert(batched.size() == batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            assert(batched[i] == tree.get(batch[i]) && "get_batch mismatch!");
+        }
+
+        std::cout << "  ✓ " << tree.size() << " keys, all inserts immediately visible" << std::endl;
+    }
+
+    void run_all() {
+        test_sequential_model();
+        test_concurrent_writers();
+        test_readers_with_writers();
+        test_parallel_avl_integration();
+    }
+};
+
+// Estructura de los árboles secuenciales alternativos (B+-tree, ART):
+// crecimiento y encogimiento en varios niveles contra std::map. Cubre keys de
+// 32/64 bits, signed y unsigned (rutas SIMD y orden de bytes).
+template<typename Tree, typename Key>
+void test_tree_structure(const char* name) {
+    std::cout << "\n[TEST] " << name << " - Structure under churn" << std::endl;
+
+    Tree tree;
+    std::map<Key, int> model;
+    std::mt19937_64 gen(7);
+    std::uniform_int_distribution<int> key_dist(0, 49999);
+    std::uniform_int_distribution<int> op_dist(0, 9);
+
+    // Mitad keys densas, mitad espaciadas por todo el rango del tipo
+    // (incluye negativos si es signed)
+    auto make_key = [](int k) {
+        if (k & 1) return static_cast<Key>(k / 2);
+        return static_cast<Key>(static_cast<Key>(k) * static_cast<Key>(40503) - static_cast<Key>(1000000));
+    };
+    auto check_invariants = [&tree]() {
+        if constexpr (has_validate<Tree>::value) {
+            assert(tree.validate() && "Tree invariants violated!");
+        }
+    };
+
+    for (int i = 0; i < 200000; ++i) {
+        Key key = make_key(key_dist(gen));
+        // Fase 1 crece, fase 2 encoge: ejercita splits y luego merges
+        bool grow = i < 100000 ? op_dist(gen) < 7 : op_dist(gen) < 3;
+
+        if (grow) {
+            tree.insert(key, i);
+            model[key] = i;
+        } else {
+            tree.remove(key);
+            model.erase(key);
+        }
+
+        if (i % 5000 == 0) {
+            check_invariants();
+            Key lo = make_key(key_dist(gen));
+            Key hi = lo + static_cast<Key>(500000);
+            if (hi < lo) std::swap(lo, hi);
+            std::vector<std::pair<Key, int>> got;
+            tree.forEachInRange(lo, hi, [&got](const Key& k, const int& v) { got.emplace_back(k, v); });
+            std::vector<std::pair<Key, int>> expected(model.lower_bound(lo), model.upper_bound(hi));
+            assert(got == expected && "Range scan mismatch!");
+        }
+    }
+
+    check_invariants();
+    assert(tree.size() == model.size());
+    for (const auto& [k, v] : model) {
+        const int* found = tree.find(k);
+        assert(found && *found == v);
+        (void)found; (void)v;
+    }
+    if (!model.empty()) {
+        assert(tree.minKey() == model.begin()->first);
+        assert(tree.maxKey() == model.rbegin()->first);
+    }
+
+    // Vaciar completamente: la raíz debe colapsar
+    for (const auto& kv : model) {
+        tree.remove(kv.first);
+    }
+    assert(tree.size() == 0);
+    check_invariants();
+
+    std::cout << "  ✓ " << model.size() << " keys, invariants hold through splits and merges" << std::endl;
+}
+
+// TieredShard: suficientes escrituras para disparar compactaciones, con
+// tombstones sobre segmentos y un compact() total al final
+void test_tiered_compaction() {
+    std::cout << "\n[TEST] TieredShard - Compaction with tombstones" << std::endl;
+
+    TieredShard<int, int> shard;
+    std::map<int, int> model;
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> key_dist(0, 59999);
+    std::uniform_int_distribution<int> op_dist(0, 9);
+
+    for (int i = 0; i < 150000; ++i) {
+        int key = key_dist(gen);
+        int op = op_dist(gen);
+        if (op < 5) {
+            shard.insert(key, i);
+            model[key] = i;
+        } else if (op < 8) {
+            bool removed = shard.remove(key);
+            assert(removed == (model.erase(key) == 1));
+            (void)removed;
+        } else {
+            auto v = shard.get(key);
+            auto it = model.find(key);
+            assert(v.has_value() == (it != model.end()));
+            if (v) assert(*v == it->second);
+        }
+
+        if (i % 10000 == 0) {
+            int lo = key_dist(gen);
+            std::vector<std::pair<int, int>> got;
+            shard.range_query(lo, lo + 3000, std::back_inserter(got));
+            std::vector<std::pair<int, int>> expected(model.lower_bound(lo), model.upper_bound(lo + 3000));
+            assert(got == expected && "Tiered range query mismatch!");
+        }
+    }
+
+    auto stats = shard.get_stats();
+    assert(stats.compactions > 0 && stats.segments > 0);
+    assert(shard.size() == model.size());
+
+    shard.compact();
+    assert(shard.segment_count() == 1 && shard.delta_size() == 0);
+
+    std::vector<std::pair<int, int>> all;
+    shard.extract_all(std::back_inserter(all));
+    std::vector<std::pair<int, int>> expected(model.begin(), model.end());
+    assert(all == expected && "Tiered contents mismatch after full compaction!");
+    for (int k = 0; k < 60000; ++k) {
+        assert(shard.contains(k) == (model.count(k) == 1));
+    }
+
+    // La fusión corre fuera del lock: con un compact() grande en curso en
+    // otro thread, get() sigue respondiendo (antes esperaba toda la fusión)
+    TieredShard<int, int> big;
+    const int BIG = 1000000;
+    for (int k = 0; k < BIG; ++k) big.insert(k, k);
+    for (int k = 0; k < BIG; k += 3) big.remove(k);
+    std::atomic<bool> finished{false};
+    std::thread compactor([&] {
+        big.compact();
+        finished = true;
+    });
+    size_t reads_during = 0;
+    while (!finished.load()) {
+        if (!big.compacting()) continue;
+        int k = static_cast<int>(reads_during * 7919 % BIG);
+        auto v = big.get(k);
+        assert(v.has_value() == (k % 3 != 0));
+        if (v) assert(*v == k);
+        ++reads_during;
+    }
+    compactor.join();
+    assert(reads_during > 0);
+    assert(big.segment_count() == 1 && big.size() == static_cast<size_t>(BIG - (BIG + 2) / 3));
+
+    std::cout << "  ✓ " << stats.compactions << " compactions, " << stats.segments
+              << " segments before full compaction, contents exact; "
+              << reads_during << " reads served during a 1M-entry merge" << std::endl;
+}
+
+// findBatch del AVL: lotes de tamaños arbitrarios (no múltiplos del grupo)
+// con keys presentes, ausentes y repetidas
+void test_avl_find_batch() {
+    std::cout << "\n[TEST] AVLTree - findBatch matches find" << std::endl;
+
+    AVLTree<int, int> tree;
+    for (int k = 0; k < 100000; k += 2) tree.insert(k, k * 3);
+
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> dist(-10, 100010);
+    for (size_t n : {0, 1, 7, 16, 17, 100, 5000}) {
+        std::vector<int> keys(n);
+        for (auto& k : keys) k = dist(gen);
+        if (n > 2) keys[1] = keys[0];
+        std::vector<const int*> out(n, nullptr);
+        tree.findBatch(keys.data(), n, out.data());
+        for (size_t i = 0; i < n; ++i) {
+            assert(out[i] == tree.find(keys[i]) && "findBatch mismatch!");
+        }
+    }
+
+    std::cout << "  ✓ Batched and single lookups agree" << std::endl;
+}
+
+// Monoid no conmutativo: (primera key, última key) del rango. Detecta
+// combinaciones fuera de orden en reduceRange
+struct FirstLastMonoid {
+    struct value_type {
+        bool empty = true;
+        int first = 0;
+        int last = 0;
+    };
+    static value_type identity() { return value_type{}; }
+    static value_type lift(const int& k, const int&) { return value_type{false, k, k}; }
+    static value_type combine(const value_type& a, const value_type& b) {
+        if (a.empty) return b;
+        if (b.empty) return a;
+        return value_type{false, a.first, b.last};
+    }
+};
+
+// Agregados por subárbol: reduceRange contra un escaneo de std::map con
+// inserts, updates y removes intercalados (las rotaciones deben mantenerlos)
+void test_range_reduce() {
+    std::cout << "\n[TEST] AVLTree - subtree aggregates and reduce_range" << std::endl;
+
+    using Stats = StatsMonoid<long long>;
+    AVLTree<int, int, Stats> tree;
+    AVLTree<int, int, FirstLastMonoid> ordered;
+    std::map<int, int> model;
+
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> key_dist(0, 20000);
+    std::uniform_int_distribution<int> val_dist(-1000, 1000);
+    std::uniform_int_distribution<int> op_dist(0, 9);
+
+    auto check = [&](int lo, int hi) {
+        Stats::value_type expected;
+        for (auto it = model.lower_bound(lo); it != model.end() && it->first <= hi; ++it) {
+            expected = Stats::combine(expected, Stats::lift(it->first, it->second));
+        }
+        auto got = tree.reduceRange(lo, hi);
+        assert(got.count == expected.count && got.sum == expected.sum);
+        assert(got.min == expected.min && got.max == expected.max);
+
+        auto fl = ordered.reduceRange(lo, hi);
+        assert(fl.empty == (expected.count == 0));
+        if (!fl.empty) {
+            assert(fl.first == model.lower_bound(lo)->first);
+            assert(fl.last == std::prev(model.upper_bound(hi))->first);
+        }
+    };
+
+    for (int i = 0; i < 60000; ++i) {
+        int k = key_dist(gen);
+        if (op_dist(gen) < 7) {
+            int v = val_dist(gen);
+            tree.insert(k, v);
+            ordered.insert(k, v);
+            model[k] = v;
+        } else {
+            tree.remove(k);
+            ordered.remove(k);
+            model.erase(k);
+        }
+        if (i % 500 == 0) {
+            int lo = key_dist(gen);
+            check(lo, lo + key_dist(gen) / 8);
+        }
+    }
+    check(-1, 30000);
+    check(500, 499);
+    assert(tree.aggregate().count == model.size());
+
+    // ParallelAVL: suma O(log n) por shard contra range_query
+    using AggShard = TreeShard<int, int, AVLTree<int, int, Stats>>;
+    ParallelAVL<int, int, AggShard> par(8);
+    for (const auto& [k, v] : model) par.insert(k, v);
+    for (int q = 0; q < 200; ++q) {
+        int lo = key_dist(gen);
+        int hi = lo + key_dist(gen) / 4;
+        std::vector<std::pair<int, int>> scan;
+        par.range_query(lo, hi, std::back_inserter(scan));
+        long long sum = 0;
+        for (const auto& kv : scan) sum += kv.second;
+        auto agg = par.reduce_range(lo, hi);
+        assert(agg.count == scan.size() && agg.sum == sum);
+    }
+
+    std::cout << "  ✓ Aggregates match full scans (" << model.size() << " keys)" << std::endl;
+}
+
+// Desfragmentación online: pasos intercalados con inserts/removes contra
+// std::map, memoria devuelta tras borrados masivos, y un shard desfragmentado
+// mientras otros threads lo usan
+template<typename V, typename MakeV>
+void check_relocation(const char* name, MakeV make_value) {
+    std::cout << "\n[TEST] AVLTree<" << name << "> - incremental relocation" << std::endl;
+
+    AVLTree<int, V> tree;
+    std::map<int, V> model;
+    std::mt19937 gen(21);
+    std::uniform_int_distribution<int> key_dist(0, 400000);
+
+    for (int i = 0; i < 200000; ++i) {
+        int k = key_dist(gen);
+        tree.insert(k, make_value(k));
+        model[k] = make_value(k);
+    }
+    for (int i = 0; i < 400000; ++i) {
+        int k = key_dist(gen);
+        if (i % 10 != 0) {
+            tree.remove(k);
+            model.erase(k);
+        }
+    }
+    size_t before = tree.memoryBytes();
+
+    tree.beginRelocation();
+    assert(tree.relocating());
+    int steps = 0;
+    while (!tree.relocateStep(257)) {
+        // Mutaciones entre pasos, como haría otro thread
+        for (int j = 0; j < 5; ++j) {
+            int k = key_dist(gen);
+            if (j % 2) {
+                tree.insert(k, make_value(k + 1));
+                model[k] = make_value(k + 1);
+            } else {
+                tree.remove(k);
+                model.erase(k);
+            }
+        }
+        ++steps;
+    }
+    assert(!tree.relocating());
+    assert(tree.size() == model.size());
+    auto it = model.begin();
+    tree.forEach([&](const int& k, const V& v) {
+        assert(it != model.end() && it->first == k && it->second == v);
+        ++it;
+    });
+    assert(it == model.end());
+    assert(tree.memoryBytes() < before / 2);
+
+    std::cout << "  ✓ " << steps << " steps, " << before / 1024 << " KB -> "
+              << tree.memoryBytes() / 1024 << " KB" << std::endl;
+}
+
+// Árbol grande con churn aleatorio y muchas rotaciones entre pasos: un nodo
+// queda encolado dos veces (una por key, otra por puntero) y el segundo no
+// debe tocar el slot ya liberado. La pasada final se reparte entre pasos
+void check_relocation_churn() {
+    std::cout << "\n[TEST] AVLTree<int> - relocation under heavy churn" << std::endl;
+    using namespace std::chrono;
+
+    const int N = 1000000;
+    AVLTree<int, int> tree;
+    std::map<int, int> model;
+    std::mt19937 gen(83);
+    std::uniform_int_distribution<int> key_dist(0, 2 * N);
+    for (int k = 0; k < N; ++k) {
+        tree.insert(k, k);
+        model[k] = k;
+    }
+    for (int i = 0; i < N / 2; ++i) {
+        int out = key_dist(gen), in = key_dist(gen);
+        tree.remove(out);
+        model.erase(out);
+        tree.insert(in, in);
+        model[in] = in;
+    }
+
+    tree.beginRelocation();
+    int steps = 0;
+    nanoseconds worst{0}, total{0};
+    for (;;) {
+        auto t0 = steady_clock::now();
+        bool done = tree.relocateStep(4096);
+        auto dt = steady_clock::now() - t0;
+        worst = std::max(worst, duration_cast<nanoseconds>(dt));
+        total += duration_cast<nanoseconds>(dt);
+        ++steps;
+        if (done) break;
+        for (int j = 0; j < 50; ++j) {
+            int k = key_dist(gen);
+            tree.insert(k, -k);
+            model[k] = -k;
+            k = key_dist(gen);
+            tree.remove(k);
+            model.erase(k);
+        }
+    }
+    assert(tree.size() == model.size());
+    auto it = model.begin();
+    tree.forEach([&](const int& k, const int& v) {
+        assert(it != model.end() && it->first == k && it->second == v);
+        ++it;
+    });
+    assert(it == model.end());
+
+    std::cout << "  ✓ " << steps << " steps, avg "
+              << duration_cast<microseconds>(total).count() / steps << " us, worst "
+              << duration_cast<microseconds>(worst).count() << " us" << std::endl;
+}
+
+void test_defragment() {
+    check_relocation<int>("int", [](int k) { return k * 7; });
+    check_relocation<std::string>("string", [](int k) {
+        return std::string(24, 'a' + k % 26) + std::to_string(k);
+    });
+    check_relocation_churn();
+
+    std::cout << "\n[TEST] TreeShard - defragment under concurrent load" << std::endl;
+    TreeShard<int, int> shard;
+    for (int k = 0; k < 100000; ++k) shard.insert(k, k);
+    for (int k = 0; k < 100000; k += 2) shard.remove(k);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t]() {
+            int k = 1 + 2 * t;
+            while (!done.load()) {
+                auto v = shard.get(k);
+                if (!v || *v != k) failures++;
+                shard.insert(200000 + k, k);
+                shard.remove(200000 + k);
+                k = (k + 8) % 100000;
+            }
+        });
+    }
+    shard.defragment(1000);
+    done = true;
+    for (auto& w : workers) w.join();
+    assert(failures.load() == 0);
+    assert(shard.size() == 50000);
+
+    std::cout << "  ✓ Readers saw every key while nodes moved" << std::endl;
+}
+
+// Destrucción diferida: clear/remove_shard/destructor no liberan en el
+// thread que llama; todo se libera (una vez) tras drain()
+struct Tracked {
+    static inline std::atomic<long> live{0};
+    static inline std::atomic<long> foreign_frees{0};
+    static inline std::thread::id owner;
+    int v = 0;
+    Tracked() { live++; }
+    explicit Tracked(int x) : v(x) { live++; }
+    Tracked(const Tracked& o) : v(o.v) { live++; }
+    Tracked(Tracked&& o) noexcept : v(o.v) { live++; }
+    Tracked& operator=(const Tracked& o) { v = o.v; return *this; }
+    ~Tracked() {
+        live--;
+        if (std::this_thread::get_id() != owner) foreign_frees++;
+    }
+};
+
+void test_deferred_destruction() {
+    std::cout << "\n[TEST] DeferredDestroyer - background tree destruction" << std::endl;
+    Tracked::owner = std::this_thread::get_id();
+
+    TreeShard<int, Tracked> shard;
+    for (int k = 0; k < 50000; ++k) shard.insert(k, Tracked(k));
+    long before = Tracked::live.load();
+    assert(before >= 50000);
+
+    shard.clear();
+    assert(shard.size() == 0 && !shard.contains(1));
+    shard.insert(7, Tracked(7));
+    assert(shard.get(7)->v == 7);
+    DeferredDestroyer::drain();
+    assert(Tracked::live.load() <= before - 50000 + 1);
+    assert(Tracked::foreign_frees.load() >= 50000);
+
+    {
+        ParallelAVL<int, Tracked> tree(4);
+        for (int k = 0; k < 20000; ++k) tree.insert(k, Tracked(k));
+        tree.remove_shard();
+        tree.force_rebalance();
+        for (int k = 0; k < 20000; ++k) assert(tree.get(k)->v == k);
+    }
+    DeferredDestroyer::drain();
+    assert(Tracked::live.load() == 1);  // solo el del shard de arriba
+    assert(DeferredDestroyer::destroyed_count() > 0);
+
+    std::cout << "  ✓ " << Tracked::foreign_frees.load()
+              << " values freed off the calling thread" << std::endl;
+}
+
+void test_cache_eviction() {
+    std::cout << "\n[TEST] CacheShard - budgets and S3-FIFO eviction" << std::endl;
+
+    // Presupuesto de entradas
+    CacheShard<int, int> shard;
+    shard.set_budget({100, 0});
+    size_t evicted = 0;
+    for (int k = 0; k < 1000; ++k) {
+        auto r = shard.insert_tracked(k, k);
+        assert(r.inserted);
+        evicted += r.evicted;
+    }
+    assert(shard.size() == 100);
+    assert(evicted == 900 && shard.get_stats().evictions == 900);
+    assert(!shard.insert_tracked(999, 1).inserted);   // update, no key nueva
+
+    // clear() vacía también colas y ghosts (se destruyen en background)
+    size_t ghost_hits = shard.get_stats().ghost_hits;
+    shard.clear();
+    assert(shard.size() == 0 && shard.memory_bytes() == 0);
+    shard.insert(0, 0);     // expulsada antes: ya no es ghost
+    assert(shard.get_stats().ghost_hits == ghost_hits);
+    shard.remove(0);
+
+    // Keys calientes sobreviven a un scan de keys de un solo uso
+    for (int k = 0; k < 50; ++k) shard.insert(k, k);
+    for (int round = 0; round < 3; ++round) {
+        for (int k = 0; k < 50; ++k) assert(shard.get(k));
+    }
+    for (int k = 1000; k < 20000; ++k) {
+        shard.insert(k, k);
+        if (k % 100 == 0) {
+            for (int h = 0; h < 50; ++h) shard.get(h);
+        }
+    }
+    int hot_alive = 0;
+    for (int k = 0; k < 50; ++k) hot_alive += shard.contains(k);
+    assert(shard.size() == 100);
+    assert(hot_alive == 50);
+
+    // Presupuesto de bytes con values dinámicos
+    CacheShard<int, std::string> strings;
+    strings.set_budget({0, 64 * 1024});
+    for (int k = 0; k < 10000; ++k) strings.insert(k, std::string(200, 'x'));
+    assert(strings.memory_bytes() <= 64 * 1024);
+    assert(strings.size() > 100 && strings.size() < 320);
+    strings.remove(9999);
+    strings.set_budget({0, 0});
+    for (int k = 0; k < 1000; ++k) strings.insert(k, "");
+    assert(strings.get_stats().evictions < 10000);
+
+    // ParallelAVL como cache acotado
+    ParallelAVL<int, int, CacheShard<int, int>> cache(4);
+    cache.set_capacity(4000);
+    std::mt19937 rng(7);
+    for (int i = 0; i < 100000; ++i) {
+        int k = static_cast<int>(rng() % 50000);
+        cache.insert(k, k);
+        if (auto v = cache.get(k)) assert(*v == k);
+    }
+    assert(cache.size() <= 4000 && cache.size() > 3000);
+    cache.add_shard();
+    for (int k = 0; k < 20000; ++k) cache.insert(k, k);
+    assert(cache.size() <= 4000 + 5);
+
+    std::cout << "  ✓ " << shard.get_stats().evictions << " evictions, "
+              << hot_alive << "/50 hot keys kept, cache size " << cache.size() << std::endl;
+}
+
+void test_timer_wheel() {
+    std::cout << "\n[TEST] TimerWheel - hierarchical expiry order" << std::endl;
+    TimerWheel<int> wheel(1000);
+    std::multimap<uint64_t, int> expected;
+    std::mt19937_64 rng(3);
+    for (int i = 0; i < 20000; ++i) {
+        // Deltas en todos los niveles, incluido más allá del horizonte
+        uint64_t delta = rng() % (uint64_t(1) << (6 * (1 + rng() % 5)));
+        wheel.schedule(1000 + delta, i);
+        expected.emplace(1000 + delta, i);
+    }
+    wheel.schedule(10, -1);   // en el pasado: vence en el primer advance
+    expected.emplace(1000, -1);
+
+    uint64_t now = 1000;
+    size_t fired = 0;
+    while (!wheel.empty()) {
+        now += 1 + rng() % 5000;
+        fired += wheel.advance(now, [&](uint64_t tick, int id) {
+            assert(tick <= now);
+            auto range = expected.equal_range(id == -1 ? 1000 : tick);
+            auto it = std::find_if(range.first, range.second,
+                                   [id](const auto& e) { return e.second == id; });
+            assert(it != range.second);
+            expected.erase(it);
+        });
+        // Nada vencido queda pendiente
+        assert(expected.empty() || expected.begin()->first > now);
+    }
+    assert(fired == 20001 && expected.empty());
+    std::cout << "  ✓ 20001 timers fired on time (up to tick " << now << ")" << std::endl;
+}
+
+// Reloj que solo avanza a mano: el test de TTL no depende de cuánto tarde
+// el trabajo entre insertar y comprobar (sanitizers, máquina cargada)
+struct ManualClock {
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = true;
+
+    // Empieza lejos de 0 para que "ahora - 1 ms" no sea negativo
+    static inline std::atomic<rep> ns{std::chrono::nanoseconds(std::chrono::hours(1)).count()};
+
+    static time_point now() { return time_point(duration(ns.load())); }
+    static void advance(duration d) { ns += d.count(); }
+};
+
+void test_ttl_expiry() {
+    std::cout << "\n[TEST] CacheShard - TTL expiry" << std::endl;
+    using namespace std::chrono;
+    using Shard = CacheShard<int, int, ManualClock>;
+
+    Shard shard;
+    auto soon = Shard::Clock::now() + milliseconds(30);
+    for (int k = 0; k < 1000; ++k) shard.insert_tracked(k, k, soon);
+    for (int k = 1000; k < 1100; ++k) shard.insert(k, k);
+    shard.insert(5, 5);                                         // quita el TTL
+    shard.insert_tracked(6, 6, Shard::Clock::now() + hours(1)); // lo alarga
+    ManualClock::advance(milliseconds(29));
+    assert(shard.get(7) && shard.contains(8));
+
+    ManualClock::advance(milliseconds(1));
+    // Lectura perezosa: vencido no se ve aunque el wheel no corrió
+    assert(!shard.get(7) && !shard.contains(8) && !shard.remove(9));
+    std::vector<std::pair<int, int>> range;
+    shard.range_query(0, 2000, std::back_inserter(range));
+    assert(range.size() == 102);
+    assert(shard.size() == 1100);
+
+    assert(shard.expire() == 998);
+    assert(shard.size() == 102 && shard.get(5) && shard.get(6) && shard.get(1050));
+    assert(shard.get_stats().expirations == 998);
+
+    // Un deadline pasado no inserta y borra la key
+    auto r = shard.insert_tracked(5, 5, Shard::Clock::now() - milliseconds(1));
+    assert(!r.inserted && r.evicted == 1 && !shard.contains(5));
+
+    // ParallelAVL: TTL sobrevive a remove_shard/force_rebalance
+    ParallelAVL<int, int, Shard> tree(4);
+    for (int k = 0; k < 2000; ++k) tree.insert_with_ttl(k, k, milliseconds(40));
+    for (int k = 2000; k < 2500; ++k) tree.insert(k, k);
+    tree.remove_shard();
+    tree.force_rebalance();
+    ManualClock::advance(milliseconds(39));
+    assert(tree.size() == 2500 && tree.get(10));
+    ManualClock::advance(milliseconds(1));
+    assert(!tree.contains(10) && tree.contains(2100));
+    size_t expired = tree.expire();
+    assert(expired == 2000 && tree.size() == 500);
+
+    std::cout << "  ✓ 998 + " << expired << " entries expired, untimed keys kept" << std::endl;
+}
+
+void test_admission_control() {
+    std::cout << "\n[TEST] AdmissionGate - per-shard limits and backpressure" << std::endl;
+    using namespace std::chrono;
+
+    AdmissionGate gate;
+    gate.set_limit(2);
+    assert(gate.try_acquire() && gate.try_acquire());
+    assert(!gate.try_acquire());
+    auto t0 = AdmissionGate::Clock::now();
+    assert(!gate.acquire_until(t0 + milliseconds(20)));
+    assert(AdmissionGate::Clock::now() - t0 >= milliseconds(20));
+
+    // Un waiter entra cuando se libera un lugar
+    std::atomic<bool> admitted{false};
+    std::thread waiter([&] {
+        admitted = gate.acquire_until(AdmissionGate::Clock::now() + seconds(5));
+    });
+    while (gate.stats().waiting == 0) std::this_thread::yield();
+    gate.release();
+    waiter.join();
+    assert(admitted);
+    gate.release();
+    gate.release();
+
+    auto st = gate.stats();
+    assert(st.in_flight == 0 && st.max_waiting == 1);
+    assert(st.admitted == 3 && st.rejected == 1 && st.timed_out == 1);
+    assert(st.wait_p999_ns > 0 && st.wait_p50_ns == 0);
+
+    // ParallelAVL: con límite 1 por shard, try_* rechaza y *_until espera
+    ParallelAVL<int, int> tree(2);
+    tree.set_admission_limit(1);
+    const int threads = 4, per_thread = 5000;
+    std::atomic<int> shed{0};
+    std::vector<std::thread> workers;
+    std::vector<std::vector<int>> accepted(threads);
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                int key = t * per_thread + i;
+                bool ok = (i % 2) ? tree.try_insert(key, key)
+                                  : tree.insert_until(key, key,
+                                                      AdmissionGate::Clock::now() + seconds(5));
+                if (ok) accepted[t].push_back(key); else shed++;
+                std::optional<int> v;
+                if (tree.try_get(key, v) && ok) assert(v && *v == key);
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    size_t total_accepted = 0;
+    for (auto& keys : accepted) {
+        total_accepted += keys.size();
+        for (int k : keys) assert(tree.contains(k));
+    }
+    assert(total_accepted + shed == threads * per_thread);
+    assert(tree.size() == total_accepted);
+
+    size_t rejected = 0, timed_out = 0;
+    for (const auto& s : tree.get_admission_stats()) {
+        assert(s.limit == 1 && s.in_flight == 0);
+        rejected += s.rejected;
+        timed_out += s.timed_out;
+    }
+    assert(timed_out == 0);
+
+    // get_batch pasa por el gate: un lugar por shard tocado
+    std::vector<size_t> admitted_before;
+    for (const auto& s : tree.get_admission_stats()) admitted_before.push_back(s.admitted);
+    std::vector<int> batch(accepted[0].begin(), accepted[0].begin() + 100);
+    for (const auto& v : tree.get_batch(batch)) assert(v);
+    auto after = tree.get_admission_stats();
+    for (size_t s = 0; s < after.size(); ++s) {
+        assert(after[s].admitted == admitted_before[s] + 1 && after[s].in_flight == 0);
+    }
+
+    tree.add_shard();
+    assert(tree.get_admission_stats().size() == 3);
+
+    // Tras el cambio de topología una key ausente se busca en todos los
+    // shards: cada uno la admite, no solo el natural
+    auto admitted_per_shard = [&tree] {
+        std::vector<size_t> admitted;
+        for (const auto& s : tree.get_admission_stats()) admitted.push_back(s.admitted);
+        return admitted;
+    };
+    auto before = admitted_per_shard();
+    std::optional<int> missing;
+    assert(!tree.get(-7) && !tree.contains(-7) && !tree.remove(-7));
+    assert(tree.try_get(-7, missing) && !missing);
+    assert(tree.get_until(-7, AdmissionGate::Clock::now() + seconds(5), missing) && !missing);
+    assert(!tree.get_batch({-7})[0]);
+    auto touched = admitted_per_shard();
+    for (size_t s = 0; s < touched.size(); ++s) {
+        assert(touched[s] == before[s] + 6);
+    }
+    for (const auto& s : tree.get_admission_stats()) assert(s.in_flight == 0);
+    tree.set_admission_limit(0);
+    assert(tree.try_insert(-1, -1));
+
+    std::cout << "  ✓ " << total_accepted << " admitted, " << shed.load()
+              << " shed (" << rejected << " rejected by gates)" << std::endl;
+}
+
+// TreeShard con el lock ya configurado, para correr la batería genérica
+template<ShardLockMode Mode, bool Batching>
+struct ConfiguredTreeShard : TreeShard<int, int> {
+    ConfiguredTreeShard() {
+        set_lock_mode(Mode, 2);
+        set_write_batching(Batching);
+    }
+};
+
+void test_read_priority() {
+    std::cout << "\n[TEST] ShardLock - reader priority and fairness" << std::endl;
+    using namespace std::chrono;
+
+    // Espera a que cond() sea true, con un tope generoso (sanitizers, CI cargado)
+    auto wait_for = [](auto cond) {
+        auto deadline = steady_clock::now() + seconds(30);
+        while (!cond()) {
+            if (steady_clock::now() > deadline) return false;
+            std::this_thread::yield();
+        }
+        return true;
+    };
+
+    // Con un lector adentro y un writer esperando, ¿entra un lector nuevo?
+    // El lector nuevo o entra o queda contado en waiting_readers(): no hace
+    // falta adivinar con sleeps cuándo decidió
+    auto reader_passes_waiting_writer = [&wait_for](ShardLockMode mode, size_t ratio) {
+        ShardLock lock;
+        lock.set_mode(mode, ratio);
+        lock.lock_shared();
+        std::atomic<bool> writer_in{false};
+        std::thread writer([&] {
+            lock.lock();
+            writer_in = true;
+            lock.unlock();
+        });
+        assert(wait_for([&] { return lock.waiting_writers() == 1; }));
+        std::atomic<bool> reader_in{false};
+        std::thread reader([&] {
+            lock.lock_shared();
+            reader_in = true;
+            lock.unlock_shared();
+        });
+        assert(wait_for([&] { return reader_in.load() || lock.waiting_readers() == 1; }));
+        bool passed = reader_in.load();
+        lock.unlock_shared();
+        writer.join();
+        reader.join();
+        assert(writer_in && reader_in);
+        return passed;
+    };
+    assert(reader_passes_waiting_writer(ShardLockMode::READER_PRIORITY, 0));
+    assert(reader_passes_waiting_writer(ShardLockMode::FAIR, 1));
+    assert(!reader_passes_waiting_writer(ShardLockMode::FAIR, 0));
+
+    // Escrituras en lote: todas aplicadas, resultados de remove correctos
+    ParallelAVL<int, int> tree(2);
+    tree.set_shard_lock_mode(ShardLockMode::READER_PRIORITY);
+    tree.set_write_batching(true);
+    std::atomic<int> removed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 5000; ++i) {
+                int key = t * 5000 + i;
+                tree.insert(key, key);
+                assert(tree.get(key) == key);
+                if (i % 4 == 0 && tree.remove(key)) removed++;
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    assert(removed == 5000);
+    assert(tree.size() == 15000);
+    tree.add_shard();
+    tree.insert(-5, -5);
+    assert(tree.contains(-5));
+
+    std::cout << "  ✓ Readers pass waiting writers only when allowed; "
+              << "batched writes exact" << std::endl;
+}
+
+// Exclusión mutua, orden FIFO (colas) y contadores de contención
+template<typename Lock>
+void check_queue_lock(const char* name, bool fifo) {
+    using namespace std::chrono;
+    Lock lock;
+
+    constexpr int THREADS = 6;
+    constexpr int ITERS = 20000;
+    long counter = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < ITERS; ++i) {
+                std::lock_guard<Lock> guard(lock);
+                counter++;
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    assert(counter == static_cast<long>(THREADS) * ITERS);
+
+    // Con el lock tomado, los waiters se encolan de a uno: deben entrar en
+    // el mismo orden
+    std::vector<int> order;
+    lock.lock();
+    threads.clear();
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            std::lock_guard<Lock> guard(lock);
+            order.push_back(t);
+        });
+        std::this_thread::sleep_for(milliseconds(10));
+    }
+    lock.unlock();
+    for (auto& th : threads) th.join();
+    assert(order.size() == 4);
+    if (fifo) {
+        for (int t = 0; t < 4; ++t) assert(order[t] == t);
+    }
+
+    LockContentionStats stats = lock.contention_stats();
+    assert(stats.acquisitions == static_cast<size_t>(THREADS) * ITERS + 5);
+    assert(stats.contended >= 4 && stats.contended <= stats.acquisitions);
+    assert(stats.wait_ns > 0);
+    // Una espera cuenta un park aunque haya cedido el core varias veces
+    assert(stats.parks <= stats.contended);
+
+    std::cout << "  ✓ " << name << ": " << stats.contended << "/" << stats.acquisitions
+              << " contended, " << stats.parks << " parks, " << stats.yields << " yields"
+              << std::endl;
+}
+
+void test_queue_locks() {
+    std::cout << "\n[TEST] Queue locks - exclusion, FIFO handoff, contention stats" << std::endl;
+    check_queue_lock<StdShardMutex>("StdShardMutex", false);
+    check_queue_lock<McsLock>("McsLock", true);
+    check_queue_lock<ClhLock>("ClhLock", true);
+    check_queue_lock<SpinThenParkLock>("SpinThenParkLock", false);
+
+    // Stats por shard a través de ParallelAVL
+    ParallelAVL<int, int, TreeShard<int, int, AVLTree<int, int>, McsLock>> tree(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 2000; ++i) tree.insert(t * 2000 + i, i);
+        });
+    }
+    for (auto& th : threads) th.join();
+    size_t acquisitions = 0;
+    for (const auto& s : tree.get_lock_stats()) acquisitions += s.acquisitions;
+    assert(tree.get_lock_stats().size() == 4);
+    assert(acquisitions >= 8000);
+    assert(tree.size() == 8000);
+}
+
+int main() {
+    std::cout << "╔════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  Shard Backend Test Suite                  ║" << std::endl;
+    std::cout << "╚════════════════════════════════════════════╝" << std::endl;
+
+    ShardBackendTest<TreeShard<int, int>>("TreeShard").run_all();
+    ShardBackendTest<ConcurrentAVLShard<int, int>>("ConcurrentAVLShard").run_all();
+    ShardBackendTest<SkipListShard<int, int>>("SkipListShard").run_all();
+    ShardBackendTest<TreeShard<int, int, BPlusTree<int, int>>>("TreeShard<BPlusTree>").run_all();
+
+    ShardBackendTest<TreeShard<int, int, AdaptiveRadixTree<int, int>>>("TreeShard<AdaptiveRadixTree>").run_all();
+    ShardBackendTest<TieredShard<int, int>>("TieredShard").run_all();
+    ShardBackendTest<TreeShard<int, int, AVLTree<int, int, StatsMonoid<long long>>>>(
+        "TreeShard<AVLTree+StatsMonoid>").run_all();
+    ShardBackendTest<CacheShard<int, int>>("CacheShard").run_all();
+    ShardBackendTest<ConfiguredTreeShard<ShardLockMode::READER_PRIORITY, true>>(
+        "TreeShard<reader priority, batched writes>").run_all();
+    ShardBackendTest<ConfiguredTreeShard<ShardLockMode::FAIR, false>>(
+        "TreeShard<fair 2:1>").run_all();
+    ShardBackendTest<TreeShard<int, int, AVLTree<int, int>, McsLock>>("TreeShard<McsLock>").run_all();
+    ShardBackendTest<TreeShard<int, int, AVLTree<int, int>, ClhLock>>("TreeShard<ClhLock>").run_all();
+    ShardBackendTest<TreeShard<int, int, AVLTree<int, int>, SpinThenParkLock>>(
+        "TreeShard<SpinThenParkLock>").run_all();
+
+    test_tree_structure<BPlusTree<int, int>, int>("BPlusTree<int>");
+    test_tree_structure<BPlusTree<int64_t, int>, int64_t>("BPlusTree<int64_t>");
+    test_tree_structure<BPlusTree<uint32_t, int>, uint32_t>("BPlusTree<uint32_t>");
+    test_tree_structure<AdaptiveRadixTree<int, int>, int>("AdaptiveRadixTree<int>");
+    test_tree_structure<AdaptiveRadixTree<int64_t, int>, int64_t>("AdaptiveRadixTree<int64_t>");
+    test_tree_structure<AdaptiveRadixTree<uint32_t, int>, uint32_t>("AdaptiveRadixTree<uint32_t>");
+    test_tiered_compaction();
+    test_avl_find_batch();
+    test_range_reduce();
+    test_defragment();
+    test_deferred_destruction();
+    test_cache_eviction();
+    test_timer_wheel();
+    test_ttl_expiry();
+    test_admission_control();
+    test_read_priority();
+    test_queue_locks();
+
+    std::cout << "\n✓ All shard backend tests passed" << std::endl;
+    return 0;
+}
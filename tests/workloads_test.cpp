@@ -78,6 +78,53 @@ void test_zipfian_skew() {
     std::cout << "  ✓ Zipfian shows expected skew" << std::endl;
 }
 
+void test_scrambled_zipfian() {
+    std::cout << "\n[TEST] Scrambled Zipfian (YCSB, θ=0.99)" << std::endl;
+
+    constexpr size_t N = 10000;
+    constexpr size_t SAMPLES = 200000;
+    ScrambledZipfianGenerator<int> gen(N, 12345);
+
+    std::unordered_map<int, size_t> counts;
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        int key = gen.next();
+        assert(key >= 0 && key < static_cast<int>(N) && "Key out of range");
+        counts[key]++;
+    }
+
+    std::vector<std::pair<int, size_t>> sorted(counts.begin(), counts.end());
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto& a, const auto& b) { return a.second > b.second; });
+
+    size_t top_1_count = 0;
+    for (size_t i = 0; i < N / 100 && i < sorted.size(); ++i) {
+        top_1_count += sorted[i].second;
+    }
+    double top_1_percent = (top_1_count * 100.0) / SAMPLES;
+    std::cout << "  Top 1% keys got: " << top_1_percent << "% of accesses" << std::endl;
+    std::cout << "  Distinct keys: " << counts.size() << " / " << N << std::endl;
+
+    // Sesgo fuerte, pero la cola larga sigue alcanzando buena parte del espacio
+    assert(top_1_percent > 30.0 && "Should show strong skew");
+    assert(counts.size() > N / 4 && "Should reach the long tail");
+
+    // Las keys calientes quedan repartidas, no agrupadas en las más bajas
+    size_t hot_in_low_half = 0;
+    for (size_t i = 0; i < 10; ++i) {
+        if (sorted[i].first < static_cast<int>(N / 2)) hot_in_low_half++;
+    }
+    assert(hot_in_low_half < 10 && "Hot keys should be scrambled");
+
+    // Con zeta precalculado se obtiene la misma secuencia
+    ScrambledZipfianGenerator<int> a(N, 7);
+    ScrambledZipfianGenerator<int> b(N, 7, a.zeta_n());
+    for (size_t i = 0; i < 1000; ++i) {
+        assert(a.next() == b.next());
+    }
+
+    std::cout << "  ✓ Scrambled zipfian shows skew over the whole key space" << std::endl;
+}
+
 void test_sequential() {
     std::cout << "\n[TEST] Sequential Generator" << std::endl;
 
@@ -174,6 +221,7 @@ int main() {
 
     test_uniform_distribution();
     test_zipfian_skew();
+    test_scrambled_zipfian();
     test_sequential();
     test_adversarial();
     test_hotspot();